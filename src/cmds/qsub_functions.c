@@ -38,6 +38,8 @@
 #include <grp.h>
 #include <csv.h>
 #include <pwd.h>
+#include <string>
+#include <vector>
 
 #ifdef sun
 #include <sys/stream.h>
@@ -3876,7 +3878,7 @@ void print_qsub_usage_exit(const char *error_msg)
   /* need secondary usage since there appears to be a 512 byte size limit */
 
   static char usage2[] =
-    "      [-W additional_attributes] [-v variable_list] [-V ] [-x] [-X] [-z] [script]\n";
+    "      [-W additional_attributes] [-v variable_list] [-V ] [-x] [-X] [-z]\n      [--batch-file file] [script]\n";
     
   fprintf(stderr,"[%s]\n\n%s%s\n", error_msg, usage, usage2);
 
@@ -4096,6 +4098,509 @@ bool retry_submit_error(
 
 
 
+
+/*
+ * submit_job()
+ *
+ * Sends the job to the server, using the single round trip Submit Job
+ * request unless the server has already shown it doesn't support it.
+ * Older servers close the connection on the unknown request, so we
+ * reconnect before falling back to the Queue Job request sequence.
+ *
+ * @param sock_num - the server connection, replaced if we had to reconnect
+ * @return the error from pbs_submit_commit_hash() or pbs_submit_hash()
+ */
+
+int submit_job(
+
+  int        &sock_num,
+  job_info   *ji,
+  char       *script,
+  char       *destination,
+  const char *server,
+  char      **new_jobname,
+  char      **errmsg)
+
+  {
+  static bool try_submit_commit = true;
+  int         rc;
+
+  if (try_submit_commit == true)
+    {
+    rc = pbs_submit_commit_hash(
+           sock_num,
+           ji->job_attr,
+           ji->res_attr,
+           script,
+           destination,
+           NULL,
+           new_jobname,
+           errmsg);
+
+    if (rc != PBSE_NOSUP)
+      return(rc);
+
+    try_submit_commit = false;
+
+    pbs_disconnect(sock_num);
+
+    if ((sock_num = cnt2server(server)) <= 0)
+      return(-1 * sock_num);
+    }
+
+  return(pbs_submit_hash(
+           sock_num,
+           ji->job_attr,
+           ji->res_attr,
+           script,
+           destination,
+           NULL,
+           new_jobname,
+           errmsg));
+  } /* END submit_job() */
+
+
+
+/*
+ * extract_batch_file()
+ *
+ * Removes --batch-file <path> (or --batch-file=<path>) from the arguments
+ * so getopt and the submit args never see it.
+ *
+ * @return the path of the batch file, or NULL if the option wasn't given
+ */
+
+char *extract_batch_file(
+
+  int   &argc,
+  char **argv)
+
+  {
+  char *batch_file = NULL;
+  int   removed;
+  int   i;
+
+  for (i = 1; i < argc; i++)
+    {
+    removed = 0;
+
+    if (strcmp(argv[i], "--batch-file") == 0)
+      {
+      if (i + 1 >= argc)
+        print_qsub_usage_exit("qsub: --batch-file requires a file name");
+
+      batch_file = argv[i + 1];
+      removed = 2;
+      }
+    else if (strncmp(argv[i], "--batch-file=", strlen("--batch-file=")) == 0)
+      {
+      batch_file = argv[i] + strlen("--batch-file=");
+      removed = 1;
+      }
+
+    if (removed > 0)
+      {
+      /* shift the rest down, including the terminating NULL */
+      memmove(argv + i, argv + i + removed, (argc - i - removed + 1) * sizeof(char *));
+      argc -= removed;
+      i--;
+      }
+    }
+
+  return(batch_file);
+  } /* END extract_batch_file() */
+
+
+
+/*
+ * prepare_batch_job()
+ *
+ * Builds one job of a --batch-file submission. The job starts from the
+ * settings every job shares (defaults, config file and environment), then
+ * the script's directives are read and the command line is applied last so
+ * it keeps its usual precedence over them.
+ *
+ * @param base - the settings shared by every job
+ * @param script - the path of this job's script
+ * @param script_tmp - O, the copy of the script to send (minsize=MAXPATHLEN + 1)
+ * @return the new job, which the caller deletes, or NULL on error
+ */
+
+static job_info *prepare_batch_job(
+
+  int         argc,
+  char      **argv,
+  job_info   *base,
+  char       *script,
+  char       *script_tmp)
+
+  {
+  job_info    *ji = new job_info();
+  job_data    *tmp_job_info = NULL;
+  struct stat  statbuf;
+  FILE        *script_fp;
+  char        *bnp;
+
+  hash_add_hash(ji->job_attr, base->job_attr, TRUE);
+  hash_add_hash(ji->res_attr, base->res_attr, TRUE);
+  hash_add_hash(ji->user_attr, base->user_attr, TRUE);
+  hash_add_hash(ji->client_attr, base->client_attr, TRUE);
+
+  /* -L requests are collected per job */
+  cr.clear_reqs();
+
+  script_tmp[0] = '\0';
+
+  if (stat(script, &statbuf) < 0)
+    {
+    fprintf(stderr, "qsub: script file '%s' cannot be loaded - %s\n",
+      script,
+      strerror(errno));
+
+    delete ji;
+    return(NULL);
+    }
+
+  if (!S_ISREG(statbuf.st_mode))
+    {
+    fprintf(stderr, "qsub: script '%s' is not a file\n", script);
+
+    delete ji;
+    return(NULL);
+    }
+
+  if ((script_fp = fopen(script, "r")) == NULL)
+    {
+    fprintf(stderr, "qsub: opening script file '%s' - %s\n",
+      script,
+      strerror(errno));
+
+    delete ji;
+    return(NULL);
+    }
+
+  hash_add_or_exit(ji->client_attr, "cmdline_script", script, CMDLINE_DATA);
+
+  if (hash_find(ji->job_attr, ATTR_N, &tmp_job_info) == FALSE)
+    {
+    if ((bnp = strrchr(script, (int)'/')))
+      bnp++;
+    else
+      bnp = script;
+
+    if (check_job_name(bnp, 0) != 0)
+      {
+      fprintf(stderr, "qsub: cannot form a valid job name from the script name '%s'\n", script);
+
+      fclose(script_fp);
+      delete ji;
+      return(NULL);
+      }
+
+    hash_add_or_exit(ji->job_attr, ATTR_N, bnp, CMDLINE_DATA);
+    }
+
+  /* (3) */
+  if (get_script(argc, argv, script_fp, script_tmp, ji) != 0)
+    {
+    fclose(script_fp);
+    unlink(script_tmp);
+    delete ji;
+    return(NULL);
+    }
+
+  fclose(script_fp);
+
+  /* (2) cmdline options */
+  process_opts(argc, argv, ji, CMDLINE_DATA);
+
+  if (hash_find(ji->job_attr, ATTR_inter, &tmp_job_info))
+    {
+    fprintf(stderr, "qsub: interactive jobs can not be submitted with --batch-file (%s)\n", script);
+
+    unlink(script_tmp);
+    delete ji;
+    return(NULL);
+    }
+
+  /* Root user submission not allowed */
+  if ((hash_find(ji->job_attr, ATTR_P, &tmp_job_info) == TRUE) ?
+      (strcmp("root", tmp_job_info->value.c_str()) == 0) :
+      ((getuid() == 0) && (geteuid() == 0)))
+    {
+    fprintf(stderr, "qsub can not be run as root\n");
+
+    unlink(script_tmp);
+    delete ji;
+    return(NULL);
+    }
+
+  post_check_attributes(ji, script_tmp);
+
+  add_new_request_if_present(ji);
+
+  set_minwclimit(ji->job_attr);
+
+  if (hash_find(ji->client_attr, "user_attr", &tmp_job_info))
+    add_variable_list(ji, ATTR_v, ji->user_attr);
+
+  return(ji);
+  } /* END prepare_batch_job() */
+
+
+
+/*
+ * submit_batch_file()
+ *
+ * Submits every script listed in batch_file, one path per line, using
+ * pbs_submit_many() so the whole set costs one connection and a request
+ * per SUBMIT_MANY_MAX jobs. Jobs the server couldn't take that way, or
+ * every job if the server doesn't know the Submit Many request, are sent
+ * one at a time with submit_job().
+ *
+ * Prints each new job id, or an error naming the script.
+ *
+ * @return PBSE_NONE if every job was queued, else the last error
+ */
+
+static int submit_batch_file(
+
+  int         argc,
+  char      **argv,
+  job_info   *base,
+  const char *batch_file)
+
+  {
+  FILE                              *fp;
+  char                               line[MAXPATHLEN + 1];
+  char                               script_tmp[MAXPATHLEN + 1];
+  char                              *ptr;
+  char                              *q_n_out;
+  char                              *s_n_out;
+  job_data                          *tmp_job_info = NULL;
+  job_info                          *ji;
+  int                                sock_num;
+  int                                rc = PBSE_NONE;
+  int                                local_errno = PBSE_NONE;
+  bool                               failed = false;
+  unsigned int                       i;
+  std::vector<std::string>           script_names;
+  std::vector<job_info *>            jobs;
+  std::vector<std::string>           script_tmps;
+  std::vector<std::string>           destinations;
+  std::vector<job_data_container *>  job_attrs;
+  std::vector<job_data_container *>  res_attrs;
+  std::vector<char *>                scripts;
+  std::vector<char *>                destins;
+  std::vector<char *>                jobids;
+  std::vector<int>                   codes;
+
+  if ((fp = fopen(batch_file, "r")) == NULL)
+    {
+    fprintf(stderr, "qsub: cannot open batch file '%s' - %s\n",
+      batch_file,
+      strerror(errno));
+
+    return(PBSE_BADSCRIPT);
+    }
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+    ptr = line + strlen(line);
+
+    while ((ptr > line) && (isspace(*(ptr - 1))))
+      *--ptr = '\0';
+
+    ptr = line;
+
+    while (isspace(*ptr))
+      ptr++;
+
+    if ((*ptr == '\0') || (*ptr == '#'))
+      continue;
+
+    script_names.push_back(ptr);
+    }
+
+  fclose(fp);
+
+  if (script_names.size() == 0)
+    {
+    fprintf(stderr, "qsub: batch file '%s' lists no scripts\n", batch_file);
+
+    return(PBSE_BADSCRIPT);
+    }
+
+  /* prepare every job before sending any, so an error in one script
+   * doesn't leave the set half submitted */
+  server_out[0] = '\0';
+
+  for (i = 0; i < script_names.size(); i++)
+    {
+    std::string server;
+
+    if ((ji = prepare_batch_job(argc, argv, base, (char *)script_names[i].c_str(), script_tmp)) == NULL)
+      {
+      failed = true;
+      break;
+      }
+
+    jobs.push_back(ji);
+    script_tmps.push_back(script_tmp);
+
+    if (hash_find(ji->client_attr, "destination", &tmp_job_info))
+      {
+      if (parse_destination_id((char *)tmp_job_info->value.c_str(), &q_n_out, &s_n_out))
+        {
+        fprintf(stderr, "qsub: illegally formed destination: %s\n",
+          tmp_job_info->value.c_str());
+
+        failed = true;
+        break;
+        }
+
+      if (notNULL(s_n_out))
+        server = s_n_out;
+
+      destinations.push_back(tmp_job_info->value);
+      }
+    else
+      destinations.push_back("");
+
+    /* one connection carries the whole set */
+    if (i == 0)
+      snprintf(server_out, sizeof(server_out), "%s", server.c_str());
+    else if (server != server_out)
+      {
+      fprintf(stderr, "qsub: every job in a batch file must go to the same server (%s)\n",
+        script_names[i].c_str());
+
+      failed = true;
+      break;
+      }
+    }
+
+  if (failed == false)
+    {
+    if (hash_find(base->client_attr, "cnt2server_retry", &tmp_job_info))
+      {
+      int tmpNum = atoi(tmp_job_info->value.c_str());
+      if (tmpNum > 0)
+        cnt2server_conf(tmpNum);
+      }
+
+    sock_num = cnt2server(server_out);
+
+    if (sock_num <= 0)
+      {
+      local_errno = -1 * sock_num;
+
+      fprintf(stderr, "qsub: cannot connect to server %s (errno=%d) %s\n",
+        (server_out[0] != '\0') ? server_out : pbs_server,
+        local_errno,
+        pbs_strerror(local_errno));
+
+      failed = true;
+      }
+    }
+
+  if (failed == true)
+    {
+    for (i = 0; i < jobs.size(); i++)
+      {
+      unlink(script_tmps[i].c_str());
+      delete jobs[i];
+      }
+
+    return((local_errno != PBSE_NONE) ? local_errno : PBSE_BADSCRIPT);
+    }
+
+  for (i = 0; i < jobs.size(); i++)
+    {
+    job_attrs.push_back(jobs[i]->job_attr);
+    res_attrs.push_back(jobs[i]->res_attr);
+    scripts.push_back((char *)script_tmps[i].c_str());
+    destins.push_back((char *)destinations[i].c_str());
+    }
+
+  jobids.resize(jobs.size(), NULL);
+  codes.resize(jobs.size(), PBSE_NOSUP);
+
+  rc = pbs_submit_many(
+         sock_num,
+         jobs.size(),
+         &job_attrs[0],
+         &res_attrs[0],
+         &scripts[0],
+         &destins[0],
+         NULL,
+         &jobids[0],
+         &codes[0]);
+
+  if (rc == PBSE_NOSUP)
+    {
+    /* the server doesn't know the request and has dropped the
+     * connection, so every job goes one at a time */
+    pbs_disconnect(sock_num);
+    sock_num = cnt2server(server_out);
+    }
+  else if (rc != PBSE_NONE)
+    {
+    /* a request may have been acted on without a reply reaching us, so
+     * resending its jobs could queue them twice */
+    for (i = 0; i < jobs.size(); i++)
+      {
+      if (codes[i] == PBSE_NOSUP)
+        codes[i] = rc;
+      }
+    }
+
+  for (i = 0; i < jobs.size(); i++)
+    {
+    char *errmsg = NULL;
+
+    if ((codes[i] == PBSE_NOSUP) &&
+        (sock_num > 0))
+      {
+      codes[i] = submit_job(
+                   sock_num,
+                   jobs[i],
+                   scripts[i],
+                   destins[i],
+                   server_out,
+                   &jobids[i],
+                   &errmsg);
+      }
+    else if (codes[i] == PBSE_NOSUP)
+      codes[i] = -1 * sock_num;
+
+    if (codes[i] == PBSE_NONE)
+      {
+      if (hash_find(jobs[i]->client_attr, "no_jobid_out", &tmp_job_info) == FALSE)
+        printf("%s\n", jobids[i]);
+      }
+    else
+      {
+      fprintf(stderr, "qsub: submit error for %s (%s)\n",
+        script_names[i].c_str(),
+        (errmsg != NULL) ? errmsg : pbs_strerror(codes[i]));
+
+      local_errno = codes[i];
+      }
+
+    free(jobids[i]);
+    unlink(script_tmps[i].c_str());
+    delete jobs[i];
+    }
+
+  if (sock_num > 0)
+    pbs_disconnect(sock_num);
+
+  return(local_errno);
+  } /* END submit_batch_file() */
+
+
+
 /** 
  * qsub main 
  *
@@ -4133,6 +4638,7 @@ void main_func(
   /* Allocate Memmgr */
   int               debug = FALSE;
   job_info          ji;
+  char             *batch_file;
 
   /**
    * Before we go to the trouble of allocating memory, initializing structures,
@@ -4140,6 +4646,8 @@ void main_func(
    * short-circuiting. If yes, then we'll exit without ever returning to main_func.
    */
   process_early_opts(argc, argv);
+
+  batch_file = extract_batch_file(argc, argv);
   
   /* The order of precedence for processing options follows:
    * 1 - processing logic (includes submitfilter)
@@ -4193,6 +4701,14 @@ void main_func(
 
   script_index = find_job_script_index(optind + 1, &job_is_interactive, &prefix_index, argc, argv);
 
+  if (batch_file != NULL)
+    {
+    if (script_index != -1)
+      print_qsub_usage_exit("qsub: a script can not be given with --batch-file");
+
+    exit(submit_batch_file(argc, argv, &ji, batch_file));
+    }
+
   if (script_index != -1)
     {
     snprintf(script, sizeof(script), "%s", argv[script_index]);
@@ -4476,13 +4992,12 @@ void main_func(
 
   do
     {
-    local_errno = pbs_submit_hash(
+    local_errno = submit_job(
                   sock_num,
-                  ji.job_attr,
-                  ji.res_attr,
+                  &ji,
                   script_tmp,
                   destination,
-                  NULL,
+                  server_out,
                   &new_jobname,
                   &errmsg);
 
@@ -31,6 +31,8 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "pbs_error.h"
+
 #include <attrib.h>
 #include <compat.h>
 #include <drmaa_impl.h>
@@ -46,6 +48,9 @@ __attribute__((unused))
 
 struct batch_status *pbs_statjob_err(int c, char *id, struct attrl *attrib, char *extend, int *local_errno);
 
+/** Longest wait for a job event before the job is queried anyway (seconds). */
+#define DRMAA_EVENT_WAIT 60
+
 int
 drmaa_synchronize(
   const char **job_ids, signed long timeout,
@@ -367,6 +372,49 @@ drmaa_get_job_rusage(
   }
 
 
+/**
+ * Waits for the next event on the job event stream, at most until
+ * @a timeout_time or for DRMAA_EVENT_WAIT seconds, whichever is sooner.
+ * Without a stream (or once it's lost) sleeps for the polling interval.
+ */
+static void
+drmaa_wait_for_event(int *events, time_t timeout_time)
+  {
+
+  struct pbs_job_event event;
+  long wait = (long)(timeout_time - time(NULL));
+
+  if (*events < 0)
+    {
+    sleep(1);    /* pooling interval */
+    return;
+    }
+
+  if (wait > DRMAA_EVENT_WAIT)
+    wait = DRMAA_EVENT_WAIT;
+  else if (wait < 0)
+    wait = 0;
+
+  switch (pbs_next_event(*events, &event, (int)wait))
+    {
+
+    case PBSE_NONE:
+      DEBUG(("job event: %s state=%c", event.job_id, event.state));
+      break;
+
+    case PBSE_TIMEOUT:
+      break;
+
+    default:
+      DEBUG(("job event stream lost, polling instead"));
+      pbs_disconnect(*events);
+      *events = -1;
+      sleep(1);
+      break;
+    }
+  }
+
+
 int
 drmaa_job_wait(
   const char *jobid,
@@ -382,11 +430,28 @@ drmaa_job_wait(
   drmaa_session_t *c       = NULL;
   int rc                   = DRMAA_ERRNO_SUCCESS;
   int              local_errno = 0;
+  int              events      = -1;
   bool terminated          = false;
 
   DEBUG(("-> drmaa_job_wait(jobid=%s)", jobid));
   GET_DRMAA_SESSION(c);
 
+  /*
+   * Subscribe to the job's events on a connection of our own so state
+   * changes wake us up instead of re-querying the server every second.
+   * Servers without job events just leave us polling.
+   */
+  if (!rc && timeout_time > time(NULL))
+    {
+    events = pbs_connect(c->contact);
+
+    if (events >= 0 && pbs_subscribe(events, (char*)jobid, NULL) != 0)
+      {
+      pbs_disconnect(events);
+      events = -1;
+      }
+    }
+
   if (!rc)
     {
 
@@ -548,13 +613,16 @@ drmaa_job_wait(
     if (!rc  &&  !terminated)
       {
       if (time(NULL) < timeout_time)
-        sleep(1);    /* pooling interval */
+        drmaa_wait_for_event(&events, timeout_time);
       else
         SET_DRMAA_ERROR(rc = DRMAA_ERRNO_EXIT_TIMEOUT);
       }
     }
   while (!(rc  ||  terminated));
 
+  if (events >= 0)
+    pbs_disconnect(events);
+
   free(attribs[0].name);
   free(attribs[1].name);
   free(attribs);
@@ -141,6 +141,13 @@ struct job_array
 
   pthread_mutex_t *ai_mutex;
 
+  int    num_idle; /* number of cloned jobs that are queued or held, -1 if 
+                      it has to be counted again. when the server's 
+                      idle_slot_limit is set, jobs are only cloned from the 
+                      request tokens while this is below it */
+
+  bool   cloning;  /* job_clone_wt() is cloning jobs for this array */
+
   /* this info is saved in the array file */
   array_info   ai_qs;
   };
@@ -212,4 +219,14 @@ job_array *next_array(all_arrays_iterator **);
 
 job_array *get_jobs_array(job **);
 
+int  get_subjob_index(const char *job_id, char *parent_id);
+bool is_uncloned_index(job_array *, int);
+bool is_uncloned_subjob(const char *job_id);
+int  next_uncloned_index(job_array *);
+int  remove_uncloned_range(job_array *, int, int);
+void purge_uncloned_subjobs(job_array *, int);
+int  count_idle_subjobs(job_array *);
+void clone_more_subjobs(job_array *);
+void hold_array_template(job_array *, pbs_attribute *, enum batch_op);
+
 #endif
@@ -360,6 +360,7 @@ struct array_strings
 
 void clear_attr(pbs_attribute *pattr, attribute_def *pdef);
 int  find_attr(attribute_def *attrdef, const char *name, int limit);
+int  find_def_index(const void *defs, int limit, size_t def_size, size_t name_offset, bool nocase, const char *name);
 int  recov_attr(int fd, void *parent, attribute_def *padef,
                 pbs_attribute *pattr, int limit, int unknown, int do_actions);
 long attr_ifelse_long(pbs_attribute *, pbs_attribute *, long);
@@ -131,6 +131,23 @@ struct rq_queuejob
   tlist_head    rq_attr; /* svrattrlist */
   };
 
+/* SubmitJob - a QueueJob request that also carries the script and commits */
+
+struct rq_submitjob
+  {
+  struct rq_queuejob rq_queuejob; /* must be first, see req_submitjob() */
+  size_t             rq_scriptsz;
+  char              *rq_script;
+  };
+
+/* SubmitMany - several Submit Job requests in one */
+
+struct rq_submitmany
+  {
+  int                  rq_count;
+  struct rq_submitjob *rq_jobs;
+  };
+
 /* JobCredential */
 
 struct rq_jobcred
@@ -210,6 +227,14 @@ struct rq_runjob
   unsigned int rq_resch;
   };
 
+/* RunJobs - several Run Job requests in one */
+
+struct rq_runjobs
+  {
+  int               rq_count;
+  struct rq_runjob *rq_jobs;
+  };
+
 /* SignalJob */
 
 struct rq_signal
@@ -336,7 +361,12 @@ struct batch_request
   int                 rq_noreply; /* Set true if no reply is required */
   int                 rq_failcode;
   char               *rq_extend; /* request "extension" data  */
+  int                 rq_extflags; /* REQ_EXTEND_* flags sent with it */
+  int                 rq_encoding; /* DIS_ENCODING_* to reply with */
   char               *rq_id;      /* the batch request's id */
+  struct client_session *rq_session; /* the session it came on, or NULL */
+  unsigned int        rq_tag;     /* its tag on rq_session */
+  int                *rq_result;  /* O - gets the code of a reply that isn't sent */
 
   struct batch_reply  rq_reply;   /* the reply area for this request */
 
@@ -348,6 +378,10 @@ struct batch_request
 
     struct rq_queuejob    rq_queuejob;
 
+    struct rq_submitjob   rq_submitjob;
+
+    struct rq_submitmany  rq_submitmany;
+
     struct rq_jobcred     rq_jobcred;
 
     struct rq_jobfile     rq_jobfile;
@@ -371,10 +405,13 @@ struct batch_request
 
     struct rq_manage      rq_release;
     char                  rq_rerun[PBS_MAXSVRJOBID+1];
+    char                  rq_subscribe[PBS_MAXSVRJOBID+1];
 
     struct rq_rescq       rq_rescq;
 
     struct rq_runjob      rq_run;
+
+    struct rq_runjobs     rq_runjobs;
     tlist_head            rq_select; /* svrattrlist */
     int                   rq_shutdown;
 
@@ -455,6 +492,8 @@ extern int decode_DIS_Manage (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_MoveJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_MessageJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_QueueJob (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_SubmitJob (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_SubmitMany (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Register (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ReturnFiles (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ReqExtend (struct tcp_chan *chan, struct batch_request *);
@@ -462,6 +501,7 @@ extern int decode_DIS_ReqHdr (struct tcp_chan *chan, struct batch_request *, int
 extern int decode_DIS_Rescl (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Rescq (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_RunJob (struct tcp_chan *chan, struct batch_request *);
+extern int decode_DIS_RunJobs (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_ShutDown (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_SignalJob (struct tcp_chan *chan, struct batch_request *);
 extern int decode_DIS_Status (struct tcp_chan *chan, struct batch_request *);
@@ -477,6 +517,8 @@ extern int encode_DIS_Register (struct tcp_chan *chan, struct batch_request *);
 extern int encode_DIS_ReturnFiles (struct tcp_chan *chan, struct batch_request *);
 extern int encode_DIS_TrackJob (struct tcp_chan *chan, struct batch_request *);
 extern int encode_DIS_reply (struct tcp_chan *chan, struct batch_reply *);
+extern int encode_DIS_status_stream (struct tcp_chan *chan, tlist_head *);
+extern int encode_DIS_status_stream_end (struct tcp_chan *chan, int code, int auxcode);
 extern int encode_DIS_svrattrl (struct tcp_chan *chan, svrattrl *);
 
 extern int dis_request_read (struct tcp_chan *chan, struct batch_request *);
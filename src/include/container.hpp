@@ -124,6 +124,22 @@ class item_container
       if (endHit)
         return(NULL);
 
+      if (snapshot != NULL)
+        {
+        const std::string *id;
+
+        while ((id = get_next_id()) != NULL)
+          {
+          T pT = pContainer->find(*id);
+
+          if (pT != NULL)
+            return(pT);
+          }
+
+        endHit = true;
+        return(NULL);
+        }
+
       if (iter == ALWAYS_EMPTY_INDEX)
         {
         endHit = true;
@@ -169,6 +185,59 @@ class item_container
       pContainer->initialize_ra_iterator(&iter);
       reversed = reverse;
       endHit = false;
+      snapshot = NULL;
+      snapshot_pos = 0;
+      }
+
+    /*
+     * a snapshot iterator owns a copy of the ids that were in the container
+     * when it was created. Walking it never touches the container, so long
+     * scans don't hold the container's lock while others insert and remove.
+     */
+    item_iterator(item_container<T> *pCtner,
+#ifdef CHECK_LOCKING
+        bool *locked,
+#endif
+        std::vector<std::string> *ids)
+      {
+#ifdef CHECK_LOCKING
+      pLocked = locked;
+#endif
+      pContainer = pCtner;
+      iter = ALWAYS_EMPTY_INDEX;
+      reversed = false;
+      endHit = false;
+      snapshot = ids;
+      snapshot_pos = 0;
+      }
+
+    ~item_iterator()
+      {
+      delete snapshot;
+      }
+
+    bool is_snapshot() const
+      {
+      return(snapshot != NULL);
+      }
+
+    item_container<T> *get_container()
+      {
+      return(pContainer);
+      }
+
+    /*
+     * returns the next id of a snapshot iterator, or NULL at the end.
+     * The caller looks the id up however it likes.
+     */
+    const std::string *get_next_id()
+      {
+      if ((snapshot == NULL) ||
+          (exit_called) ||
+          (snapshot_pos >= snapshot->size()))
+        return(NULL);
+
+      return(&(*snapshot)[snapshot_pos++]);
       }
     void reset(void) //Reset the iterator;
       {
@@ -185,12 +254,15 @@ class item_container
       iter = -1;
       pContainer->initialize_ra_iterator(&iter);
       endHit = false;
+      snapshot_pos = 0;
       }
   private:
     item_container<T> *pContainer;
     int iter;
     bool endHit;
     bool reversed;
+    std::vector<std::string> *snapshot;
+    size_t snapshot_pos;
 #ifdef CHECK_LOCKING
     bool *pLocked;
 #endif
@@ -386,12 +458,14 @@ class item_container
     if (exit_called)
       return  empty_val();
 
-    int index = map[id];
-    if (index == ALWAYS_EMPTY_INDEX)
+    // don't use map[id] here, it would add an entry for every missing id
+    typename boost::unordered_map<std::string, int>::iterator it = map.find(id);
+    if ((it == map.end()) ||
+        (it->second == ALWAYS_EMPTY_INDEX))
       {
       return empty_val();
       }
-    item<T> *pItem = slots[index].pItem;
+    item<T> *pItem = slots[it->second].pItem;
     if (pItem == NULL)
       {
       return empty_val();
@@ -483,6 +557,37 @@ class item_container
 
 
 
+  /*
+   * copies the ids, in order, into a new snapshot iterator.
+   * The container must be locked only while this is called.
+   */
+  item_iterator *get_snapshot_iterator()
+    {
+    CHECK_LOCK
+
+    if (exit_called)
+      return(NULL);
+
+    std::vector<std::string> *ids = new std::vector<std::string>();
+    int                       i = slots[ALWAYS_EMPTY_INDEX].next;
+
+    ids->reserve(num);
+
+    while (i != ALWAYS_EMPTY_INDEX)
+      {
+      ids->push_back(slots[i].pItem->id);
+      i = slots[i].next;
+      }
+
+    return new item_iterator(this,
+#ifdef CHECK_LOCKING
+        &locked,
+#endif
+        ids);
+    }
+
+
+
   void clear()
     {
     CHECK_LOCK
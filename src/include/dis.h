@@ -258,8 +258,13 @@ extern const char *dis_emsg[];
 /* the following routines set/control DIS over tcp */
 
 extern struct tcp_chan * DIS_tcp_setup (int fd);
+extern struct tcp_chan * DIS_buf_setup (void);
+extern char *DIS_buf_data(struct tcp_chan *chan, size_t *len);
+extern size_t DIS_tcp_wpending(struct tcp_chan *chan);
 extern int  DIS_tcp_wflush (struct tcp_chan *chan);
 extern void DIS_tcp_settimeout (long timeout);
+extern void DIS_tcp_set_encoding(int fd, int encoding);
+extern int  DIS_tcp_get_encoding(int fd);
 extern void DIS_tcp_cleanup(struct tcp_chan *chan);
 extern void DIS_tcp_close(struct tcp_chan *chan);
 
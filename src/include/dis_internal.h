@@ -121,6 +121,8 @@ int diswl_(struct tcp_chan *chan, dis_long_double_t value, unsigned ndigs);
 int diswsl(struct tcp_chan *chan, long value);
 /* int diswui(struct tcp_chan *chan, unsigned value); */
 int diswui_(struct tcp_chan *chan, unsigned value);
+int diswvi_(struct tcp_chan *chan, int negate, unsigned long value);
+int disrvi_(struct tcp_chan *chan, int *negate, unsigned long *value, unsigned int timeout);
 int diswul(struct tcp_chan *chan, unsigned long value);
 
 extern unsigned dis_dmx10;
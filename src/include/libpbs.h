@@ -110,9 +110,18 @@
 
 #define PBS_BATCH_PROT_TYPE 2
 #define PBS_BATCH_PROT_VER 2
+#define PBS_BATCH_PROT_VER_BINARY 3 /* the rest of the message is DIS_ENCODING_BINARY */
+
+/* flags carried by the marker ahead of a request's extension string,
+ * see encode_DIS_ReqExtend_flags() */
+#define REQ_EXTEND_STRING  0x1  /* the string is the caller's extension */
+#define REQ_EXTEND_STREAM  0x2  /* the client takes a streamed status reply */
+#define REQ_EXTEND_BINARY  0x4  /* the client takes a binary encoded reply */
 /* #define PBS_REQUEST_MAGIC (56) */
 /* #define PBS_REPLY_MAGIC   (57) */
 #define SCRIPT_CHUNK_Z (65536)
+#define SUBMIT_MANY_MAX (256) /* most jobs in one Submit Many request */
+#define RUN_JOBS_MAX (256) /* most jobs in one Run Jobs request */
 #ifndef TRUE
 #define TRUE 1
 #define FALSE 0
@@ -155,6 +164,8 @@ extern char pbs_current_group[];
 
 const char PBS_MSG_EQUAL[] = "MSG=";
 
+struct pbs_session;
+
 struct connect_handle
   {
   int ch_inuse; /* 1 if in use, 0 otherwise  */
@@ -163,6 +174,7 @@ struct connect_handle
   int ch_errno; /* last error on this connection */
   char *ch_errtxt; /* pointer to last server error text */
   pthread_mutex_t *ch_mutex;
+  struct pbs_session *ch_session; /* set by pbs_session_open() */
   };
 
 extern struct connect_handle connection[];
@@ -182,6 +194,8 @@ struct brp_status    /* reply to Status Job/Queue/Server Request */
   int   brp_objtype;
   char   brp_objname[(PBS_MAXSVRJOBID > PBS_MAXDEST ? PBS_MAXSVRJOBID:PBS_MAXDEST)+1];
   tlist_head brp_attr;  /* head of svrattrlist */
+  char      *brp_encoded; /* if set, the attribute list already DIS encoded */
+  size_t     brp_encoded_len;
   };
 
 struct brp_cmdstat
@@ -216,6 +230,8 @@ struct brp_rescq              /* reply to Resource Query Request */
 #define BATCH_REPLY_CHOICE_Text      7  /* text,   see brp_txt   */
 #define BATCH_REPLY_CHOICE_Locate    8  /* locate, see brp_locate */
 #define BATCH_REPLY_CHOICE_RescQuery 9  /* Resource Query         */
+#define BATCH_REPLY_CHOICE_StatusStream 10 /* status records follow the reply */
+#define BATCH_REPLY_CHOICE_EventStream  11 /* job events follow the reply */
 
 struct batch_reply
   {
@@ -308,8 +324,19 @@ PBSD_jobfile (int connect, int req_type, char *path, char *jobid, enum job_file
 int
 PBSD_status_put (int c, int func, char *id, struct attrl *attrib, char *extend);
 
+int
+PBSD_status_put_flags (int c, int func, char *id, struct attrl *attrib, char *extend, int ext_flags);
+
 struct batch_reply *PBSD_rdrpy(int *local_errno, int connect);
 
+struct batch_reply *PBSD_rdrpy_stream(int *local_errno, int connect, struct tcp_chan **stream);
+
+int PBSD_session_tag(int sock, unsigned int *tag);
+
+struct batch_reply *PBSD_session_rdrpy(int *local_errno, int connect);
+
+void PBSD_session_free(struct pbs_session *ps);
+
 void PBSD_FreeReply (struct batch_reply *);
 
 struct batch_status *PBSD_status(int c, int function, int *, char *id, struct attrl *attrib, char *extend);
@@ -318,25 +345,33 @@ struct batch_status *PBSD_status_get(int *local_errno, int c);
 
 char *PBSD_queuejob (int c, int *, char *j, char *d, struct attropl *a, char *ex);
 int PBSD_QueueJob_hash(int c, char *j, char *d, job_data_container *ja, job_data_container *ra, char *ex, char **job_id, char **msg);
+int PBSD_SubmitJob_hash(int c, char *d, job_data_container *ja, job_data_container *ra, char *script, size_t script_len, char *ex, char **job_id, char **msg);
+int PBSD_SubmitMany_hash(int c, int count, char **d, job_data_container **ja, job_data_container **ra, char **scripts, size_t *script_lens, char *ex, char **results);
 
 
+extern int decode_DIS_JobEvent (struct tcp_chan *chan, struct pbs_job_event *event);
 extern int decode_DIS_JobId (struct tcp_chan *chan, char *jobid);
 extern int decode_DIS_replyCmd (struct tcp_chan *chan, struct batch_reply *);
 
 extern int encode_DIS_GpuCtrl (struct tcp_chan *chan, char *node, char *gpuid, int gpumode, int reset_perm, int reset_vol);
 extern int encode_DIS_JobCred (struct tcp_chan *chan, int type, char *cred, int len);
 extern int encode_DIS_JobFile (struct tcp_chan *chan, int, char *, int, char *, int);
+extern int encode_DIS_JobEvent (struct tcp_chan *chan, const char *job_id, char state, int exit_status, int flags);
 extern int encode_DIS_JobId (struct tcp_chan *chan, char *);
 extern int encode_DIS_Manage (struct tcp_chan *chan, int cmd, int objt, char *, struct attropl *);
 extern int encode_DIS_MoveJob (struct tcp_chan *chan, char *jid, char *dest);
 extern int encode_DIS_MessageJob (struct tcp_chan *chan, char *jid, int fopt, char *m);
 extern int encode_DIS_QueueJob (struct tcp_chan *chan, char *jid, char *dest, struct attropl *);
 int encode_DIS_QueueJob_hash(struct tcp_chan *chan, char *jid, char *destin, job_data_container *job_attr, job_data_container *res_attr);
+int encode_DIS_SubmitJob_hash(struct tcp_chan *chan, char *jid, char *destin, job_data_container *job_attr, job_data_container *res_attr, char *script, size_t script_len);
+int encode_DIS_SubmitMany_hash(struct tcp_chan *chan, int count, char **destins, job_data_container **job_attrs, job_data_container **res_attrs, char **scripts, size_t *script_lens);
 extern int encode_DIS_ReqExtend (struct tcp_chan *chan, char *extend);
+extern int encode_DIS_ReqExtend_flags (struct tcp_chan *chan, char *extend, int flags);
 extern int encode_DIS_PowerState (struct tcp_chan *chan, unsigned short power_state);
 extern int encode_DIS_ReqHdr (struct tcp_chan *chan, int reqt, char *user);
 extern int encode_DIS_Rescq (struct tcp_chan *chan, char **rlist, int num);
 extern int encode_DIS_RunJob (struct tcp_chan *chan, char *jid, char *where, unsigned int resch);
+extern int encode_DIS_RunJobs (struct tcp_chan *chan, int count, char **jids, char **wheres);
 extern int encode_DIS_ShutDown (struct tcp_chan *chan, int manner);
 extern int encode_DIS_SignalJob (struct tcp_chan *chan, char *jid, char *sig);
 extern int encode_DIS_Status (struct tcp_chan *chan, char *objid, struct attrl *);
@@ -115,6 +115,7 @@ extern char            *auto_ideal_load;
 extern char            *auto_max_load;
 extern int              exec_with_exec;
 extern int              ServerStatUpdateInterval;
+extern int              status_delta_refresh;
 extern char            *AllocParCmd;
 extern char             PBSNodeCheckPath[];
 extern int              PBSNodeCheckProlog;
@@ -183,6 +184,7 @@ extern struct specials  special[];
 extern struct config    common_config[];
 
 unsigned long setstatusupdatetime(const char *value);
+unsigned long setstatusdeltarefresh(const char *value);
 unsigned long setcheckpolltime(const char *value);
 unsigned long jobstartblocktime(const char *value);
 unsigned long setloglevel(const char *value);
@@ -0,0 +1,139 @@
+#ifndef MOM_CONNECTION_POOL_HPP
+#define MOM_CONNECTION_POOL_HPP
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include <map>
+#include <vector>
+#include <time.h>
+#include <pthread.h>
+
+#include "net_connect.h" /* pbs_net_t */
+#include "work_task.h" /* work_task */
+
+/* idle connections kept open to each mom */
+#define MOM_POOL_MAX_IDLE      8
+/* seconds an idle connection is kept, well under the mom's own timeout */
+#define MOM_POOL_IDLE_TIMEOUT  60
+/* how often idle connections are looked for */
+#define MOM_POOL_CHECK_RATE    30
+
+class idle_mom_connection
+  {
+  public:
+  int    handle;
+  time_t last_used;
+  };
+
+/*
+ * mom_connection_pool keeps connections to the moms open after a request so
+ * the next request to the same mom doesn't have to connect again. A caller
+ * takes a connection with get(), has it to itself while the request and
+ * reply go over it, and hands it back with release(). Several requests to a
+ * mom can be outstanding at once, each on its own connection, and up to
+ * max_idle of them are kept once they are done.
+ *
+ * The pooled connections aren't watched by wait_request(), so a connection
+ * is checked before it is handed out again, and connections nobody used for
+ * idle_timeout seconds are closed.
+ */
+
+class mom_connection_pool
+  {
+    pthread_mutex_t                                           mutex;
+    unsigned int                                              max_idle;
+    time_t                                                    idle_timeout;
+    std::map<unsigned long long, std::vector<idle_mom_connection> > idle;
+
+    unsigned long long key(pbs_net_t addr, unsigned short port);
+
+  public:
+    mom_connection_pool(unsigned int max_idle, time_t idle_timeout);
+    ~mom_connection_pool();
+    int    get(pbs_net_t addr, unsigned short port, int *my_err, bool *reused);
+    void   release(pbs_net_t addr, unsigned short port, int handle, bool usable);
+    void   close_idle(time_t now);
+    size_t idle_count();
+  };
+
+extern mom_connection_pool mom_connections;
+
+void check_mom_connections(struct work_task *ptask);
+
+#endif // MOM_CONNECTION_POOL_HPP
@@ -222,6 +222,8 @@ char * netaddr_pbs_net_t(pbs_net_t);
 int socket_to_handle(int sock, int *local_errno);
 
 
+struct client_session;
+
 struct connection
   {
   pbs_net_t cn_addr; /* internet address of client */
@@ -235,6 +237,7 @@ struct connection
   void (*cn_oncl)(int);  /* func to call on close */
   pthread_mutex_t *cn_mutex;
   int cn_stay_open; /* Set to TRUE when the connection needs to remain open */
+  struct client_session *cn_session; /* set by an OpenSession request */
   };
 
 struct netcounter
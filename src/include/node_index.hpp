@@ -0,0 +1,142 @@
+#ifndef NODE_INDEX_HPP
+#define NODE_INDEX_HPP
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <pthread.h>
+#include <boost/unordered_map.hpp>
+#include <boost/dynamic_bitset.hpp>
+
+/* bucket b > 0 holds nodes with 2^(b-1) to 2^b - 1 free slots, bucket 0 the full ones */
+#define NODE_INDEX_BUCKETS 16
+
+/*
+ * one req of a node spec as the index sees it: the properties a node must
+ * have and the execution slots it must have free
+ */
+
+class node_index_req
+  {
+  public:
+  std::vector<std::string> props;
+  int                      slots;
+  };
+
+/*
+ * node_index keeps, for every node, which properties it has, how many
+ * execution slots it has free and whether its state lets it take a job. Each
+ * of these is a bitset over the nodes, in the order they were added, so the
+ * nodes that might fit a node spec are found with a few bitwise ANDs instead
+ * of locking and checking every node.
+ *
+ * The index is only a hint: the candidates it returns still have to be
+ * checked under the node's lock, and callers fall back to walking every node
+ * when the candidates don't satisfy a request.
+ */
+
+class node_index
+  {
+    pthread_mutex_t                                 mutex;
+    boost::unordered_map<std::string, size_t>       positions;    /* node name -> bit */
+    std::vector<std::string>                        names;        /* bit -> node name */
+    std::map<std::string, boost::dynamic_bitset<> > prop_nodes;   /* nodes with each property */
+    boost::dynamic_bitset<>                         available;    /* nodes free to take a job */
+    boost::dynamic_bitset<>                         buckets[NODE_INDEX_BUCKETS];
+    boost::dynamic_bitset<>                         opaque;       /* nodes the index can't describe */
+
+    size_t get_position(const std::string &name);
+    void   clear_position(size_t pos);
+
+  public:
+    node_index();
+    ~node_index();
+    void   update(const std::string &name, const std::vector<std::string> &props,
+                  int free_slots, bool is_available, bool is_opaque);
+    void   remove(const std::string &name);
+    bool   get_candidates(const std::vector<node_index_req> &reqs,
+                          std::vector<std::string> &candidates);
+    size_t count();
+  };
+
+extern node_index allnodes_index;
+
+#endif // NODE_INDEX_HPP
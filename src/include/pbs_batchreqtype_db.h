@@ -83,5 +83,10 @@ PbsBatchReqType(PBS_BATCH_DeleteReservation,    "DeleteAlpsReservation")
 PbsBatchReqType(PBS_BATCH_SelStatAttr,          "SelStatAttr")
 PbsBatchReqType(PBS_BATCH_ChangePowerState,     "ChangePowerState")
 PbsBatchReqType(PBS_BATCH_ModifyNode,           "ModifyNode")
+PbsBatchReqType(PBS_BATCH_SubmitJob,            "SubmitJob")
+PbsBatchReqType(PBS_BATCH_SubmitMany,           "SubmitMany")
+PbsBatchReqType(PBS_BATCH_SubscribeJobs,        "SubscribeJobs")
+PbsBatchReqType(PBS_BATCH_OpenSession,          "OpenSession")
+PbsBatchReqType(PBS_BATCH_RunJobs,              "RunJobs")
 #endif
 #endif /* _PBS_BATCHREQTYPE_DB_H */
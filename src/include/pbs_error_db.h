@@ -291,6 +291,8 @@ PbsErrClient(PBSE_INDICES_EMPTY, (char *)"The cpuset or memset indices are not s
 PbsErrClient(PBSE_EMPTY, (char *)"The container is empty")
 PbsErrClient(PBSE_MINLIMIT, (char *)"Request doesn't meet minimum limit")
 PbsErrClient(PBSE_CANT_EDIT_NODES, (char *)"With dont_write_nodes_file set you can't edit nodes via qmgr.")
+PbsErrClient(PBSE_CONN_HANDED_OFF, (char *)"The connection was handed off to the job event stream")
+PbsErrClient(PBSE_CHANGES_EXPIRED, (char *)"Changes since the requested sequence are no longer known, request the full status")
 
 /* pbs client errors ceiling (max_client_err + 1) */
 PbsErrClient(PBSE_CEILING,           (char*)0)
@@ -146,6 +146,8 @@
 #define ATTR_exechost   "exec_host"
 #define ATTR_execport	"exec_port"
 #define ATTR_mtime      "mtime"
+#define ATTR_change_seq "change_seq"
+#define ATTR_deleted    "deleted"
 #define ATTR_qtime      "qtime"
 #define ATTR_session    "session_id"
 #define ATTR_euser      "euser"
@@ -174,6 +176,7 @@
 #define ATTR_submit_args "submit_args"
 #define ATTR_tokens     "tokens"
 #define ATTR_netcounter "net_counter"
+#define ATTR_timerlateness "timer_lateness"
 #define ATTR_umask      "umask"
 #define ATTR_start_time "start_time"
 #define ATTR_start_count "start_count"
@@ -384,10 +387,14 @@
 #define ATTR_timeoutforjobdelete       "timeout_for_job_delete"
 #define ATTR_timeoutforjobrequeue      "timeout_for_job_requeue"
 #define ATTR_dontwritenodesfile        "dont_write_nodes_file"
+#define ATTR_idleslotlimit             "idle_slot_limit"
 
 /* notification email formating */
 #define ATTR_mailsubjectfmt "mail_subject_fmt"
 #define ATTR_mailbodyfmt    "mail_body_fmt"
+#define ATTR_mailcoalescewindow "mail_coalesce_window"
+#define ATTR_mailsmtpserver "mail_smtp_server"
+#define ATTR_mailqueuestats "mail_queue_stats"
 
 
 /* various attribute values */
@@ -407,6 +414,7 @@
 #define DELASYNC     "delasync"   /* see req_delete.c */
 #define PURGECOMP    "purgecomplete="   /* see req_delete.c */
 #define EXECQUEONLY  "exec_queue_only"   /* see req_stat.c */
+#define CHANGEDSINCE "changed_since="   /* see req_stat.c */
 #define RERUNFORCE   "force"
 
 #define USER_HOLD   "u"
@@ -619,6 +627,19 @@ struct batch_status
   char                *text;
   };
 
+/* a job state change pushed to a connection after pbs_subscribe() */
+
+#define PBS_EVENT_EXIT_STATUS 0x1 /* exit_status is set */
+#define PBS_EVENT_PURGED      0x2 /* the server no longer knows the job */
+
+struct pbs_job_event
+  {
+  char job_id[PBS_MAXSVRJOBID + 1];
+  char state;        /* job_state letter, as qstat shows it */
+  int  exit_status;
+  int  flags;        /* PBS_EVENT_* */
+  };
+
 
 
 
@@ -674,6 +695,8 @@ int pbs_rlsjob(int connect, char *job_id, char *hold_type, char *extend);
 
 int pbs_runjob(int connect, char *jobid, char *loc, char *extend);
 
+int pbs_runjobs(int connect, int count, char **jobids, char **locs, char *extend, int *return_codes);
+
 char **pbs_selectjob(int connect, struct attropl *select_list, char *extend);
 
 int pbs_sigjob(int connect, char *job_id, char *signal, char *extend);
@@ -692,6 +715,14 @@ struct batch_status *pbs_statserver(int connect, struct attrl *attrib, char *ext
 
 struct batch_status *pbs_statnode(int connect, char *id, struct attrl *attrib, char *extend);
 
+int pbs_session_open(char *server);
+
+int pbs_session_close(int connect);
+
+int pbs_subscribe(int connect, char *job_id, char *extend);
+
+int pbs_next_event(int connect, struct pbs_job_event *event, int timeout);
+
 char *pbs_submit(int connect, struct attropl *attrib, char *script, char *destination, char *extend);
 
 int pbs_submit_hash_ext(int connect, void *job_attr, void *res_attr, char *script, char *destination, char *extend, char **job_id, char **msg);
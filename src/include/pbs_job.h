@@ -586,6 +586,23 @@ struct jobfix
     } ji_un;
   };
 
+#ifndef PBS_MOM
+/*
+ * The attribute list of a job as last encoded for a status reply. It is
+ * only kept for jobs that are not running and is dropped whenever the job
+ * is saved, see status_job() and job_stat_cache_invalidate().
+ */
+
+typedef struct job_stat_cache
+  {
+  int     jsc_key;      /* requester privilege, owner and condensed flags */
+  int     jsc_state;    /* job state and substate it was built in */
+  int     jsc_substate;
+  size_t  jsc_len;
+  char   *jsc_data;     /* DIS encoded svrattrl list */
+  } job_stat_cache;
+#endif /* PBS_MOM */
+
 /**
  * THE JOB
  *
@@ -701,6 +718,8 @@ struct job
   // the queue count and the server count
   unsigned          ji_queue_counted;
   bool              ji_being_deleted;
+  job_stat_cache   *ji_stat_cache;    /* encoded status, NULL if none */
+  long long         ji_change_seq;    /* server change sequence of the last change */
 #endif/* PBS_MOM */   /* END SERVER ONLY */
   int               ji_commit_done;   /* req_commit has completed. If in routing queue job can now be routed */
 
@@ -999,6 +1018,7 @@ typedef struct send_job_request
 #define JOB_FILE_COPY           ".JC"    /* tmp copy while updating */
 #define JOB_FILE_SUFFIX         ".JB"    /* job control file */
 #define JOB_FILE_BACKUP         ".BK"    /* job file backup */
+#define JOB_FILE_JOURNAL        ".JL"    /* job changes since the last .JB */
 #define JOB_SCRIPT_SUFFIX       ".SC"    /* job script file  */
 #define JOB_STDOUT_SUFFIX       ".OU"    /* job standard out */
 #define JOB_STDERR_SUFFIX       ".ER"    /* job standard error */
@@ -1133,6 +1153,7 @@ job         *job_clone(job *,struct job_array *, int);
 job         *svr_find_job(const char *jobid, int get_subjob);
 job         *svr_find_job_by_id(int internal_job_id);
 job         *find_job_by_array(all_jobs *aj, const char *job_id, int get_subjob, bool locked);
+void         job_stat_cache_invalidate(job *);
 #else
 extern job  *mom_find_job(const char *);
 #endif
@@ -111,6 +111,8 @@
 #define END_GPU_STATUS         "</gpu_status>"
 #define START_MIC_STATUS       "<mic_status>"
 #define END_MIC_STATUS         "</mic_status>"
+#define STATUS_DELTA_KEYWORD   "status_delta=true" /* only changed status strings follow */
+#define STATUS_UNSET_KEYWORD   "status_unset="     /* a status key the mom stopped reporting */
 
 #ifdef NUMA_SUPPORT
 #  define MAX_NODE_BOARDS      2048
@@ -268,6 +270,7 @@ typedef struct nodeboard_t
 
 
 #define SEND_HELLO 11
+#define SEND_FULL_STATUS 12
 
 /* container for holding communication information */
 class received_node
@@ -311,6 +314,7 @@ struct pbsnode
   short                         nd_order;            /* order of user's request */
   time_t                        nd_warnbad;
   time_t                        nd_lastupdate;       /* time of last update. */
+  long long                     nd_change_seq;       /* server change sequence of the last change */
   time_t                        nd_lastHierarchySent; /* last time the hierarchy was sent to this node. */
   unsigned short                nd_hierarchy_level;
   unsigned char                 nd_in_hierarchy;     /* set to TRUE if in the hierarchy file */
@@ -385,6 +389,8 @@ int             remove_node(all_nodes *,struct pbsnode *);
 struct pbsnode *next_node(all_nodes *,struct pbsnode *,node_iterator *);
 struct pbsnode *next_host(all_nodes *,all_nodes_iterator **,struct pbsnode *);
 int             copy_properties(struct pbsnode *dest, struct pbsnode *src);
+void            update_node_index(struct pbsnode *);
+void            node_changed(struct pbsnode *);
 
 
 #if 0
@@ -192,3 +192,6 @@ ATTR_exitcodecanceledjob,
 ATTR_timeoutforjobdelete,
 ATTR_timeoutforjobrequeue,
 ATTR_dontwritenodesfile,
+ATTR_idleslotlimit,
+ATTR_mailcoalescewindow,
+ATTR_mailsmtpserver,
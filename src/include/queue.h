@@ -207,6 +207,7 @@ typedef struct pbs_queue
   int              qu_numjobs;  /* current numb jobs in queue */
   int              qu_njstate[PBS_NUMJOBSTATE]; /* # of jobs per state */
   char             qu_jobstbuf[100];
+  long long        qu_change_seq; /* server change sequence of the last change */
 
   /* the queue attributes */
 
@@ -218,6 +218,11 @@ enum srv_atr
   SRV_ATR_TimeoutForJobDelete,
   SRV_ATR_TimeoutForJobRequeue,
   SRV_ATR_DontWriteNodesFile,
+  SRV_ATR_TimerLateness,
+  SRV_ATR_IdleSlotLimit,
+  SRV_ATR_MailCoalesceWindow,
+  SRV_ATR_MailSmtpServer,
+  SRV_ATR_MailQueueStats,
 
   /* This must be last */
   SRV_ATR_LAST
@@ -84,6 +84,7 @@ struct stat_cntl    /* used in req_stat_job */
   int        sc_XXXY;
   int        sc_conn;
   bool       sc_condensed;
+  long long  sc_changed_since;  /* only jobs changed after this, -1 for all */
   pbs_queue      *sc_pque;
 
   struct batch_request *sc_origrq;
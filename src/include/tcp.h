@@ -5,6 +5,15 @@
 #include <stddef.h>
 #include <time.h>
 
+/* a filled write buffer waiting on DIS_tcp_wflush() */
+struct tcpdisseg
+  {
+  struct tcpdisseg *next;
+  char             *data;
+  size_t            size;   /* allocated size of data */
+  size_t            len;    /* committed bytes in data */
+  };
+
 struct tcpdisbuf
   {
   unsigned long tdis_bufsize;
@@ -12,8 +21,17 @@ struct tcpdisbuf
   char *tdis_trailp;
   char *tdis_eod;
   char  *tdis_thebuf;
+
+  /* write buffer only: full segments sent ahead of tdis_thebuf */
+  struct tcpdisseg *tdis_segs;
+  struct tcpdisseg *tdis_lastseg;
+  size_t            tdis_seglen; /* committed bytes held in tdis_segs */
   };
 
+/* how the DIS integers and string counts on a channel are written */
+#define DIS_ENCODING_CLASSIC 0 /* recursive decimal strings */
+#define DIS_ENCODING_BINARY  1 /* sign and magnitude varints */
+
 struct tcp_chan
   {
 
@@ -25,6 +43,7 @@ struct tcp_chan
   int              ReadErrno;
   int              SelectErrno;
   int              sock;
+  int              encoding;   /* DIS_ENCODING_* */
   };
 
 
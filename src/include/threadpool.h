@@ -87,10 +87,15 @@
 
 
 #include <pthread.h>
+#include <time.h>
 
 
 #define POOL_DESTROY 0x1
 
+/* number of work queues per pool. Submitters spread work across them and
+ * idle workers steal from the others, so tp_mutex stays off the hot path */
+#define TP_QUEUES    8
+
 
 
 typedef struct tp_work tp_work_t;
@@ -99,6 +104,7 @@ struct tp_work
   tp_work_t *next;
   void      *(*work_func)(void *); /* function to call */
   void      *work_arg; /* argument */
+  struct timespec queued_at; /* when the work was enqueued */
   };
 
 
@@ -109,6 +115,32 @@ struct tp_working
   {
   tp_working_t *next;
   pthread_t     working_id; /* id of thread currently working */
+  volatile int  busy;       /* TRUE while the thread runs a work function */
+  };
+
+
+
+
+typedef struct tp_queue tp_queue_t;
+struct tp_queue
+  {
+  pthread_mutex_t  q_mutex;
+  tp_work_t       *q_first; /* first in queue */
+  tp_work_t       *q_last;  /* last in queue */
+  };
+
+
+
+
+/* counters reported by get_threadpool_stats() */
+typedef struct tp_stats tp_stats_t;
+struct tp_stats
+  {
+  long               queue_depth;      /* work waiting for a thread */
+  unsigned long      completed;        /* work items handed to a thread */
+  unsigned long      stolen;           /* items taken from another thread's queue */
+  unsigned long long total_wait_usecs; /* summed time items spent queued */
+  unsigned long long max_wait_usecs;   /* longest time an item spent queued */
   };
 
 
@@ -120,9 +152,12 @@ struct threadpool
   pthread_mutex_t  tp_mutex;
   pthread_cond_t   tp_waiting_work; /* what waiting threads pend on */
   pthread_cond_t   tp_can_destroy; /* thread pool is ready to be deleted */
-  tp_working_t    *tp_active;  /* list of currently working threads */
-  tp_work_t       *tp_first; /* first in queue */
-  tp_work_t       *tp_last;  /* last in queue */
+  tp_working_t    *tp_active;  /* list of worker threads */
+  tp_queue_t       tp_queues[TP_QUEUES]; /* pending work */
+  volatile long    tp_pending; /* number of queued work items */
+  unsigned int     tp_next_queue; /* round robin index for outside submitters */
+  unsigned int     tp_next_home; /* home queue for the next worker thread */
+  tp_stats_t       tp_stats; /* updated atomically by the workers */
   pthread_attr_t   tp_attr; /* attributes for workers */
   int              tp_nthreads; /* number of threads */
   int              tp_min_threads; /* minimum number of threads */
@@ -145,6 +180,7 @@ int  initialize_threadpool(threadpool_t **,int,int,int);
 void destroy_request_pool(threadpool_t *tp);
 void start_request_pool(threadpool_t *tp);
 bool threadpool_is_too_busy(threadpool_t *tp, int permissions);
+void get_threadpool_stats(threadpool_t *tp, tp_stats_t *stats);
 
 
 #endif /* ndef THREADPOOL_H */ 
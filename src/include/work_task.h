@@ -99,6 +99,7 @@
 #include <list>
 #include <vector>
 #include <stdlib.h>
+#include <time.h>
 
 #define INITIAL_ALL_TASKS_SIZE 4
 
@@ -129,10 +130,50 @@ int task_is_in_threadpool(struct work_task *ptask);
 
 typedef struct timed_task
   {
-  work_task *wt;
-  long       task_time;
+  work_task     *wt;
+  long           task_time;
+  unsigned long  seq;       /* tasks due at the same time run in the order set */
   } timed_task;
 
+/* seconds of dispatches timed_task_heap remembers the worst lateness for */
+#define TIMER_LATENESS_WINDOW 60
+
+/*
+ * timed_task_heap holds the WORK_Timed tasks in a binary min-heap ordered by
+ * the time they are due. Each task records where it is in the heap, so a
+ * task is added or taken out in O(log n) while holding the mutex, instead of
+ * walking every pending task.
+ *
+ * It also keeps how late tasks were when they came due, which the server
+ * reports as its timer_lateness attribute.
+ */
+
+class timed_task_heap
+  {
+    pthread_mutex_t          mutex;
+    std::vector<timed_task>  heap;
+    unsigned long            next_seq;
+    time_t                   late_times[TIMER_LATENESS_WINDOW];
+    long                     late_max[TIMER_LATENESS_WINDOW];
+    unsigned long            late_count;   /* dispatched more than a second late */
+
+    bool before(const timed_task &a, const timed_task &b);
+    void place(size_t pos, const timed_task &tt);
+    void sift_up(size_t pos);
+    void sift_down(size_t pos);
+    void take(size_t pos);
+    void record_lateness(time_t time_now, long lateness);
+
+  public:
+    timed_task_heap();
+    ~timed_task_heap();
+    void       insert(work_task *wt);
+    bool       remove(work_task *wt);
+    work_task *pop(time_t time_now);
+    size_t     size();
+    void       get_lateness(time_t time_now, long lateness[3]);
+  };
+
 class all_tasks
   {
 public:
@@ -165,6 +206,7 @@ typedef struct work_task
   void (*wt_parmfunc)  (struct work_task *);
   /* used in reissue_to_svr to store wt_func */
   int                  wt_aux; /* optional info: e.g. child status */
+  size_t               wt_heap_pos; /* 1 + index in the timed task heap, 0 if not in it */
   } work_task;
 
 int        insert_task(all_tasks *, work_task *);
@@ -172,7 +214,8 @@ int        remove_task(all_tasks *,work_task *);
 int        has_task(all_tasks *);
 int        dispatch_timed_task(work_task *);
 work_task *pop_timed_task(time_t time_now);
-int        insert_timed_task(all_tasks *, time_t task_time, work_task *);
+void       insert_timed_task(work_task *);
+void       get_timer_lateness(long lateness[3]);
 
 
 
@@ -84,6 +84,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include "pbs_ifl.h"
 #include "log.h"
 #include "list_link.h"
@@ -723,19 +724,15 @@ resource_def *find_resc_def(
   int           limit) /* number of members in resource_def array */
 
   {
-  while (limit--)
-    {
-    if (!strcmp(rscdf->rs_name, name))
-      {
-      /* SUCCESS */
+  int index = find_def_index(rscdf, limit, sizeof(resource_def),
+                offsetof(resource_def, rs_name), false, name);
 
-      return(rscdf);
-      }
+  if (index < 0)
+    return(NULL);
 
-    rscdf++;
-    }
+  /* SUCCESS */
 
-  return(NULL);
+  return(rscdf + index);
   }  /* END find_resc_def() */
 
 
@@ -83,6 +83,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <pthread.h>
 #include "pbs_ifl.h"
 #include "list_link.h"
 #include "attribute.h"
@@ -93,6 +95,7 @@
  * Included are:
  * clear_attr()
  * find_attr()
+ * find_def_index()
  * free_null()
  * attrlist_alloc()
  * attrlist_create()
@@ -166,6 +169,286 @@ static int str_nc_cmp(
 
 
 
+/*
+ * Name lookups in the attribute and resource definition arrays go through
+ * an open addressed hash table per array. A table is built the first time
+ * its array is searched and is identified by the array address, its size
+ * and the addresses of its first and last names, so a different array
+ * reusing the same address gets a new table.
+ */
+
+#define MAX_DEF_HASHES 32
+
+typedef struct def_hash
+  {
+  const void *defs;
+  int         limit;
+  size_t      def_size;
+  bool        nocase;
+  const char *first_name;
+  const char *last_name;
+  unsigned    mask;    /* slot count - 1, the slot count is a power of 2 */
+  int        *slots;   /* definition index + 1, 0 if empty */
+  } def_hash;
+
+static def_hash         *def_hashes[MAX_DEF_HASHES];
+static pthread_rwlock_t  def_hash_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+
+
+static const char *def_name(
+
+  const void *defs,
+  size_t      def_size,
+  size_t      name_offset,
+  int         index)
+
+  {
+  return(*(const char **)((const char *)defs + (index * def_size) + name_offset));
+  } /* END def_name() */
+
+
+
+static unsigned def_name_hash(
+
+  const char *name,
+  bool        nocase)
+
+  {
+  unsigned hash = 2166136261U;
+
+  for (; *name != '\0'; name++)
+    {
+    hash ^= (unsigned char)(nocase ? tolower((int)*name) : *name);
+    hash *= 16777619U;
+    }
+
+  return(hash);
+  } /* END def_name_hash() */
+
+
+
+static int def_name_cmp(
+
+  const char *s1,
+  const char *s2,
+  bool        nocase)
+
+  {
+  if (nocase)
+    return(str_nc_cmp(s1, s2));
+
+  return(strcmp(s1, s2));
+  } /* END def_name_cmp() */
+
+
+
+static def_hash *build_def_hash(
+
+  const void *defs,
+  int         limit,
+  size_t      def_size,
+  size_t      name_offset,
+  bool        nocase)
+
+  {
+  def_hash *dh = (def_hash *)calloc(1, sizeof(def_hash));
+  unsigned  slot_count = 16;
+
+  if (dh == NULL)
+    return(NULL);
+
+  while (slot_count < (unsigned)limit * 2)
+    slot_count <<= 1;
+
+  if ((dh->slots = (int *)calloc(slot_count, sizeof(int))) == NULL)
+    {
+    free(dh);
+    return(NULL);
+    }
+
+  dh->defs = defs;
+  dh->limit = limit;
+  dh->def_size = def_size;
+  dh->nocase = nocase;
+  dh->first_name = def_name(defs, def_size, name_offset, 0);
+  dh->last_name = def_name(defs, def_size, name_offset, limit - 1);
+  dh->mask = slot_count - 1;
+
+  for (int index = 0; index < limit; index++)
+    {
+    const char *name = def_name(defs, def_size, name_offset, index);
+
+    if (name == NULL)
+      continue;
+
+    unsigned slot = def_name_hash(name, nocase) & dh->mask;
+
+    /* keep the first of any duplicate names, as the linear scan did */
+    while (dh->slots[slot] != 0)
+      {
+      if (!def_name_cmp(def_name(defs, def_size, name_offset, dh->slots[slot] - 1), name, nocase))
+        break;
+
+      slot = (slot + 1) & dh->mask;
+      }
+
+    if (dh->slots[slot] == 0)
+      dh->slots[slot] = index + 1;
+    }
+
+  return(dh);
+  } /* END build_def_hash() */
+
+
+
+static void free_def_hash(
+
+  def_hash *dh)
+
+  {
+  free(dh->slots);
+  free(dh);
+  } /* END free_def_hash() */
+
+
+
+/* the caller holds def_hash_lock, returns the slot in def_hashes or -1 */
+
+static int get_def_hash(
+
+  const void *defs,
+  int         limit,
+  size_t      def_size,
+  size_t      name_offset,
+  bool        nocase)
+
+  {
+  for (int i = 0; i < MAX_DEF_HASHES; i++)
+    {
+    def_hash *dh = def_hashes[i];
+
+    if ((dh != NULL) &&
+        (dh->defs == defs) &&
+        (dh->limit == limit) &&
+        (dh->def_size == def_size) &&
+        (dh->nocase == nocase) &&
+        (dh->first_name == def_name(defs, def_size, name_offset, 0)) &&
+        (dh->last_name == def_name(defs, def_size, name_offset, limit - 1)))
+      return(i);
+    }
+
+  return(-1);
+  } /* END get_def_hash() */
+
+
+
+/*
+ * find_def_index - find a definition by name in an array of attribute or
+ * resource definitions
+ *
+ * Returns: >= 0 index of the first definition with that name
+ *     -1 if there is none
+ */
+
+int find_def_index(
+
+  const void *defs,        /* I array of definitions */
+  int         limit,       /* I number of definitions in defs */
+  size_t      def_size,    /* I size of one definition */
+  size_t      name_offset, /* I offset of the name pointer in a definition */
+  bool        nocase,      /* I compare names without case */
+  const char *name)        /* I name to find */
+
+  {
+  int       index = -1;
+  int       slot;
+  def_hash *dh;
+
+  if ((defs == NULL) ||
+      (name == NULL) ||
+      (limit <= 0))
+    return(-1);
+
+  pthread_rwlock_rdlock(&def_hash_lock);
+
+  if ((slot = get_def_hash(defs, limit, def_size, name_offset, nocase)) < 0)
+    {
+    pthread_rwlock_unlock(&def_hash_lock);
+
+    dh = build_def_hash(defs, limit, def_size, name_offset, nocase);
+
+    pthread_rwlock_wrlock(&def_hash_lock);
+
+    if ((slot = get_def_hash(defs, limit, def_size, name_offset, nocase)) >= 0)
+      {
+      /* another thread built it first */
+      if (dh != NULL)
+        free_def_hash(dh);
+      }
+    else if (dh != NULL)
+      {
+      /* use a free slot, or replace a table whose array has changed */
+      for (slot = 0; slot < MAX_DEF_HASHES; slot++)
+        {
+        if ((def_hashes[slot] == NULL) ||
+            (def_hashes[slot]->defs == defs))
+          break;
+        }
+
+      if (slot < MAX_DEF_HASHES)
+        {
+        if (def_hashes[slot] != NULL)
+          free_def_hash(def_hashes[slot]);
+
+        def_hashes[slot] = dh;
+        }
+      else
+        {
+        free_def_hash(dh);
+        slot = -1;
+        }
+      }
+    }
+
+  if (slot < 0)
+    {
+    /* no table could be made, search the array */
+    pthread_rwlock_unlock(&def_hash_lock);
+
+    for (index = 0; index < limit; index++)
+      {
+      const char *def = def_name(defs, def_size, name_offset, index);
+
+      if ((def != NULL) &&
+          (!def_name_cmp(def, name, nocase)))
+        return(index);
+      }
+
+    return(-1);
+    }
+
+  dh = def_hashes[slot];
+
+  for (unsigned probe = def_name_hash(name, nocase) & dh->mask;
+       dh->slots[probe] != 0;
+       probe = (probe + 1) & dh->mask)
+    {
+    if (!def_name_cmp(def_name(defs, def_size, name_offset, dh->slots[probe] - 1), name, nocase))
+      {
+      index = dh->slots[probe] - 1;
+      break;
+      }
+    }
+
+  pthread_rwlock_unlock(&def_hash_lock);
+
+  return(index);
+  } /* END find_def_index() */
+
+
+
+
 /*
  * find_attr - find pbs_attribute definition by name
  *
@@ -183,22 +466,8 @@ int find_attr(
   int                   limit)    /* limit on size of def array */
 
   {
-  int index;
-
-  if (attr_def != NULL)
-    {
-    for (index = 0;index < limit;index++)
-      {
-      if (!str_nc_cmp(attr_def->at_name, name))
-        {
-        return(index);
-        }
-
-      attr_def++;
-      }  /* END for (index) */
-    }
-
-  return(-1);
+  return(find_def_index(attr_def, limit, sizeof(attribute_def),
+           offsetof(attribute_def, at_name), true, name));
   }
 
 
@@ -7,6 +7,8 @@ void clear_attr(pbs_attribute *pattr, attribute_def *pdef);
 
 int find_attr(struct attribute_def *attr_def, const char *name, int limit);
 
+int find_def_index(const void *defs, int limit, size_t def_size, size_t name_offset, bool nocase, const char *name);
+
 long attr_ifelse_long(pbs_attribute *attr1, pbs_attribute *attr2, long deflong);
 
 void free_null(struct pbs_attribute *attr);
@@ -33,6 +33,29 @@ int disrsi_(
   if (count == 0)
     return DIS_INVALID;
 
+  if (chan->encoding == DIS_ENCODING_BINARY)
+    {
+    unsigned long ulval;
+    int           rc;
+
+    if ((rc = disrvi_(chan, negate, &ulval, timeout)) != DIS_SUCCESS)
+      {
+      if (rc == DIS_OVERFLOW)
+        goto overflow;
+
+      return(rc);
+      }
+
+    if (ulval > UINT_MAX)
+      {
+      *negate = FALSE;
+      goto overflow;
+      }
+
+    *value = (unsigned)ulval;
+    return(DIS_SUCCESS);
+    }
+
   memset(scratch, 0, sizeof(scratch));
 
   if (dis_umaxd == 0)
@@ -109,6 +109,9 @@ int disrsl_(
   assert(value != NULL);
   assert(count);
 
+  if (chan->encoding == DIS_ENCODING_BINARY)
+    return(disrvi_(chan, negate, value, pbs_tcp_timeout));
+
   memset(scratch, 0, sizeof(scratch));
 
   if (ulmaxdigs == 0)
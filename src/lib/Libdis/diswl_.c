@@ -153,14 +153,15 @@ int diswl_(
   memset(scratch, 0, sizeof(scratch));
 
   /* Make zero a special case.  If we don't it will blow exponent  */
-  /* calculation.        */
+  /* calculation.  The exponent is written like any other integer */
+  /* so that it follows the channel's encoding.     */
 
   if (value == 0.0L)
     {
-    retval = tcp_puts(chan, "+0+0", 4) < 0 ?
-             DIS_PROTO : DIS_SUCCESS;
-    return ((tcp_wcommit(chan, retval == DIS_SUCCESS) < 0) ?
-            DIS_NOCOMMIT : retval);
+    if (tcp_puts(chan, "+0", 2) < 0)
+      return ((tcp_wcommit(chan, FALSE) < 0) ? DIS_NOCOMMIT : DIS_PROTO);
+
+    return (diswsi(chan, 0));
     }
 
   /* Extract the sign from the coefficient.    */
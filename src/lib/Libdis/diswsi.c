@@ -140,6 +140,14 @@ int diswsi(
     c = '+';
     }
 
+  if (chan->encoding == DIS_ENCODING_BINARY)
+    {
+    retval = diswvi_(chan, c == '-', uval);
+
+    return((tcp_wcommit(chan, retval == DIS_SUCCESS) < 0) ?
+      DIS_NOCOMMIT : retval);
+    }
+
   cp = discui_(&scratch[sizeof(scratch)-1], uval, &ndigs);
 
   *--cp = c;
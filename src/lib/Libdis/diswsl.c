@@ -135,6 +135,14 @@ int diswsl(
     c = '+';
     }
 
+  if (chan->encoding == DIS_ENCODING_BINARY)
+    {
+    retval = diswvi_(chan, c == '-', ulval);
+
+    return ((tcp_wcommit(chan, retval == DIS_SUCCESS) < 0) ?
+            DIS_NOCOMMIT : retval);
+    }
+
   cp = discul_(&scratch[sizeof(scratch)-1], ulval, &ndigs);
 
   *--cp = c;
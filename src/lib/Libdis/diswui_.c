@@ -95,6 +95,9 @@ int diswui_(
   unsigned ndigs;
   char  *cp = NULL;
   char  scratch[DIS_BUFSIZ];
+
+  if (chan->encoding == DIS_ENCODING_BINARY)
+    return(diswvi_(chan, FALSE, value));
   
   memset(scratch, 0, sizeof(scratch));
 
@@ -128,6 +128,14 @@ int diswul(
   int           rc;
   char          scratch[DIS_BUFSIZ];
 
+  if (chan->encoding == DIS_ENCODING_BINARY)
+    {
+    retval = diswvi_(chan, FALSE, value);
+
+    return((tcp_wcommit(chan, retval == DIS_SUCCESS) < 0) ?
+           DIS_NOCOMMIT : retval);
+    }
+
   memset(scratch, 0, sizeof(scratch));
   cp = discul_(&scratch[sizeof(scratch)-1], value, &ndigs);
 
@@ -98,10 +98,20 @@
 
 
 
-struct batch_reply *PBSD_rdrpy(
+/*
+ * PBSD_rdrpy_stream() - read a reply that may be a streamed status reply
+ *
+ * If the reply is BATCH_REPLY_CHOICE_StatusStream or EventStream, its status
+ * objects or job events are still to be read and the channel they're on is
+ * handed back in *stream; the caller reads them and calls DIS_tcp_cleanup().
+ * Without a stream pointer such a reply is a protocol error.
+ */
 
-  int *local_errno, /* O */
-  int  c)           /* I */
+struct batch_reply *PBSD_rdrpy_stream(
+
+  int              *local_errno, /* O */
+  int               c,           /* I */
+  struct tcp_chan **stream)      /* O (optional) */
 
   {
   int          rc;
@@ -127,6 +137,10 @@ struct batch_reply *PBSD_rdrpy(
     connection[c].ch_errtxt = NULL;
     }
 
+  /* the replies on a session may come in any order, see pbsD_session.c */
+  if (connection[c].ch_session != NULL)
+    return(PBSD_session_rdrpy(local_errno, c));
+
   if ((reply = (struct batch_reply *)calloc(1, sizeof(struct batch_reply))) == NULL)
     {
     connection[c].ch_errno = PBSE_SYSTEM;
@@ -177,7 +191,24 @@ struct batch_reply *PBSD_rdrpy(
     return(NULL);
     }
 
-  DIS_tcp_cleanup(chan);
+  if ((reply->brp_choice == BATCH_REPLY_CHOICE_StatusStream) ||
+      (reply->brp_choice == BATCH_REPLY_CHOICE_EventStream))
+    {
+    if (stream == NULL)
+      {
+      PBSD_FreeReply(reply);
+      DIS_tcp_cleanup(chan);
+
+      *local_errno = PBSE_PROTOCOL;
+      connection[c].ch_errno = PBSE_PROTOCOL;
+
+      return(NULL);
+      }
+
+    *stream = chan;
+    }
+  else
+    DIS_tcp_cleanup(chan);
 
   connection[c].ch_errno = reply->brp_code;
 
@@ -192,6 +223,18 @@ struct batch_reply *PBSD_rdrpy(
     }
 
   return(reply);
+  }  /* END PBSD_rdrpy_stream() */
+
+
+
+
+struct batch_reply *PBSD_rdrpy(
+
+  int *local_errno, /* O */
+  int  c)           /* I */
+
+  {
+  return(PBSD_rdrpy_stream(local_errno, c, NULL));
   }  /* END PBSD_rdrpy() */
 
 
@@ -86,7 +86,9 @@
 #include <string.h>
 #include <stdio.h>
 #include "libpbs.h"
+#include "dis.h"
 #include "server_limits.h"
+#include "lib_ifl.h" /* decode_DIS_attrl */
 
 
 static struct batch_status *alloc_bs();
@@ -108,7 +110,15 @@ struct batch_status *PBSD_status(
   if (id == NULL)
     id =(char *)""; /* set to null string for encoding */
 
-  rc = PBSD_status_put(c, function, id, attrib, extend);
+  /* job status can be large, let the server stream it and send it binary,
+   * which also switches the rest of the connection to binary */
+  rc = PBSD_status_put_flags(
+         c,
+         function,
+         id,
+         attrib,
+         extend,
+         (function == PBS_BATCH_StatusJob) ? (REQ_EXTEND_STREAM | REQ_EXTEND_BINARY) : 0);
 
   if (rc != 0)
     {
@@ -130,6 +140,84 @@ struct batch_status *PBSD_status(
 
 
 
+/*
+ * PBSD_status_stream() - read the status objects of a streamed status reply
+ *
+ * Each object is decoded straight into a batch_status entry as it
+ * arrives. The stream ends with the final code of the reply; if it isn't
+ * 0 the entries read so far are thrown away, as with a rejected request.
+ */
+
+static struct batch_status *PBSD_status_stream(
+
+  int              *local_errno, /* O */
+  int               c,           /* I */
+  struct tcp_chan  *chan)        /* I */
+
+  {
+  struct batch_status  *rbsp = NULL;
+  struct batch_status **tail = &rbsp;
+  struct batch_status  *bsp;
+  char                  objname[(PBS_MAXSVRJOBID > PBS_MAXDEST ? PBS_MAXSVRJOBID : PBS_MAXDEST) + 1];
+  int                   code = PBSE_NONE;
+  int                   rc = DIS_SUCCESS;
+
+  while (disrui(chan, &rc) != 0)
+    {
+    if (rc != DIS_SUCCESS)
+      break;
+
+    /* the object type isn't kept in a batch_status */
+    disrui(chan, &rc);
+
+    if ((rc != DIS_SUCCESS) ||
+        ((rc = disrfst(chan, sizeof(objname) - 1, objname)) != DIS_SUCCESS))
+      break;
+
+    if ((bsp = alloc_bs()) == NULL)
+      {
+      code = PBSE_SYSTEM;
+      break;
+      }
+
+    *tail = bsp;
+    tail = &bsp->next;
+
+    bsp->name = strdup(objname);
+
+    if ((rc = decode_DIS_attrl(chan, &bsp->attribs)) != DIS_SUCCESS)
+      break;
+    }
+
+  if ((rc == DIS_SUCCESS) &&
+      (code == PBSE_NONE))
+    {
+    code = disrsi(chan, &rc);
+
+    if (rc == DIS_SUCCESS)
+      disrsi(chan, &rc); /* auxcode */
+    }
+
+  if (rc != DIS_SUCCESS)
+    code = (chan->IsTimeout == TRUE) ? PBSE_TIMEOUT : PBSE_PROTOCOL;
+
+  if (code != PBSE_NONE)
+    {
+    connection[c].ch_errno = code;
+
+    *local_errno = code;
+
+    pbs_statfree(rbsp);
+
+    rbsp = NULL;
+    }
+
+  return(rbsp);
+  }  /* END PBSD_status_stream() */
+
+
+
+
 struct batch_status *PBSD_status_get(
 
   int *local_errno, /* O */
@@ -140,6 +228,7 @@ struct batch_status *PBSD_status_get(
   struct batch_status *bsp = NULL;
   struct batch_status *rbsp = (struct batch_status *)NULL;
   struct batch_reply  *reply;
+  struct tcp_chan     *stream = NULL;
   int i;
   
   if ((c < 0) || 
@@ -153,12 +242,21 @@ struct batch_status *PBSD_status_get(
   *local_errno = 0;
 
   /* read reply from stream into presentation element */
-  reply = PBSD_rdrpy(local_errno, c);
+  reply = PBSD_rdrpy_stream(local_errno, c, &stream);
 
   if (reply == NULL)
     {
     *local_errno = PBSE_PROTOCOL;
     }
+  else if (stream != NULL)
+    {
+    /* a streamed reply's code always starts out 0 */
+    *local_errno = 0;
+
+    rbsp = PBSD_status_stream(local_errno, c, stream);
+
+    DIS_tcp_cleanup(stream);
+    }
   else if ((reply->brp_choice != BATCH_REPLY_CHOICE_NULL) &&
            (reply->brp_choice != BATCH_REPLY_CHOICE_Text) &&
            (reply->brp_choice != BATCH_REPLY_CHOICE_Status))
@@ -91,13 +91,19 @@
 #include "server_limits.h"
 
 
-int PBSD_status_put(
+/*
+ * PBSD_status_put_flags() - send a status request, passing REQ_EXTEND_*
+ * flags along with the extension
+ */
+
+int PBSD_status_put_flags(
 
   int           c,
   int           function,
   char         *id,
   struct attrl *attrib,
-  char         *extend)
+  char         *extend,
+  int           ext_flags)
 
   {
   int rc = 0;
@@ -121,7 +127,7 @@ int PBSD_status_put(
     }
   else if ((rc = encode_DIS_ReqHdr(chan, function, pbs_current_user)) ||
       (rc = encode_DIS_Status(chan, id, attrib)) ||
-      (rc = encode_DIS_ReqExtend(chan, extend)))
+      (rc = encode_DIS_ReqExtend_flags(chan, extend, ext_flags)))
     {
     connection[c].ch_errtxt = strdup(dis_emsg[rc]);
 
@@ -140,6 +146,21 @@ int PBSD_status_put(
 
   DIS_tcp_cleanup(chan);
   return(PBSE_NONE);
+  }  /* END PBSD_status_put_flags() */
+
+
+
+
+int PBSD_status_put(
+
+  int           c,
+  int           function,
+  char         *id,
+  struct attrl *attrib,
+  char         *extend)
+
+  {
+  return(PBSD_status_put_flags(c, function, id, attrib, extend, 0));
   }  /* END PBSD_status_put() */
 
 
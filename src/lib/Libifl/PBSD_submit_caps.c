@@ -701,4 +701,216 @@ int PBSD_QueueJob_hash(
   return rc;
   }  /* END PBSD_queuejob() */
 
+
+
+
+/*
+ * PBSD_SubmitJob_hash() - send the attributes and the script of a new job
+ * in one Submit Job request.  The server queues, saves and commits the job
+ * before it replies.
+ *
+ * Servers that predate the request close the connection without a reply;
+ * that is reported as PBSE_NOSUP so the caller can reconnect and use the
+ * Queue Job sequence instead.
+ */
+
+int PBSD_SubmitJob_hash(
+
+  int                 connect,     /* I */
+  char               *destin,      /* I */
+  job_data_container *job_attr,    /* I */
+  job_data_container *res_attr,    /* I */
+  char               *script,      /* I (script contents, may be NULL) */
+  size_t              script_len,  /* I */
+  char               *extend,      /* I (optional) */
+  char              **job_id,      /* O */
+  char              **msg)         /* O */
+
+  {
+  struct batch_reply *reply;
+  int                 rc = PBSE_NONE;
+  int                 sock;
+  struct tcp_chan    *chan = NULL;
+
+  if ((connect < 0) || 
+      (connect >= PBS_NET_MAX_CONNECTIONS))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  sock = connection[connect].ch_socket;
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    return(PBSE_PROTOCOL);
+    }
+  else if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_SubmitJob, pbs_current_user)) ||
+           (rc = encode_DIS_SubmitJob_hash(chan, (char *)"", destin, job_attr, res_attr, script, script_len)) ||
+           (rc = encode_DIS_ReqExtend(chan, extend)))
+    {
+    pthread_mutex_lock(connection[connect].ch_mutex);
+    if (connection[connect].ch_errtxt == NULL)
+      {
+      if ((rc >= 0) &&
+          (rc <= DIS_INVALID))
+        connection[connect].ch_errtxt = strdup(dis_emsg[rc]);
+      }
+
+    if (connection[connect].ch_errtxt != NULL)  
+      *msg = strdup(connection[connect].ch_errtxt);
+
+    pthread_mutex_unlock(connection[connect].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+
+  if ((rc = DIS_tcp_wflush(chan)))
+    {
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+    
+  DIS_tcp_cleanup(chan);
+
+  reply = PBSD_rdrpy(&rc, connect);
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  if (reply == NULL)
+    {
+    if (rc == PBSE_TIMEOUT)
+      rc = PBSE_EXPIRED;
+    else
+      rc = PBSE_NOSUP;
+    }
+  else if ((rc == PBSE_UNKREQ) ||
+           (rc == PBSE_DISPROTO))
+    {
+    rc = PBSE_NOSUP;
+    }
+  else if (reply->brp_choice &&
+           reply->brp_choice != BATCH_REPLY_CHOICE_Text &&
+           reply->brp_choice != BATCH_REPLY_CHOICE_Commit)
+    {
+    rc = PBSE_PROTOCOL;
+    }
+  else if (reply->brp_choice == BATCH_REPLY_CHOICE_Text)
+    {
+    *msg = strdup(reply->brp_un.brp_txt.brp_str);
+    }
+  else if (connection[connect].ch_errno == 0)
+    {
+    *job_id = strdup(reply->brp_un.brp_jid);
+    }
+    
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  PBSD_FreeReply(reply);
+
+  return(rc);
+  }  /* END PBSD_SubmitJob_hash() */
+
+
+
+
+/*
+ * PBSD_SubmitMany_hash() - send up to SUBMIT_MANY_MAX jobs in one Submit
+ * Many request.  On success results holds the server's reply, a line per
+ * job with its error code followed by its job id or an error message.
+ *
+ * As with PBSD_SubmitJob_hash(), PBSE_NOSUP means the server closed the
+ * connection without understanding the request.
+ */
+
+int PBSD_SubmitMany_hash(
+
+  int                  connect,     /* I */
+  int                  count,       /* I */
+  char               **destins,     /* I */
+  job_data_container **job_attrs,   /* I */
+  job_data_container **res_attrs,   /* I */
+  char               **scripts,     /* I (script contents) */
+  size_t              *script_lens, /* I */
+  char                *extend,      /* I (optional) */
+  char               **results)     /* O */
+
+  {
+  struct batch_reply *reply;
+  int                 rc = PBSE_NONE;
+  int                 sock;
+  struct tcp_chan    *chan = NULL;
+
+  if ((connect < 0) || 
+      (connect >= PBS_NET_MAX_CONNECTIONS) ||
+      (count <= 0) ||
+      (count > SUBMIT_MANY_MAX))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  pthread_mutex_lock(connection[connect].ch_mutex);
+  sock = connection[connect].ch_socket;
+  pthread_mutex_unlock(connection[connect].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    return(PBSE_PROTOCOL);
+    }
+  else if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_SubmitMany, pbs_current_user)) ||
+           (rc = encode_DIS_SubmitMany_hash(chan, count, destins, job_attrs, res_attrs, scripts, script_lens)) ||
+           (rc = encode_DIS_ReqExtend(chan, extend)))
+    {
+    pthread_mutex_lock(connection[connect].ch_mutex);
+    if ((connection[connect].ch_errtxt == NULL) &&
+        (rc >= 0) &&
+        (rc <= DIS_INVALID))
+      connection[connect].ch_errtxt = strdup(dis_emsg[rc]);
+    pthread_mutex_unlock(connection[connect].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(PBSE_PROTOCOL);
+    }
+
+  if ((rc = DIS_tcp_wflush(chan)))
+    {
+    DIS_tcp_cleanup(chan);
+
+    return(rc);
+    }
+    
+  DIS_tcp_cleanup(chan);
+
+  reply = PBSD_rdrpy(&rc, connect);
+
+  if (reply == NULL)
+    {
+    if (rc == PBSE_TIMEOUT)
+      rc = PBSE_EXPIRED;
+    else
+      rc = PBSE_NOSUP;
+    }
+  else if ((rc == PBSE_UNKREQ) ||
+           (rc == PBSE_DISPROTO))
+    {
+    rc = PBSE_NOSUP;
+    }
+  else if (rc == PBSE_NONE)
+    {
+    if ((reply->brp_choice != BATCH_REPLY_CHOICE_Text) ||
+        (reply->brp_un.brp_txt.brp_str == NULL))
+      rc = PBSE_PROTOCOL;
+    else
+      *results = strdup(reply->brp_un.brp_txt.brp_str);
+    }
+
+  PBSD_FreeReply(reply);
+
+  return(rc);
+  }  /* END PBSD_SubmitMany_hash() */
+
 /* END PBSD_submit.c */
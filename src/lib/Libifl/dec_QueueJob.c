@@ -87,6 +87,7 @@
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include <stdlib.h>
 #include <sys/types.h>
 #include "libpbs.h"
 #include "list_link.h"
@@ -128,4 +129,111 @@ int decode_DIS_QueueJob(
 
 
 
+/*
+ * decode_submitjob() - decode the items of one job of a Submit Job or
+ * Submit Many request
+ */
+
+static int decode_submitjob(
+
+  struct tcp_chan     *chan,
+  struct rq_submitjob *psj)
+
+  {
+  int    rc;
+  size_t amt = 0;
+
+  CLEAR_HEAD(psj->rq_queuejob.rq_attr);
+
+  psj->rq_script = NULL;
+  psj->rq_scriptsz = 0;
+
+  if (((rc = disrfst(chan, PBS_MAXSVRJOBID, psj->rq_queuejob.rq_jid)) != 0) ||
+      ((rc = disrfst(chan, PBS_MAXDEST, psj->rq_queuejob.rq_destin)) != 0) ||
+      ((rc = decode_DIS_svrattrl(chan, &psj->rq_queuejob.rq_attr)) != 0))
+    return(rc);
+
+  psj->rq_script = disrcs(chan, &amt, &rc);
+
+  if (rc != 0)
+    {
+    if (psj->rq_script != NULL)
+      free(psj->rq_script);
+
+    psj->rq_script = NULL;
+
+    return(rc);
+    }
+
+  psj->rq_scriptsz = amt;
+
+  return(rc);
+  }  /* END decode_submitjob() */
+
+
+
+
+/*
+ * decode_DIS_SubmitJob() - decode a Submit Job Batch Request
+ *
+ * Data items are: the Queue Job items, see decode_DIS_QueueJob()
+ *   counted string script (may be empty)
+ */
+
+int decode_DIS_SubmitJob(
+
+  struct tcp_chan *chan,
+  struct batch_request *preq)
+
+  {
+  return(decode_submitjob(chan, &preq->rq_ind.rq_submitjob));
+  }  /* END decode_DIS_SubmitJob() */
+
+
+
+
+/*
+ * decode_DIS_SubmitMany() - decode a Submit Many Batch Request
+ *
+ * Data items are: u int number of jobs (at most SUBMIT_MANY_MAX)
+ *   the Submit Job items of each job, see decode_DIS_SubmitJob()
+ */
+
+int decode_DIS_SubmitMany(
+
+  struct tcp_chan *chan,
+  struct batch_request *preq)
 
+  {
+  int      rc;
+  int      i;
+  unsigned count;
+
+  preq->rq_ind.rq_submitmany.rq_count = 0;
+  preq->rq_ind.rq_submitmany.rq_jobs = NULL;
+
+  count = disrui(chan, &rc);
+
+  if (rc != 0)
+    return(rc);
+
+  if ((count == 0) ||
+      (count > SUBMIT_MANY_MAX))
+    return(DIS_PROTO);
+
+  preq->rq_ind.rq_submitmany.rq_jobs = (struct rq_submitjob *)calloc(count, sizeof(struct rq_submitjob));
+
+  if (preq->rq_ind.rq_submitmany.rq_jobs == NULL)
+    return(DIS_NOMALLOC);
+
+  for (i = 0; i < (int)count; i++)
+    {
+    /* count what has been decoded so free_br() releases it on failure */
+    preq->rq_ind.rq_submitmany.rq_count = i + 1;
+
+    if ((rc = decode_submitjob(chan, &preq->rq_ind.rq_submitmany.rq_jobs[i])) != 0)
+      break;
+    }
+
+  return(rc);
+  }  /* END decode_DIS_SubmitMany() */
@@ -86,12 +86,15 @@
  * have already be decoded.
  *
  * The next field is an unsigned integer which is 1 if there is an
- * extension string and zero if not.
+ * extension string and zero if not.  Newer clients send REQ_EXTEND_*
+ * flags there instead; the string is the caller's extension only when
+ * REQ_EXTEND_STRING is set.
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <sys/types.h>
+#include <stdlib.h>
 #include "libpbs.h"
 #include "list_link.h"
 #include "server_limits.h"
@@ -117,6 +120,15 @@ int decode_DIS_ReqExtend(
     if (i != 0)
       {
       preq->rq_extend = disrst(chan, &rc);
+      preq->rq_extflags = i;
+
+      if (((i & REQ_EXTEND_STRING) == 0) &&
+          (preq->rq_extend != NULL))
+        {
+        /* just a placeholder for the flags */
+        free(preq->rq_extend);
+        preq->rq_extend = NULL;
+        }
       }
     }
 
@@ -119,6 +119,14 @@ int decode_DIS_ReqHdr(
 
   *proto_ver = disrui(chan, &rc);
 
+  if ((rc == 0) &&
+      (*proto_ver == PBS_BATCH_PROT_VER_BINARY))
+    {
+    /* the rest of the request, and the reply, are binary */
+    chan->encoding = DIS_ENCODING_BINARY;
+    preq->rq_encoding = DIS_ENCODING_BINARY;
+    }
+
   if (rc == 0)
     {
     preq->rq_type = disrui(chan, &rc);
@@ -91,6 +91,7 @@
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include <stdlib.h>
 #include <sys/types.h>
 #include "libpbs.h"
 #include "list_link.h"
@@ -124,3 +125,63 @@ int decode_DIS_RunJob(
   return rc;
   }
 
+
+
+/*
+ * decode_DIS_RunJobs() - decode a Run Jobs batch request
+ *
+ * Data items are: u int number of jobs (at most RUN_JOBS_MAX)
+ *   the Run Job items of each job, see decode_DIS_RunJob()
+ */
+
+int decode_DIS_RunJobs(
+
+  struct tcp_chan      *chan,
+  struct batch_request *preq)
+
+  {
+  int               rc;
+  int               i;
+  unsigned          count;
+  struct rq_runjob *prj;
+
+  preq->rq_ind.rq_runjobs.rq_count = 0;
+  preq->rq_ind.rq_runjobs.rq_jobs = NULL;
+
+  count = disrui(chan, &rc);
+
+  if (rc != 0)
+    return(rc);
+
+  if ((count == 0) ||
+      (count > RUN_JOBS_MAX))
+    return(DIS_PROTO);
+
+  preq->rq_ind.rq_runjobs.rq_jobs = (struct rq_runjob *)calloc(count, sizeof(struct rq_runjob));
+
+  if (preq->rq_ind.rq_runjobs.rq_jobs == NULL)
+    return(DIS_NOMALLOC);
+
+  for (i = 0; i < (int)count; i++)
+    {
+    prj = &preq->rq_ind.rq_runjobs.rq_jobs[i];
+
+    /* count what has been decoded so free_br() releases it on failure */
+    preq->rq_ind.rq_runjobs.rq_count = i + 1;
+
+    if ((rc = disrfst(chan, PBS_MAXSVRJOBID, prj->rq_jid)) != 0)
+      break;
+
+    prj->rq_destin = disrst(chan, &rc);
+
+    if (rc != 0)
+      break;
+
+    prj->rq_resch = disrui(chan, &rc);
+
+    if (rc != 0)
+      break;
+    }
+
+  return(rc);
+  }  /* END decode_DIS_RunJobs() */
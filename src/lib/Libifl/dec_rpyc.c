@@ -121,6 +121,8 @@ int decode_DIS_replyCmd(
 
   /* first decode "header" consisting of protocol type and version */
 
+  chan->encoding = DIS_ENCODING_CLASSIC;
+
   i = disrui(chan, &rc);
 
   if (rc != 0)
@@ -140,7 +142,14 @@ int decode_DIS_replyCmd(
     return(rc);
     }
 
-  if (i != PBS_BATCH_PROT_VER)
+  if (i == PBS_BATCH_PROT_VER_BINARY)
+    {
+    /* the server speaks binary, send it our later requests that way too */
+    chan->encoding = DIS_ENCODING_BINARY;
+
+    DIS_tcp_set_encoding(chan->sock, DIS_ENCODING_BINARY);
+    }
+  else if (i != PBS_BATCH_PROT_VER)
     {
     return(DIS_PROTO);
     }
@@ -286,6 +295,18 @@ int decode_DIS_replyCmd(
 
       break;
 
+    case BATCH_REPLY_CHOICE_StatusStream:
+
+      /* the status objects are left on the channel, see PBSD_status_get() */
+
+      break;
+
+    case BATCH_REPLY_CHOICE_EventStream:
+
+      /* the job events are left on the channel, see pbs_next_event() */
+
+      break;
+
     case BATCH_REPLY_CHOICE_Text:
 
       /* text reply */
@@ -137,7 +137,10 @@ int decode_DIS_replySvr(
 
   if (rc != 0) return rc;
 
-  if (i != PBS_BATCH_PROT_VER) return DIS_PROTO;
+  if (i == PBS_BATCH_PROT_VER_BINARY)
+    chan->encoding = DIS_ENCODING_BINARY;
+  else if (i != PBS_BATCH_PROT_VER)
+    return DIS_PROTO;
 
   /* next decode code, auxcode and choice (union type identifier) */
 
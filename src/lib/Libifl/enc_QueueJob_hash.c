@@ -127,4 +127,81 @@ int encode_DIS_QueueJob_hash(
 
 
 
+/*
+ * encode_DIS_SubmitJob_hash() - encode a Submit Job Batch Request
+ *
+ * This request carries everything needed to queue and commit a job
+ * in a single round trip.
+ *
+ * Data items are: the Queue Job items, see encode_DIS_QueueJob_hash()
+ *   counted string script (may be empty)
+ */
+
+int encode_DIS_SubmitJob_hash(
+
+  struct tcp_chan    *chan,
+  char               *jobid,
+  char               *destin,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char               *script,
+  size_t              script_len)
+
+  {
+  int rc;
+
+  if ((rc = encode_DIS_QueueJob_hash(chan, jobid, destin, job_attr, res_attr)) != 0)
+    return(rc);
+
+  if (script == NULL)
+    script = (char *)"";
+
+  return(diswcs(chan, script, script_len));
+  }  /* END encode_DIS_SubmitJob_hash() */
+
+
+
+
+/*
+ * encode_DIS_SubmitMany_hash() - encode a Submit Many Batch Request
+ *
+ * Data items are: u int number of jobs
+ *   the Submit Job items of each job, see encode_DIS_SubmitJob_hash()
+ */
+
+int encode_DIS_SubmitMany_hash(
+
+  struct tcp_chan     *chan,
+  int                  count,
+  char               **destins,
+  job_data_container **job_attrs,
+  job_data_container **res_attrs,
+  char               **scripts,
+  size_t              *script_lens)
+
+  {
+  int rc;
+  int i;
+
+  if ((rc = diswui(chan, count)) != 0)
+    return(rc);
+
+  for (i = 0; i < count; i++)
+    {
+    if ((rc = encode_DIS_SubmitJob_hash(chan,
+                                        NULL,
+                                        destins[i],
+                                        job_attrs[i],
+                                        res_attrs[i],
+                                        scripts[i],
+                                        script_lens[i])) != 0)
+      return(rc);
+    }
+
+  return(PBSE_NONE);
+  }  /* END encode_DIS_SubmitMany_hash() */
+
+
+
+
 
@@ -82,13 +82,20 @@
  * The extension is in two parts:
  *  unsigned integer - 1 if an extension string follows, 0 if not
  *  character string - if 1 above
+ *
+ * Newer clients may send REQ_EXTEND_* flags in place of the 1, see
+ * encode_DIS_ReqExtend_flags().
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include "libpbs.h"
 #include "dis.h"
 #include "tcp.h" /* tcp_chan */
 
+/* sent when there are flags but no extension, older servers ignore it */
+#define REQ_EXTEND_PLACEHOLDER "flags"
+
 int encode_DIS_ReqExtend(
     
   struct tcp_chan *chan,
@@ -112,3 +119,41 @@ int encode_DIS_ReqExtend(
   return rc;
   }
 
+
+
+/*
+ * encode_DIS_ReqExtend_flags() - write an extension along with REQ_EXTEND_*
+ * flags in the unsigned integer ahead of it
+ *
+ * Older servers read any non-zero value there as "a string follows", so
+ * a string is always sent with flags: the caller's extension, marked with
+ * REQ_EXTEND_STRING, or a placeholder that newer servers drop.
+ */
+
+int encode_DIS_ReqExtend_flags(
+
+  struct tcp_chan *chan,
+  char            *extend,
+  int              flags)
+
+  {
+  int rc;
+
+  if (flags == 0)
+    return(encode_DIS_ReqExtend(chan, extend));
+
+  if ((extend == NULL) || (*extend == '\0'))
+    {
+    flags &= ~REQ_EXTEND_STRING;
+    extend = (char *)REQ_EXTEND_PLACEHOLDER;
+    }
+  else
+    flags |= REQ_EXTEND_STRING;
+
+  if ((rc = diswui(chan, flags)) == 0)
+    {
+    rc = diswst(chan, extend);
+    }
+
+  return(rc);
+  }
@@ -79,7 +79,9 @@
 
 /*
  * encode_DIS_ReqHdr() - DIS encode a Request Header
- * Fields are: Protocol ID (unsigned integer)
+ * Fields are: Session Tag (unsigned integer, only on a session, see
+ *     pbsD_session.c)
+ *   Protocol ID (unsigned integer)
  *   Protocol Version (unsigned integer)
  *   Request Type (unsignded integer)
  *   User Name (string)
@@ -97,11 +99,30 @@ int encode_DIS_ReqHdr(
   int   reqt,
   char *user)
   {
-  int rc;
+  int          rc;
+  int          encoding = DIS_tcp_get_encoding(chan->sock);
+  unsigned int tag;
+
+  /* the protocol type and version are always classic, the version tells
+   * the server how the rest of the request is encoded */
+  chan->encoding = DIS_ENCODING_CLASSIC;
+
+  if ((PBSD_session_tag(chan->sock, &tag) == TRUE) &&
+      ((rc = diswui(chan, tag))))
+    {
+    return rc;
+    }
 
   if ((rc = diswui(chan, PBS_BATCH_PROT_TYPE)) ||
-      (rc = diswui(chan, PBS_BATCH_PROT_VER)) ||
-      (rc = diswui(chan, reqt))   ||
+      (rc = diswui(chan, (encoding == DIS_ENCODING_BINARY) ?
+                          PBS_BATCH_PROT_VER_BINARY : PBS_BATCH_PROT_VER)))
+    {
+    return rc;
+    }
+
+  chan->encoding = encoding;
+
+  if ((rc = diswui(chan, reqt))   ||
       (rc = diswst(chan, user)))
     {
     return rc;
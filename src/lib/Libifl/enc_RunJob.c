@@ -108,3 +108,34 @@ int encode_DIS_RunJob(
   return 0;
   }
 
+
+
+/*
+ * encode_DIS_RunJobs() - encode a Run Jobs Batch Request
+ *
+ * Data items are: u int number of jobs (at most RUN_JOBS_MAX)
+ *   the Run Job items of each job, see encode_DIS_RunJob()
+ */
+
+int encode_DIS_RunJobs(
+
+  struct tcp_chan *chan,
+  int              count,
+  char           **jobids,
+  char           **wheres)
+
+  {
+  int   rc;
+  int   i;
+
+  if ((rc = diswui(chan, count)) != 0)
+    return(rc);
+
+  for (i = 0; i < count; i++)
+    {
+    if ((rc = encode_DIS_RunJob(chan, jobids[i], wheres[i], 0)) != 0)
+      return(rc);
+    }
+
+  return(0);
+  }  /* END encode_DIS_RunJobs() */
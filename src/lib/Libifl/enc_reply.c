@@ -91,6 +91,35 @@
 #include "attribute.h"
 #include "dis.h"
 #include "batch_request.h"
+#include "tcp.h"
+
+
+
+/* encode one status object: its type, name and attributes */
+
+static int encode_DIS_brp_status(
+
+  struct tcp_chan   *chan,
+  struct brp_status *pstat)
+
+  {
+  int rc;
+
+  if ((rc = diswui(chan, pstat->brp_objtype)) ||
+      (rc = diswst(chan, pstat->brp_objname)))
+    return rc;
+
+  if (pstat->brp_encoded != NULL)
+    {
+    /* the server kept this object's encoded attributes, copy them as is */
+    if (tcp_puts(chan, pstat->brp_encoded, pstat->brp_encoded_len) != (int)pstat->brp_encoded_len)
+      rc = DIS_PROTO;
+
+    return((tcp_wcommit(chan, rc == DIS_SUCCESS) < 0) ? DIS_NOCOMMIT : rc);
+    }
+
+  return(encode_DIS_svrattrl(chan, (svrattrl *)GET_NEXT(pstat->brp_attr)));
+  }
 
 
 
@@ -105,14 +134,23 @@ int encode_DIS_reply(
 
   struct brp_select  *psel;
   struct brp_status  *pstat;
-  svrattrl           *psvrl;
   int                 rc;
+  int                 encoding = chan->encoding;
 
-  /* first encode "header" consisting of protocol type and version */
+  /* first encode "header" consisting of protocol type and version, always
+   * classic, the version tells the client how the rest is encoded */
+
+  chan->encoding = DIS_ENCODING_CLASSIC;
 
   if ((rc = diswui(chan, PBS_BATCH_PROT_TYPE)) ||
-      (rc = diswui(chan, PBS_BATCH_PROT_VER)))
+      (rc = diswui(chan, (encoding == DIS_ENCODING_BINARY) ?
+                          PBS_BATCH_PROT_VER_BINARY : PBS_BATCH_PROT_VER)))
+    {
+    chan->encoding = encoding;
     return rc;
+    }
+
+  chan->encoding = encoding;
 
   /* next encode code, auxcode and choice (union type identifier) */
 
@@ -195,13 +233,7 @@ int encode_DIS_reply(
 
       while (pstat)
         {
-        if ((rc = diswui(chan, pstat->brp_objtype)) ||
-            (rc = diswst(chan, pstat->brp_objname)))
-          return rc;
-
-        psvrl = (svrattrl *)GET_NEXT(pstat->brp_attr);
-
-        if ((rc = encode_DIS_svrattrl(chan, psvrl)))
+        if ((rc = encode_DIS_brp_status(chan, pstat)))
           return rc;
 
         pstat = (struct brp_status *)GET_NEXT(pstat->brp_stlink);
@@ -209,6 +241,18 @@ int encode_DIS_reply(
 
       break;
 
+    case BATCH_REPLY_CHOICE_StatusStream:
+
+      /* the status objects follow, see encode_DIS_status_stream() */
+
+      break;
+
+    case BATCH_REPLY_CHOICE_EventStream:
+
+      /* the job events follow, see encode_DIS_JobEvent() */
+
+      break;
+
     case BATCH_REPLY_CHOICE_Text:
 
       /* text reply */
@@ -273,3 +317,57 @@ int encode_DIS_reply(
 
   return 0;
   }
+
+
+
+/*
+ * encode_DIS_status_stream() - encode status objects of a streamed status
+ * reply
+ *
+ * After a BATCH_REPLY_CHOICE_StatusStream reply, each status object is
+ * sent preceded by a 1 instead of being counted up front, so the sender
+ * can encode objects as it builds them.  encode_DIS_status_stream_end()
+ * sends the 0 that ends the stream and the final code of the reply.
+ */
+
+int encode_DIS_status_stream(
+
+  struct tcp_chan *chan,
+  tlist_head      *status)
+
+  {
+  struct brp_status *pstat;
+  int                rc;
+
+  pstat = (struct brp_status *)GET_NEXT(*status);
+
+  while (pstat)
+    {
+    if ((rc = diswui(chan, 1)) ||
+        (rc = encode_DIS_brp_status(chan, pstat)))
+      return rc;
+
+    pstat = (struct brp_status *)GET_NEXT(pstat->brp_stlink);
+    }
+
+  return 0;
+  }
+
+
+
+int encode_DIS_status_stream_end(
+
+  struct tcp_chan *chan,
+  int              code,
+  int              auxcode)
+
+  {
+  int rc;
+
+  if ((rc = diswui(chan, 0)) ||
+      (rc = diswsi(chan, code)) ||
+      (rc = diswsi(chan, auxcode)))
+    return rc;
+
+  return 0;
+  }
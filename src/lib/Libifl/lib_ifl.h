@@ -51,6 +51,7 @@ int PBSD_msg_put(int c, char *jobid, int fileopt, char *msg, char *extend);
 
 /* PBSD_rdrpy.c */
 struct batch_reply *PBSD_rdrpy(int *, int c); 
+struct batch_reply *PBSD_rdrpy_stream(int *local_errno, int c, struct tcp_chan **stream);
 void PBSD_FreeReply(struct batch_reply *reply);
 
 /* PBSD_sig2.c */
@@ -64,6 +65,7 @@ struct batch_status *PBSD_status_get(int *, int c);
 
 /* PBSD_status2.c */
 int PBSD_status_put(int c, int function, char *id, struct attrl *attrib, char *extend);
+int PBSD_status_put_flags(int c, int function, char *id, struct attrl *attrib, char *extend, int ext_flags);
 
 /* PBSD_submit_caps.c */
 int PBSD_rdytocmt(int connect, char *jobid);
@@ -78,11 +80,32 @@ int pbs_submit_hash(
   char              *extend,  /* (optional) */
   char              **return_jobid,
   char              **msg);
+int pbs_submit_commit_hash(
+  int                 socket,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char               *script,
+  char               *destination,
+  char               *extend,  /* (optional) */
+  char              **return_jobid,
+  char              **msg);
+int pbs_submit_many(
+  int                  socket,
+  int                  count,
+  job_data_container **job_attrs,
+  job_data_container **res_attrs,
+  char               **scripts,
+  char               **destinations,
+  char                *extend,  /* (optional) */
+  char               **return_jobids,
+  int                 *return_codes);
 /* static int PBSD_scbuf(int c, int reqtype, int seq, char *buf, int len, char *jobid, enum job_file which);  */
 int PBSD_jscript(int c, char *script_file, char *jobid);
 int PBSD_jobfile(int c, int req_type, char *path, char *jobid, enum job_file which);
 char *PBSD_queuejob(int connect, int *, char *jobid, char *destin, struct attropl *attrib, char *extend);
 int PBSD_QueueJob_hash(int connect, char *jobid, char *destin, job_data *job_attr, job_data *res_attr, char *extend, char **job_id, char **msg);
+int PBSD_SubmitJob_hash(int connect, char *destin, job_data_container *job_attr, job_data_container *res_attr, char *script, size_t script_len, char *extend, char **job_id, char **msg);
+int PBSD_SubmitMany_hash(int connect, int count, char **destins, job_data_container **job_attrs, job_data_container **res_attrs, char **scripts, size_t *script_lens, char *extend, char **results);
 
 /* PBS_attr.c */
 int PBS_val_al(struct attrl *alp);
@@ -108,6 +131,9 @@ int decode_DIS_JobCred(struct tcp_chan *chan, struct batch_request *preq);
 /* dec_JobFile.c */
 int decode_DIS_JobFile(struct tcp_chan *chan, struct batch_request *preq);
 
+/* dec_JobEvent.c */
+int decode_DIS_JobEvent(struct tcp_chan *chan, struct pbs_job_event *event);
+
 /* dec_JobId.c */
 int decode_DIS_JobId(struct tcp_chan *chan, char *jobid);
 
@@ -125,6 +151,8 @@ int decode_DIS_MessageJob(struct tcp_chan *chan, struct batch_request *preq);
 
 /* dec_QueueJob.c */
 int decode_DIS_QueueJob(struct tcp_chan *chan, struct batch_request *preq);
+int decode_DIS_SubmitJob(struct tcp_chan *chan, struct batch_request *preq);
+int decode_DIS_SubmitMany(struct tcp_chan *chan, struct batch_request *preq);
 
 /* dec_Reg.c */
 int decode_DIS_Register(struct tcp_chan *chan, struct batch_request *preq);
@@ -183,6 +211,9 @@ int encode_DIS_JobCred(struct tcp_chan *chan, int type, char *cred, int len);
 /* enc_JobFile.c */
 int encode_DIS_JobFile(struct tcp_chan *chan, int seq, char *buf, int len, char *jobid, int which);
 
+/* enc_JobEvent.c */
+int encode_DIS_JobEvent(struct tcp_chan *chan, const char *job_id, char state, int exit_status, int flags);
+
 /* enc_JobId.c */
 int encode_DIS_JobId(struct tcp_chan *chan, char *jobid);
 
@@ -206,6 +237,7 @@ int encode_DIS_Register(struct tcp_chan *chan, struct batch_request *preq);
 
 /* enc_ReqExt.c */
 int encode_DIS_ReqExtend(struct tcp_chan *chan, char *extend);
+int encode_DIS_ReqExtend_flags(struct tcp_chan *chan, char *extend, int flags);
 
 /* enc_ReqHdr.c */
 int encode_DIS_ReqHdr(struct tcp_chan *chan, int reqt, char *user);
@@ -215,6 +247,7 @@ int encode_DIS_ReturnFiles(struct tcp_chan *chan, struct batch_request *preq);
 
 /* enc_RunJob.c */
 int encode_DIS_RunJob(struct tcp_chan *chan, char *jobid, char *where, unsigned int resch); 
+int encode_DIS_RunJobs(struct tcp_chan *chan, int count, char **jobids, char **wheres);
 
 /* enc_Shut.c */
 int encode_DIS_ShutDown(struct tcp_chan *chan, int manner); 
@@ -236,6 +269,8 @@ int encode_DIS_attropl(struct tcp_chan *chan, struct attropl *pattropl);
 
 /* enc_reply.c */
 int encode_DIS_reply(struct tcp_chan *chan, struct batch_reply *reply);
+int encode_DIS_status_stream(struct tcp_chan *chan, tlist_head *status);
+int encode_DIS_status_stream_end(struct tcp_chan *chan, int code, int auxcode);
 
 /* enc_svrattrl.c */
 int encode_DIS_svrattrl(struct tcp_chan *chan, svrattrl *psattl);
@@ -258,6 +293,8 @@ void free_pidlist(struct pidl *pl);
 /* ssize_t write_nonblocking_socket(int fd, const void *buf, ssize_t count);  */
 /* ssize_t read_nonblocking_socket(int fd, void *buf, ssize_t count); */
 extern ssize_t write_ac_socket(int, const void *, ssize_t);
+struct iovec;
+extern ssize_t writev_ac_socket(int, const struct iovec *, int);
 extern ssize_t read_ac_socket(int, void *, ssize_t);
 
 ssize_t read_blocking_socket(int fd, void *buf, ssize_t count);
@@ -326,6 +363,14 @@ int pbs_orderjob_err(int c, char *job1, char *job2, char *extend, int *);
 /* pbsD_rerunjo.c */
 int pbs_rerunjob_err(int c, char *jobid, char *extend, int *);
 
+/* pbsD_session.c */
+int PBSD_session_tag(int sock, unsigned int *tag);
+struct batch_reply *PBSD_session_rdrpy(int *local_errno, int c);
+void PBSD_session_free(struct pbs_session *ps);
+
+/* pbsD_subscribe.c */
+int pbs_subscribe_err(int c, char *job_id, char *extend, int *);
+
 /* pbsD_resc.c */
 /* static int encode_DIS_Resc(int sock, char **rlist, int ct, resource_t rh); */
 /* static int PBS_resc(int c, int reqtype, char **rescl, int ct, resource_t rh); */
@@ -429,6 +474,11 @@ int tcp_wcommit(struct tcp_chan *chan, int commit_flag);
 int lock_all_channels();
 int unlock_all_channels(); 
 struct tcp_chan * DIS_tcp_setup(int fd);
+struct tcp_chan * DIS_buf_setup(void);
+char *DIS_buf_data(struct tcp_chan *chan, size_t *len);
+size_t DIS_tcp_wpending(struct tcp_chan *chan);
 void DIS_tcp_cleanup(struct tcp_chan *chan);
+void DIS_tcp_set_encoding(int fd, int encoding);
+int DIS_tcp_get_encoding(int fd);
 
 
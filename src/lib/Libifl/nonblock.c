@@ -11,6 +11,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <time.h>
+#include <sys/uio.h>
 
 /*
  * Assumes full-block read/write.  No accounting for partial blocks,
@@ -67,6 +68,58 @@ ssize_t write_ac_socket(
 
 
 
+/*
+ * writev_ac_socket - write_ac_socket() for a scatter-gather list
+ */
+
+ssize_t writev_ac_socket(
+
+  int                 fd,     /* I */
+  const struct iovec *iov,    /* I */
+  int                 iovcnt) /* I */
+
+  {
+  ssize_t i;
+  time_t  start, now;
+
+  /* Set a timer to prevent an infinite loop here. */
+  time(&now);
+  start = now;
+
+  for (;;)
+    {
+    i = writev(fd, iov, iovcnt);
+
+    if (i >= 0)
+      {
+      /* successfully wrote 'i' bytes */
+
+      return(i);
+      }
+
+    if (errno != EAGAIN)
+      {
+      /* write failed */
+
+      return(i);
+      }
+
+    time(&now);
+    if ((now - start) > 30)
+      {
+      /* timed out */
+
+      return(i);
+      }
+    }    /* END for () */
+
+  /*NOTREACHED*/
+
+  return(0);
+  }  /* END writev_ac_socket() */
+
+
+
 ssize_t read_ac_socket(
 
   int     fd,
@@ -887,6 +887,29 @@ int trq_set_preferred_network_interface(
 
 
 
+/*
+ * alloc_connection_mutex() - allocate the mutex of a connection table entry
+ *
+ * The mutex is error checking so PBSD_session_rdrpy() can tell whether its
+ * caller holds it.
+ */
+
+static pthread_mutex_t *alloc_connection_mutex(void)
+
+  {
+  pthread_mutex_t     *mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutexattr_t  attr;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ERRORCHECK);
+  pthread_mutex_init(mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+
+  return(mutex);
+  } /* END alloc_connection_mutex() */
+
+
+
 
 /* returns socket descriptor or negative value (-1) on failure */
 
@@ -947,10 +970,7 @@ int pbs_original_connect(
   for (i = 1;i < NCONNECTS;i++)
     {
     if (connection[i].ch_mutex == NULL)
-      {
-      connection[i].ch_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
-      pthread_mutex_init(connection[i].ch_mutex,NULL);
-      }
+      connection[i].ch_mutex = alloc_connection_mutex();
 
     pthread_mutex_lock(connection[i].ch_mutex);
 
@@ -1434,6 +1454,9 @@ int pbs_original_connect(
       }
     } /* END if !use_unixsock */
 
+  /* requests start out classic until the server answers in binary */
+  DIS_tcp_set_encoding(connection[out].ch_socket, DIS_ENCODING_CLASSIC);
+
   pthread_mutex_unlock(connection[out].ch_mutex);
 
   return(out);
@@ -1494,6 +1517,8 @@ int pbs_disconnect_socket(
 
   if (chan != NULL)
     DIS_tcp_cleanup(chan);
+
+  DIS_tcp_set_encoding(sock, DIS_ENCODING_CLASSIC);
   close(sock);
   return(0);
   }  /* END pbs_disconnect_socket() */
@@ -1512,10 +1537,25 @@ int pbs_disconnect(
 
   pthread_mutex_lock(connection[connect].ch_mutex);
 
-  /* send close-connection message */
   sock = connection[connect].ch_socket;
 
-  pbs_disconnect_socket(sock);
+  if (connection[connect].ch_stream != NULL)
+    {
+    /* a job event stream has no request/reply exchange left to close */
+    DIS_tcp_cleanup((struct tcp_chan *)connection[connect].ch_stream);
+    connection[connect].ch_stream = NULL;
+
+    DIS_tcp_set_encoding(sock, DIS_ENCODING_CLASSIC);
+    close(sock);
+    }
+  else
+    {
+    /* send close-connection message */
+    pbs_disconnect_socket(sock);
+
+    PBSD_session_free(connection[connect].ch_session);
+    connection[connect].ch_session = NULL;
+    }
 
   if (connection[connect].ch_errtxt != (char *)NULL)
     {
@@ -1686,8 +1726,7 @@ void initialize_connections_table()
 
   for (i = 1;i < PBS_NET_MAX_CONNECTIONS;i++)
     {
-    connection[i].ch_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
-    pthread_mutex_init(connection[i].ch_mutex, NULL);
+    connection[i].ch_mutex = alloc_connection_mutex();
     }
   } /* END initialize_connections_table() */
 
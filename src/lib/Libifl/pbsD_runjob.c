@@ -84,6 +84,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "libpbs.h"
 #include "dis.h"
 #include "tcp.h" /* tcp_chan */
@@ -235,4 +236,188 @@ int pbs_runjob(
 
 
 
+/*
+ * PBSD_runjobs() - send up to RUN_JOBS_MAX jobs in one Run Jobs request
+ *
+ * The reply holds a line per job with its error code followed by its job
+ * id or an error message; the codes are copied to return_codes.
+ * As with PBSD_SubmitMany_hash(), PBSE_NOSUP means the server closed the
+ * connection without understanding the request.
+ */
+
+static int PBSD_runjobs(
+
+  int   c,
+  int   count,
+  char **jobids,
+  char **locations,
+  char  *extend,
+  int   *return_codes) /* O */
+
+  {
+  struct batch_reply *reply;
+  int                 rc = PBSE_NONE;
+  int                 i;
+  int                 sock;
+  char               *line;
+  char               *end;
+  struct tcp_chan    *chan = NULL;
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  sock = connection[c].ch_socket;
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+    return(PBSE_PROTOCOL);
+    }
+  else if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_RunJobs, pbs_current_user)) ||
+           (rc = encode_DIS_RunJobs(chan, count, jobids, locations)) ||
+           (rc = encode_DIS_ReqExtend(chan, extend)))
+    {
+    if ((connection[c].ch_errtxt == NULL) &&
+        (rc >= 0) &&
+        (rc <= DIS_INVALID))
+      connection[c].ch_errtxt = strdup(dis_emsg[rc]);
+
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(PBSE_PROTOCOL);
+    }
+
+  if ((rc = DIS_tcp_wflush(chan)) != PBSE_NONE)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+
+    DIS_tcp_cleanup(chan);
+
+    return(PBSE_PROTOCOL);
+    }
+
+  DIS_tcp_cleanup(chan);
+
+  reply = PBSD_rdrpy(&rc, c);
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  if (reply == NULL)
+    {
+    if (rc == PBSE_TIMEOUT)
+      rc = PBSE_EXPIRED;
+    else
+      rc = PBSE_NOSUP;
+    }
+  else if ((rc == PBSE_UNKREQ) ||
+           (rc == PBSE_DISPROTO))
+    {
+    rc = PBSE_NOSUP;
+    }
+  else if (rc == PBSE_NONE)
+    {
+    if ((reply->brp_choice != BATCH_REPLY_CHOICE_Text) ||
+        (reply->brp_un.brp_txt.brp_str == NULL))
+      {
+      rc = PBSE_PROTOCOL;
+      }
+    else
+      {
+      /* one "<code> <job id or message>" line per job, in order */
+      line = reply->brp_un.brp_txt.brp_str;
+
+      for (i = 0; i < count; i++)
+        {
+        if ((line == NULL) || (*line == '\0'))
+          {
+          return_codes[i] = PBSE_PROTOCOL;
+          continue;
+          }
+
+        end = strchr(line, '\n');
+
+        return_codes[i] = strtol(line, NULL, 10);
+
+        line = (end != NULL) ? end + 1 : NULL;
+        }
+      }
+    }
+
+  PBSD_FreeReply(reply);
+
+  return(rc);
+  }  /* END PBSD_runjobs() */
+
+
+
+
+/*
+ * pbs_runjobs() - run many jobs with as few requests as possible
+ *
+ * Jobs are sent RUN_JOBS_MAX at a time in Run Jobs requests, so the server
+ * can assign the nodes of all of them before it starts sending them to
+ * their moms. Each job gets its own result in return_codes: PBSE_NONE if
+ * the job was started, else the error its run was rejected with. A job
+ * whose code is PBSE_NOSUP was not sent because an earlier request failed.
+ *
+ * @param locs - the location to run each job at, the array and its
+ * entries may be NULL
+ * @return PBSE_NONE if every request got a reply, else the request's error;
+ * PBSE_NOSUP means the server doesn't know the request and has closed the
+ * connection.
+ */
+
+int pbs_runjobs(
+
+  int    c,
+  int    count,
+  char **jobids,
+  char **locs,
+  char  *extend,
+  int   *return_codes) /* O */
+
+  {
+  int   rc = PBSE_NONE;
+  int   i;
+  int   next;
+  int   batch;
+  char *locations[RUN_JOBS_MAX];
+
+  if ((c < 0) || 
+      (c >= PBS_NET_MAX_CONNECTIONS) ||
+      (count < 0))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+    if ((jobids[i] == NULL) ||
+        (*jobids[i] == '\0'))
+      return(PBSE_IVALREQ);
+
+    return_codes[i] = PBSE_NOSUP;
+    }
+
+  for (next = 0; (next < count) && (rc == PBSE_NONE); next += batch)
+    {
+    batch = count - next;
+
+    if (batch > RUN_JOBS_MAX)
+      batch = RUN_JOBS_MAX;
+
+    for (i = 0; i < batch; i++)
+      {
+      if ((locs == NULL) ||
+          (locs[next + i] == NULL))
+        locations[i] = (char *)"";
+      else
+        locations[i] = locs[next + i];
+      }
+
+    rc = PBSD_runjobs(c, batch, jobids + next, locations, extend, return_codes + next);
+    }
 
+  return(rc);
+  }  /* END pbs_runjobs() */
@@ -0,0 +1,478 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+/* pbs_subscribe.c
+/*
+ * pbsD_session.c
+ *
+ * Open a long-lived, multiplexed connection to the server.
+ *
+ * The connection returned by pbs_session_open() is used with the usual
+ * pbs_* calls, from as many threads as the caller likes.  Each request on
+ * it is preceded by a tag, and the server sends the reply to it preceded by
+ * the same tag, so a thread waiting for its reply lets the others send
+ * theirs in the meantime, and the server works on them concurrently.
+ * Whichever waiting thread finds nobody reading reads the next reply and
+ * hands it to the thread it belongs to.  The client connects and is
+ * authenticated once, however many requests it sends.
+ *
+ * Job event subscriptions and streamed status replies aren't available on
+ * a session; pbs_subscribe() needs a connection of its own.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <map>
+#include "libpbs.h"
+#include "dis.h"
+#include "tcp.h" /* tcp_chan */
+#include "server_limits.h"
+#include "lib_ifl.h"
+
+
+struct pbs_session
+  {
+  pthread_mutex_t  ps_mutex;
+  pthread_cond_t   ps_cond;     /* signalled when a reply is read */
+  struct tcp_chan *ps_chan;     /* kept since replies may arrive together */
+  unsigned int     ps_next_tag;
+  bool             ps_reading;  /* a thread is reading a reply */
+  int              ps_error;    /* the replies can no longer be read */
+
+  /* the outstanding tags, with their replies once they're read */
+  std::map<unsigned int, struct batch_reply *> ps_replies;
+  };
+
+/* the tag of the last request this thread sent on a session */
+static __thread unsigned int session_tag = 0;
+
+
+
+/*
+ * PBSD_session_tag() - get the tag for the next request on sock
+ *
+ * @return TRUE with *tag set if sock is a session, FALSE otherwise
+ */
+
+int PBSD_session_tag(
+
+  int           sock, /* I */
+  unsigned int *tag)  /* O */
+
+  {
+  struct pbs_session *ps = NULL;
+  int                 c;
+
+  /* pbs_original_connect() only hands out the first NCONNECTS entries */
+  for (c = 1; c < NCONNECTS; c++)
+    {
+    if ((connection[c].ch_inuse == TRUE) &&
+        (connection[c].ch_socket == sock) &&
+        (connection[c].ch_session != NULL))
+      {
+      ps = connection[c].ch_session;
+      break;
+      }
+    }
+
+  if (ps == NULL)
+    return(FALSE);
+
+  pthread_mutex_lock(&ps->ps_mutex);
+
+  session_tag = ps->ps_next_tag++;
+  ps->ps_replies[session_tag] = NULL;
+
+  pthread_mutex_unlock(&ps->ps_mutex);
+
+  *tag = session_tag;
+
+  return(TRUE);
+  } /* END PBSD_session_tag() */
+
+
+
+/*
+ * session_read_reply() - read the next tagged reply from the server
+ */
+
+static int session_read_reply(
+
+  struct tcp_chan     *chan,  /* I */
+  unsigned int        *tag,   /* O */
+  struct batch_reply **reply) /* O */
+
+  {
+  int                 rc;
+  struct batch_reply *rp;
+
+  chan->encoding = DIS_ENCODING_CLASSIC;
+
+  *tag = disrui(chan, &rc);
+
+  if (rc == DIS_SUCCESS)
+    {
+    if ((rp = (struct batch_reply *)calloc(1, sizeof(struct batch_reply))) == NULL)
+      return(PBSE_SYSTEM);
+
+    if ((rc = decode_DIS_replyCmd(chan, rp)) == DIS_SUCCESS)
+      {
+      /* a streamed reply can't be shared with the other requests */
+      if ((rp->brp_choice == BATCH_REPLY_CHOICE_StatusStream) ||
+          (rp->brp_choice == BATCH_REPLY_CHOICE_EventStream))
+        {
+        PBSD_FreeReply(rp);
+        return(PBSE_PROTOCOL);
+        }
+
+      *reply = rp;
+      return(PBSE_NONE);
+      }
+
+    PBSD_FreeReply(rp);
+    }
+
+  if (chan->IsTimeout == TRUE)
+    return(PBSE_TIMEOUT);
+
+  return(PBSE_PROTOCOL);
+  } /* END session_read_reply() */
+
+
+
+/*
+ * PBSD_session_rdrpy() - read the reply to the last request this thread
+ * sent on session c
+ *
+ * Called from PBSD_rdrpy() in place of reading the socket directly.  The
+ * connection's mutex, if the caller holds it, is let go while waiting so
+ * the other threads may send their requests.
+ */
+
+struct batch_reply *PBSD_session_rdrpy(
+
+  int *local_errno, /* O */
+  int  c)           /* I */
+
+  {
+  struct pbs_session *ps = connection[c].ch_session;
+  struct batch_reply *reply = NULL;
+  struct batch_reply *other;
+  unsigned int        tag = session_tag;
+  unsigned int        other_tag;
+  int                 rc = PBSE_NONE;
+  bool                held;
+  const char         *the_msg;
+
+  std::map<unsigned int, struct batch_reply *>::iterator it;
+
+  /* the mutex is error checking, this fails if the caller doesn't hold it */
+  held = (pthread_mutex_unlock(connection[c].ch_mutex) == 0);
+
+  pthread_mutex_lock(&ps->ps_mutex);
+
+  while (true)
+    {
+    if ((it = ps->ps_replies.find(tag)) == ps->ps_replies.end())
+      {
+      /* no request of ours is outstanding */
+      rc = PBSE_IVALREQ;
+      break;
+      }
+
+    if (it->second != NULL)
+      {
+      reply = it->second;
+      ps->ps_replies.erase(it);
+      break;
+      }
+
+    if (ps->ps_error != PBSE_NONE)
+      {
+      rc = ps->ps_error;
+      ps->ps_replies.erase(it);
+      break;
+      }
+
+    if (ps->ps_reading == true)
+      {
+      pthread_cond_wait(&ps->ps_cond, &ps->ps_mutex);
+      continue;
+      }
+
+    ps->ps_reading = true;
+
+    pthread_mutex_unlock(&ps->ps_mutex);
+
+    other = NULL;
+    rc = session_read_reply(ps->ps_chan, &other_tag, &other);
+
+    pthread_mutex_lock(&ps->ps_mutex);
+
+    ps->ps_reading = false;
+
+    if (rc != PBSE_NONE)
+      {
+      /* a partly read reply leaves the socket out of step for good */
+      ps->ps_error = rc;
+      }
+    else if (((it = ps->ps_replies.find(other_tag)) != ps->ps_replies.end()) &&
+             (it->second == NULL))
+      {
+      it->second = other;
+      }
+    else
+      {
+      /* nobody is waiting for it */
+      PBSD_FreeReply(other);
+      }
+
+    rc = PBSE_NONE;
+
+    pthread_cond_broadcast(&ps->ps_cond);
+    }
+
+  pthread_mutex_unlock(&ps->ps_mutex);
+
+  if (held == true)
+    pthread_mutex_lock(connection[c].ch_mutex);
+
+  if (reply == NULL)
+    {
+    *local_errno = rc;
+    connection[c].ch_errno = rc;
+
+    if ((the_msg = pbs_strerror(rc)) != NULL)
+      connection[c].ch_errtxt = strdup(the_msg);
+
+    return(NULL);
+    }
+
+  connection[c].ch_errno = reply->brp_code;
+
+  *local_errno = reply->brp_code;
+
+  if (reply->brp_choice == BATCH_REPLY_CHOICE_Text)
+    {
+    if ((the_msg = reply->brp_un.brp_txt.brp_str) != NULL)
+      {
+      connection[c].ch_errtxt = strdup(the_msg);
+      }
+    }
+
+  return(reply);
+  } /* END PBSD_session_rdrpy() */
+
+
+
+/*
+ * PBSD_session_free() - free a session once its socket is closed
+ */
+
+void PBSD_session_free(
+
+  struct pbs_session *ps)
+
+  {
+  std::map<unsigned int, struct batch_reply *>::iterator it;
+
+  if (ps == NULL)
+    return;
+
+  for (it = ps->ps_replies.begin(); it != ps->ps_replies.end(); it++)
+    {
+    if (it->second != NULL)
+      PBSD_FreeReply(it->second);
+    }
+
+  if (ps->ps_chan != NULL)
+    DIS_tcp_cleanup(ps->ps_chan);
+
+  pthread_cond_destroy(&ps->ps_cond);
+  pthread_mutex_destroy(&ps->ps_mutex);
+
+  delete ps;
+  } /* END PBSD_session_free() */
+
+
+
+/*
+ * pbs_session_open() - connect to server and open a session on the
+ * connection
+ *
+ * A server that doesn't know about sessions gets a plain connection, which
+ * works the same, just one request at a time.  Note such a server doesn't
+ * reply to the OpenSession request at all, so that takes the client's tcp
+ * timeout.
+ *
+ * @return the connection, or a negative PBSE_* code like pbs_connect()
+ */
+
+int pbs_session_open(
+
+  char *server)
+
+  {
+  int                 c;
+  int                 rc = PBSE_NONE;
+  int                 local_errno = 0;
+  struct tcp_chan    *chan;
+  struct batch_reply *reply;
+  struct pbs_session *ps;
+
+  if ((c = pbs_connect(server)) < 0)
+    return(c);
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  if ((chan = DIS_tcp_setup(connection[c].ch_socket)) == NULL)
+    rc = PBSE_MEM_MALLOC;
+  else
+    {
+    if ((encode_DIS_ReqHdr(chan, PBS_BATCH_OpenSession, pbs_current_user)) ||
+        (encode_DIS_ReqExtend(chan, NULL)) ||
+        (DIS_tcp_wflush(chan)))
+      rc = PBSE_PROTOCOL;
+
+    DIS_tcp_cleanup(chan);
+    }
+
+  if (rc == PBSE_NONE)
+    {
+    reply = PBSD_rdrpy(&local_errno, c);
+
+    if ((rc = connection[c].ch_errno) == PBSE_NONE)
+      {
+      if (reply == NULL)
+        rc = PBSE_PROTOCOL;
+      else
+        {
+        ps = new pbs_session();
+
+        pthread_mutex_init(&ps->ps_mutex, NULL);
+        pthread_cond_init(&ps->ps_cond, NULL);
+        ps->ps_chan = DIS_tcp_setup(connection[c].ch_socket);
+        ps->ps_next_tag = 1;
+        ps->ps_reading = false;
+        ps->ps_error = PBSE_NONE;
+
+        if (ps->ps_chan == NULL)
+          {
+          PBSD_session_free(ps);
+          rc = PBSE_MEM_MALLOC;
+          }
+        else
+          connection[c].ch_session = ps;
+        }
+      }
+
+    PBSD_FreeReply(reply);
+    }
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  if (rc == PBSE_NONE)
+    return(c);
+
+  pbs_disconnect(c);
+
+  if ((rc == PBSE_UNKREQ) ||
+      (rc == PBSE_DISPROTO) ||
+      (rc == PBSE_PROTOCOL) ||
+      (rc == PBSE_TIMEOUT))
+    {
+    /* the server doesn't do sessions */
+    return(pbs_connect(server));
+    }
+
+  return(-1 * rc);
+  } /* END pbs_session_open() */
+
+
+
+int pbs_session_close(
+
+  int c)
+
+  {
+  return(pbs_disconnect(c));
+  } /* END pbs_session_close() */
@@ -90,11 +90,15 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include "libpbs.h"
 #include "u_hash_map_structs.h"
 #include "server_limits.h"
+#include "../lib/Libifl/lib_ifl.h"
 
 int pbs_submit_hash(
 
@@ -187,6 +191,238 @@ int pbs_submit_hash(
   return rc;
   }  /* END pbs_submit() */
 
+
+
+
+/*
+ * read_job_script() - read a script of at most one script chunk into memory
+ *
+ * @return PBSE_NONE, PBSE_BADSCRIPT, PBSE_MEM_MALLOC or PBSE_NOSUP if the
+ * script is too large to be sent in a single request
+ */
+
+static int read_job_script(
+
+  const char *script,  /* I (may be NULL or empty) */
+  char      **buf,     /* O (free'd by the caller) */
+  size_t     *len)     /* O */
+
+  {
+  int         fd;
+  ssize_t     cc;
+  struct stat sb;
+
+  *buf = NULL;
+  *len = 0;
+
+  if ((script == NULL) || (*script == '\0'))
+    return(PBSE_NONE);
+
+  if ((fd = open(script, O_RDONLY, 0)) < 0)
+    return(PBSE_BADSCRIPT);
+
+  if (fstat(fd, &sb) != 0)
+    {
+    close(fd);
+    return(PBSE_BADSCRIPT);
+    }
+
+  if (sb.st_size > SCRIPT_CHUNK_Z)
+    {
+    close(fd);
+    return(PBSE_NOSUP);
+    }
+
+  if ((*buf = (char *)calloc(1, sb.st_size + 1)) == NULL)
+    {
+    close(fd);
+    return(PBSE_MEM_MALLOC);
+    }
+
+  cc = read_ac_socket(fd, *buf, sb.st_size);
+
+  close(fd);
+
+  if (cc != sb.st_size)
+    {
+    free(*buf);
+    *buf = NULL;
+    return(PBSE_BADSCRIPT);
+    }
+
+  *len = cc;
+
+  return(PBSE_NONE);
+  }  /* END read_job_script() */
+
+
+
+
+/*
+ * pbs_submit_commit_hash() - submit and commit a job in one round trip
+ *
+ * The script is read into memory and sent along with the attributes in a
+ * single Submit Job request.  PBSE_NOSUP is returned, before anything is
+ * sent, if the script is larger than one script chunk, and after the
+ * request if the server does not support it.  In the latter case the
+ * server has closed the connection, so the caller must reconnect before
+ * falling back to pbs_submit_hash().
+ */
+
+int pbs_submit_commit_hash(
+
+  int                 socket,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char               *script,
+  char               *destination,
+  char               *extend,  /* (optional) */
+  char              **return_jobid,
+  char              **msg)
+
+  {
+  int     rc = PBSE_NONE;
+  char   *buf = NULL;
+  size_t  len = 0;
+
+  if ((socket < 0) || 
+      (socket >= PBS_NET_MAX_CONNECTIONS))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  if ((rc = read_job_script(script, &buf, &len)) != PBSE_NONE)
+    return(rc);
+
+  rc = PBSD_SubmitJob_hash(socket, destination, job_attr, res_attr, buf, len, extend, return_jobid, msg);
+
+  free(buf);
+
+  return(rc);
+  }  /* END pbs_submit_commit_hash() */
+
+
+
+
+/*
+ * pbs_submit_many() - submit many jobs with as few requests as possible
+ *
+ * Jobs are sent SUBMIT_MANY_MAX at a time in Submit Many requests. Each
+ * job gets its own result: return_codes[i] is PBSE_NONE and
+ * return_jobids[i] the new job id (free'd by the caller), or the error the
+ * job was rejected with.  A job whose code is PBSE_NOSUP was not sent,
+ * because its script is too large or the request failed before the job's
+ * turn, and must be submitted on its own.
+ *
+ * @return PBSE_NONE if every request got a reply, else the request's error;
+ * PBSE_NOSUP means the server doesn't know the request and has closed the
+ * connection.
+ */
+
+int pbs_submit_many(
+
+  int                  socket,
+  int                  count,
+  job_data_container **job_attrs,
+  job_data_container **res_attrs,
+  char               **scripts,       /* script file names (entries may be NULL) */
+  char               **destinations,
+  char                *extend,        /* (optional) */
+  char               **return_jobids, /* O */
+  int                 *return_codes)  /* O */
+
+  {
+  int                  rc = PBSE_NONE;
+  int                  i;
+  int                  next = 0;
+  int                  batch;
+  int                  index[SUBMIT_MANY_MAX];
+  char                *destins[SUBMIT_MANY_MAX];
+  job_data_container  *jattrs[SUBMIT_MANY_MAX];
+  job_data_container  *rattrs[SUBMIT_MANY_MAX];
+  char                *bufs[SUBMIT_MANY_MAX];
+  size_t               lens[SUBMIT_MANY_MAX];
+
+  if ((socket < 0) || 
+      (socket >= PBS_NET_MAX_CONNECTIONS) ||
+      (count < 0))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  for (i = 0; i < count; i++)
+    {
+    return_jobids[i] = NULL;
+    return_codes[i] = PBSE_NOSUP;
+    }
+
+  while ((next < count) &&
+         (rc == PBSE_NONE))
+    {
+    char *results = NULL;
+    char *line;
+    char *end;
+
+    /* gather the next batch of jobs whose scripts can be sent inline */
+    for (batch = 0; (next < count) && (batch < SUBMIT_MANY_MAX); next++)
+      {
+      if ((return_codes[next] = read_job_script(scripts[next], &bufs[batch], &lens[batch])) != PBSE_NONE)
+        continue;
+
+      return_codes[next] = PBSE_NOSUP;
+      index[batch]   = next;
+      destins[batch] = (destinations[next] != NULL) ? destinations[next] : (char *)"";
+      jattrs[batch]  = job_attrs[next];
+      rattrs[batch]  = res_attrs[next];
+      batch++;
+      }
+
+    if (batch == 0)
+      break;
+
+    rc = PBSD_SubmitMany_hash(socket, batch, destins, jattrs, rattrs, bufs, lens, extend, &results);
+
+    for (i = 0; i < batch; i++)
+      free(bufs[i]);
+
+    if (rc != PBSE_NONE)
+      break;
+
+    /* one "<code> <job id or message>" line per job, in order */
+    line = results;
+
+    for (i = 0; i < batch; i++)
+      {
+      if ((line == NULL) || (*line == '\0'))
+        {
+        return_codes[index[i]] = PBSE_PROTOCOL;
+        continue;
+        }
+
+      if ((end = strchr(line, '\n')) != NULL)
+        *end = '\0';
+
+      return_codes[index[i]] = strtol(line, &line, 10);
+
+      if (return_codes[index[i]] == PBSE_NONE)
+        {
+        while (*line == ' ')
+          line++;
+
+        return_jobids[index[i]] = strdup(line);
+        }
+
+      line = (end != NULL) ? end + 1 : NULL;
+      }
+
+    free(results);
+    }
+
+  return(rc);
+  }  /* END pbs_submit_many() */
+
+
+
 int pbs_submit_hash_ext(
   int                socket,
   void               *job_attr,
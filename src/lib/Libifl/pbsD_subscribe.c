@@ -0,0 +1,285 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+/* pbs_subscribe.c
+ *
+ * Subscribe to the job events of the server and read them.
+ *
+ * Once pbs_subscribe() succeeds the connection only carries job events:
+ * the server pushes one each time a job changes state or is purged, and
+ * they're read with pbs_next_event() until the connection is closed with
+ * pbs_disconnect(). Open a separate connection for other requests.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <poll.h>
+#include "libpbs.h"
+#include "dis.h"
+#include "tcp.h" /* tcp_chan */
+#include "server_limits.h"
+
+
+
+/*
+ * pbs_subscribe_err() - subscribe to the job events of one job, or of
+ * every job the user may see if job_id is NULL or empty
+ */
+
+int pbs_subscribe_err(
+
+  int   c,
+  char *job_id,
+  char *extend,
+  int  *local_errno)
+
+  {
+  int                 rc;
+
+  struct batch_reply *reply;
+  int                 sock;
+  struct tcp_chan    *chan = NULL;
+  struct tcp_chan    *stream = NULL;
+
+  if ((c < 0) || 
+      (c >= PBS_NET_MAX_CONNECTIONS))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  if (job_id == NULL)
+    job_id = (char *)"";
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  if (connection[c].ch_stream != NULL)
+    {
+    /* already subscribed */
+    pthread_mutex_unlock(connection[c].ch_mutex);
+    *local_errno = PBSE_IVALREQ;
+    return(PBSE_IVALREQ);
+    }
+
+  sock = connection[c].ch_socket;
+
+  if ((chan = DIS_tcp_setup(sock)) == NULL)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+    rc = PBSE_PROTOCOL;
+    return rc;
+    }
+  else if ((rc = encode_DIS_ReqHdr(chan, PBS_BATCH_SubscribeJobs, pbs_current_user)) ||
+           (rc = encode_DIS_JobId(chan, job_id)) ||
+           (rc = encode_DIS_ReqExtend(chan, extend)))
+    {
+    connection[c].ch_errtxt = strdup(dis_emsg[rc]);
+
+    pthread_mutex_unlock(connection[c].ch_mutex);
+    DIS_tcp_cleanup(chan);
+    return (PBSE_PROTOCOL);
+    }
+
+  if (DIS_tcp_wflush(chan))
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+    DIS_tcp_cleanup(chan);
+    return (PBSE_PROTOCOL);
+    }
+
+  DIS_tcp_cleanup(chan);
+
+  /* events sent right after the reply may already be buffered on the
+   * channel the reply is read from, so that channel is kept */
+  reply = PBSD_rdrpy_stream(local_errno, c, &stream);
+
+  rc = connection[c].ch_errno;
+
+  if ((reply != NULL) &&
+      (rc == PBSE_NONE) &&
+      (reply->brp_choice != BATCH_REPLY_CHOICE_EventStream))
+    {
+    rc = PBSE_PROTOCOL;
+    connection[c].ch_errno = rc;
+    *local_errno = rc;
+    }
+
+  if ((stream != NULL) &&
+      (rc != PBSE_NONE))
+    {
+    DIS_tcp_cleanup(stream);
+    stream = NULL;
+    }
+
+  connection[c].ch_stream = stream;
+
+  PBSD_FreeReply(reply);
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  return(rc);
+  } /* END pbs_subscribe_err() */
+
+
+
+int pbs_subscribe(
+
+  int   c,
+  char *job_id,
+  char *extend)
+
+  {
+  pbs_errno = 0;
+
+  return(pbs_subscribe_err(c, job_id, extend, &pbs_errno));
+  } /* END pbs_subscribe() */
+
+
+
+/*
+ * pbs_next_event() - read the next job event from a subscribed connection
+ *
+ * Waits up to timeout seconds for the event, or indefinitely if timeout is
+ * negative.
+ *
+ * @return PBSE_NONE with *event filled in, PBSE_TIMEOUT if no event came,
+ * or PBSE_PROTOCOL if the connection was lost, in which case it should be
+ * disconnected
+ */
+
+int pbs_next_event(
+
+  int                   c,       /* I */
+  struct pbs_job_event *event,   /* O */
+  int                   timeout) /* I (seconds) */
+
+  {
+  struct tcp_chan *chan;
+  struct pollfd    pfd;
+  int              rc;
+
+  if ((c < 0) || 
+      (c >= PBS_NET_MAX_CONNECTIONS) ||
+      (event == NULL))
+    {
+    return(PBSE_IVALREQ);
+    }
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+
+  if ((chan = (struct tcp_chan *)connection[c].ch_stream) == NULL)
+    {
+    pthread_mutex_unlock(connection[c].ch_mutex);
+    return(PBSE_IVALREQ);
+    }
+
+  if (tcp_chan_has_data(chan) == FALSE)
+    {
+    pfd.fd = connection[c].ch_socket;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    rc = poll(&pfd, 1, (timeout < 0) ? -1 : timeout * 1000);
+
+    if (rc <= 0)
+      {
+      pthread_mutex_unlock(connection[c].ch_mutex);
+
+      if ((rc == 0) ||
+          (errno == EINTR))
+        return(PBSE_TIMEOUT);
+
+      return(PBSE_SYSTEM);
+      }
+    }
+
+  /* a partly read event leaves the stream out of step, so any failure
+   * here means the connection is no longer usable */
+  if (decode_DIS_JobEvent(chan, event) != DIS_SUCCESS)
+    rc = PBSE_PROTOCOL;
+  else
+    rc = PBSE_NONE;
+
+  connection[c].ch_errno = rc;
+
+  pthread_mutex_unlock(connection[c].ch_mutex);
+
+  return(rc);
+  } /* END pbs_next_event() */
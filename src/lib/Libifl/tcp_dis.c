@@ -88,6 +88,8 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <sys/uio.h>
 #include "../lib/Libifl/lib_ifl.h" /* DIS_tcp_setup, DIS_tcp_cleanup */
 
 
@@ -109,6 +111,153 @@
 #define MAX_SOCKETS 65536
 time_t pbs_tcp_timeout = 300;  
 
+/* the encoding requests are sent with on each client socket */
+static unsigned char sock_encoding[MAX_SOCKETS];
+
+/*
+ * Channel buffers come from a pool of a few size classes so that setting
+ * up a connection does not calloc and zero two fresh buffers.  A write
+ * buffer that fills up is chained onto the channel as a segment and the
+ * next one comes from the class above, so a large reply is never copied
+ * into a bigger buffer; DIS_tcp_wflush() sends the chain with writev().
+ */
+
+#define TCP_POOL_CLASSES 4
+#define TCP_POOL_DEPTH   64
+#define TCP_MAX_IOV      64
+
+static const size_t tcp_pool_sizes[TCP_POOL_CLASSES] =
+  { 16384, 65536, THE_BUF_SIZE, 4 * THE_BUF_SIZE };
+
+/* free buffers kept per class, larger classes keep fewer */
+static const int    tcp_pool_limits[TCP_POOL_CLASSES] = { 64, 32, 8, 4 };
+
+static char            *tcp_pool[TCP_POOL_CLASSES][TCP_POOL_DEPTH];
+static int              tcp_pool_count[TCP_POOL_CLASSES];
+static pthread_mutex_t  tcp_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+/*
+ * tcp_pool_class - the smallest size class holding size bytes, -1 if none
+ */
+
+static int tcp_pool_class(
+
+  size_t size)
+
+  {
+  int i;
+
+  for (i = 0; i < TCP_POOL_CLASSES; i++)
+    {
+    if (size <= tcp_pool_sizes[i])
+      return(i);
+    }
+
+  return(-1);
+  }  /* END tcp_pool_class() */
+
+
+
+/*
+ * tcp_pool_get - get a buffer of at least size bytes
+ *
+ * The allocated size (the class size, or size itself when it is larger
+ * than every class) is returned in *alloc_size.  The buffer has room for
+ * a terminating NUL past that size.
+ */
+
+static char *tcp_pool_get(
+
+  size_t  size,        /* I */
+  size_t *alloc_size)  /* O */
+
+  {
+  char *buf = NULL;
+  int   cl = tcp_pool_class(size);
+
+  if (cl >= 0)
+    {
+    size = tcp_pool_sizes[cl];
+
+    pthread_mutex_lock(&tcp_pool_mutex);
+
+    if (tcp_pool_count[cl] > 0)
+      buf = tcp_pool[cl][--tcp_pool_count[cl]];
+
+    pthread_mutex_unlock(&tcp_pool_mutex);
+    }
+
+  if ((buf == NULL) &&
+      ((buf = (char *)malloc(size + 1)) == NULL))
+    return(NULL);
+
+  *buf = '\0';
+  *alloc_size = size;
+
+  return(buf);
+  }  /* END tcp_pool_get() */
+
+
+
+/*
+ * tcp_pool_put - give a buffer from tcp_pool_get() back
+ */
+
+static void tcp_pool_put(
+
+  char   *buf,   /* I (freed or pooled) */
+  size_t  size)  /* I */
+
+  {
+  int cl = tcp_pool_class(size);
+
+  if (buf == NULL)
+    return;
+
+  if ((cl >= 0) &&
+      (tcp_pool_sizes[cl] == size))
+    {
+    pthread_mutex_lock(&tcp_pool_mutex);
+
+    if (tcp_pool_count[cl] < tcp_pool_limits[cl])
+      {
+      tcp_pool[cl][tcp_pool_count[cl]++] = buf;
+      buf = NULL;
+      }
+
+    pthread_mutex_unlock(&tcp_pool_mutex);
+    }
+
+  free(buf);
+  }  /* END tcp_pool_put() */
+
+
+
+/*
+ * tcp_free_segs - release the full segments of a write buffer
+ */
+
+static void tcp_free_segs(
+
+  struct tcpdisbuf *tp)
+
+  {
+  struct tcpdisseg *seg;
+
+  while ((seg = tp->tdis_segs) != NULL)
+    {
+    tp->tdis_segs = seg->next;
+
+    tcp_pool_put(seg->data, seg->size);
+    free(seg);
+    }
+
+  tp->tdis_lastseg = NULL;
+  tp->tdis_seglen = 0;
+  }  /* END tcp_free_segs() */
+
 
 
 void DIS_tcp_settimeout(
@@ -123,11 +272,48 @@ void DIS_tcp_settimeout(
 
 
 
+/*
+ * DIS_tcp_set_encoding - set the encoding later requests on a socket are
+ * sent with
+ *
+ * A connection starts out DIS_ENCODING_CLASSIC and is switched once the
+ * server answers in binary, see decode_DIS_replyCmd(). The entry must be
+ * reset when the socket is connected or closed so that a reused fd starts
+ * over.
+ */
+
+void DIS_tcp_set_encoding(
+
+  int fd,        /* I */
+  int encoding)  /* I */
+
+  {
+  if ((fd >= 0) &&
+      (fd < MAX_SOCKETS))
+    sock_encoding[fd] = (unsigned char)encoding;
+  }  /* END DIS_tcp_set_encoding() */
+
+
+
+int DIS_tcp_get_encoding(
+
+  int fd)  /* I */
+
+  {
+  if ((fd < 0) ||
+      (fd >= MAX_SOCKETS))
+    return(DIS_ENCODING_CLASSIC);
+
+  return(sock_encoding[fd]);
+  }  /* END DIS_tcp_get_encoding() */
+
+
+
 /*
  * tcp_pack_buff - pack existing data into front of buffer
  *
  * Moves "uncommited" data to front of buffer and adjusts pointers.
- * Does a character by character move since data may over lap.
+ * Uses memmove() since data may over lap.
  */
 
 static void tcp_pack_buff(
@@ -137,7 +323,6 @@ static void tcp_pack_buff(
   {
   size_t amt;
   size_t start;
-  size_t i;
 
   start = tp->tdis_trailp - tp->tdis_thebuf;
 
@@ -145,10 +330,7 @@ static void tcp_pack_buff(
     {
     amt  = tp->tdis_eod - tp->tdis_trailp;
 
-    for (i = 0;i < amt;++i)
-      {
-      *(tp->tdis_thebuf + i) = *(tp->tdis_thebuf + i + start);
-      }
+    memmove(tp->tdis_thebuf, tp->tdis_trailp, amt);
     *(tp->tdis_thebuf + amt) = '\0';
 
     tp->tdis_leadp  -= start;
@@ -182,15 +364,15 @@ int tcp_read(
 
   {
   int               rc = PBSE_NONE;
-  unsigned long     newsize;
+  size_t            newsize;
   char             *ptr;
   int               tdis_buf_len = 0;
   int               max_read_len = 0;
   char             *new_data = NULL;
   struct tcpdisbuf *tp;
-  int               tmp_leadp = 0;
-  int               tmp_trailp = 0;
-  int               tmp_eod = 0;
+  size_t            tmp_leadp = 0;
+  size_t            tmp_trailp = 0;
+  size_t            tmp_eod = 0;
   char              err_msg[1024];
 
 
@@ -256,8 +438,16 @@ int tcp_read(
   /* data read is greater than buffer size */
   else if (max_read_len <= *read_len)
     {
-    newsize = (tdis_buf_len + *read_len) * 2;
-    if ((ptr = (char *)calloc(1, newsize+1)) == NULL)
+    tmp_leadp = tp->tdis_leadp - tp->tdis_thebuf;
+    tmp_trailp = tp->tdis_trailp - tp->tdis_thebuf;
+    tmp_eod = tp->tdis_eod - tp->tdis_thebuf;
+
+    /* at least double so that a long message is not copied over and over */
+    newsize = tmp_eod + *read_len;
+    if (newsize < (size_t)tdis_buf_len * 2)
+      newsize = (size_t)tdis_buf_len * 2;
+
+    if ((ptr = tcp_pool_get(newsize, &newsize)) == NULL)
       {
       log_err(ENOMEM,__func__,"Could not allocate memory to read buffer");
       rc = PBSE_MEM_MALLOC;
@@ -265,15 +455,14 @@ int tcp_read(
       return rc;
       }
 
-    tmp_leadp = tp->tdis_leadp - tp->tdis_thebuf;
-    tmp_trailp = tp->tdis_trailp - tp->tdis_thebuf;
-    tmp_eod = tp->tdis_eod - tp->tdis_thebuf;
-
-    snprintf(ptr, newsize, "%s%s", tp->tdis_thebuf, new_data);
-    free(tp->tdis_thebuf);
+    /* the data may hold NULs, so copy it by length */
+    memcpy(ptr, tp->tdis_thebuf, tmp_eod);
+    memcpy(ptr + tmp_eod, new_data, *read_len);
+    tcp_pool_put(tp->tdis_thebuf, tp->tdis_bufsize);
     tp->tdis_thebuf = ptr;
     tp->tdis_bufsize = newsize;
     tp->tdis_eod = tp->tdis_thebuf + tmp_eod + *read_len;
+    *tp->tdis_eod = '\0';
     tp->tdis_trailp = tp->tdis_thebuf + tmp_trailp;
     tp->tdis_leadp = tp->tdis_thebuf + tmp_leadp;
     *avail_len = tp->tdis_eod - tp->tdis_leadp;
@@ -297,6 +486,67 @@ int tcp_read(
 
 
 
+/*
+ * tcp_writev - write all of an iovec array to the channel's socket
+ *
+ * The array is consumed as it is written.
+ * Returns: 0 on success, -1 on error
+ */
+
+static int tcp_writev(
+
+  struct tcp_chan *chan,    /* I */
+  struct iovec    *iov,     /* M */
+  int              iovcnt)  /* I */
+
+  {
+  ssize_t  i;
+  char    *pbs_debug = NULL;
+
+  while (iovcnt > 0)
+    {
+    if ((i = writev_ac_socket(chan->sock, iov, iovcnt)) == -1)
+      {
+      if (errno == EINTR)
+        {
+        continue;
+        }
+
+      /* FAILURE */
+
+      pbs_debug = getenv("PBSDEBUG");
+
+      if (pbs_debug != NULL)
+        {
+        fprintf(stderr,
+          "TCP write of %d bytes (%.32s) [sock=%d] failed, errno=%d (%s)\n",
+          (int)iov->iov_len, (char *)iov->iov_base, chan->sock, errno, strerror(errno));
+        }
+
+      return(-1);
+      }  /* END if (i == -1) */
+
+    while ((iovcnt > 0) &&
+           ((size_t)i >= iov->iov_len))
+      {
+      i -= iov->iov_len;
+      iov++;
+      iovcnt--;
+      }
+
+    if (iovcnt > 0)
+      {
+      iov->iov_base = (char *)iov->iov_base + i;
+      iov->iov_len -= i;
+      }
+    }  /* END while (iovcnt) */
+
+  return(0);
+  }  /* END tcp_writev() */
+
+
+
+
 /*
  * DIS_tcp_wflush - flush tcp/dis write buffer
  *
@@ -312,44 +562,60 @@ int DIS_tcp_wflush(
   struct tcp_chan *chan)  /* I */
 
   {
-  int               i;
-  char             *pbs_debug = NULL;
+  struct iovec      iov[TCP_MAX_IOV];
+  int               iovcnt;
+  int               head_sent = FALSE;
+  struct tcpdisseg *seg;
 
   struct tcpdisbuf *tp = &chan->writebuf;
-  char             *pb = tp->tdis_thebuf;
   size_t            ct = tp->tdis_trailp - tp->tdis_thebuf;
 
-  pbs_debug = getenv("PBSDEBUG");
-
-  while ((i = write_ac_socket(chan->sock, pb, ct)) != (ssize_t)ct)
+  /* the full segments go out first, then the committed part of the buffer */
+  while (head_sent == FALSE)
     {
-    if (i == -1)
+    iovcnt = 0;
+
+    for (seg = tp->tdis_segs; (seg != NULL) && (iovcnt < TCP_MAX_IOV); seg = seg->next)
       {
-      if (errno == EINTR)
+      iov[iovcnt].iov_base = seg->data;
+      iov[iovcnt].iov_len = seg->len;
+      iovcnt++;
+      }
+
+    if ((seg == NULL) &&
+        (iovcnt < TCP_MAX_IOV))
+      {
+      if (ct > 0)
         {
-        continue;
+        iov[iovcnt].iov_base = tp->tdis_thebuf;
+        iov[iovcnt].iov_len = ct;
+        iovcnt++;
         }
 
-      /* FAILURE */
+      head_sent = TRUE;
+      }
 
-      if (pbs_debug != NULL)
-        {
-        fprintf(stderr,
-          "TCP write of %d bytes (%.32s) [sock=%d] failed, errno=%d (%s)\n",
-          (int)ct, pb, chan->sock, errno, strerror(errno));
-        }
-      
+    if ((iovcnt > 0) &&
+        (tcp_writev(chan, iov, iovcnt) != 0))
       return(-1);
-      }  /* END if (i == -1) */
-    else
+
+    /* release the segments that have been written */
+    while (tp->tdis_segs != seg)
       {
-      ct -= i;
-      pb += i;
+      struct tcpdisseg *done = tp->tdis_segs;
+
+      tp->tdis_segs = done->next;
+      tp->tdis_seglen -= done->len;
+
+      tcp_pool_put(done->data, done->size);
+      free(done);
       }
-    }  /* END while (i) */
+    }  /* END while (head_sent) */
 
   /* SUCCESS */
 
+  tp->tdis_lastseg = NULL;
+
   tp->tdis_eod = tp->tdis_leadp;
 
   tcp_pack_buff(tp);
@@ -370,6 +636,8 @@ static void DIS_tcp_clear(
   struct tcpdisbuf *tp)
 
   {
+  tcp_free_segs(tp);
+
   tp->tdis_leadp  = tp->tdis_thebuf;
   tp->tdis_trailp = tp->tdis_thebuf;
   tp->tdis_eod    = tp->tdis_thebuf;
@@ -485,6 +753,79 @@ int tcp_getc(
 
 
 
+/*
+ * tcp_grow_wbuf - make room for ct more bytes in the write buffer
+ *
+ * The committed part of the buffer is chained on as a full segment, and
+ * only the uncommitted bytes are moved into the new buffer, so the data
+ * already written is never copied again.
+ *
+ * Returns: PBSE_NONE, or PBSE_MEM_MALLOC if no buffer could be had
+ */
+
+static int tcp_grow_wbuf(
+
+  struct tcpdisbuf *tp,  /* M */
+  size_t            ct)  /* I */
+
+  {
+  struct tcpdisseg *seg = NULL;
+  char             *newbuf;
+  size_t            newsize;
+  size_t            committed = tp->tdis_trailp - tp->tdis_thebuf;
+  size_t            uncommitted = tp->tdis_leadp - tp->tdis_trailp;
+  int               cl = tcp_pool_class(tp->tdis_bufsize);
+
+  /* step up a size class each time, up to the largest */
+  if ((cl >= 0) &&
+      (cl < TCP_POOL_CLASSES - 1))
+    newsize = tcp_pool_sizes[cl + 1];
+  else
+    newsize = tp->tdis_bufsize;
+
+  if (newsize < uncommitted + ct)
+    newsize = uncommitted + ct;
+
+  if ((committed > 0) &&
+      ((seg = (struct tcpdisseg *)calloc(1, sizeof(struct tcpdisseg))) == NULL))
+    return(PBSE_MEM_MALLOC);
+
+  if ((newbuf = tcp_pool_get(newsize, &newsize)) == NULL)
+    {
+    free(seg);
+    return(PBSE_MEM_MALLOC);
+    }
+
+  memcpy(newbuf, tp->tdis_trailp, uncommitted);
+
+  if (seg != NULL)
+    {
+    seg->data = tp->tdis_thebuf;
+    seg->size = tp->tdis_bufsize;
+    seg->len  = committed;
+
+    if (tp->tdis_lastseg != NULL)
+      tp->tdis_lastseg->next = seg;
+    else
+      tp->tdis_segs = seg;
+
+    tp->tdis_lastseg = seg;
+    tp->tdis_seglen += committed;
+    }
+  else
+    tcp_pool_put(tp->tdis_thebuf, tp->tdis_bufsize);
+
+  tp->tdis_thebuf = newbuf;
+  tp->tdis_bufsize = newsize;
+  tp->tdis_trailp = newbuf;
+  tp->tdis_leadp = newbuf + uncommitted;
+  tp->tdis_eod = newbuf + newsize;
+
+  return(PBSE_NONE);
+  }  /* END tcp_grow_wbuf() */
+
+
+
 /*
  * tcp_puts - tcp/dis support routine to put a counted string of characters
  * into the write buffer.
@@ -501,16 +842,8 @@ int tcp_puts(
 
   {
   struct tcpdisbuf *tp = NULL;
-  char             *temp = NULL;
-  int               leadpct;
-  int               trailpct; 
-  size_t            newbufsize;
   char              log_buf[LOCAL_LOG_BUF_SIZE];
 
-  /* NOTE:  currently, failures may occur if THE_BUF_SIZE is not large enough */
-  /*        this should be changed to allow proper operation with degraded    */
-  /*        performance (how?) */
-
   tp = &chan->writebuf;
 
   if (tp->tdis_bufsize == 0)
@@ -523,38 +856,18 @@ int tcp_puts(
 
   if ((tp->tdis_thebuf + tp->tdis_bufsize - tp->tdis_leadp) < (ssize_t)ct)
     {
-    /* not enough room, reallocate the buffer */
-    leadpct = (int)(tp->tdis_thebuf - tp->tdis_leadp);
-    trailpct = (int)(tp->tdis_thebuf - tp->tdis_trailp);
-    newbufsize = tp->tdis_bufsize + THE_BUF_SIZE + ct*2;
-    temp = (char *)calloc(1, newbufsize+1);
-    if (!temp)
+    /* not enough room, chain the buffer and start a new one */
+    if (tcp_grow_wbuf(tp, ct) != PBSE_NONE)
       {
       /* FAILURE */
       snprintf(log_buf,sizeof(log_buf),
-        "out of space in buffer and cannot calloc message buffer (bufsize=%ld, buflen=%d, ct=%d)\n",
+        "out of space in buffer and cannot allocate message buffer (bufsize=%ld, buflen=%d, ct=%d)\n",
         tp->tdis_bufsize,
         (int)(tp->tdis_leadp - tp->tdis_thebuf),
         (int)ct);
       log_err(ENOMEM, __func__, log_buf);
       return(-1);
       }
-
-    memcpy(temp, tp->tdis_thebuf, tp->tdis_bufsize);
-    if (strlen(tp->tdis_thebuf) > tp->tdis_bufsize)
-      {
-      snprintf(log_buf, sizeof(log_buf),
-          "line #%d, The length of the string is GREATER than the size of buf",
-          __LINE__);
-      log_err(ENOMEM, __func__, log_buf);
-      }
-    free(tp->tdis_thebuf);
-    tp->tdis_thebuf = temp;
-    tp->tdis_bufsize = newbufsize;
-    tp->tdis_leadp = tp->tdis_thebuf - leadpct;
-    tp->tdis_trailp = tp->tdis_thebuf - trailpct;
-    tp->tdis_eod = tp->tdis_thebuf + newbufsize;
-
     }
 
   memcpy(tp->tdis_leadp, (char *)str, ct);
@@ -649,28 +962,17 @@ int tcp_chan_has_data(
 
 
 /*
- * DIS_tcp_setup - setup supports routines for dis, "data is strings", to
- * use tcp stream I/O.  Also initializes an array of pointers to
- * buffers and a buffer to be used for the given fd.
- * 
- * NOTE:  tmpArray is global
- *
- * NOTE:  does not return FAILURE - FIXME
+ * tcp_chan_alloc - allocate a channel and its read and write buffers
  */
 
-struct tcp_chan * DIS_tcp_setup(
+static struct tcp_chan *tcp_chan_alloc(
 
   int fd)
 
   {
   struct tcp_chan  *chan = NULL;
   struct tcpdisbuf *tp = NULL;
-
-  /* check for bad file descriptor */
-  if (fd < 0)
-    {
-    return(NULL);
-    }
+  size_t            bufsize;
 
   if ((chan = (struct tcp_chan *)calloc(1, sizeof(struct tcp_chan))) == NULL)
     {
@@ -681,36 +983,152 @@ struct tcp_chan * DIS_tcp_setup(
   /* Assign socket to struct */
   chan->sock = fd;
 
-  /* Setting up the read buffer */
+  /* Setting up the read buffer, it grows as messages need */
   tp = &chan->readbuf;
-  if ((tp->tdis_thebuf = (char *)calloc(1, THE_BUF_SIZE+1)) == NULL)
+  if ((tp->tdis_thebuf = tcp_pool_get(tcp_pool_sizes[0], &bufsize)) == NULL)
     {
     free(chan);
-    log_err(errno,"DIS_tcp_setup","calloc failure");
+    log_err(errno,"DIS_tcp_setup","malloc failure");
     return(NULL);
     }
 
-  tp->tdis_bufsize = THE_BUF_SIZE;
+  tp->tdis_bufsize = bufsize;
   DIS_tcp_clear(tp);
 
   /* Setting up the write buffer */
   tp = &chan->writebuf;
-  if ((tp->tdis_thebuf = (char *)calloc(1, THE_BUF_SIZE+1)) == NULL)
+  if ((tp->tdis_thebuf = tcp_pool_get(tcp_pool_sizes[0], &bufsize)) == NULL)
     {
-    free(chan->readbuf.tdis_thebuf);
+    tcp_pool_put(chan->readbuf.tdis_thebuf, chan->readbuf.tdis_bufsize);
     free(chan);
-    log_err(errno,"DIS_tcp_setup","calloc failure");
+    log_err(errno,"DIS_tcp_setup","malloc failure");
     return(NULL);
     }
 
-  tp->tdis_bufsize = THE_BUF_SIZE;
+  tp->tdis_bufsize = bufsize;
   DIS_tcp_clear(tp);
 
   return(chan);
+  }  /* END tcp_chan_alloc() */
+
+
+
+/*
+ * DIS_tcp_setup - setup supports routines for dis, "data is strings", to
+ * use tcp stream I/O.  Also initializes an array of pointers to
+ * buffers and a buffer to be used for the given fd.
+ * 
+ * NOTE:  tmpArray is global
+ *
+ * NOTE:  does not return FAILURE - FIXME
+ */
+
+struct tcp_chan * DIS_tcp_setup(
+
+  int fd)
+
+  {
+  /* check for bad file descriptor */
+  if (fd < 0)
+    {
+    return(NULL);
+    }
+
+  return(tcp_chan_alloc(fd));
   }  /* END DIS_tcp_setup() */
 
 
 
+/*
+ * DIS_buf_setup - set up a channel with no socket behind it
+ *
+ * The DIS encoders write into its write buffer, which grows as needed
+ * and is never flushed. DIS_buf_data() returns the committed bytes.
+ * Release it with DIS_tcp_cleanup().
+ */
+
+struct tcp_chan *DIS_buf_setup(void)
+
+  {
+  return(tcp_chan_alloc(-1));
+  }  /* END DIS_buf_setup() */
+
+
+
+/*
+ * DIS_buf_data - get the committed bytes of a channel's write buffer
+ *
+ * Gathers any full segments and the current buffer into one buffer,
+ * which stays owned by the channel and is valid until the next write to
+ * it. The number of bytes is returned in *len.
+ *
+ * Returns NULL if the data could not be gathered.
+ */
+
+char *DIS_buf_data(
+
+  struct tcp_chan *chan,  /* I */
+  size_t          *len)   /* O */
+
+  {
+  struct tcpdisbuf *tp = &chan->writebuf;
+  struct tcpdisseg *seg;
+  char             *newbuf;
+  char             *cp;
+  size_t            newsize;
+  size_t            committed;
+  size_t            uncommitted = tp->tdis_leadp - tp->tdis_trailp;
+
+  committed = DIS_tcp_wpending(chan);
+
+  if (tp->tdis_segs != NULL)
+    {
+    if ((newbuf = tcp_pool_get(committed + uncommitted, &newsize)) == NULL)
+      return(NULL);
+
+    cp = newbuf;
+
+    for (seg = tp->tdis_segs; seg != NULL; seg = seg->next)
+      {
+      memcpy(cp, seg->data, seg->len);
+      cp += seg->len;
+      }
+
+    memcpy(cp, tp->tdis_thebuf, tp->tdis_leadp - tp->tdis_thebuf);
+
+    tcp_free_segs(tp);
+    tcp_pool_put(tp->tdis_thebuf, tp->tdis_bufsize);
+
+    tp->tdis_thebuf = newbuf;
+    tp->tdis_bufsize = newsize;
+    tp->tdis_trailp = newbuf + committed;
+    tp->tdis_leadp = tp->tdis_trailp + uncommitted;
+    tp->tdis_eod = newbuf + newsize;
+    }
+
+  *len = committed;
+
+  return(tp->tdis_thebuf);
+  }  /* END DIS_buf_data() */
+
+
+
+/*
+ * DIS_tcp_wpending - the number of committed bytes not yet flushed
+ */
+
+size_t DIS_tcp_wpending(
+
+  struct tcp_chan *chan)  /* I */
+
+  {
+  struct tcpdisbuf *tp = &chan->writebuf;
+
+  return(tp->tdis_seglen + (tp->tdis_trailp - tp->tdis_thebuf));
+  }  /* END DIS_tcp_wpending() */
+
+
+
 void DIS_tcp_cleanup(
     
   struct tcp_chan *chan)
@@ -721,10 +1139,11 @@ void DIS_tcp_cleanup(
   if (chan == NULL)
     return;
   tp = &chan->readbuf;
-  free(tp->tdis_thebuf);
+  tcp_pool_put(tp->tdis_thebuf, tp->tdis_bufsize);
 
   tp = &chan->writebuf;
-  free(tp->tdis_thebuf);
+  tcp_free_segs(tp);
+  tcp_pool_put(tp->tdis_thebuf, tp->tdis_bufsize);
 
   free(chan);
   }
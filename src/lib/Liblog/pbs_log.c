@@ -88,6 +88,8 @@
  * log_close()
  * log_roll()
  * log_size()
+ * log_async_start()
+ * log_async_stop()
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -112,6 +114,7 @@
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 
 #include "log.h"
 #if SYSLOG
@@ -156,6 +159,43 @@ static volatile int  job_log_opened = 0;
 
 pthread_mutex_t job_log_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * asynchronous logging. Each thread formats its records into its own ring
+ * without taking log_mutex, and a writer thread drains every ring into the
+ * log file with writev().
+ */
+#define LOG_RING_SIZE        (64 * 1024)
+#define LOG_DRAIN_BATCH      64   /* rings written per writev() */
+#define LOG_WRITER_WAKE_MSEC 50
+
+typedef struct log_ring log_ring;
+struct log_ring
+  {
+  log_ring               *next;
+  char                   *buf;      /* LOG_RING_SIZE bytes of formatted lines */
+  volatile unsigned long  head;     /* bytes added by the owning thread */
+  volatile unsigned long  tail;     /* bytes written by the drain */
+  volatile int            orphaned; /* the owning thread has exited */
+  pid_t                   thr_id;
+  time_t                  ts_sec;   /* second ts_str was formatted for */
+  char                    ts_str[32];
+  };
+
+static volatile int     log_async_active = 0;
+static pthread_t        log_writer_id;
+static pthread_key_t    log_ring_key;
+static pthread_once_t   log_ring_key_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t  log_ring_mutex = PTHREAD_MUTEX_INITIALIZER; /* protects log_rings */
+static pthread_cond_t   log_writer_cond = PTHREAD_COND_INITIALIZER;
+static log_ring        *log_rings = NULL;
+static volatile unsigned long log_async_queued = 0;
+static volatile unsigned long log_async_dropped = 0;
+static unsigned long    log_dropped_reported = 0;
+static int              log_draining = FALSE; /* protected by log_mutex */
+
+static void log_record_sync(int, int, const char *, const char *);
+static void log_drain_rings(void);
+
 /*
  * the order of these names MUST match the defintions of
  * PBS_EVENTCLASS_* in log.h
@@ -401,7 +441,7 @@ int log_open(
   else
     snprintf(buf2, sizeof(buf2), "Log opened");
 
-  log_record(
+  log_record_sync(
     PBSEVENT_SYSTEM,
     PBS_EVENTCLASS_SERVER,
     "Log",
@@ -748,6 +788,596 @@ bool log_available(int eventtype)
   }
 
 
+/*
+ * log_ring_release - pthread key destructor. The writer frees the ring
+ * once it has been drained.
+ */
+
+static void log_ring_release(
+
+  void *vp)
+
+  {
+  log_ring *ring = (log_ring *)vp;
+
+  ring->orphaned = TRUE;
+  }  /* END log_ring_release() */
+
+
+
+/*
+ * log_async_atfork_child - a forked child has no writer thread, so it logs
+ * synchronously and leaves the parent's rings alone.
+ */
+
+static void log_async_atfork_child(void)
+
+  {
+  log_async_active = 0;
+  log_rings = NULL;
+  pthread_mutex_init(&log_ring_mutex, NULL);
+  pthread_cond_init(&log_writer_cond, NULL);
+  }  /* END log_async_atfork_child() */
+
+
+
+/*
+ * log_async_atexit - write out whatever is still queued. Uses trylock since
+ * another thread may be holding log_mutex as the process exits.
+ */
+
+static void log_async_atexit(void)
+
+  {
+  if (log_rings == NULL)
+    return;
+
+  if (pthread_mutex_trylock(&log_mutex) == 0)
+    {
+    log_drain_rings();
+    pthread_mutex_unlock(&log_mutex);
+    }
+  }  /* END log_async_atexit() */
+
+
+
+static void log_ring_key_init(void)
+
+  {
+  pthread_key_create(&log_ring_key, log_ring_release);
+  pthread_atfork(NULL, NULL, log_async_atfork_child);
+  atexit(log_async_atexit);
+  }  /* END log_ring_key_init() */
+
+
+
+/*
+ * get_log_ring - return the calling thread's ring, creating it on first use
+ */
+
+static log_ring *get_log_ring(void)
+
+  {
+  log_ring *ring = (log_ring *)pthread_getspecific(log_ring_key);
+
+  if (ring != NULL)
+    return(ring);
+
+  if ((ring = (log_ring *)calloc(1, sizeof(log_ring))) == NULL)
+    return(NULL);
+
+  if ((ring->buf = (char *)malloc(LOG_RING_SIZE)) == NULL)
+    {
+    free(ring);
+    return(NULL);
+    }
+
+  ring->thr_id = syscall(SYS_gettid);
+  ring->ts_sec = -1;
+
+  pthread_setspecific(log_ring_key, ring);
+
+  pthread_mutex_lock(&log_ring_mutex);
+  ring->next = log_rings;
+  log_rings = ring;
+  pthread_mutex_unlock(&log_ring_mutex);
+
+  return(ring);
+  }  /* END get_log_ring() */
+
+
+
+/*
+ * write_log_iovecs - writev() all of iov to fd, continuing after short writes
+ *
+ * @return 0 on success, -1 on error (errno is set)
+ */
+
+static int write_log_iovecs(
+
+  int           fd,
+  struct iovec *iov,
+  int           count)
+
+  {
+  ssize_t written;
+
+  while (count > 0)
+    {
+    if ((written = writev(fd, iov, count)) < 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      return(-1);
+      }
+
+    while ((count > 0) &&
+           ((size_t)written >= iov->iov_len))
+      {
+      written -= iov->iov_len;
+      iov++;
+      count--;
+      }
+
+    if (count > 0)
+      {
+      iov->iov_base = (char *)iov->iov_base + written;
+      iov->iov_len -= written;
+      }
+    }
+
+  return(0);
+  }  /* END write_log_iovecs() */
+
+
+
+/*
+ * log_write_batch - write the queued bytes of count rings and release the
+ * space. A log that is not open discards them, as log_record() would.
+ * NOTE: log_mutex and log_ring_mutex must be held
+ */
+
+static void log_write_batch(
+
+  log_ring      **rings,
+  unsigned long  *heads,
+  int             count)
+
+  {
+  struct iovec iov[LOG_DRAIN_BATCH * 2];
+  int          iovcnt = 0;
+  int          i;
+  int          tryagain = TRUE;
+
+  for (i = 0; i < count; i++)
+    {
+    unsigned long start = rings[i]->tail % LOG_RING_SIZE;
+    unsigned long len = heads[i] - rings[i]->tail;
+
+    if (start + len > LOG_RING_SIZE)
+      {
+      iov[iovcnt].iov_base = rings[i]->buf + start;
+      iov[iovcnt++].iov_len = LOG_RING_SIZE - start;
+      iov[iovcnt].iov_base = rings[i]->buf;
+      iov[iovcnt++].iov_len = len - (LOG_RING_SIZE - start);
+      }
+    else
+      {
+      iov[iovcnt].iov_base = rings[i]->buf + start;
+      iov[iovcnt++].iov_len = len;
+      }
+    }
+
+  while ((log_opened > 0) &&
+         (logfile != NULL))
+    {
+    fflush(logfile);
+
+    if (write_log_iovecs(fileno(logfile), iov, iovcnt) == 0)
+      break;
+
+    if ((errno == EPIPE) &&
+        (tryagain == TRUE))
+      {
+      /* the log file descriptor has been changed--reopen the log */
+      log_opened = 0;
+      log_open(NULL, log_directory);
+      tryagain = FALSE;
+      continue;
+      }
+
+    FILE *console = fopen("/dev/console", "w");
+
+    if (console != NULL)
+      {
+      fprintf(console, "%s: PBS cannot write to its log: %s\n",
+        msg_daemonname,
+        strerror(errno));
+      fclose(console);
+      }
+
+    break;
+    }
+
+  __sync_synchronize();
+
+  for (i = 0; i < count; i++)
+    rings[i]->tail = heads[i];
+  }  /* END log_write_batch() */
+
+
+
+/*
+ * log_drain_rings - write every queued record to the log file and free
+ * the rings of exited threads.
+ * NOTE: log_mutex must be held
+ */
+
+static void log_drain_rings(void)
+
+  {
+  log_ring      *batch[LOG_DRAIN_BATCH];
+  unsigned long  heads[LOG_DRAIN_BATCH];
+  int            count = 0;
+  log_ring      *ring;
+  log_ring      *prev = NULL;
+  log_ring      *next;
+  unsigned long  dropped;
+  char           buf[128];
+
+  /* reopening the log from inside a drain can close it again */
+  if ((log_rings == NULL) ||
+      (log_draining == TRUE))
+    return;
+
+  log_draining = TRUE;
+
+  pthread_mutex_lock(&log_ring_mutex);
+
+  for (ring = log_rings; ring != NULL; ring = ring->next)
+    {
+    unsigned long head = __sync_fetch_and_add(&ring->head, 0);
+
+    if (head == ring->tail)
+      continue;
+
+    batch[count] = ring;
+    heads[count++] = head;
+
+    if (count == LOG_DRAIN_BATCH)
+      {
+      log_write_batch(batch, heads, count);
+      count = 0;
+      }
+    }
+
+  if (count > 0)
+    log_write_batch(batch, heads, count);
+
+  for (ring = log_rings; ring != NULL; ring = next)
+    {
+    next = ring->next;
+
+    if ((ring->orphaned == TRUE) &&
+        (ring->head == ring->tail))
+      {
+      if (prev == NULL)
+        log_rings = next;
+      else
+        prev->next = next;
+
+      free(ring->buf);
+      free(ring);
+      continue;
+      }
+
+    prev = ring;
+    }
+
+  pthread_mutex_unlock(&log_ring_mutex);
+
+  log_draining = FALSE;
+
+  dropped = log_async_dropped;
+
+  if (dropped != log_dropped_reported)
+    {
+    snprintf(buf, sizeof(buf), "%lu log records were dropped because the log buffer was full",
+      dropped - log_dropped_reported);
+
+    log_dropped_reported = dropped;
+
+    log_record_sync(PBSEVENT_ERROR | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER, msg_daemonname, buf);
+    }
+  }  /* END log_drain_rings() */
+
+
+
+/*
+ * log_ring_put - copy len bytes into ring. When the ring is full, records
+ * that must not be lost are written out by the calling thread and the
+ * rest are dropped.
+ *
+ * @return PBSE_NONE if queued, -1 if dropped
+ */
+
+static int log_ring_put(
+
+  log_ring   *ring,
+  const char *data,
+  size_t      len,
+  bool        must_keep)
+
+  {
+  unsigned long head = ring->head;
+  unsigned long start;
+  size_t        first;
+
+  while (LOG_RING_SIZE - (head - __sync_fetch_and_add(&ring->tail, 0)) < len)
+    {
+    if (must_keep == false)
+      {
+      __sync_fetch_and_add(&log_async_dropped, 1);
+      return(-1);
+      }
+
+    pthread_mutex_lock(&log_mutex);
+    log_drain_rings();
+    pthread_mutex_unlock(&log_mutex);
+    }
+
+  start = head % LOG_RING_SIZE;
+  first = LOG_RING_SIZE - start;
+
+  if (first >= len)
+    memcpy(ring->buf + start, data, len);
+  else
+    {
+    memcpy(ring->buf + start, data, first);
+    memcpy(ring->buf, data + first, len - first);
+    }
+
+  /* publish the bytes before the new head */
+  __sync_synchronize();
+  ring->head = head + len;
+
+  __sync_fetch_and_add(&log_async_queued, 1);
+
+  /* don't wait for the writer's next pass once the ring is half full */
+  if (head + len - ring->tail > LOG_RING_SIZE / 2)
+    {
+    pthread_mutex_lock(&log_ring_mutex);
+    pthread_cond_signal(&log_writer_cond);
+    pthread_mutex_unlock(&log_ring_mutex);
+    }
+
+  return(PBSE_NONE);
+  }  /* END log_ring_put() */
+
+
+
+/*
+ * log_record_async - format a record into the calling thread's ring.
+ * The timestamp is only rebuilt when the second changes.
+ *
+ * @return PBSE_NONE if the record was queued or dropped, -1 if it must be
+ * written synchronously
+ */
+
+static int log_record_async(
+
+  int         eventtype,  /* I */
+  int         objclass,   /* I */
+  const char *objname,    /* I */
+  const char *text)       /* I */
+
+  {
+  log_ring       *ring;
+  char            record[LOG_RING_SIZE / 2];
+  size_t          len = 0;
+  int             rc;
+  int             eventclass = 0;
+  struct timeval  now;
+  struct tm       tm;
+  const char     *start;
+  const char     *end;
+
+  log_get_set_eventclass(&eventclass, GETV);
+
+  if ((eventclass == PBS_EVENTCLASS_TRQAUTHD) ||
+      ((ring = get_log_ring()) == NULL))
+    return(-1);
+
+  gettimeofday(&now, NULL);
+
+  if (now.tv_sec != ring->ts_sec)
+    {
+    localtime_r(&now.tv_sec, &tm);
+
+    snprintf(ring->ts_str, sizeof(ring->ts_str), "%02d/%02d/%04d %02d:%02d:%02d",
+      tm.tm_mon + 1,
+      tm.tm_mday,
+      tm.tm_year + 1900,
+      tm.tm_hour,
+      tm.tm_min,
+      tm.tm_sec);
+
+    ring->ts_sec = now.tv_sec;
+    }
+
+  /* split the message on newlines as log_record_sync() does */
+  start = text;
+
+  while (1)
+    {
+    for (end = start; *end != '\n' && *end != '\r' && *end != '\0'; end++)
+      ;
+
+    rc = snprintf(record + len, sizeof(record) - len,
+           "%s.%03d;%02d;%10.10s.%d;%s;%s;%s%.*s\n",
+           ring->ts_str,
+           (int)(now.tv_usec / 1000),
+           (eventtype & ~PBSEVENT_FORCE),
+           msg_daemonname,
+           ring->thr_id,
+           class_names[objclass],
+           objname,
+           (text == start ? "" : "[continued]"),
+           (int)(end - start),
+           start);
+
+    if ((rc < 0) ||
+        ((size_t)rc >= sizeof(record) - len))
+      return(-1);
+
+    len += rc;
+
+    if (*end == '\r' && *(end + 1) == '\n')
+      end++;
+
+    if (*end == '\0')
+      break;
+
+    start = end + 1;
+    }
+
+  log_ring_put(ring, record, len, (eventtype & (PBSEVENT_ERROR | PBSEVENT_FORCE)) != 0);
+
+  return(PBSE_NONE);
+  }  /* END log_record_async() */
+
+
+
+/*
+ * log_writer - the writer thread. Drains the rings every
+ * LOG_WRITER_WAKE_MSEC, or sooner when a ring fills, and switches to a new
+ * day's log file when log_record() would have.
+ */
+
+static void *log_writer(
+
+  void *vp)
+
+  {
+  struct timespec ts;
+  struct tm       tm;
+  time_t          now;
+
+  while (log_async_active)
+    {
+    pthread_mutex_lock(&log_ring_mutex);
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += LOG_WRITER_WAKE_MSEC * 1000000;
+
+    if (ts.tv_nsec >= 1000000000)
+      {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000;
+      }
+
+    pthread_cond_timedwait(&log_writer_cond, &log_ring_mutex, &ts);
+
+    pthread_mutex_unlock(&log_ring_mutex);
+
+    pthread_mutex_lock(&log_mutex);
+
+    if ((log_auto_switch) &&
+        (log_opened > 0))
+      {
+      now = time(NULL);
+      localtime_r(&now, &tm);
+
+      if (tm.tm_yday != log_open_day)
+        {
+        log_close(1);
+        log_open(NULL, log_directory);
+        }
+      }
+
+    log_drain_rings();
+
+    pthread_mutex_unlock(&log_mutex);
+    }
+
+  return(NULL);
+  }  /* END log_writer() */
+
+
+
+/*
+ * log_async_start - make log_record() queue records for a writer thread
+ * instead of writing them while holding log_mutex
+ *
+ * @return PBSE_NONE, or PBSE_SYSTEM if the writer thread can't be started
+ */
+
+int log_async_start(void)
+
+  {
+  pthread_once(&log_ring_key_once, log_ring_key_init);
+
+  if (log_async_active)
+    return(PBSE_NONE);
+
+  log_async_active = TRUE;
+
+  if (pthread_create(&log_writer_id, NULL, log_writer, NULL) != 0)
+    {
+    log_async_active = FALSE;
+    return(PBSE_SYSTEM);
+    }
+
+  return(PBSE_NONE);
+  }  /* END log_async_start() */
+
+
+
+/*
+ * log_async_stop - stop the writer thread and write out what is queued.
+ * log_record() goes back to writing synchronously.
+ */
+
+void log_async_stop(void)
+
+  {
+  if (!log_async_active)
+    return;
+
+  log_async_active = FALSE;
+
+  pthread_mutex_lock(&log_ring_mutex);
+  pthread_cond_signal(&log_writer_cond);
+  pthread_mutex_unlock(&log_ring_mutex);
+
+  pthread_join(log_writer_id, NULL);
+
+  pthread_mutex_lock(&log_mutex);
+  log_drain_rings();
+  pthread_mutex_unlock(&log_mutex);
+  }  /* END log_async_stop() */
+
+
+
+/*
+ * log_get_async_stats - the number of records queued for the writer thread
+ * and the number dropped because a ring was full
+ */
+
+void log_get_async_stats(
+
+  unsigned long *queued,
+  unsigned long *dropped)
+
+  {
+  *queued = __sync_fetch_and_add(&log_async_queued, 0);
+  *dropped = __sync_fetch_and_add(&log_async_dropped, 0);
+  }  /* END log_get_async_stats() */
+
+
+
+
 /*
  * log_record - log a message to the log file
  * The log file must have been opened by log_open().
@@ -765,6 +1395,50 @@ void log_record(
   const char *objname,    /* I */
   const char *text)       /* I */
 
+  {
+  if ((log_async_active) &&
+      (log_record_async(eventtype, objclass, objname, text) == PBSE_NONE))
+    {
+#if SYSLOG
+    if (eventtype & PBSEVENT_SYSLOG)
+      {
+      pthread_mutex_lock(&log_mutex);
+
+      if (syslogopen == 0)
+        {
+        openlog(msg_daemonname, LOG_NOWAIT, LOG_DAEMON);
+
+        syslogopen = 1;
+        }
+
+      pthread_mutex_unlock(&log_mutex);
+
+      syslog(LOG_ERR | LOG_DAEMON,"%s",text);
+      }
+#endif /* SYSLOG */
+
+    return;
+    }
+
+  log_record_sync(eventtype, objclass, objname, text);
+  }  /* END log_record() */
+
+
+
+
+/*
+ * log_record_sync - format and write a record to the log file while holding
+ * log_mutex. Used when logging is not asynchronous, and for the records
+ * log_open() and log_close() write themselves.
+ */
+
+static void log_record_sync(
+
+  int         eventtype,  /* I */
+  int         objclass,   /* I */
+  const char *objname,    /* I */
+  const char *text)       /* I */
+
   {
   int tryagain = 2;
   time_t now;
@@ -932,7 +1606,7 @@ void log_record(
   pthread_mutex_unlock(&log_mutex);
 
   return;
-  }  /* END log_record() */
+  }  /* END log_record_sync() */
 
 
 
@@ -949,6 +1623,9 @@ void log_close(
   char buf[1024];
   if (log_opened == 1)
     {
+    /* records still queued belong in this file */
+    log_drain_rings();
+
     log_auto_switch = 0;
 
     if (msg)
@@ -959,7 +1636,7 @@ void log_close(
         snprintf(buf, sizeof(buf), "Log closed");
 
       pthread_mutex_unlock(&log_mutex);
-      log_record(
+      log_record_sync(
         PBSEVENT_SYSTEM,
         PBS_EVENTCLASS_SERVER,
         "Log",
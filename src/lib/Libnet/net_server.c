@@ -91,6 +91,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <time.h>
+#include <fcntl.h>
 
 #include <sys/types.h>
 #include <sys/stat.h>  /* added - CRI 9/05 */
@@ -105,6 +106,9 @@
 #if defined(FD_SET_IN_SYS_SELECT_H)
 #include <sys/select.h>
 #endif
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
 #if defined(NTOHL_NEEDS_ARPA_INET_H) && defined(HAVE_ARPA_INET_H)
 #include <arpa/inet.h>
 #endif
@@ -158,6 +162,18 @@ static u_long   *GlobalSocketAddrSet = NULL;
 static u_long   *GlobalSocketPortSet = NULL;
 pthread_mutex_t *global_sock_read_mutex = NULL;
 
+#ifdef USE_EPOLL
+/* max number of ready descriptors harvested by a single epoll_wait() */
+#define EPOLL_MAX_EVENTS 1024
+
+/* when epoll_create() fails we quietly fall back to select() */
+static int                 global_epoll_fd = -1;
+static struct epoll_event *epoll_ready_events = NULL;
+#endif
+
+/* the stale connection scan in wait_request() runs at most once per second */
+static time_t    last_idle_check = 0;
+
 void *(*read_func[2])(void *);
 
 pthread_mutex_t *nc_list_mutex  = NULL;
@@ -342,6 +358,18 @@ int init_network(
     global_sock_read_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
     pthread_mutex_init(global_sock_read_mutex,&t_attr);
 
+#ifdef USE_EPOLL
+    epoll_ready_events = (struct epoll_event *)calloc(EPOLL_MAX_EVENTS, sizeof(struct epoll_event));
+
+    if (epoll_ready_events != NULL)
+      global_epoll_fd = epoll_create(EPOLL_MAX_EVENTS);
+
+    if (global_epoll_fd < 0)
+      log_err(errno, __func__, "Unable to create epoll descriptor, falling back to select()");
+    else
+      fcntl(global_epoll_fd, F_SETFD, FD_CLOEXEC);
+#endif
+
     num_connections_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
     pthread_mutex_init(num_connections_mutex,&t_attr);
     
@@ -646,21 +674,158 @@ int check_network_port(
 
 
 /*
- * wait_request - wait for a request (socket with data to read)
- * This routine does a select on the readset of sockets,
- * when data is ready, the processing routine associated with
- * the socket is invoked.
+ * dispatch_ready_socket - invoke the processing routine of a socket that
+ * has data to read.  Idle sockets are pulled out of the read set and closed.
+ *
+ * @return TRUE if the caller should stop dispatching (the state changed)
  */
 
-int wait_request(
+static int dispatch_ready_socket(
+
+  int     sock,      /* I */
+  u_long  addr,      /* I */
+  u_long  port,      /* I */
+  long   *SState,    /* I (optional) */
+  long    OrigState) /* I */
+
+  {
+  char tmpLine[1024];
+
+  pthread_mutex_lock(svr_conn[sock].cn_mutex);
+
+  svr_conn[sock].cn_lasttime = time(NULL);
+
+  if (svr_conn[sock].cn_active != Idle)
+    {
+    void *(*func)(void *) = svr_conn[sock].cn_func;
+
+    netcounter_incr();
+
+    pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+    if (func != NULL)
+      {
+      int args[3];
+
+      args[0] = sock;
+      args[1] = (int)addr;
+      args[2] = (int)port;
+      func((void *)args);
+      }
+
+    /* NOTE:  breakout if state changed (probably received shutdown request) */
+
+    if ((SState != NULL) && 
+        (OrigState != *SState))
+      return(TRUE);
+    }
+  else
+    {
+    pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+    globalset_del_sock(sock);
+    close_conn(sock, FALSE);
+
+    pthread_mutex_lock(num_connections_mutex);
+
+    sprintf(tmpLine, "closed connections to fd %d - num_connections=%d (select bad socket)",
+      sock,
+      num_connections);
+
+    pthread_mutex_unlock(num_connections_mutex);
+    log_err(-1, __func__, tmpLine);
+    }
+
+  return(FALSE);
+  } /* END dispatch_ready_socket() */
+
+
+
+#ifdef USE_EPOLL
+/*
+ * wait_request_epoll - the epoll() flavor of the wait in wait_request().
+ * Only the ready descriptors are visited, so the cost of a wakeup no longer
+ * depends on the number of open connections and nothing is copied or
+ * allocated per call.  Descriptors are registered level-triggered: a
+ * processing routine reads a single request per call and any pipelined
+ * request left in the socket must wake us up again, exactly as select() did.
+ *
+ * @return the number of ready descriptors, or -1 on error
+ */
+
+static int wait_request_epoll(
 
   time_t  waittime,   /* I (seconds) */
-  long   *SState)     /* I (optional) */
+  long   *SState,     /* I (optional) */
+  long    OrigState)  /* I */
+
+  {
+  int i;
+  int n;
+
+  n = epoll_wait(global_epoll_fd, epoll_ready_events, EPOLL_MAX_EVENTS, waittime * 1000);
+
+  if (n == -1)
+    {
+    if (errno == EINTR)
+      return(0); /* interrupted, cycle around */
+
+    log_err(errno, __func__, "Unable to epoll sockets to read requests");
+
+    return(-1);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+    int    sock = epoll_ready_events[i].data.fd;
+    u_long addr;
+    u_long port;
+
+    if ((sock < 0) ||
+        (sock >= max_connection))
+      continue;
+
+    pthread_mutex_lock(global_sock_read_mutex);
+
+    if (FD_ISSET(sock, GlobalSocketReadSet) == 0)
+      {
+      /* removed by an earlier processing routine in this batch */
+      pthread_mutex_unlock(global_sock_read_mutex);
+
+      continue;
+      }
+
+    addr = GlobalSocketAddrSet[sock];
+    port = GlobalSocketPortSet[sock];
+
+    pthread_mutex_unlock(global_sock_read_mutex);
+
+    if (dispatch_ready_socket(sock, addr, port, SState, OrigState) == TRUE)
+      break;
+    }
+
+  return(n);
+  } /* END wait_request_epoll() */
+#endif /* USE_EPOLL */
+
+
+
+/*
+ * wait_request_select - the select() flavor of the wait in wait_request()
+ *
+ * @return the number of ready descriptors, or -1 on error
+ */
+
+static int wait_request_select(
+
+  time_t  waittime,   /* I (seconds) */
+  long   *SState,     /* I (optional) */
+  long    OrigState)  /* I */
 
   {
   int             i;
   int             n;
-  time_t          now;
+  int             ready;
 
   fd_set          *SelectSet = NULL;
   int             SelectSetSize = 0;
@@ -669,13 +834,7 @@ int wait_request(
   u_long   		  *SocketAddrSet = NULL;
   u_long          *SocketPortSet = NULL;
 
-
-  char            tmpLine[1024];
   struct timeval  timeout;
-  long            OrigState = 0;
-
-  if (SState != NULL)
-    OrigState = *SState;
 
   timeout.tv_usec = 0;
   timeout.tv_sec  = waittime;
@@ -719,8 +878,6 @@ int wait_request(
       }
     else
       {
-      int i;
-
       struct stat fbuf;
 
       /* check all file descriptors to verify they are valid */
@@ -750,62 +907,61 @@ int wait_request(
       }  /* END else (errno == EINTR) */
     }    /* END if (n == -1) */
 
+  ready = n;
+
   for (i = 0; (i < max_connection) && (n > 0); i++)
     {
     if (FD_ISSET(i, SelectSet))
       {
-      pthread_mutex_lock(svr_conn[i].cn_mutex);
       /* this socket has data */
       n--;
 
-      svr_conn[i].cn_lasttime = time(NULL);
+      if (dispatch_ready_socket(i, SocketAddrSet[i], SocketPortSet[i], SState, OrigState) == TRUE)
+        break;
+      }
+    } /* END for i */
 
-      if (svr_conn[i].cn_active != Idle)
-        {
-        void *(*func)(void *) = svr_conn[i].cn_func;
+  free(SelectSet);
+  free(SocketAddrSet);
+  free(SocketPortSet);
 
-        netcounter_incr();
+  return(ready);
+  } /* END wait_request_select() */
 
-        pthread_mutex_unlock(svr_conn[i].cn_mutex);
 
-        if (func != NULL)
-          {
-          int args[3];
 
-          args[0] = i;
-          args[1] = (int)SocketAddrSet[i];
-          args[2] = (int)SocketPortSet[i];
-          func((void *)args);
-          }
+/*
+ * wait_request - wait for a request (socket with data to read)
+ * This routine waits (epoll or select) on the readset of sockets,
+ * when data is ready, the processing routine associated with
+ * the socket is invoked.
+ */
 
-        /* NOTE:  breakout if state changed (probably received shutdown request) */
+int wait_request(
 
-        if ((SState != NULL) && 
-            (OrigState != *SState))
-          break;
-        }
-      else
-        {
-        pthread_mutex_unlock(svr_conn[i].cn_mutex);
+  time_t  waittime,   /* I (seconds) */
+  long   *SState)     /* I (optional) */
 
-        globalset_del_sock(i);
-        close_conn(i, FALSE);
+  {
+  int             i;
+  int             rc;
+  time_t          now;
 
-        pthread_mutex_lock(num_connections_mutex);
+  char            tmpLine[1024];
+  long            OrigState = 0;
 
-        sprintf(tmpLine, "closed connections to fd %d - num_connections=%d (select bad socket)",
-          i,
-          num_connections);
+  if (SState != NULL)
+    OrigState = *SState;
 
-        pthread_mutex_unlock(num_connections_mutex);
-        log_err(-1, __func__, tmpLine);
-        }
-      }
-    } /* END for i */
+#ifdef USE_EPOLL
+  if (global_epoll_fd >= 0)
+    rc = wait_request_epoll(waittime, SState, OrigState);
+  else
+#endif
+    rc = wait_request_select(waittime, SState, OrigState);
 
-  free(SelectSet);
-  free(SocketAddrSet);
-  free(SocketPortSet);
+  if (rc < 0)
+    return(-1);
 
   /* NOTE:  break out if shutdown request received */
 
@@ -816,6 +972,11 @@ int wait_request(
 
   now = time((time_t *)0);
 
+  if (now == last_idle_check)
+    return(PBSE_NONE);
+
+  last_idle_check = now;
+
   for (i = 0;i < max_connection;i++)
     {
     struct connection *cp;
@@ -965,6 +1126,23 @@ void globalset_add_sock(
   FD_SET(sock, GlobalSocketReadSet);
   GlobalSocketAddrSet[sock] = addr;
   GlobalSocketPortSet[sock] = port;
+
+#ifdef USE_EPOLL
+  if (global_epoll_fd >= 0)
+    {
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = sock;
+
+    /* the descriptor may still be registered if it was never deleted */
+    if ((epoll_ctl(global_epoll_fd, EPOLL_CTL_ADD, sock, &ev) != 0) &&
+        (errno == EEXIST))
+      epoll_ctl(global_epoll_fd, EPOLL_CTL_MOD, sock, &ev);
+    }
+#endif
+
   pthread_mutex_unlock(global_sock_read_mutex);
   } /* END globalset_add_sock() */
 
@@ -980,6 +1158,13 @@ void globalset_del_sock(
   FD_CLR(sock, GlobalSocketReadSet);
   GlobalSocketAddrSet[sock] = 0;
   GlobalSocketPortSet[sock] = 0;
+
+#ifdef USE_EPOLL
+  /* a closed descriptor has already left the epoll set, so ignore errors */
+  if (global_epoll_fd >= 0)
+    epoll_ctl(global_epoll_fd, EPOLL_CTL_DEL, sock, NULL);
+#endif
+
   pthread_mutex_unlock(global_sock_read_mutex);
   } /* END globalset_del_sock() */
 
@@ -1042,6 +1227,10 @@ int add_connection(
   svr_conn[sock].cn_func     = func;
   svr_conn[sock].cn_oncl     = 0;
   svr_conn[sock].cn_socktype = socktype;
+  svr_conn[sock].cn_session  = NULL;
+
+  /* a reused socket starts over with classic DIS requests */
+  DIS_tcp_set_encoding(sock, DIS_ENCODING_CLASSIC);
 
 #ifndef NOPRIVPORTS
 
@@ -1198,6 +1387,7 @@ void close_conn(
   svr_conn[sd].cn_func = (void *(*)(void *))0;
   svr_conn[sd].cn_authen = 0;
   svr_conn[sd].cn_stay_open = FALSE;
+  svr_conn[sd].cn_session = NULL; /* the session belongs to the socket's thread */
     
   if (has_mutex == FALSE)
     pthread_mutex_unlock(svr_conn[sd].cn_mutex);
@@ -1266,6 +1456,7 @@ void clear_conn(
   svr_conn[sd].cn_func = (void *(*)(void *))0;
   svr_conn[sd].cn_authen = 0;
   svr_conn[sd].cn_stay_open = FALSE;
+  svr_conn[sd].cn_session = NULL; /* the session belongs to the socket's thread */
     
   if (has_mutex == FALSE)
     pthread_mutex_unlock(svr_conn[sd].cn_mutex);
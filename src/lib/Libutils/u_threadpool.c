@@ -97,6 +97,124 @@ threadpool_t *async_pool;
 
 static void *work_thread(void *);
 
+/* the pool and queue a worker thread owns. Work enqueued from a worker goes
+ * to its own queue, everything else is spread round robin */
+static __thread threadpool_t *home_pool = NULL;
+static __thread int           home_queue = 0;
+static __thread tp_working_t *home_working = NULL;
+
+
+
+/*
+ * elapsed_usecs()
+ *
+ * @return the number of microseconds from start to end, 0 if negative
+ */
+
+static unsigned long long elapsed_usecs(
+
+  struct timespec *start,
+  struct timespec *end)
+
+  {
+  long long usecs;
+
+  usecs = (long long)(end->tv_sec - start->tv_sec) * 1000000 +
+          (end->tv_nsec - start->tv_nsec) / 1000;
+
+  if (usecs < 0)
+    return(0);
+
+  return((unsigned long long)usecs);
+  } /* END elapsed_usecs() */
+
+
+
+/*
+ * record_wait_time()
+ *
+ * updates the pool's wait-time counters for a work item that was just dequeued
+ */
+
+static void record_wait_time(
+
+  threadpool_t *tp,
+  tp_work_t    *work,
+  bool          stolen)
+
+  {
+  struct timespec    now;
+  unsigned long long waited;
+  unsigned long long max_wait;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  waited = elapsed_usecs(&work->queued_at, &now);
+
+  __sync_fetch_and_add(&tp->tp_stats.completed, 1);
+  __sync_fetch_and_add(&tp->tp_stats.total_wait_usecs, waited);
+
+  if (stolen == true)
+    __sync_fetch_and_add(&tp->tp_stats.stolen, 1);
+
+  max_wait = tp->tp_stats.max_wait_usecs;
+  while ((waited > max_wait) &&
+         (__sync_bool_compare_and_swap(&tp->tp_stats.max_wait_usecs, max_wait, waited) == false))
+    max_wait = tp->tp_stats.max_wait_usecs;
+  } /* END record_wait_time() */
+
+
+
+/*
+ * dequeue_work()
+ *
+ * takes the oldest item from queue home, or steals from the other queues
+ * when home is empty. No pool lock is held.
+ *
+ * @param tp - the threadpool
+ * @param home - the index of the calling thread's queue
+ * @return the work item, or NULL if every queue is empty
+ */
+
+static tp_work_t *dequeue_work(
+
+  threadpool_t *tp,
+  int           home)
+
+  {
+  tp_work_t  *work;
+  tp_queue_t *q;
+  int         i;
+
+  for (i = 0; i < TP_QUEUES; i++)
+    {
+    if (__sync_fetch_and_add(&tp->tp_pending, 0) <= 0)
+      break;
+
+    q = &tp->tp_queues[(home + i) % TP_QUEUES];
+
+    pthread_mutex_lock(&q->q_mutex);
+
+    if ((work = q->q_first) != NULL)
+      {
+      q->q_first = work->next;
+
+      if (q->q_last == work)
+        q->q_last = NULL;
+      }
+
+    pthread_mutex_unlock(&q->q_mutex);
+
+    if (work != NULL)
+      {
+      __sync_sub_and_fetch(&tp->tp_pending, 1);
+      record_wait_time(tp, work, i != 0);
+      return(work);
+      }
+    }
+
+  return(NULL);
+  } /* END dequeue_work() */
+
 
 /*
  * create_work_thread()
@@ -144,6 +262,25 @@ static void work_thread_cleanup(
 
   {
   threadpool_t *tp = (threadpool_t *)a;
+  tp_working_t *curr;
+  tp_working_t *prev = NULL;
+
+  /* take this thread off of the worker list */
+  for (curr = tp->tp_active; curr != NULL; prev = curr, curr = curr->next)
+    {
+    if (curr == home_working)
+      {
+      if (prev == NULL)
+        tp->tp_active = curr->next;
+      else
+        prev->next = curr->next;
+
+      break;
+      }
+    }
+
+  home_working = NULL;
+  home_pool = NULL;
 
   --tp->tp_nthreads;
 
@@ -157,7 +294,7 @@ static void work_thread_cleanup(
     if (create_work_thread(tp) == 0)
       tp->tp_nthreads++;
     }
-  else if ((tp->tp_first != NULL) &&
+  else if ((tp->tp_pending > 0) &&
            (tp->tp_nthreads < tp->tp_min_threads) &&
            (create_work_thread(tp) == 0))
     {
@@ -170,44 +307,19 @@ static void work_thread_cleanup(
 
 
 
+/*
+ * called if a worker thread is cancelled while running a work function.
+ * Takes tp_mutex so that work_thread_cleanup() runs with it held.
+ */
+
 void work_cleanup(
     
   void *a)
 
   {
   threadpool_t *tp = (threadpool_t *)a;
-  pthread_t   my_id = pthread_self();
-  tp_working_t  *curr;
-  tp_working_t  *prev = NULL;
 
   pthread_mutex_lock(&tp->tp_mutex);
-
-  /* make sure the active process gets removed */
-  curr = tp->tp_active;
-
-  while (curr != NULL)
-    {
-    if (curr->working_id == my_id)
-      {
-      /* handle if it's first in the list */
-      if (prev == NULL)
-        {
-        tp->tp_active = curr->next;
-        }
-      /* anywhere after first position */
-      else
-        {
-        prev->next = curr->next;
-        }
-
-      /* all done */       
-      break;
-      }
-
-    prev = curr;
-    curr = curr->next;
-    }
-
   } /* END work_cleanup() */
 
 
@@ -237,19 +349,25 @@ static void *work_thread(
     }
 
   pthread_mutex_lock(&tp->tp_mutex);
-  pthread_cleanup_push(work_thread_cleanup, tp);
+
   working.working_id = pthread_self();
+  working.busy = FALSE;
+  working.next = tp->tp_active;
+  tp->tp_active = &working;
+
+  home_pool = tp;
+  home_queue = tp->tp_next_home++ % TP_QUEUES;
+  home_working = &working;
+
+  pthread_cleanup_push(work_thread_cleanup, tp);
 
   /* this is the main work loop, which is only exited on timeout, if 
-   * a timeout is configured */
+   * a timeout is configured. tp_mutex is held at the top of the loop */
   for (;;) 
     {
-    /* reset signal mask for each job */
-    pthread_sigmask(SIG_SETMASK,&fillset,NULL);
-    pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED,NULL);
-    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE,NULL);
-
-    tp->tp_idle_threads++;
+    /* tp_idle_threads and tp_pending are read by enqueue_threadpool_request()
+     * without tp_mutex, so both sides use full barriers to avoid a lost wakeup */
+    __sync_add_and_fetch(&tp->tp_idle_threads, 1);
   
     /* stay asleep until the pool is started */
     while (tp->tp_started == FALSE)
@@ -261,8 +379,7 @@ static void *work_thread(
       pthread_mutex_lock(&tp->tp_mutex);
       }
 
-
-    while ((tp->tp_first == NULL) &&
+    while ((__sync_fetch_and_add(&tp->tp_pending, 0) <= 0) &&
            (!(tp->tp_flags & POOL_DESTROY)))
       {
       if ((tp->tp_nthreads <= tp->tp_min_threads) ||
@@ -288,47 +405,50 @@ static void *work_thread(
         (tp->tp_nthreads > tp->tp_min_threads) &&
         (tp->tp_idle_threads > 2))
       {
-      tp->tp_idle_threads--;
+      __sync_sub_and_fetch(&tp->tp_idle_threads, 1);
       break;
       }
 
-    tp->tp_idle_threads--;
+    rc = PBSE_NONE;
+    __sync_sub_and_fetch(&tp->tp_idle_threads, 1);
 
     /* if we're shutting down, leave this loop */
     if (tp->tp_flags & POOL_DESTROY)
       break;
 
-    if ((mywork = tp->tp_first) != NULL)
+    pthread_mutex_unlock(&tp->tp_mutex);
+
+    /* keep working without the pool lock until every queue is empty */
+    while ((mywork = dequeue_work(tp, home_queue)) != NULL)
       {
       func = mywork->work_func;
       arg  = mywork->work_arg;
+      free(mywork);
 
-      tp->tp_first = mywork->next;
-      if (tp->tp_last == mywork)
-        tp->tp_last = NULL;
-
-      working.next = tp->tp_active;
-      tp->tp_active = &working;
+      /* reset signal mask for each job */
+      pthread_sigmask(SIG_SETMASK,&fillset,NULL);
+      pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED,NULL);
+      pthread_setcancelstate(PTHREAD_CANCEL_ENABLE,NULL);
 
-      pthread_mutex_unlock(&tp->tp_mutex);
+      working.busy = TRUE;
       pthread_cleanup_push(work_cleanup,tp);
-      free(mywork);
 
       /* do the work */
       func(arg);
 
-      /* cleanup the work */
-      pthread_cleanup_pop(1); /* calls work_cleanup(NULL) */
+      pthread_cleanup_pop(0);
+      working.busy = FALSE;
+
+      if (tp->tp_flags & POOL_DESTROY)
+        break;
       }
+
+    pthread_mutex_lock(&tp->tp_mutex);
     }
 
   /* calls work_thread_cleanup(tp), this also unlock tp->tp_mutex */
   pthread_cleanup_pop(1);
 
-  /*sprintf(log_buf, "work_thread exiting. Current allocated threads: %d", request_pool->tp_nthreads);
-    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, log_buf);
-  sprintf(log_buf, "work_thread exiting. Current idle threads: %d", request_pool->tp_idle_threads);
-  log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, log_buf);*/
   pthread_exit(0);
   } /* END work_thread() */
 
@@ -366,6 +486,10 @@ int initialize_threadpool(
   pthread_mutex_init(&(*pool)->tp_mutex,NULL);
   pthread_cond_init(&(*pool)->tp_waiting_work,NULL);
   pthread_cond_init(&(*pool)->tp_can_destroy,NULL);
+
+  for (i = 0; i < TP_QUEUES; i++)
+    pthread_mutex_init(&(*pool)->tp_queues[i].q_mutex, NULL);
+
   (*pool)->tp_min_threads = min_threads;
   (*pool)->tp_max_threads = max_threads;
   (*pool)->tp_max_idle_secs = max_idle_time;
@@ -410,6 +534,15 @@ int initialize_threadpool(
 
 
 
+/*
+ * enqueue_threadpool_request()
+ *
+ * queues func(arg) to run on a thread from tp. The work goes on the calling
+ * worker's own queue or, from outside the pool, on the next queue round robin.
+ * tp_mutex is only taken when an idle thread must be woken or a new thread
+ * created.
+ */
+
 int enqueue_threadpool_request(
 
   void         *(*func)(void *),
@@ -417,8 +550,9 @@ int enqueue_threadpool_request(
   threadpool_t *tp)
 
   {
-  tp_work_t *work = NULL;
-/*  char              log_buf[LOCAL_LOG_BUF_SIZE];*/
+  tp_work_t  *work = NULL;
+  tp_queue_t *q;
+  int         index;
 
   if ((work = (tp_work_t *)calloc(1, sizeof(tp_work_t))) == NULL)
     {
@@ -428,23 +562,44 @@ int enqueue_threadpool_request(
   work->next = NULL;
   work->work_func = func;
   work->work_arg  = arg;
+  clock_gettime(CLOCK_MONOTONIC, &work->queued_at);
 
-  pthread_mutex_lock(&tp->tp_mutex);
+  if (home_pool == tp)
+    index = home_queue;
+  else
+    index = __sync_fetch_and_add(&tp->tp_next_queue, 1) % TP_QUEUES;
 
-  if (tp->tp_first == NULL)
-    tp->tp_first = work;
+  q = &tp->tp_queues[index];
+
+  pthread_mutex_lock(&q->q_mutex);
+
+  if (q->q_first == NULL)
+    q->q_first = work;
   else
-    tp->tp_last->next = work;
+    q->q_last->next = work;
   
-  tp->tp_last = work;
+  q->q_last = work;
+
+  pthread_mutex_unlock(&q->q_mutex);
+
+  __sync_add_and_fetch(&tp->tp_pending, 1);
 
-  if (tp->tp_idle_threads > 0)
+  if (__sync_fetch_and_add(&tp->tp_idle_threads, 0) > 0)
+    {
+    pthread_mutex_lock(&tp->tp_mutex);
     pthread_cond_signal(&tp->tp_waiting_work);
-  else if ((tp->tp_nthreads < tp->tp_max_threads) &&
-           (create_work_thread(tp) == 0))
-    tp->tp_nthreads++;
+    pthread_mutex_unlock(&tp->tp_mutex);
+    }
+  else if (tp->tp_nthreads < tp->tp_max_threads)
+    {
+    pthread_mutex_lock(&tp->tp_mutex);
 
-  pthread_mutex_unlock(&tp->tp_mutex);
+    if ((tp->tp_nthreads < tp->tp_max_threads) &&
+        (create_work_thread(tp) == 0))
+      tp->tp_nthreads++;
+
+    pthread_mutex_unlock(&tp->tp_mutex);
+    }
 
   return(0);
   } /* END enqueue_threadpool_request() */
@@ -496,6 +651,7 @@ void destroy_request_pool(
   {
   tp_work_t    *work;
   tp_working_t *ptr;
+  int           i;
 
   pthread_mutex_lock(&tp->tp_mutex);
 
@@ -507,7 +663,9 @@ void destroy_request_pool(
   ptr = tp->tp_active;
   while (ptr != NULL)
     {
-    pthread_cancel(ptr->working_id);
+    if (ptr->busy == TRUE)
+      pthread_cancel(ptr->working_id);
+
     ptr = ptr->next;
     }
 
@@ -518,11 +676,18 @@ void destroy_request_pool(
   pthread_mutex_unlock(&tp->tp_mutex);
 
   /* free pending work */
-  while ((work = tp->tp_first) != NULL)
+  for (i = 0; i < TP_QUEUES; i++)
     {
-    tp->tp_first = work->next;
-    free(work);
+    while ((work = tp->tp_queues[i].q_first) != NULL)
+      {
+      tp->tp_queues[i].q_first = work->next;
+      free(work);
+      }
+
+    tp->tp_queues[i].q_last = NULL;
     }
+
+  tp->tp_pending = 0;
   } /* END destroy_request_pool() */
 
 
@@ -541,5 +706,26 @@ void start_request_pool(
 
 
 
+/*
+ * get_threadpool_stats()
+ *
+ * copies the pool's queue depth and wait-time counters into stats
+ */
+
+void get_threadpool_stats(
+
+  threadpool_t *tp,
+  tp_stats_t   *stats)
+
+  {
+  stats->queue_depth      = __sync_fetch_and_add(&tp->tp_pending, 0);
+  stats->completed        = __sync_fetch_and_add(&tp->tp_stats.completed, 0);
+  stats->stolen           = __sync_fetch_and_add(&tp->tp_stats.stolen, 0);
+  stats->total_wait_usecs = __sync_fetch_and_add(&tp->tp_stats.total_wait_usecs, 0);
+  stats->max_wait_usecs   = __sync_fetch_and_add(&tp->tp_stats.max_wait_usecs, 0);
+  } /* END get_threadpool_stats() */
+
+
+
 /* END u_threadpool.c */
 
@@ -2352,38 +2352,85 @@ int get_job_sid_from_pid(pid_t pid)
 
 
 /*
- * Declare start of polling loop.
+ * add_proc_to_sample()
  *
- * This function caches information about all of processes
- * on the compute node (pbs_mom calls this function). Each process
- * in /proc/ is queried by looking at the 'stat' file. Statistics like
- * CPU usage time, memory consumption, etc. are gathered in the proc_array
- * list. This list is then used throughout the pbs_mom to get information
- * about tasks it is monitoring.
- *
- * This function is called from the main MOM loop once every "check_poll_interval"
- * seconds.
- *
- * @see get_proc_stat() - child
- * @see mom_set_use() - Aggregates data collected here
+ * reads the stat for pid and appends it to proc_array, growing the array as needed.
  *
- * NOTE:  populates global 'proc_array[]' variable.
- * NOTE:  reallocs proc_array[] as needed to accomodate processes.
- * NOTE:  populates global 'pid2jobsid_map' map (pid to owning job session id mapping for all pids).
- * NOTE:  populates global 'pid2procarrayindex_map' map (pid to index in proc_array map).
+ * @return PBSE_NONE if the process was added, -1 if it could not be read,
+ * PBSE_SYSTEM if proc_array could not be grown
+ */
+
+static int add_proc_to_sample(
+
+  pid_t pid)
+
+  {
+  proc_stat_t *pi;
+  proc_stat_t *ps;
+
+  if ((ps = get_proc_stat(pid)) == NULL)
+    {
+    if (errno != ENOENT)
+      {
+      sprintf(log_buffer, "%d: get_proc_stat", pid);
+
+      log_err(errno, __func__, log_buffer);
+      }
+
+    return(-1);
+    }
+
+  /* nproc++; -- we need to increment AFTER assigning this ps to
+     the proc_array--otherwise we could skip it in for loops */
+
+  if ((nproc + 1) >= max_proc)
+    {
+    proc_stat_t *hold;
+
+    if (LOGLEVEL >= 9)
+      {
+      log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, __func__, "alloc more proc_array");
+      }
+
+    max_proc *= 2;
+
+    hold = (proc_stat_t *)calloc(1, max_proc * sizeof(proc_stat_t));
+
+    if (hold == NULL)
+      {
+      log_err(errno, __func__, "unable to realloc space for proc_array sample");
+
+      return(PBSE_SYSTEM);
+      }
+
+    memcpy(hold, proc_array, sizeof(proc_stat_t) * max_proc / 2);
+    free(proc_array);
+
+    proc_array = hold;
+    }  /* END if ((nproc+1) == max_proc) */
+
+  /* map pid to proc_array index */
+  pid2procarrayindex_map[pid] = nproc;
+
+  pi = &proc_array[nproc++];
+
+  memcpy(pi, ps, sizeof(proc_stat_t));
+
+  return(PBSE_NONE);
+  } /* END add_proc_to_sample() */
+
+
+
+/*
+ * sample_all_procs()
  *
- * @see mom_open_poll() - allocs proc_array table.
- * @see mom_close_poll() - frees procs_array.
- * @see setup_program_environment() - parent - called at pbs_mom start
- * @see main_loop() - parent - called once per iteration
- * @see mom_set_use() - populate job structure with usage data for local use or to send to mother superior
+ * loads proc_array with every process in /proc, or with every process in
+ * and below the torque cpuset when cpusets are enabled.
  */
 
-int mom_get_sample(void)
+static int sample_all_procs()
 
   {
-  proc_stat_t           *pi;
-  proc_stat_t           *ps;
   pid_t                  pid;
 #ifdef PENABLE_LINUX26_CPUSETS
   struct pidl           *pids = NULL;
@@ -2392,22 +2439,6 @@ int mom_get_sample(void)
   struct dirent         *dent;
 #endif
 
-  if (proc_array == NULL)
-    mom_open_poll();
-
-  nproc = 0;
-
-  /* clear the maps */
-  pid2jobsid_map.clear();
-  pid2procarrayindex_map.clear();
-
-  pi = proc_array;
-
-  if (LOGLEVEL >= 6)
-    {
-    log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, __func__, "proc_array load started");
-    }
-
 #ifdef PENABLE_LINUX26_CPUSETS
 
   /* Instead of collect stats of all processes running on a large SMP system,
@@ -2441,59 +2472,207 @@ int mom_get_sample(void)
 
     pid = atoi(dent->d_name);
 #endif
-    if ((ps = get_proc_stat(pid)) == NULL)
+    if (add_proc_to_sample(pid) == PBSE_SYSTEM)
       {
-      if (errno != ENOENT)
-        {
-        sprintf(log_buffer, "%d: get_proc_stat", pid);
+#ifdef PENABLE_LINUX26_CPUSETS
+      free_pidlist(pids);
+#endif
+      return(PBSE_SYSTEM);
+      }
+    }  /* END while (...) != NULL) */
 
-        log_err(errno, __func__, log_buffer);
-        }
+#ifdef PENABLE_LINUX26_CPUSETS
+  free_pidlist(pids);
+#endif
+
+  return(PBSE_NONE);
+  } /* END sample_all_procs() */
+
+
+
+/*
+ * read_cgroup_procs()
+ *
+ * appends the pids in dir/cgroup.procs, and in the cgroup.procs of each
+ * child cgroup (the per task R<req>.t<task> groups), to pids.
+ *
+ * @param dir - the cgroup directory
+ * @param pids - O the pids found
+ * @return PBSE_NONE, or -1 if dir could not be read (errno is set)
+ */
+
+int read_cgroup_procs(
 
+  const std::string  &dir,
+  std::vector<pid_t> &pids)
+
+  {
+  std::string    procs_path = dir + "/cgroup.procs";
+  FILE          *fp;
+  DIR           *cg_dir;
+  struct dirent *dent;
+  struct stat    sb;
+  long           pid;
+
+  if ((fp = fopen(procs_path.c_str(), "r")) == NULL)
+    return(-1);
+
+  while (fscanf(fp, "%ld", &pid) == 1)
+    pids.push_back((pid_t)pid);
+
+  fclose(fp);
+
+  if ((cg_dir = opendir(dir.c_str())) == NULL)
+    return(-1);
+
+  while ((dent = readdir(cg_dir)) != NULL)
+    {
+    if (dent->d_name[0] == '.')
       continue;
-      }
 
-    /* nproc++; -- we need to increment AFTER assigning this ps to
-       the proc_array--otherwise we could skip it in for loops */
+    std::string child = dir + "/" + dent->d_name;
 
-    if ((nproc + 1) >= max_proc)
-      {
-      proc_stat_t *hold;
+    if ((stat(child.c_str(), &sb) == 0) &&
+        (S_ISDIR(sb.st_mode)))
+      read_cgroup_procs(child, pids);
+    }
 
-      if (LOGLEVEL >= 9)
+  closedir(cg_dir);
+
+  return(PBSE_NONE);
+  } /* END read_cgroup_procs() */
+
+
+
+#ifdef PENABLE_LINUX_CGROUPS
+/*
+ * sample_job_cgroups()
+ *
+ * loads proc_array with only the processes in the jobs' cpuacct cgroups, and
+ * maps each of them to its job's session id, so the cost of a sample follows
+ * the number of job processes rather than every process on the host.
+ *
+ * @return PBSE_NONE, PBSE_SYSTEM if proc_array could not be grown, or -1 if a
+ * running job's cgroup could not be read and /proc must be scanned instead
+ */
+
+static int sample_job_cgroups()
+
+  {
+  std::list<job *>::iterator iter;
+  std::vector<pid_t>         pids;
+  int                        job_sid;
+
+  for (iter = alljobs_list.begin(); iter != alljobs_list.end(); iter++)
+    {
+    job *pjob = *iter;
+
+    /* no processes until the job has a session */
+    if ((pjob->ji_wattr[JOB_ATR_session_id].at_flags & ATR_VFLAG_SET) == 0)
+      continue;
+
+    job_sid = pjob->ji_wattr[JOB_ATR_session_id].at_val.at_long;
+
+    pids.clear();
+
+    if (read_cgroup_procs(cg_cpuacct_path + pjob->ji_qs.ji_jobid, pids) != PBSE_NONE)
+      {
+      if (LOGLEVEL >= 6)
         {
-        log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, __func__, "alloc more proc_array");
+        snprintf(log_buffer, sizeof(log_buffer),
+          "cannot read the cgroup of job %s (%s), sampling all of /proc",
+          pjob->ji_qs.ji_jobid, strerror(errno));
+        log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, __func__, log_buffer);
         }
 
-      max_proc *= 2;
+      return(-1);
+      }
 
-      hold = (proc_stat_t *)calloc(1, max_proc * sizeof(proc_stat_t));
+    for (unsigned int i = 0; i < pids.size(); i++)
+      {
+      int rc = add_proc_to_sample(pids[i]);
 
-      if (hold == NULL)
-        {
-        log_err(errno, __func__, "unable to realloc space for proc_array sample");
+      if (rc == PBSE_SYSTEM)
+        return(rc);
 
-        return(PBSE_SYSTEM);
-        }
+      if ((rc == PBSE_NONE) &&
+          (job_sid > 1))
+        pid2jobsid_map[pids[i]] = job_sid;
+      }
+    }
+
+  return(PBSE_NONE);
+  } /* END sample_job_cgroups() */
+#endif /* PENABLE_LINUX_CGROUPS */
+
+
+/*
+ * Declare start of polling loop.
+ *
+ * This function caches information about all of processes
+ * on the compute node (pbs_mom calls this function). Each process
+ * in /proc/ is queried by looking at the 'stat' file. Statistics like
+ * CPU usage time, memory consumption, etc. are gathered in the proc_array
+ * list. This list is then used throughout the pbs_mom to get information
+ * about tasks it is monitoring.
+ *
+ * This function is called from the main MOM loop once every "check_poll_interval"
+ * seconds.
+ *
+ * When built with cgroups only the processes in the jobs' cgroups are read.
+ *
+ * @see get_proc_stat() - child
+ * @see mom_set_use() - Aggregates data collected here
+ *
+ * NOTE:  populates global 'proc_array[]' variable.
+ * NOTE:  reallocs proc_array[] as needed to accomodate processes.
+ * NOTE:  populates global 'pid2jobsid_map' map (pid to owning job session id mapping for all pids).
+ * NOTE:  populates global 'pid2procarrayindex_map' map (pid to index in proc_array map).
+ *
+ * @see mom_open_poll() - allocs proc_array table.
+ * @see mom_close_poll() - frees procs_array.
+ * @see setup_program_environment() - parent - called at pbs_mom start
+ * @see main_loop() - parent - called once per iteration
+ * @see mom_set_use() - populate job structure with usage data for local use or to send to mother superior
+ */
 
-      memcpy(hold, proc_array, sizeof(proc_stat_t) * max_proc / 2);
-      free(proc_array);
+int mom_get_sample(void)
 
-      proc_array = hold;
-      }  /* END if ((nproc+1) == max_proc) */
+  {
+  int                    rc;
 
-    /* map pid to proc_array index */
-    pid2procarrayindex_map[pid] = nproc;
+  if (proc_array == NULL)
+    mom_open_poll();
 
-    pi = &proc_array[nproc++];
+  nproc = 0;
 
-    memcpy(pi, ps, sizeof(proc_stat_t));
-    }  /* END while (...) != NULL) */
+  /* clear the maps */
+  pid2jobsid_map.clear();
+  pid2procarrayindex_map.clear();
 
-#ifdef PENABLE_LINUX26_CPUSETS
-  free_pidlist(pids);
+  if (LOGLEVEL >= 6)
+    {
+    log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, __func__, "proc_array load started");
+    }
+
+#ifdef PENABLE_LINUX_CGROUPS
+  /* every job process lives in its job's cgroup, so only those need to be
+   * read. Scan all of /proc only if a job's cgroup can't be read */
+  if ((rc = sample_job_cgroups()) == -1)
+    {
+    nproc = 0;
+    pid2jobsid_map.clear();
+    pid2procarrayindex_map.clear();
+
+    rc = sample_all_procs();
+    }
+#else
+  rc = sample_all_procs();
 #endif
 
+  if (rc != PBSE_NONE)
+    return(rc);
+
   if (LOGLEVEL >= 6)
     {
     sprintf(log_buffer, "proc_array loaded - nproc=%d",
@@ -2516,6 +2695,10 @@ int mom_get_sample(void)
       continue;
       }
 
+    /* already mapped from its job's cgroup */
+    if (pid2jobsid_map.find(proc_array[i].pid) != pid2jobsid_map.end())
+      continue;
+
     /* If the session of this entry is in the global_job_sid_set then it belongs to the job.
        associate the pid with the session of the job */
     it = global_job_sid_set.find(proc_array[i].session);
@@ -244,6 +244,7 @@
 #include "mom_func.h"
 #include <string>
 #include <vector>
+#include <map>
 #include "container.hpp"
 #include <arpa/inet.h>
 #ifdef PENABLE_LINUX_CGROUPS
@@ -305,6 +306,12 @@ extern u_long              localaddr;
 extern container::item_container<received_node *> received_statuses;
 std::vector<std::string>   global_gpu_status;
 std::vector<std::string>   mom_status;
+/* the status strings, by key, that the server last acknowledged */
+std::map<std::string, std::string> acked_status;
+/* the complete status behind the update being sent */
+std::map<std::string, std::string> sent_status;
+int                        updates_since_full_status = 0;
+bool                       status_acked = false;
 
 
 extern struct config *rm_search(struct config *where, const char *what);
@@ -1318,6 +1325,8 @@ int mom_server_update_stat(
     return(NO_SERVER_CONFIGURED);
     }
 
+  status_acked = false;
+
   stream = tcp_connect_sockaddr((struct sockaddr *)&pms->sock_addr, sizeof(pms->sock_addr), false);
  
   if (IS_VALID_STREAM(stream))
@@ -1343,6 +1352,14 @@ int mom_server_update_stat(
     else
       {
       read_tcp_reply(chan, IS_PROTOCOL, IS_PROTOCOL_VER, IS_STATUS, &ret);
+
+      if (ret == SEND_FULL_STATUS)
+        {
+        /* the update was taken, but the server wants the whole status next time */
+        ret = DIS_SUCCESS;
+        }
+      else if (ret == DIS_SUCCESS)
+        status_acked = true;
       }
 
     if (chan != NULL)
@@ -1553,6 +1570,195 @@ int append_gpu_status(
 
 
 
+/*
+ * status_key()
+ *
+ * @return the key a status string reports, "name" for "name=value"
+ */
+
+std::string status_key(
+
+  const std::string &str)
+
+  {
+  return(str.substr(0, str.find('=')));
+  } /* END status_key() */
+
+
+
+/*
+ * always_send_status()
+ *
+ * The server acts on these strings every time it receives them (state changes,
+ * job syncing, down_on_error), so they are part of every delta update.
+ */
+
+bool always_send_status(
+
+  const std::string &key)
+
+  {
+  return((key == "state") ||
+         (key == "jobs") ||
+         (key == "message"));
+  } /* END always_send_status() */
+
+
+
+/*
+ * make_status_delta()
+ *
+ * When $status_delta_refresh is set, reduces status to the strings whose values
+ * changed since the server last acknowledged an update.  The keys that are no
+ * longer reported are sent as STATUS_UNSET_KEYWORD entries and the gpu and mic
+ * sections are passed through unchanged.  The complete status is kept in
+ * sent_status so it can be recorded once the server acknowledges it.
+ *
+ * A full status is sent instead when nothing has been acknowledged yet or when
+ * $status_delta_refresh updates have gone out since the last full one.
+ *
+ * @return true if status now holds a delta
+ */
+
+bool make_status_delta(
+
+  std::vector<std::string> &status)
+
+  {
+  sent_status.clear();
+
+#ifdef NUMA_SUPPORT
+  /* each numa board reports separately, so there is no single status to diff */
+  return(false);
+#else
+  std::vector<std::string>  delta;
+  unsigned int              i;
+
+  if (status_delta_refresh <= 0)
+    return(false);
+
+  for (i = 0; i < status.size(); i++)
+    {
+    if ((status[i] == START_GPU_STATUS) ||
+        (status[i] == START_MIC_STATUS))
+      break;
+
+    sent_status[status_key(status[i])] = status[i];
+    }
+
+  if ((acked_status.size() == 0) ||
+      (updates_since_full_status >= status_delta_refresh))
+    return(false);
+
+  delta.push_back(STATUS_DELTA_KEYWORD);
+
+  for (i = 0; i < status.size(); i++)
+    {
+    if ((status[i] == START_GPU_STATUS) ||
+        (status[i] == START_MIC_STATUS))
+      break;
+
+    std::string key(status_key(status[i]));
+    std::map<std::string, std::string>::iterator it = acked_status.find(key);
+
+    if ((it == acked_status.end()) ||
+        (it->second != status[i]) ||
+        (always_send_status(key) == true))
+      delta.push_back(status[i]);
+    }
+
+  for (std::map<std::string, std::string>::iterator it = acked_status.begin();
+       it != acked_status.end();
+       it++)
+    {
+    if (sent_status.find(it->first) == sent_status.end())
+      delta.push_back(STATUS_UNSET_KEYWORD + it->first);
+    }
+
+  /* the gpu and mic sections always go out in full */
+  delta.insert(delta.end(), status.begin() + i, status.end());
+
+  status.swap(delta);
+
+  return(true);
+#endif /* NUMA_SUPPORT */
+  } /* END make_status_delta() */
+
+
+
+/*
+ * write_acked_status()
+ *
+ * Tells the parent pbs_mom which status the server acknowledged.  Written after the
+ * update's return code as " <delta>\n" followed by each status string, NUL
+ * terminated.
+ */
+
+void write_acked_status(
+
+  int  fd,
+  bool delta)
+
+  {
+  std::string msg(delta ? " 1\n" : " 0\n");
+
+  for (std::map<std::string, std::string>::iterator it = sent_status.begin();
+       it != sent_status.end();
+       it++)
+    {
+    msg += it->second;
+    msg += '\0';
+    }
+
+  if (write(fd, msg.c_str(), msg.size()) != (ssize_t)msg.size())
+    log_err(errno, __func__, "Couldn't report the acknowledged status");
+  } /* END write_acked_status() */
+
+
+
+/*
+ * read_acked_status()
+ *
+ * Records the status the server acknowledged, as reported by write_acked_status().
+ * If the reply doesn't contain one the next update must be a full one.
+ */
+
+void read_acked_status(
+
+  const std::string &reply)
+
+  {
+  int    rc;
+  int    delta;
+  size_t start = reply.find('\n');
+
+  acked_status.clear();
+
+  if ((start == std::string::npos) ||
+      (sscanf(reply.c_str(), "%d %d", &rc, &delta) != 2))
+    return;
+
+  if (delta != 0)
+    updates_since_full_status++;
+  else
+    updates_since_full_status = 0;
+
+  for (start++; start < reply.size();)
+    {
+    size_t end = reply.find('\0', start);
+
+    if (end == std::string::npos)
+      end = reply.size();
+
+    std::string str(reply, start, end - start);
+
+    acked_status[status_key(str)] = str;
+    start = end + 1;
+    }
+  } /* END read_acked_status() */
+
+
+
 int send_update_to_a_server()
 
   {
@@ -1650,7 +1856,9 @@ void mom_server_all_update_stat(void)
   int          fd_pipe[2];
   int          rc;
   char         buf[LOCAL_LOG_BUF_SIZE];
-  size_t       len;
+  ssize_t      len;
+  bool         status_delta = false;
+  std::string  reply;
 
   time_now = time(NULL);
 
@@ -1742,17 +1950,20 @@ void mom_server_all_update_stat(void)
       delete iter;
       received_statuses.unlock();
 
-      len = read(fd_pipe[0], buf, LOCAL_LOG_BUF_SIZE);
+      while ((len = read(fd_pipe[0], buf, LOCAL_LOG_BUF_SIZE)) > 0)
+        reply.append(buf, len);
 
       close(fd_pipe[0]);
 
-      if (len <= 0)
+      if (reply.size() == 0)
         {
         log_err(-1, __func__, "read of pipe failed for status update");
         return;
         }
 
-      if (buf[0] != '0')
+      read_acked_status(reply);
+
+      if (reply[0] != '0')
         num_stat_update_failures++;
       else
         {
@@ -1778,13 +1989,20 @@ void mom_server_all_update_stat(void)
       update_mom_status();
   
       if (send_status_through_hierarchy() != PBSE_NONE)
+        {
+        /* deltas only go directly to the server, never through the hierarchy */
+        status_delta = make_status_delta(mom_status);
         rc = send_update_to_a_server();
+        }
       }
 
     sprintf(buf, "%d", rc);
     len = strlen(buf);
     write(fd_pipe[1], buf, len);
 
+    if (status_acked == true)
+      write_acked_status(fd_pipe[1], status_delta);
+
     exit_called = true;
   
     exit(0);
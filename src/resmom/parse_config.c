@@ -123,6 +123,7 @@ double           cputfactor = 1.00;
 float            ideal_load_val = -1.0;
 int              exec_with_exec = 0;
 int              ServerStatUpdateInterval = DEFAULT_SERVER_STAT_UPDATES;
+int              status_delta_refresh = 0; /* 0 sends the full status every time */
 float            max_load_val = -1.0;
 char            *auto_ideal_load = NULL;
 char            *auto_max_load   = NULL;
@@ -280,6 +281,7 @@ unsigned long setreduceprologchecks(const char *);
 unsigned long setextpwdretry(const char *);
 unsigned long setexecwithexec(const char *);
 unsigned long setmaxupdatesbeforesending(const char *);
+unsigned long setstatusdeltarefresh(const char *);
 unsigned long setthreadunlinkcalls(const char *);
 unsigned long setapbasilpath(const char *);
 unsigned long setapbasilprotocol(const char *);
@@ -330,6 +332,7 @@ struct specials special[] = {
   { "checkpoint_run_exe",  mom_checkpoint_set_checkpoint_run_exe_name },
   { "down_on_error",       setdownonerror },
   { "status_update_time",  setstatusupdatetime },
+  { "status_delta_refresh", setstatusdeltarefresh },
   { "check_poll_time",     setcheckpolltime },
   { "tmpdir",              settmpdir },
   { "log_directory",       setlogdirectory },
@@ -2163,6 +2166,38 @@ unsigned long setstatusupdatetime(
 
 
 
+/*
+ * setstatusdeltarefresh()
+ *
+ * sets how many delta status updates are sent between two full ones. 0 turns
+ * delta updates off.
+ */
+
+unsigned long setstatusdeltarefresh(
+
+  const char *value)  /* I */
+
+  {
+  int i;
+
+  log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, __func__, value);
+
+  i = (int)strtol(value, NULL, 10);
+
+  if ((i < 0) || ((i == 0) && (value[0] != '0')))
+    {
+    return(0);  /* error */
+    }
+
+  status_delta_refresh = i;
+
+  return(1);
+  }  /* END setstatusdeltarefresh() */
+
+
+
+
+
 unsigned long setcheckpolltime(
 
   const char *value)  /* I */
@@ -2287,6 +2322,7 @@ void reset_config_vars()
   ideal_load_val = -1.0;
   exec_with_exec = 0;
   ServerStatUpdateInterval = DEFAULT_SERVER_STAT_UPDATES;
+  status_delta_refresh = 0;
   max_load_val = -1.0;
   auto_ideal_load = NULL;
   auto_max_load   = NULL;
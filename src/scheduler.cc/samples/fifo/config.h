@@ -120,6 +120,8 @@
 #define PARSE_MAX_STARVE "max_starve"
 #define PARSE_SORT_QUEUES "sort_queues"
 #define PARSE_IGNORE_QUEUE "ignore_queue"
+#define PARSE_JOB_CACHE_REFRESH "job_cache_refresh"
+#define PARSE_RUN_BATCH_SIZE "run_batch_size"
 
 /* max sizes */
 #define MAX_HOLIDAY_SIZE 50
@@ -129,6 +131,7 @@
 #define MAX_RES_NAME_SIZE 256
 #define MAX_RES_RET_SIZE 256
 #define MAX_IGNORED_QUEUES 16
+#define MAX_RUN_BATCH_SIZE 256
 
 
 /* messages -
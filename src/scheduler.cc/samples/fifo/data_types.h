@@ -481,6 +481,8 @@ unsigned non_prime_lbrr:
   char ded_prefix[PBS_MAXQUEUENAME +1]; /* prefix to dedicated queues */
   time_t max_starve;   /* starving threshold */
   char* ignored_queues[MAX_IGNORED_QUEUES]; /* list of ignored queues */
+  int job_cache_refresh;  /* cycles between fetching all jobs, 0 for every cycle */
+  int run_batch_size;   /* jobs started per run request, 0 for one at a time */
   };
 
 /* for description of these bits, check the PBS admin guide or scheduler IDS */
@@ -104,6 +104,7 @@
 #include "prime.h"
 #include "dedtime.h"
 #include "token_acct.h"
+#include "job_cache.h"
 #include "../lib/Libifl/lib_ifl.h"
 
 
@@ -113,6 +114,12 @@ static int last_running_size = 0;
 static time_t last_decay;
 static time_t last_sync;
 
+/* jobs run_update_job() has put off to start together, see flush_run_batch() */
+static job_info *run_batch_jobs[MAX_RUN_BATCH_SIZE];
+static char *run_batch_nodes[MAX_RUN_BATCH_SIZE];
+static int run_batch_count = 0;
+static int run_batch_unsupported = 0;
+
 
 /*
  *
@@ -421,6 +428,9 @@ int schedule(
 
       parse_config(CONFIG_FILE);
 
+      /* start over with the new settings */
+      free_job_cache();
+
       parse_holidays(HOLIDAYS_FILE);
 
       parse_ded_file(DEDTIME_FILE);
@@ -560,6 +570,8 @@ int scheduling_cycle(
       }
     }
 
+  flush_run_batch(sd);
+
   if (cstat.fair_share)
     update_last_running(sinfo);
 
@@ -667,6 +679,7 @@ int run_update_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
   int ncpus;    /* numeric amount of resource ncpus */
   int  local_errno = 0;
   char *errmsg;    /* used for pbs_geterrmsg() */
+  int batched = 0;   /* the job waits for flush_run_batch() */
 
   strftime(timebuf, 128, "started on %a %b %d at %H:%M", localtime(&cstat.current_time));
 
@@ -688,7 +701,21 @@ int run_update_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
 
   buf[0] = '\0';
 
-  ret = pbs_runjob_err(pbs_sd, jinfo -> name, best_node_name, NULL, &local_errno);
+  if ((conf.run_batch_size > 1) && (!run_batch_unsupported))
+    {
+    /* assume the job will start and find out when the batch is sent */
+    run_batch_jobs[run_batch_count] = jinfo;
+    run_batch_nodes[run_batch_count] = best_node_name;
+    run_batch_count++;
+    batched = 1;
+
+    if (run_batch_count >= conf.run_batch_size)
+      flush_run_batch(pbs_sd);
+
+    ret = 0;
+    }
+  else
+    ret = pbs_runjob_err(pbs_sd, jinfo -> name, best_node_name, NULL, &local_errno);
 
   if (ret == 0)
     {
@@ -708,7 +735,8 @@ int run_update_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
     if (cstat.help_starving_jobs && jinfo == cstat.starving_job)
       jinfo -> sch_priority = 0;
 
-    sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, jinfo -> name, "Job Run");
+    if (!batched)
+      sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, jinfo -> name, "Job Run");
 
     update_server_on_run(sinfo, qinfo, jinfo);
 
@@ -739,6 +767,64 @@ int run_update_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
   return ret;
   }
 
+/*
+ *
+ * flush_run_batch - start the jobs run_update_job() has put off with one
+ *                   request and comment the ones that didn't start
+ *
+ *   pbs_sd - connection to pbs_server
+ *
+ */
+void flush_run_batch(int pbs_sd)
+  {
+  char *names[MAX_RUN_BATCH_SIZE];
+  int codes[MAX_RUN_BATCH_SIZE];
+  char buf[RUJ_BUFSIZ];
+  char *errmsg;
+  int rc;
+  int i;
+
+  if (run_batch_count == 0)
+    return;
+
+  for (i = 0; i < run_batch_count; i++)
+    names[i] = run_batch_jobs[i] -> name;
+
+  rc = pbs_runjobs(pbs_sd, run_batch_count, names, run_batch_nodes, NULL, codes);
+
+  if (rc == PBSE_NOSUP)
+    {
+    /* the server doesn't know Run Jobs and has dropped the connection, the
+     * jobs will be tried again one at a time next cycle */
+    run_batch_unsupported = 1;
+
+    sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_SERVER, "",
+              "server can't run jobs in batches, running them one at a time");
+
+    run_batch_count = 0;
+
+    return;
+    }
+
+  for (i = 0; i < run_batch_count; i++)
+    {
+    if (codes[i] == PBSE_NONE)
+      {
+      sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, names[i], "Job Run");
+      }
+    else
+      {
+      errmsg = pbse_to_txt(codes[i]);
+      snprintf(buf, RUJ_BUFSIZ, "Not Running - PBS Error: %s",
+               (errmsg != NULL) ? errmsg : "unknown error");
+      update_job_comment(pbs_sd, run_batch_jobs[i], buf);
+      sched_log(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, names[i], buf);
+      }
+    }
+
+  run_batch_count = 0;
+  }
+
 /*
  *
  * next_job - find the next job to be run by the scheduler
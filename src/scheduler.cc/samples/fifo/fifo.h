@@ -109,6 +109,11 @@ int init_schedule_cycle(server_info *sinfo);
  */
 int run_update_job(int pbs_sd, server_info *sinfo, queue_info *qinfo,
                    job_info *jinfo);
+
+/*
+ *      flush_run_batch - start the jobs run_update_job() has put off
+ */
+void flush_run_batch(int pbs_sd);
 /*
  *
  *      next_job - find the next job to be run by the scheduler
@@ -0,0 +1,631 @@
+#include "license_pbs.h" /* See here for the software license */
+/*
+ * job_cache.c - keeps the status of the jobs in each queue between
+ *   scheduling cycles so a cycle only has to fetch the jobs that changed
+ *
+ * Every job's status is kept with its mtime.  A cycle asks the server for
+ * the names and mtimes of the jobs in the queue, for the full status of the
+ * jobs modified since the newest mtime seen so far and for the running jobs,
+ * whose resources_used change without touching mtime.  Every
+ * job_cache_refresh cycles, or when the cache is turned off, the whole queue
+ * is fetched again.
+ *
+ * Functions included are:
+ * query_cached_jobs()
+ * job_cache_end_cycle()
+ * free_job_cache()
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pbs_ifl.h"
+#include "log.h"
+#include "job_cache.h"
+#include "misc.h"
+#include "globals.h"
+#include "../lib/Libifl/lib_ifl.h"
+
+struct cached_job
+  {
+  char *name;    /* name of the job, points into status */
+  long mtime;    /* mtime of the job when status was fetched */
+
+  struct batch_status *status; /* status of the job, a list of one */
+  };
+
+struct job_cache
+  {
+  char *queue;    /* name of the queue */
+
+  struct cached_job *jobs;  /* the jobs in the queue, sorted by name */
+  int num_jobs;   /* number of jobs */
+
+  struct batch_status **status_arr; /* the jobs' status, for query_jobs() */
+  long newest_mtime;   /* the newest mtime seen in the queue */
+  int cycles;    /* cycles since the whole queue was fetched */
+
+unsigned used:
+  1;    /* queue was queried this cycle */
+
+unsigned is_valid:
+  1;    /* jobs were fetched without error last cycle */
+
+  struct job_cache *next;
+  };
+
+/* the job cache of every queue */
+static struct job_cache *job_caches = NULL;
+
+
+/*
+ *
+ * get_mtime - get the mtime of a job from its status
+ *
+ *   status - the status of the job
+ *
+ * returns the mtime or 0 if the status doesn't have one
+ *
+ */
+static long get_mtime(struct batch_status *status)
+  {
+  struct attrl *attrp;
+
+  for (attrp = status -> attribs; attrp != NULL; attrp = attrp -> next)
+    {
+    if (!strcmp(attrp -> name, ATTR_mtime))
+      return strtol(attrp -> value, NULL, 10);
+    }
+
+  return 0;
+  }
+
+/*
+ *
+ * cmp_cached_job - sort cached jobs by name
+ *
+ */
+static int cmp_cached_job(const void *v1, const void *v2)
+  {
+  return strcmp(((struct cached_job *) v1) -> name,
+                ((struct cached_job *) v2) -> name);
+  }
+
+/*
+ *
+ * find_cached_job - find a job in a sorted array of cached jobs
+ *
+ *   jobs - the jobs
+ *   num_jobs - the number of jobs
+ *   name - the job to find
+ *
+ * returns the job or NULL if it is not there or was already taken
+ *
+ */
+static struct cached_job *find_cached_job(struct cached_job *jobs, int num_jobs, char *name)
+  {
+  struct cached_job key;
+  struct cached_job *cj;
+
+  if (jobs == NULL)
+    return NULL;
+
+  key.name = name;
+
+  cj = (struct cached_job *) bsearch(&key, jobs, num_jobs, sizeof(struct cached_job), cmp_cached_job);
+
+  if ((cj == NULL) || (cj -> status == NULL))
+    return NULL;
+
+  return cj;
+  }
+
+/*
+ *
+ * to_cached_jobs - split a list of job status returned from the server into
+ *    a sorted array of cached jobs, one job per status
+ *
+ *   list - the list, which is consumed
+ *   num_jobs - set to the number of jobs
+ *
+ * returns the array or NULL if there are no jobs or on error
+ *
+ */
+static struct cached_job *to_cached_jobs(struct batch_status *list, int *num_jobs)
+  {
+  struct cached_job *jobs;
+  struct batch_status *cur;
+  struct batch_status *next;
+  int num = 0;
+  int i;
+
+  *num_jobs = 0;
+
+  for (cur = list; cur != NULL; cur = cur -> next)
+    num++;
+
+  if (num == 0)
+    return NULL;
+
+  if ((jobs = (struct cached_job *) malloc(sizeof(struct cached_job) * num)) == NULL)
+    {
+    perror("Memory allocation error");
+    pbs_statfree(list);
+    return NULL;
+    }
+
+  for (i = 0, cur = list; cur != NULL; i++, cur = next)
+    {
+    next = cur -> next;
+    cur -> next = NULL;
+
+    jobs[i].name = cur -> name;
+    jobs[i].mtime = get_mtime(cur);
+    jobs[i].status = cur;
+    }
+
+  qsort(jobs, num, sizeof(struct cached_job), cmp_cached_job);
+
+  *num_jobs = num;
+
+  return jobs;
+  }
+
+/*
+ *
+ * free_cached_jobs - free an array of cached jobs and the status of the
+ *      jobs that were not taken from it
+ *
+ *   jobs - the jobs
+ *   num_jobs - the number of jobs
+ *
+ * returns nothing
+ *
+ */
+static void free_cached_jobs(struct cached_job *jobs, int num_jobs)
+  {
+  int i;
+
+  if (jobs == NULL)
+    return;
+
+  for (i = 0; i < num_jobs; i++)
+    {
+    if (jobs[i].status != NULL)
+      pbs_statfree(jobs[i].status);
+    }
+
+  free(jobs);
+  }
+
+/*
+ *
+ * select_jobs - get the status of the jobs in a queue
+ *
+ *   pbs_sd - connection to pbs_server
+ *   queue - the queue
+ *   name - an attribute the jobs are also selected on, or NULL
+ *   value - the value of that attribute
+ *   op - how the attribute is compared
+ *   rattr - the attributes to return, or NULL for all of them
+ *   local_errno - set to the error from the server
+ *
+ * returns the status of the jobs, or NULL if there are none or on error
+ *
+ */
+static struct batch_status *select_jobs(int pbs_sd, char *queue, const char *name,
+                                        char *value, enum batch_op op, struct attrl *rattr, int *local_errno)
+  {
+  struct attropl opl[2];
+
+  opl[0].next = NULL;
+  opl[0].name = (char *)ATTR_q;
+  opl[0].resource = NULL;
+  opl[0].value = queue;
+  opl[0].op = EQ;
+
+  if (name != NULL)
+    {
+    opl[0].next = &opl[1];
+    opl[1].next = NULL;
+    opl[1].name = (char *)name;
+    opl[1].resource = NULL;
+    opl[1].value = value;
+    opl[1].op = op;
+    }
+
+  *local_errno = 0;
+
+  if (rattr != NULL)
+    return pbs_selstatattr_err(pbs_sd, opl, rattr, NULL, local_errno);
+
+  return pbs_selstat_err(pbs_sd, opl, NULL, local_errno);
+  }
+
+/*
+ *
+ * set_jobs_in_cache - replace the jobs in a queue's cache
+ *
+ *   jc - the job cache
+ *   jobs - the new jobs, sorted by name
+ *   num_jobs - the number of new jobs
+ *
+ * returns nothing
+ *
+ */
+static void set_jobs_in_cache(struct job_cache *jc, struct cached_job *jobs, int num_jobs)
+  {
+  int i;
+
+  free_cached_jobs(jc -> jobs, jc -> num_jobs);
+
+  jc -> jobs = jobs;
+  jc -> num_jobs = num_jobs;
+
+  for (i = 0; i < num_jobs; i++)
+    {
+    if (jobs[i].mtime > jc -> newest_mtime)
+      jc -> newest_mtime = jobs[i].mtime;
+    }
+  }
+
+/*
+ *
+ * fetch_all_jobs - fetch the status of every job in the queue
+ *
+ *   pbs_sd - connection to pbs_server
+ *   jc - the queue's job cache
+ *
+ * returns success/failure
+ *
+ */
+static int fetch_all_jobs(int pbs_sd, struct job_cache *jc)
+  {
+  struct batch_status *list;
+  struct cached_job *jobs;
+  int num_jobs;
+  int local_errno;
+
+  list = select_jobs(pbs_sd, jc -> queue, NULL, NULL, EQ, NULL, &local_errno);
+
+  if ((list == NULL) && (local_errno > 0))
+    {
+    fprintf(stderr, "pbs_selstat failed: %d\n", local_errno);
+    return 0;
+    }
+
+  jobs = to_cached_jobs(list, &num_jobs);
+
+  jc -> newest_mtime = 0;
+  jc -> cycles = 0;
+
+  set_jobs_in_cache(jc, jobs, num_jobs);
+
+  return 1;
+  }
+
+/*
+ *
+ * fetch_changed_jobs - bring a queue's cache up to date by fetching only
+ *        the jobs that were added or modified since the last
+ *        cycle, and the running jobs
+ *
+ *   pbs_sd - connection to pbs_server
+ *   jc - the queue's job cache
+ *
+ * returns success/failure
+ *
+ */
+static int fetch_changed_jobs(int pbs_sd, struct job_cache *jc)
+  {
+  struct attrl mtime_attr =
+    {
+    NULL, (char *)ATTR_mtime, NULL, NULL, SET
+    };
+
+  struct batch_status *present;  /* every job in the queue, mtime only */
+
+  struct batch_status *cur;
+  struct cached_job *changed;   /* jobs modified since the last cycle */
+  struct cached_job *running;   /* jobs running right now */
+  struct cached_job *jobs;
+  struct cached_job *cj;
+  struct batch_status *status;
+  int num_present = 0;
+  int num_changed;
+  int num_running;
+  int num_jobs = 0;
+  int local_errno;
+  int i;
+  char since[32];
+
+  present = select_jobs(pbs_sd, jc -> queue, NULL, NULL, EQ, &mtime_attr, &local_errno);
+
+  if ((present == NULL) && (local_errno > 0))
+    {
+    fprintf(stderr, "pbs_selstatattr failed: %d\n", local_errno);
+    return 0;
+    }
+
+  /* mtime only has a resolution of a second, so the jobs modified in the
+   * same second as the newest one seen are fetched again
+   */
+  sprintf(since, "%ld", jc -> newest_mtime);
+
+  changed = to_cached_jobs(select_jobs(pbs_sd, jc -> queue, ATTR_mtime, since, GE, NULL, &local_errno), &num_changed);
+
+  if (local_errno > 0)
+    {
+    pbs_statfree(present);
+    free_cached_jobs(changed, num_changed);
+    return 0;
+    }
+
+  running = to_cached_jobs(select_jobs(pbs_sd, jc -> queue, ATTR_state, (char *)"R", EQ, NULL, &local_errno), &num_running);
+
+  if (local_errno > 0)
+    {
+    pbs_statfree(present);
+    free_cached_jobs(changed, num_changed);
+    free_cached_jobs(running, num_running);
+    return 0;
+    }
+
+  for (cur = present; cur != NULL; cur = cur -> next)
+    num_present++;
+
+  if ((jobs = (struct cached_job *) malloc(sizeof(struct cached_job) * (num_present + num_changed + num_running + 1))) == NULL)
+    {
+    perror("Memory allocation error");
+    pbs_statfree(present);
+    free_cached_jobs(changed, num_changed);
+    free_cached_jobs(running, num_running);
+    return 0;
+    }
+
+  for (cur = present; cur != NULL; cur = cur -> next)
+    {
+    if (((cj = find_cached_job(running, num_running, cur -> name)) != NULL) ||
+        ((cj = find_cached_job(changed, num_changed, cur -> name)) != NULL))
+      {
+      jobs[num_jobs] = *cj;
+      cj -> status = NULL;
+      }
+    else if (((cj = find_cached_job(jc -> jobs, jc -> num_jobs, cur -> name)) != NULL) &&
+             (cj -> mtime == get_mtime(cur)))
+      {
+      /* unchanged since the last cycle */
+      jobs[num_jobs] = *cj;
+      cj -> status = NULL;
+      }
+    else
+      {
+      /* the job is new to the cache but wasn't modified recently, i.e. it
+       * was moved here from another queue.  Ask for it by itself.
+       */
+      status = pbs_statjob_err(pbs_sd, cur -> name, NULL, NULL, &local_errno);
+
+      if (status == NULL)
+        continue;
+
+      jobs[num_jobs].name = status -> name;
+      jobs[num_jobs].mtime = get_mtime(status);
+      jobs[num_jobs].status = status;
+      }
+
+    num_jobs++;
+    }
+
+  /* jobs that arrived after the names were fetched */
+  for (i = 0; i < num_changed; i++)
+    {
+    if (changed[i].status != NULL)
+      {
+      jobs[num_jobs++] = changed[i];
+      changed[i].status = NULL;
+      }
+    }
+
+  for (i = 0; i < num_running; i++)
+    {
+    if (running[i].status != NULL)
+      {
+      jobs[num_jobs++] = running[i];
+      running[i].status = NULL;
+      }
+    }
+
+  qsort(jobs, num_jobs, sizeof(struct cached_job), cmp_cached_job);
+
+  /* a running job that was also modified shows up twice */
+  for (i = 1; i < num_jobs; i++)
+    {
+    if (!strcmp(jobs[i - 1].name, jobs[i].name))
+      {
+      pbs_statfree(jobs[i].status);
+      memmove(&jobs[i], &jobs[i + 1], sizeof(struct cached_job) * (num_jobs - i - 1));
+      num_jobs--;
+      i--;
+      }
+    }
+
+  pbs_statfree(present);
+  free_cached_jobs(changed, num_changed);
+  free_cached_jobs(running, num_running);
+
+  if (num_jobs == 0)
+    {
+    free(jobs);
+    jobs = NULL;
+    }
+
+  set_jobs_in_cache(jc, jobs, num_jobs);
+
+  jc -> cycles++;
+
+  return 1;
+  }
+
+/*
+ *
+ * find_alloc_job_cache - find the job cache of a queue, creating it if it
+ *      doesn't exist
+ *
+ *   queue - name of the queue
+ *
+ * returns the job cache
+ *
+ */
+static struct job_cache *find_alloc_job_cache(char *queue)
+  {
+  struct job_cache *jc;
+
+  for (jc = job_caches; jc != NULL; jc = jc -> next)
+    {
+    if (!strcmp(jc -> queue, queue))
+      return jc;
+    }
+
+  if ((jc = (struct job_cache *) calloc(1, sizeof(struct job_cache))) == NULL)
+    {
+    perror("Memory allocation error");
+    return NULL;
+    }
+
+  jc -> queue = string_dup(queue);
+  jc -> next = job_caches;
+  job_caches = jc;
+
+  return jc;
+  }
+
+/*
+ *
+ * free_one_job_cache - free the job cache of a single queue
+ *
+ *   jc - the job cache
+ *
+ * returns nothing
+ *
+ */
+static void free_one_job_cache(struct job_cache *jc)
+  {
+  free_cached_jobs(jc -> jobs, jc -> num_jobs);
+
+  if (jc -> status_arr != NULL)
+    free(jc -> status_arr);
+
+  free(jc -> queue);
+
+  free(jc);
+  }
+
+/*
+ *
+ * query_cached_jobs - return the status of every job in a queue.  With the
+ *       cache turned on only the jobs added or modified since the
+ *       last cycle, and the running jobs, are fetched from the
+ *       server; the rest are the same as last cycle.
+ *
+ *   pbs_sd - connection to pbs_server
+ *   queue - name of the queue
+ *
+ * returns a NULL terminated array of job status owned by the cache, or NULL
+ * if the queue has no jobs or on error
+ *
+ */
+struct batch_status **query_cached_jobs(int pbs_sd, char *queue)
+  {
+  struct job_cache *jc;
+  int rc;
+  int i;
+
+  if ((jc = find_alloc_job_cache(queue)) == NULL)
+    return NULL;
+
+  jc -> used = 1;
+
+  if ((conf.job_cache_refresh > 0) &&
+      (jc -> is_valid) &&
+      (jc -> cycles < conf.job_cache_refresh))
+    {
+    if ((rc = fetch_changed_jobs(pbs_sd, jc)) == 0)
+      rc = fetch_all_jobs(pbs_sd, jc);
+    }
+  else
+    rc = fetch_all_jobs(pbs_sd, jc);
+
+  jc -> is_valid = (rc != 0);
+
+  if (jc -> status_arr != NULL)
+    {
+    free(jc -> status_arr);
+    jc -> status_arr = NULL;
+    }
+
+  if ((rc == 0) || (jc -> num_jobs == 0))
+    return NULL;
+
+  if ((jc -> status_arr = (struct batch_status **) malloc(sizeof(struct batch_status *) * (jc -> num_jobs + 1))) == NULL)
+    {
+    perror("Memory allocation error");
+    return NULL;
+    }
+
+  for (i = 0; i < jc -> num_jobs; i++)
+    jc -> status_arr[i] = jc -> jobs[i].status;
+
+  jc -> status_arr[i] = NULL;
+
+  return jc -> status_arr;
+  }
+
+/*
+ *
+ * job_cache_end_cycle - free the job caches of the queues which were not
+ *         queried this cycle, i.e. were deleted, and start
+ *         a new cycle
+ *
+ * returns nothing
+ *
+ */
+void job_cache_end_cycle(void)
+  {
+  struct job_cache *jc;
+  struct job_cache **prev = &job_caches;
+
+  while ((jc = *prev) != NULL)
+    {
+    if (jc -> used)
+      {
+      jc -> used = 0;
+      prev = &jc -> next;
+      }
+    else
+      {
+      *prev = jc -> next;
+      free_one_job_cache(jc);
+      }
+    }
+  }
+
+/*
+ *
+ * free_job_cache - free every job cache, so the next cycle fetches all the
+ *    jobs again
+ *
+ * returns nothing
+ *
+ */
+void free_job_cache(void)
+  {
+  struct job_cache *jc;
+
+  while ((jc = job_caches) != NULL)
+    {
+    job_caches = jc -> next;
+    free_one_job_cache(jc);
+    }
+  }
@@ -0,0 +1,25 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef JOB_CACHE_H
+#define JOB_CACHE_H
+
+#include "pbs_ifl.h"
+#include "data_types.h"
+
+/*
+ *      query_cached_jobs - return the status of every job in a queue,
+ *                          fetching only what changed since the last cycle
+ */
+struct batch_status **query_cached_jobs(int pbs_sd, char *queue);
+
+/*
+ *      job_cache_end_cycle - forget the queues that were not queried
+ *                            this cycle
+ */
+void job_cache_end_cycle(void);
+
+/*
+ *      free_job_cache - free every cached job status
+ */
+void free_job_cache(void);
+
+#endif
@@ -90,6 +90,7 @@
 #include "globals.h"
 #include "fairshare.h"
 #include "node_info.h"
+#include "job_cache.h"
 #include "../lib/Libifl/lib_ifl.h"
 
 
@@ -105,23 +106,9 @@
  */
 job_info **query_jobs(int pbs_sd, queue_info *qinfo)
   {
-  /* pbs_selstat() takes a linked list of attropl structs which tell it
-   * what information about what jobs to return.  We want all jobs which are
-   * in a specified queue
-   */
-
-  struct attropl opl =
-    {
-    NULL, (char *)ATTR_q, NULL, NULL, EQ
-    };
-
-  /* linked list of jobs returned from pbs_selstat() */
+  /* array of the status of the jobs in the queue, owned by the job cache */
 
-  struct batch_status *jobs;
-
-  /* current job in jobs linked list */
-
-  struct batch_status *cur_job;
+  struct batch_status **jobs;
 
   /* array of internal scheduler structures for jobs */
   job_info **jinfo_arr;
@@ -132,41 +119,25 @@ job_info **query_jobs(int pbs_sd, queue_info *qinfo)
   /* number of jobs in jinfo_arr */
   int num_jobs = 0;
   int i;
-  int local_errno = 0;
-
-  opl.value = qinfo -> name;
-
-  if ((jobs = pbs_selstat_err(pbs_sd, &opl, NULL, &local_errno)) == NULL)
-    {
-    if (local_errno > 0)
-      fprintf(stderr, "pbs_selstat failed: %d\n", local_errno);
 
+  if ((jobs = query_cached_jobs(pbs_sd, qinfo -> name)) == NULL)
     return NULL;
-    }
 
-  cur_job = jobs;
-
-  while (cur_job != NULL)
-    {
+  while (jobs[num_jobs] != NULL)
     num_jobs++;
-    cur_job = cur_job -> next;
-    }
 
   /* allocate enough space for all the jobs and the NULL sentinal */
   if ((jinfo_arr = (job_info **) malloc(sizeof(jinfo) * (num_jobs + 1))) == NULL)
     {
     perror("Memory allocation error");
-    pbs_statfree(jobs);
     return NULL;
     }
 
-  cur_job = jobs;
-
-  for (i = 0; cur_job != NULL; i++)
+  for (i = 0; jobs[i] != NULL; i++)
     {
-    if ((jinfo = query_job_info(cur_job, qinfo)) == NULL)
+    if ((jinfo = query_job_info(jobs[i], qinfo)) == NULL)
       {
-      pbs_statfree(jobs);
+      jinfo_arr[i] = NULL;
       free_jobs(jinfo_arr);
       return NULL;
       }
@@ -182,14 +153,10 @@ job_info **query_jobs(int pbs_sd, queue_info *qinfo)
       jinfo -> can_not_run = 1;
 
     jinfo_arr[i] = jinfo;
-
-    cur_job = cur_job -> next;
     }
 
   jinfo_arr[i] = NULL;
 
-  pbs_statfree(jobs);
-
   return jinfo_arr;
   }
 
@@ -108,6 +108,17 @@ int set_node_type(node_info *ninfo, char *ntype);
 node_info **query_nodes(int pbs_sd, server_info *sinfo)
   {
 
+  /* only ask for what query_node_info() uses, the status the moms report
+   * is by far the largest part of a node and isn't needed
+   */
+  static struct attrl node_attrs[] =
+    {
+    { &node_attrs[1], (char *)ATTR_NODE_state, NULL, NULL, SET },
+    { &node_attrs[2], (char *)ATTR_NODE_properties, NULL, NULL, SET },
+    { &node_attrs[3], (char *)ATTR_NODE_jobs, NULL, NULL, SET },
+    { NULL, (char *)ATTR_NODE_ntype, NULL, NULL, SET }
+    };
+
   struct batch_status *nodes;  /* nodes returned from the server */
 
   struct batch_status *cur_node; /* used to cycle through nodes */
@@ -119,7 +130,7 @@ node_info **query_nodes(int pbs_sd, server_info *sinfo)
   int i;
   int local_errno;
 
-  if ((nodes = pbs_statnode_err(pbs_sd, NULL, NULL, NULL, &local_errno)) == NULL)
+  if ((nodes = pbs_statnode_err(pbs_sd, NULL, node_attrs, NULL, &local_errno)) == NULL)
     {
     err = pbs_geterrmsg(pbs_sd);
     sprintf(errbuf, "Error getting nodes: %s", err);
@@ -260,6 +260,20 @@ int parse_config(const char *fname)
           conf.unknown_shares = num;
         else if (!strcmp(config_name, PARSE_LOG_FILTER))
           conf.log_filter = num;
+        else if (!strcmp(config_name, PARSE_JOB_CACHE_REFRESH))
+          {
+          if (num < 0)
+            error = 1;
+          else
+            conf.job_cache_refresh = num;
+          }
+        else if (!strcmp(config_name, PARSE_RUN_BATCH_SIZE))
+          {
+          if ((num < 0) || (num > MAX_RUN_BATCH_SIZE))
+            error = 1;
+          else
+            conf.run_batch_size = num;
+          }
         else if (!strcmp(config_name, PARSE_DEDICATED_PREFIX))
           {
           if (strlen(config_value) > PBS_MAXQUEUENAME)
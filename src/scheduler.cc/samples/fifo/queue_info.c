@@ -89,6 +89,7 @@
 #include "check.h"
 #include "config.h"
 #include "globals.h"
+#include "job_cache.h"
 #include "../lib/Libifl/lib_ifl.h"
 
 /*
@@ -211,6 +212,9 @@ queue_info **query_queues(int pbs_sd, server_info *sinfo)
 
   qinfo_arr[i] = NULL;
 
+  /* drop the cached jobs of queues that no longer exist */
+  job_cache_end_cycle();
+
   pbs_statfree(queues);
 
   return qinfo_arr;
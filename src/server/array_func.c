@@ -13,6 +13,7 @@
  */
 
 #include <errno.h>
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -56,6 +57,7 @@
 #include "mutex_mgr.hpp"
 #include "batch_request.h"
 #include "alps_constants.h"
+#include "threadpool.h"
 
 #ifndef PBS_MOM
 #include "../lib/Libutils/u_lock_ctl.h" /* lock_ss, unlock_ss */
@@ -1049,6 +1051,9 @@ int array_recov(
   pa->ai_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
   pthread_mutex_init(pa->ai_mutex,NULL);
 
+  /* the jobs aren't recovered yet, count them when cloning resumes */
+  pa->num_idle = -1;
+
   lock_ai_mutex(pa, __func__, NULL, LOGLEVEL);
 
   /* link the struct into the servers list of job arrays */
@@ -1654,6 +1659,7 @@ int delete_array_range(
   int                 i;
   int                 num_skipped = 0;
   int                 num_deleted = 0;
+  int                 num_uncloned = 0;
   int                 deleted;
   int                 running;
 
@@ -1675,15 +1681,18 @@ int delete_array_range(
 
   while (rn != NULL)
     {
+    /* jobs that haven't been cloned yet never will be */
+    num_uncloned += remove_uncloned_range(pa, rn->start, rn->end);
+
     for (i = rn->start; i <= rn->end; i++)
       {
-      if (pa->job_ids[i] == NULL)
-        continue;
-
       /* don't stomp on other memory */
       if (i >= pa->ai_qs.array_size)
         continue;
 
+      if (pa->job_ids[i] == NULL)
+        continue;
+
       if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
         {
         free(pa->job_ids[i]);
@@ -1731,6 +1740,8 @@ int delete_array_range(
 
   pa->ai_qs.num_failed += num_deleted;
 
+  purge_uncloned_subjobs(pa, num_uncloned);
+
   return(num_skipped);
   } /* END delete_array_range() */
 
@@ -1777,11 +1788,15 @@ int delete_whole_array(
   int num_skipped = 0;
   int num_jobs = 0;
   int num_deleted = 0;
+  int num_uncloned;
   int deleted;
   int running;
 
   job *pjob;
 
+  /* jobs that haven't been cloned yet never will be */
+  num_uncloned = remove_uncloned_range(pa, 0, INT_MAX);
+
   for (i = 0; i < pa->ai_qs.array_size; i++)
     {
     if (pa->job_ids[i] == NULL)
@@ -1828,6 +1843,8 @@ int delete_whole_array(
 
   pa->ai_qs.num_failed += num_deleted;
 
+  purge_uncloned_subjobs(pa, num_uncloned);
+
   if (num_jobs == 0)
     return(NO_JOBS_IN_ARRAY);
 
@@ -1886,7 +1903,19 @@ int hold_array_range(
           continue;
         
         if (pa->job_ids[i] == NULL)
+          {
+          /* jobs that haven't been cloned yet are cloned to be held */
+          if ((pjob = clone_subjob_now(&pa, i)) != NULL)
+            {
+            hold_job(temphold,pjob);
+            unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+            }
+
+          if (pa == NULL)
+            return(PBSE_UNKARRAYID);
+
           continue;
+          }
 
         if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
           {
@@ -1955,7 +1984,22 @@ int release_array_range(
         continue;
 
       if (pa->job_ids[i] == NULL)
+        {
+        /* jobs that haven't been cloned yet are cloned to be released */
+        if ((pjob = clone_subjob_now(&pa, i)) != NULL)
+          {
+          rc = release_job(preq, pjob);
+          unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+
+          if (rc != PBSE_NONE)
+            return(rc);
+          }
+
+        if (pa == NULL)
+          return(PBSE_UNKARRAYID);
+
         continue;
+        }
 
       if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
         {
@@ -2022,10 +2066,25 @@ int modify_array_range(
         {
         for (i = rn->start; i <= rn->end; i++)
           {
-          if ((i >= pa->ai_qs.array_size) ||
-              (pa->job_ids[i] == NULL))
+          if (i >= pa->ai_qs.array_size)
             continue;
 
+          if (pa->job_ids[i] == NULL)
+            {
+            /* jobs that haven't been cloned yet are cloned to be modified */
+            if ((pjob = clone_subjob_now(&pa, i)) != NULL)
+              unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+
+            if (pa == NULL)
+              {
+              array_gone = TRUE;
+              break;
+              }
+
+            if (pjob == NULL)
+              continue;
+            }
+
           if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
             {
             free(pa->job_ids[i]);
@@ -2108,6 +2167,9 @@ void update_array_values(
           pa->ai_qs.jobs_running++;
           pa->ai_qs.num_started++;
           }
+
+        if (pa->num_idle > 0)
+          pa->num_idle--;
         }
 
       break;
@@ -2119,6 +2181,13 @@ void update_array_values(
         if (pa->ai_qs.jobs_running > 0)
           pa->ai_qs.jobs_running--;
         }
+      else if ((old_state == JOB_STATE_QUEUED) ||
+               (old_state == JOB_STATE_HELD) ||
+               (old_state == JOB_STATE_WAITING))
+        {
+        if (pa->num_idle > 0)
+          pa->num_idle--;
+        }
 
       if (job_exit_status == 0)
         {
@@ -2196,6 +2265,9 @@ void update_array_values(
 
         if (pa->ai_qs.num_started > 0)
           pa->ai_qs.num_started--;
+
+        if (pa->num_idle >= 0)
+          pa->num_idle++;
         }
 
     default:
@@ -2208,6 +2280,9 @@ void update_array_values(
   set_array_depend_holds(pa);
   array_save(pa);
 
+  /* a job started or went away, there may be room for more idle jobs */
+  clone_more_subjobs(pa);
+
   } /* END update_array_values() */
 
 
@@ -2331,6 +2406,337 @@ int num_array_jobs(
   } /* END num_array_jobs */
 
 
+
+/*
+ * get_subjob_index()
+ *
+ * @param job_id - the id of a job in an array, like 12[3].napali
+ * @param parent_id - O - the id of its array, like 12[].napali
+ * @return the job's index in the array, or -1 if job_id isn't an array job
+ */
+
+int get_subjob_index(
+
+  const char *job_id,    /* I */
+  char       *parent_id) /* O */
+
+  {
+  const char *bracket = strchr(job_id, '[');
+  char       *end;
+  long        index;
+
+  if ((bracket == NULL) ||
+      (!isdigit(bracket[1])))
+    return(-1);
+
+  index = strtol(bracket + 1, &end, 10);
+
+  if ((*end != ']') ||
+      (index > INT_MAX))
+    return(-1);
+
+  array_get_parent_id((char *)job_id, parent_id);
+
+  return((int)index);
+  } /* END get_subjob_index() */
+
+
+
+/*
+ * is_uncloned_index()
+ *
+ * @param pa - the array, locked
+ * @return true if the job at index hasn't been cloned from the template yet
+ */
+
+bool is_uncloned_index(
+
+  job_array *pa,
+  int        index)
+
+  {
+  array_request_node *rn;
+
+  for (rn = (array_request_node *)GET_NEXT(pa->request_tokens);
+       rn != NULL;
+       rn = (array_request_node *)GET_NEXT(rn->request_tokens_link))
+    {
+    if ((index >= rn->start) &&
+        (index <= rn->end))
+      return(true);
+    }
+
+  return(false);
+  } /* END is_uncloned_index() */
+
+
+
+/*
+ * is_uncloned_subjob()
+ *
+ * @return true if job_id names an array job that hasn't been cloned yet
+ */
+
+bool is_uncloned_subjob(
+
+  const char *job_id)
+
+  {
+  job_array *pa;
+  char       parent_id[PBS_MAXSVRJOBID + 1];
+  int        index;
+  bool       uncloned;
+
+  if ((strlen(job_id) > PBS_MAXSVRJOBID) ||
+      ((index = get_subjob_index(job_id, parent_id)) < 0) ||
+      ((pa = get_array(parent_id)) == NULL))
+    return(false);
+
+  uncloned = is_uncloned_index(pa, index);
+
+  unlock_ai_mutex(pa, __func__, NULL, LOGLEVEL);
+
+  return(uncloned);
+  } /* END is_uncloned_subjob() */
+
+
+
+/*
+ * remove_uncloned_range()
+ *
+ * takes the indices from start to end out of the array's request tokens so
+ * they won't be cloned. Tokens that only partly overlap are trimmed or split.
+ *
+ * @param pa - the array, locked
+ * @return the number of indices that were removed
+ */
+
+int remove_uncloned_range(
+
+  job_array *pa,
+  int        start,
+  int        end)
+
+  {
+  array_request_node *rn;
+  array_request_node *next;
+  array_request_node *split;
+  int                 first;
+  int                 last;
+  int                 removed = 0;
+
+  for (rn = (array_request_node *)GET_NEXT(pa->request_tokens); rn != NULL; rn = next)
+    {
+    next = (array_request_node *)GET_NEXT(rn->request_tokens_link);
+
+    if ((rn->end < start) ||
+        (rn->start > end))
+      continue;
+
+    first = (rn->start > start) ? rn->start : start;
+    last = (rn->end < end) ? rn->end : end;
+    removed += last - first + 1;
+
+    if ((rn->start < first) &&
+        (rn->end > last))
+      {
+      /* the removed indices are in the middle of this token */
+      split = (array_request_node *)calloc(1, sizeof(array_request_node));
+
+      if (split == NULL)
+        {
+        log_err(ENOMEM, __func__, "Can't malloc");
+        return(removed - (last - first + 1));
+        }
+
+      split->start = last + 1;
+      split->end = rn->end;
+      CLEAR_LINK(split->request_tokens_link);
+      insert_link(&rn->request_tokens_link, &split->request_tokens_link, split, LINK_INSET_AFTER);
+
+      rn->end = first - 1;
+      }
+    else if (rn->start < first)
+      rn->end = first - 1;
+    else if (rn->end > last)
+      rn->start = last + 1;
+    else
+      {
+      delete_link(&rn->request_tokens_link);
+      free(rn);
+      }
+    }
+
+  return(removed);
+  } /* END remove_uncloned_range() */
+
+
+
+/*
+ * next_uncloned_index()
+ *
+ * takes the lowest index that is still to be cloned out of the array's
+ * request tokens
+ *
+ * @param pa - the array, locked
+ * @return the index, or -1 if every job has been cloned
+ */
+
+int next_uncloned_index(
+
+  job_array *pa)
+
+  {
+  array_request_node *rn = (array_request_node *)GET_NEXT(pa->request_tokens);
+  int                 index;
+
+  if (rn == NULL)
+    return(-1);
+
+  index = rn->start;
+
+  if (rn->start < rn->end)
+    rn->start++;
+  else
+    {
+    delete_link(&rn->request_tokens_link);
+    free(rn);
+    }
+
+  return(index);
+  } /* END next_uncloned_index() */
+
+
+
+/*
+ * purge_uncloned_subjobs()
+ *
+ * accounts for jobs that were deleted before they were cloned. They are
+ * counted like queued jobs that were deleted and then purged.
+ *
+ * @param pa - the array, locked
+ * @param count - the number of jobs remove_uncloned_range() took out
+ */
+
+void purge_uncloned_subjobs(
+
+  job_array *pa,
+  int        count)
+
+  {
+  if (count <= 0)
+    return;
+
+  pa->ai_qs.num_failed += count;
+  pa->ai_qs.jobs_done += count;
+  pa->ai_qs.num_purged += count;
+
+  set_array_depend_holds(pa);
+  array_save(pa);
+  } /* END purge_uncloned_subjobs() */
+
+
+
+/*
+ * count_idle_subjobs()
+ *
+ * @param pa - the array, locked
+ * @return the number of the array's jobs that are queued, held or waiting
+ */
+
+int count_idle_subjobs(
+
+  job_array *pa)
+
+  {
+  int  i;
+  int  num_idle = 0;
+  job *pjob;
+
+  for (i = 0; i < pa->ai_qs.array_size; i++)
+    {
+    if (pa->job_ids[i] == NULL)
+      continue;
+
+    if ((pjob = svr_find_job(pa->job_ids[i], FALSE)) == NULL)
+      continue;
+
+    if ((pjob->ji_qs.ji_state == JOB_STATE_QUEUED) ||
+        (pjob->ji_qs.ji_state == JOB_STATE_HELD) ||
+        (pjob->ji_qs.ji_state == JOB_STATE_WAITING))
+      num_idle++;
+
+    unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+    }
+
+  return(num_idle);
+  } /* END count_idle_subjobs() */
+
+
+
+/*
+ * clone_more_subjobs()
+ *
+ * When the server's idle_slot_limit is set, arrays are cloned only until
+ * that many of their jobs are idle. This starts job_clone_wt() again for
+ * the array if it has jobs left to clone and fewer idle jobs than that.
+ *
+ * @param pa - the array, locked
+ */
+
+void clone_more_subjobs(
+
+  job_array *pa)
+
+  {
+  long idle_slot_limit = 0;
+
+  if ((pa->cloning == true) ||
+      (GET_NEXT(pa->request_tokens) == NULL))
+    return;
+
+  if ((get_svr_attr_l(SRV_ATR_IdleSlotLimit, &idle_slot_limit) == PBSE_NONE) &&
+      (idle_slot_limit > 0) &&
+      (pa->num_idle >= idle_slot_limit))
+    return;
+
+  pa->cloning = true;
+  enqueue_threadpool_request(job_clone_wt, strdup(pa->ai_qs.parent_id), task_pool);
+  } /* END clone_more_subjobs() */
+
+
+
+/*
+ * hold_array_template()
+ *
+ * sets (INCR) or clears (DECR) holds on the template of an array that still
+ * has jobs to clone, so those jobs get them when they are cloned
+ *
+ * @param pa - the array, locked
+ */
+
+void hold_array_template(
+
+  job_array     *pa,
+  pbs_attribute *temphold,
+  enum batch_op  op)
+
+  {
+  job *template_job;
+
+  if (GET_NEXT(pa->request_tokens) == NULL)
+    return;
+
+  if ((template_job = svr_find_job(pa->ai_qs.parent_id, FALSE)) == NULL)
+    return;
+
+  mutex_mgr template_mutex(template_job->ji_mutex, true);
+
+  if (job_attr_def[JOB_ATR_hold].at_set(&template_job->ji_wattr[JOB_ATR_hold], temphold, op) == PBSE_NONE)
+    job_save(template_job, SAVEJOB_FULL, 0);
+  } /* END hold_array_template() */
+
+
 /* 
  * insert pa into the global array 
  */
@@ -0,0 +1,231 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+
+#include "change_log.hpp"
+
+
+
+/*
+ * next()
+ *
+ * @return a new change sequence number, larger than every one before it
+ */
+
+long long change_log::next()
+
+  {
+  return(__sync_add_and_fetch(&this->seq, 1));
+  } // END next()
+
+
+
+/*
+ * current()
+ *
+ * @return the last change sequence number handed out
+ */
+
+long long change_log::current()
+
+  {
+  return(__sync_add_and_fetch(&this->seq, 0));
+  } // END current()
+
+
+
+/*
+ * record_deletion()
+ *
+ * remembers that the object called name went away. For a job leaving a queue
+ * container is the queue's name, otherwise it is NULL or "". Once more than
+ * max_deletions are kept the oldest is dropped and changes before it can no
+ * longer be reported.
+ */
+
+void change_log::record_deletion(
+
+  int         objtype,
+  const char *name,
+  const char *container)
+
+  {
+  change_deletion deleted;
+
+  if (name == NULL)
+    return;
+
+  deleted.objtype = objtype;
+  deleted.name = name;
+
+  if (container != NULL)
+    deleted.container = container;
+
+  pthread_mutex_lock(&this->mutex);
+
+  // taken under the mutex so the deque stays in sequence order
+  deleted.seq = this->next();
+  this->deletions.push_back(deleted);
+
+  while (this->deletions.size() > this->max_deletions)
+    {
+    this->oldest = this->deletions.front().seq;
+    this->deletions.pop_front();
+    }
+
+  pthread_mutex_unlock(&this->mutex);
+  } // END record_deletion()
+
+
+
+/*
+ * get_deletions()
+ *
+ * adds to names the objects of objtype deleted from container after since.
+ * container is NULL or "" for objects gone from the server.
+ *
+ * @return false if not every change after since can be reported, that is
+ * since is older than the server's start or the oldest deletion kept, or is
+ * a number that hasn't been handed out yet.
+ */
+
+bool change_log::get_deletions(
+
+  int                       objtype,
+  const char               *container,
+  long long                 since,
+  std::vector<std::string> &names)
+
+  {
+  std::string                                 where;
+  std::deque<change_deletion>::const_iterator it;
+
+  if (container != NULL)
+    where = container;
+
+  pthread_mutex_lock(&this->mutex);
+
+  if ((since < this->oldest) ||
+      (since > this->current()))
+    {
+    pthread_mutex_unlock(&this->mutex);
+    return(false);
+    }
+
+  // the newest deletions are at the back, find the first one after since
+  it = this->deletions.end();
+
+  while ((it != this->deletions.begin()) &&
+         ((it - 1)->seq > since))
+    it--;
+
+  for (; it != this->deletions.end(); it++)
+    {
+    if ((it->objtype == objtype) &&
+        (it->container == where))
+      names.push_back(it->name);
+    }
+
+  pthread_mutex_unlock(&this->mutex);
+
+  return(true);
+  } // END get_deletions()
+
+
+
+change_log::change_log(
+
+  long long start,
+  size_t    max)
+
+  {
+  pthread_mutex_init(&this->mutex, NULL);
+  this->seq = start;
+  this->oldest = start;
+  this->max_deletions = max;
+  }
+
+
+
+change_log::~change_log()
+
+  {
+  // destroyed only as the main thread exits, while other threads may still
+  // stamp changes, so leave everything in place.
+  }
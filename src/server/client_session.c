@@ -0,0 +1,362 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+/*
+/*
+ * client_session.c - long-lived, multiplexed client connections
+ *
+ * A client that sends an OpenSession request keeps its connection for as
+ * many requests as it likes.  After the OpenSession reply every request on
+ * the connection is preceded by a tag the client picked, and the reply to
+ * it is preceded by the same tag, so the client may have several requests
+ * outstanding at once.  The connection's thread keeps reading requests and
+ * hands the ones that are safe to run concurrently to the request pool; the
+ * others run in order on the connection's thread.  The client is
+ * authenticated once, when it connects.
+ *
+ * Functions included are:
+ *   req_opensession()
+ *   session_hold()
+ *   session_release()
+ *   session_close()
+ *   session_dispatch()
+ *   session_reply_write()
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <pthread.h>
+
+#include "libpbs.h"
+#include "server_limits.h"
+#include "batch_request.h"
+#include "pbs_error.h"
+#include "log.h"
+#include "../lib/Liblog/pbs_log.h"
+#include "../lib/Liblog/log_event.h"
+#include "net_connect.h"
+#include "dis.h"
+#include "tcp.h" /* tcp_chan */
+#include "threadpool.h"
+#include "client_session.h"
+#include "reply_send.h" /* reply_ack, req_reject */
+#include "process_request.h" /* dispatch_request */
+
+extern struct connection svr_conn[];
+
+
+
+/*
+ * req_opensession - turn the request's connection into a session
+ *
+ * The session starts out with the one reference the connection's thread
+ * drops in session_close() once the client goes away.
+ */
+
+int req_opensession(
+
+  struct batch_request *preq) /* I */
+
+  {
+  int             sock = preq->rq_conn;
+  client_session *cs;
+
+  if ((sock < 0) ||
+      (sock >= PBS_NET_MAX_CONNECTIONS) ||
+      (preq->rq_session != NULL))
+    {
+    req_reject(PBSE_IVALREQ, 0, preq, NULL, NULL);
+    return(PBSE_IVALREQ);
+    }
+
+  if ((cs = (client_session *)calloc(1, sizeof(client_session))) == NULL)
+    {
+    req_reject(PBSE_MEM_MALLOC, 0, preq, NULL, NULL);
+    return(PBSE_MEM_MALLOC);
+    }
+
+  pthread_mutex_init(&cs->cs_mutex, NULL);
+  cs->cs_sock = sock;
+  cs->cs_refs = 1;
+
+  pthread_mutex_lock(svr_conn[sock].cn_mutex);
+
+  if (svr_conn[sock].cn_session != NULL)
+    {
+    pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+    session_release(cs);
+    req_reject(PBSE_IVALREQ, 0, preq, NULL, NULL);
+    return(PBSE_IVALREQ);
+    }
+
+  svr_conn[sock].cn_session = cs;
+
+  pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+  /* the reply to OpenSession is the last one without a tag */
+  reply_ack(preq);
+
+  return(PBSE_NONE);
+  } /* END req_opensession() */
+
+
+
+void session_hold(
+
+  client_session *cs)
+
+  {
+  pthread_mutex_lock(&cs->cs_mutex);
+  cs->cs_refs++;
+  pthread_mutex_unlock(&cs->cs_mutex);
+  } /* END session_hold() */
+
+
+
+void session_release(
+
+  client_session *cs)
+
+  {
+  int refs;
+
+  pthread_mutex_lock(&cs->cs_mutex);
+  refs = --cs->cs_refs;
+  pthread_mutex_unlock(&cs->cs_mutex);
+
+  if (refs == 0)
+    {
+    pthread_mutex_destroy(&cs->cs_mutex);
+    free(cs);
+    }
+  } /* END session_release() */
+
+
+
+/*
+ * session_close - end the session once the client is gone
+ *
+ * The requests still in the request pool keep the session until they're
+ * freed, but their replies are dropped since the socket may have been
+ * closed and reused by then.
+ */
+
+void session_close(
+
+  client_session *cs)
+
+  {
+  pthread_mutex_lock(&cs->cs_mutex);
+  cs->cs_closed = TRUE;
+  pthread_mutex_unlock(&cs->cs_mutex);
+
+  session_release(cs);
+  } /* END session_close() */
+
+
+
+static void *session_request_work(
+
+  void *vp)
+
+  {
+  struct batch_request *preq = (struct batch_request *)vp;
+
+  dispatch_request(preq->rq_conn, preq);
+
+  return(NULL);
+  } /* END session_request_work() */
+
+
+
+/*
+ * session_dispatch - hand a session's request to the request pool if it
+ * may run alongside the session's other requests
+ *
+ * Requests that keep state on the connection, such as the steps of a job
+ * being queued, or that change how it's read are left to the caller to
+ * run in order.
+ *
+ * @return true if the request was handed off
+ */
+
+bool session_dispatch(
+
+  struct batch_request *preq) /* I */
+
+  {
+  switch (preq->rq_type)
+    {
+    case PBS_BATCH_StatusJob:
+    case PBS_BATCH_StatusQue:
+    case PBS_BATCH_StatusNode:
+    case PBS_BATCH_StatusSvr:
+    case PBS_BATCH_SelectJobs:
+    case PBS_BATCH_SelStat:
+    case PBS_BATCH_SelStatAttr:
+    case PBS_BATCH_LocateJob:
+    case PBS_BATCH_DeleteJob:
+    case PBS_BATCH_HoldJob:
+    case PBS_BATCH_ReleaseJob:
+    case PBS_BATCH_SignalJob:
+    case PBS_BATCH_MessJob:
+    case PBS_BATCH_ModifyJob:
+    case PBS_BATCH_Rerun:
+    case PBS_BATCH_OrderJob:
+    case PBS_BATCH_MoveJob:
+    case PBS_BATCH_SubmitJob:
+    case PBS_BATCH_SubmitMany:
+    case PBS_BATCH_CheckpointJob:
+    case PBS_BATCH_Rescq:
+
+      break;
+
+    default:
+
+      return(false);
+    }
+
+  if (enqueue_threadpool_request(session_request_work, preq, request_pool) != PBSE_NONE)
+    return(false);
+
+  return(true);
+  } /* END session_dispatch() */
+
+
+
+/*
+ * session_reply_write - send a reply preceded by its request's tag
+ *
+ * If the reply can't be sent the socket is shut down, which ends the
+ * session once the connection's thread notices.
+ */
+
+int session_reply_write(
+
+  struct batch_request *preq) /* I */
+
+  {
+  client_session  *cs = preq->rq_session;
+  struct tcp_chan *chan;
+  int              rc;
+  char             log_buf[LOCAL_LOG_BUF_SIZE];
+
+  /* the replies of concurrent requests mustn't interleave */
+  pthread_mutex_lock(&cs->cs_mutex);
+
+  if (cs->cs_closed == TRUE)
+    {
+    pthread_mutex_unlock(&cs->cs_mutex);
+    return(PBSE_SOCKET_CLOSE);
+    }
+
+  if ((chan = DIS_tcp_setup(cs->cs_sock)) == NULL)
+    rc = PBSE_MEM_MALLOC;
+  else
+    {
+    chan->encoding = DIS_ENCODING_CLASSIC;
+
+    if ((rc = diswui(chan, preq->rq_tag)) == DIS_SUCCESS)
+      {
+      chan->encoding = preq->rq_encoding;
+
+      if ((rc = encode_DIS_reply(chan, &preq->rq_reply)) == DIS_SUCCESS)
+        rc = DIS_tcp_wflush(chan);
+      }
+
+    DIS_tcp_cleanup(chan);
+    }
+
+  pthread_mutex_unlock(&cs->cs_mutex);
+
+  if (rc != PBSE_NONE)
+    {
+    snprintf(log_buf, sizeof(log_buf), "session reply failure on socket %d, %d",
+      cs->cs_sock,
+      rc);
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
+
+    shutdown(cs->cs_sock, SHUT_RDWR);
+    }
+
+  return(rc);
+  } /* END session_reply_write() */
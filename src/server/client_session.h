@@ -0,0 +1,34 @@
+#ifndef _CLIENT_SESSION_H
+#define _CLIENT_SESSION_H
+#include "license_pbs.h" /* See here for the software license */
+
+#include <pthread.h>
+
+#include "batch_request.h" /* batch_request */
+
+/*
+ * a long-lived client connection whose requests are tagged, see
+ * client_session.c
+ */
+
+typedef struct client_session
+  {
+  pthread_mutex_t cs_mutex;  /* serializes the replies */
+  int             cs_sock;
+  int             cs_closed; /* the client is gone, drop the replies */
+  int             cs_refs;   /* the reading thread plus each live request */
+  } client_session;
+
+int req_opensession(struct batch_request *preq);
+
+void session_hold(client_session *cs);
+
+void session_release(client_session *cs);
+
+void session_close(client_session *cs);
+
+bool session_dispatch(struct batch_request *preq);
+
+int session_reply_write(struct batch_request *preq);
+
+#endif /* _CLIENT_SESSION_H */
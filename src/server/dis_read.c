@@ -156,7 +156,8 @@ int dis_request_read(
     return(PBSE_DISPROTO);
     }
 
-  if (proto_ver != PBS_BATCH_PROT_VER)
+  if ((proto_ver != PBS_BATCH_PROT_VER) &&
+      (proto_ver != PBS_BATCH_PROT_VER_BINARY))
     {
     sprintf(log_buf, "conflicting version numbers, %d detected, %d expected",
             proto_ver,
@@ -230,6 +231,12 @@ int dis_request_read(
 
       break;
 
+    case PBS_BATCH_SubscribeJobs:
+
+      rc = decode_DIS_JobId(chan, request->rq_ind.rq_subscribe);
+
+      break;
+
     case PBS_BATCH_DeleteJob:
 
     case PBS_BATCH_HoldJob:
@@ -310,6 +317,12 @@ int dis_request_read(
 
       break;
 
+    case PBS_BATCH_RunJobs:
+
+      rc = decode_DIS_RunJobs(chan, request);
+
+      break;
+
     case PBS_BATCH_SelectJobs:
 
     case PBS_BATCH_SelStat:
@@ -381,6 +394,24 @@ int dis_request_read(
 
       break;
 
+    case PBS_BATCH_SubmitJob:
+
+      rc = decode_DIS_SubmitJob(chan, request);
+
+      break;
+
+    case PBS_BATCH_SubmitMany:
+
+      rc = decode_DIS_SubmitMany(chan, request);
+
+      break;
+
+    case PBS_BATCH_OpenSession:
+
+      /* nothing but the extension */
+
+      break;
+
 #else  /* PBS_MOM */
       
     /* pbs_mom services */
@@ -443,6 +474,11 @@ int dis_request_read(
 
       rc = PBSE_DISPROTO;
       }
+    else if (request->rq_extflags & REQ_EXTEND_BINARY)
+      {
+      /* the client asked for a binary reply to a classic request */
+      request->rq_encoding = DIS_ENCODING_BINARY;
+      }
     }
   else if (rc != PBSE_UNKREQ)
     {
@@ -93,12 +93,74 @@
 #include "libpbs.h"
 #include "net_connect.h"
 #include "batch_request.h"
+#include "client_session.h"
 
 const int SHORT_TIMEOUT = 5;
 
+extern struct connection svr_conn[];
+
 char *netaddr(struct sockaddr_in *ap);
 void netcounter_incr();
 
+
+
+/*
+ * connection_is_done - true if rc means no more requests are read from
+ * the connection
+ */
+
+static bool connection_is_done(
+
+  int rc)
+
+  {
+  return((rc == PBSE_SOCKET_DATA) ||
+         (rc == PBSE_SOCKET_INFORMATION) ||
+         (rc == PBSE_INTERNAL) ||
+         (rc == PBSE_SYSTEM) ||
+         (rc == PBSE_MEM_MALLOC) ||
+         (rc == PBSE_SOCKET_CLOSE) ||
+         (rc == PBSE_TIMEOUT) ||
+         (rc == PBSE_CONN_HANDED_OFF));
+  } /* END connection_is_done() */
+
+
+
+/*
+ * process_session - read the requests of a session until the client goes
+ *
+ * The channel is kept from one request to the next since the client may
+ * send several before reading any replies, see client_session.c.
+ */
+
+static int process_session(
+
+  struct tcp_chan *chan,
+  client_session  *cs)
+
+  {
+  int rc = PBSE_NONE;
+  int sock = chan->sock;
+
+  while (connection_is_done(rc) == false)
+    {
+    netcounter_incr();
+
+    rc = process_request(chan);
+    }
+
+  pthread_mutex_lock(svr_conn[sock].cn_mutex);
+
+  if (svr_conn[sock].cn_session == cs)
+    svr_conn[sock].cn_session = NULL;
+
+  pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+  session_close(cs);
+
+  return(rc);
+  } /* END process_session() */
+
 int get_protocol_type(
 
   struct tcp_chan *chan,
@@ -153,10 +215,22 @@ int process_pbs_server_port(
   switch (protocol_type)
     {
     case PBS_BATCH_PROT_TYPE:
+
+      {
+      client_session *cs;
       
       rc = process_request(chan);
+
+      pthread_mutex_lock(svr_conn[sock].cn_mutex);
+      cs = svr_conn[sock].cn_session;
+      pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+      if ((rc == PBSE_NONE) &&
+          (cs != NULL))
+        rc = process_session(chan, cs);
       
       break;
+      }
       
     case IS_PROTOCOL:
 
@@ -252,13 +326,7 @@ void *start_process_pbs_server_port(
  
   sock = (int)args[0];
 
-  while ((rc != PBSE_SOCKET_DATA) &&
-         (rc != PBSE_SOCKET_INFORMATION) &&
-         (rc != PBSE_INTERNAL) &&
-         (rc != PBSE_SYSTEM) &&
-         (rc != PBSE_MEM_MALLOC) &&
-         (rc != PBSE_SOCKET_CLOSE) &&
-         (rc != PBSE_TIMEOUT))
+  while (connection_is_done(rc) == false)
     {
     netcounter_incr();
 
@@ -266,7 +334,10 @@ void *start_process_pbs_server_port(
     }
 
   free(new_sock);
-  close_conn(sock, FALSE);
+
+  /* a job event subscriber's connection is closed by job_events.c */
+  if (rc != PBSE_CONN_HANDED_OFF)
+    close_conn(sock, FALSE);
 
   /* Thread exit */
   return(NULL);
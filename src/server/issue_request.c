@@ -113,6 +113,7 @@
 #include "process_request.h" /* dispatch_request */
 #include "svr_connect.h" /* svr_disconnect_sock */
 #include "ji_mutex.h"
+#include "mom_connection_pool.hpp"
 
 
 /* Global Data Items: */
@@ -133,11 +134,41 @@ extern int       LOGLEVEL;
 int issue_to_svr(char *, struct batch_request *, void (*f)(struct work_task *));
 int issue_Drequest(int conn, struct batch_request  *request);
 
+/*
+ * reply_was_read - tell whether a request sent with issue_Drequest() got its
+ * whole reply back. A failed send or a reply that couldn't be read can leave
+ * the connection in the middle of a message, so it mustn't carry another
+ * request. The mom only replies with PBSE_* codes, so a code below
+ * PBSE_FLOOR is the DIS error from reading the reply.
+ */
+
+bool reply_was_read(
+
+  int            rc,      /* I - what issue_Drequest() returned */
+  batch_request *request) /* I */
+
+  {
+  int code = request->rq_reply.brp_code;
+
+  if (rc != PBSE_NONE)
+    return(false);
+
+  if ((code != PBSE_NONE) &&
+      (code < PBSE_FLOOR))
+    return(false);
+
+  return(true);
+  } /* END reply_was_read() */
+
+
+
+
 /*
  * relay_to_mom - relay a (typically existing) batch_request to MOM
  *
- * Make connection to MOM and issue the request.  Called with
- * network address rather than name to save look-ups.
+ * Take a connection to MOM from the pool and issue the request.  Called
+ * with network address rather than name to save look-ups.  The connection
+ * goes back to the pool for the next request to the same MOM.
  *
  * Unlike issue_to_svr(), a failed connection is not retried.
  * The calling routine typically handles this problem.
@@ -155,6 +186,7 @@ int relay_to_mom(
   int             handle; /* a client style connection handle */
   int             rc;
   int             local_errno = 0;
+  bool            reused = false;
   pbs_net_t       addr;
   unsigned short  port;
   job            *pjob = *pjob_ptr;
@@ -211,7 +243,7 @@ int relay_to_mom(
   unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
   *pjob_ptr = NULL;
 
-  handle = svr_connect(addr, port, &local_errno, NULL, NULL);
+  handle = mom_connections.get(addr, port, &local_errno, &reused);
 
   if (handle < 0)
     {
@@ -222,7 +254,30 @@ int relay_to_mom(
 
   request->rq_orgconn = request->rq_conn; /* save client socket */
 
-  rc = issue_Drequest(handle, request, true);
+  rc = issue_Drequest(handle, request, false);
+
+  if ((rc != PBSE_NONE) &&
+      (reused == true))
+    {
+    /* the mom closed the pooled connection after it was checked, so the
+     * request never got there. Send it once more on a new connection. */
+    mom_connections.release(addr, port, handle, false);
+
+    handle = mom_connections.get(addr, port, &local_errno, &reused);
+
+    if (handle < 0)
+      {
+      log_event(PBSEVENT_ERROR,PBS_EVENTCLASS_REQUEST,"",msg_norelytomom);
+
+      *pjob_ptr = svr_find_job(jobid, TRUE);
+
+      return(PBSE_NORELYMOM);
+      }
+
+    rc = issue_Drequest(handle, request, false);
+    }
+
+  mom_connections.release(addr, port, handle, reply_was_read(rc, request));
 
   *pjob_ptr = svr_find_job(jobid, TRUE);
 
@@ -96,6 +96,7 @@
 #include "svrfunc.h"
 #include "ji_mutex.h"
 #include "id_map.hpp"
+#include "job_index.hpp"
 
 
 extern char     server_name[];
@@ -311,6 +312,36 @@ char *get_correct_jobname(
 
 
 
+/*
+ * alljobs is the only container with a sharded index. These keep the index
+ * in step with the container and are no-ops for every other container.
+ */
+
+static void index_job(
+
+  all_jobs *aj,
+  job      *pjob)
+
+  {
+  if (aj == &alljobs)
+    alljobs_index.insert(pjob->ji_qs.ji_jobid, pjob);
+  } /* END index_job() */
+
+
+
+static void unindex_job(
+
+  all_jobs   *aj,
+  const char *job_id,
+  job        *pjob)
+
+  {
+  if (aj == &alljobs)
+    alljobs_index.remove(job_id, pjob);
+  } /* END unindex_job() */
+
+
+
 /*
  * Searches the array passed in for the job_id
  * @parent svr_find_job()
@@ -337,16 +368,29 @@ job *find_job_by_array(
     return(NULL);
     }
 
-  if (locked == false)
-    aj->lock();
+  if (aj == &alljobs)
+    {
+    /* lookups in alljobs only take a read lock on one shard of the index.
+     * As in next_job() the job is locked after the lookup and a job that
+     * was recycled in between is discarded below */
+    pj = alljobs_index.find(job_id);
+
+    if (pj != NULL)
+      lock_ji_mutex(pj, __func__, NULL, LOGLEVEL);
+    }
+  else
+    {
+    if (locked == false)
+      aj->lock();
   
-  pj = aj->find(job_id);
+    pj = aj->find(job_id);
 
-  if (pj != NULL)
-    lock_ji_mutex(pj, __func__, NULL, LOGLEVEL);
+    if (pj != NULL)
+      lock_ji_mutex(pj, __func__, NULL, LOGLEVEL);
 
-  if (locked == false)
-    aj->unlock();
+    if (locked == false)
+      aj->unlock();
+    }
   
   if (pj != NULL)
     {
@@ -562,7 +606,10 @@ int insert_job(
     log_err(rc, __func__, "No memory to resize the array...SYSTEM FAILURE\n");
     }
   else
+    {
+    index_job(aj, pjob);
     rc = PBSE_NONE;
+    }
 
   aj->unlock();
 
@@ -626,7 +673,10 @@ int insert_job_after(
       log_err(rc, __func__, "No memory to resize the array...SYSTEM FAILURE");
       }
     else
+      {
+      index_job(aj, pjob);
       rc = PBSE_NONE;
+      }
     }
 
   aj->unlock();
@@ -685,7 +735,10 @@ int insert_job_after(
     log_err(rc, __func__, "No memory to resize the array...SYSTEM FAILURE");
     }
   else
+    {
+    index_job(aj, pjob);
     rc = PBSE_NONE;
+    }
 
   aj->unlock();
 
@@ -725,7 +778,10 @@ int insert_job_first(
     log_err(rc, __func__, "No memory to resize the array...SYSTEM FAILURE");
     }
   else
+    {
+    index_job(aj, pjob);
     rc = PBSE_NONE;
+    }
 
   aj->unlock();
 
@@ -849,6 +905,8 @@ int  remove_job(
     {
     if (!aj->remove(pjob->ji_qs.ji_jobid))
       rc = THING_NOT_FOUND;
+    else
+      unindex_job(aj, pjob->ji_qs.ji_jobid, pjob);
     }
 
   aj->unlock();
@@ -864,7 +922,7 @@ job *next_job(
   all_jobs_iterator *iter)
 
   {
-  job *pjob;
+  job *pjob = NULL;
 
   if (aj == NULL)
     {
@@ -877,9 +935,33 @@ job *next_job(
     return(NULL);
     }
 
-  aj->lock();
-  pjob = iter->get_next_item();
-  aj->unlock();
+  if (iter->is_snapshot())
+    {
+    const std::string *id;
+    all_jobs          *snapped = iter->get_container();
+
+    /* skip the jobs that left the container after the snapshot was taken */
+    while ((id = iter->get_next_id()) != NULL)
+      {
+      if (snapped == &alljobs)
+        pjob = alljobs_index.find(*id);
+      else
+        {
+        snapped->lock();
+        pjob = snapped->find(*id);
+        snapped->unlock();
+        }
+
+      if (pjob != NULL)
+        break;
+      }
+    }
+  else
+    {
+    aj->lock();
+    pjob = iter->get_next_item();
+    aj->unlock();
+    }
 
   if (pjob != NULL)
     {
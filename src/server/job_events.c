@@ -0,0 +1,645 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+/*
+ * job_events.c - push job state changes to subscribed clients
+ *
+ * A client sends a SubscribeJobs request for one job or for every job it
+ * may see.  Once acknowledged, its connection leaves the request loop and
+ * only carries job events, which are encoded once per state change and
+ * queued on every matching subscriber.  A task thread writes them out
+ * without blocking so a slow client never holds up the job being changed.
+ *
+ * Functions included are:
+ *   req_subscribe()
+ *   job_events_publish()
+ *   flush_job_events()
+ *   check_job_subscribers()
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+#include "libpbs.h"
+#include "server_limits.h"
+#include "attribute.h"
+#include "server.h"
+#include "batch_request.h"
+#include "pbs_job.h"
+#include "pbs_error.h"
+#include "log.h"
+#include "../lib/Liblog/pbs_log.h"
+#include "../lib/Liblog/log_event.h"
+#include "net_connect.h"
+#include "dis.h"
+#include "tcp.h" /* tcp_chan */
+#include "threadpool.h"
+#include "svrfunc.h"
+#include "ji_mutex.h"
+#include "job_events.h"
+#include "reply_send.h" /* reply_send_svr, req_reject */
+#include "svr_chk_owner.h" /* svr_authorize_jobreq */
+
+extern struct connection svr_conn[];
+
+
+struct job_subscriber
+  {
+  int         sock;
+  bool        ready;     /* the subscribe reply has been sent */
+  bool        all_users; /* may see every user's jobs */
+  time_t      stalled;   /* when sending last made no progress, or 0 */
+  std::string user;
+  std::string job_id;    /* empty for every job */
+  std::string pending;   /* encoded events not yet sent */
+  };
+
+static std::vector<job_subscriber> subscribers;
+static pthread_mutex_t             subscribers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool                        flush_queued = false;
+
+
+
+/*
+ * drop_subscriber - close a subscriber's connection and forget it
+ *
+ * subscribers_mutex must be held.
+ */
+
+static void drop_subscriber(
+
+  size_t index)
+
+  {
+  char log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if (LOGLEVEL >= 6)
+    {
+    snprintf(log_buf, sizeof(log_buf), "dropping job event subscriber on sock %d",
+      subscribers[index].sock);
+    log_event(PBSEVENT_CLIENTAUTH, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+    }
+
+  close_conn(subscribers[index].sock, FALSE);
+
+  subscribers.erase(subscribers.begin() + index);
+  } /* END drop_subscriber() */
+
+
+
+/*
+ * queue_flush - have a task thread send the pending events
+ *
+ * subscribers_mutex must be held.
+ */
+
+static void queue_flush(void)
+
+  {
+  int rc;
+
+  if (flush_queued == true)
+    return;
+
+  if ((rc = enqueue_threadpool_request(flush_job_events, NULL, task_pool)) != PBSE_NONE)
+    {
+    log_err(rc, __func__, "Unable to enqueue flush_job_events task into the threadpool");
+    return;
+    }
+
+  flush_queued = true;
+  } /* END queue_flush() */
+
+
+
+/*
+ * encode_job_event - encode the current state of a job as a job event
+ *
+ * @param pjob - the job, locked
+ * @param flags - PBS_EVENT_* flags to send, PBS_EVENT_EXIT_STATUS is added
+ * when the job has an exit status
+ * @param out - the encoded event is appended here
+ */
+
+int encode_job_event(
+
+  job         *pjob,  /* I */
+  int          flags, /* I */
+  std::string &out)   /* O */
+
+  {
+  struct tcp_chan *chan;
+  char            *encoded;
+  size_t           len;
+  int              exit_status = 0;
+  int              rc;
+
+  if ((chan = DIS_buf_setup()) == NULL)
+    return(PBSE_MEM_MALLOC);
+
+  if (pjob->ji_wattr[JOB_ATR_exitstat].at_flags & ATR_VFLAG_SET)
+    {
+    exit_status = pjob->ji_wattr[JOB_ATR_exitstat].at_val.at_long;
+    flags |= PBS_EVENT_EXIT_STATUS;
+    }
+
+  rc = encode_DIS_JobEvent(chan,
+         pjob->ji_qs.ji_jobid,
+         pjob->ji_wattr[JOB_ATR_state].at_val.at_char,
+         exit_status,
+         flags);
+
+  if (rc != DIS_SUCCESS)
+    rc = PBSE_PROTOCOL;
+  else if ((encoded = DIS_buf_data(chan, &len)) != NULL)
+    out.append(encoded, len);
+  else
+    rc = PBSE_MEM_MALLOC;
+
+  DIS_tcp_cleanup(chan);
+
+  return(rc);
+  } /* END encode_job_event() */
+
+
+
+/*
+ * subscriber_wants - does a subscriber get the events of this job
+ */
+
+static bool subscriber_wants(
+
+  const job_subscriber &sub,
+  const job            *pjob,
+  const char           *owner)
+
+  {
+  if (sub.job_id.size() != 0)
+    return(sub.job_id == pjob->ji_qs.ji_jobid);
+
+  if (sub.all_users == true)
+    return(true);
+
+  if (owner == NULL)
+    return(false);
+
+  /* the owner is user@host */
+  return((strncmp(owner, sub.user.c_str(), sub.user.size()) == 0) &&
+         ((owner[sub.user.size()] == '@') ||
+          (owner[sub.user.size()] == '\0')));
+  } /* END subscriber_wants() */
+
+
+
+/*
+ * job_events_publish - queue an event for the job's current state on
+ * every matching subscriber
+ *
+ * Called with the job locked whenever its state changes or it is purged.
+ */
+
+void job_events_publish(
+
+  job *pjob,  /* I */
+  int  flags) /* I */
+
+  {
+  std::string  event;
+  const char  *owner;
+  bool         queued = false;
+
+  if (pjob == NULL)
+    return;
+
+  owner = pjob->ji_wattr[JOB_ATR_job_owner].at_val.at_str;
+
+  pthread_mutex_lock(&subscribers_mutex);
+
+  if (subscribers.size() == 0)
+    {
+    pthread_mutex_unlock(&subscribers_mutex);
+    return;
+    }
+
+  for (size_t i = 0; i < subscribers.size();)
+    {
+    job_subscriber &sub = subscribers[i];
+
+    if (subscriber_wants(sub, pjob, owner) == false)
+      {
+      i++;
+      continue;
+      }
+
+    if ((event.size() == 0) &&
+        (encode_job_event(pjob, flags, event) != PBSE_NONE))
+      break;
+
+    if (sub.pending.size() + event.size() > JOB_EVENTS_MAX_PENDING)
+      {
+      /* the client isn't keeping up, it can reconnect and re-query */
+      drop_subscriber(i);
+      continue;
+      }
+
+    sub.pending.append(event);
+    queued = true;
+
+    i++;
+    }
+
+  if (queued == true)
+    queue_flush();
+
+  pthread_mutex_unlock(&subscribers_mutex);
+  } /* END job_events_publish() */
+
+
+
+/*
+ * send_pending - send as much of the subscribers' pending events as the
+ * sockets take without blocking
+ *
+ * subscribers_mutex must be held.
+ *
+ * @return the number of subscribers with events still pending
+ */
+
+static int send_pending(
+
+  std::vector<int> &waiting) /* O */
+
+  {
+  time_t now = time(NULL);
+
+  waiting.clear();
+
+  for (size_t i = 0; i < subscribers.size();)
+    {
+    job_subscriber &sub = subscribers[i];
+    ssize_t         sent;
+
+    if ((sub.ready == false) ||
+        (sub.pending.size() == 0))
+      {
+      i++;
+      continue;
+      }
+
+    sent = send(sub.sock, sub.pending.data(), sub.pending.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+
+    if (sent > 0)
+      {
+      sub.pending.erase(0, sent);
+      sub.stalled = 0;
+      }
+    else if ((sent < 0) &&
+             (errno != EAGAIN) &&
+             (errno != EWOULDBLOCK) &&
+             (errno != EINTR))
+      {
+      drop_subscriber(i);
+      continue;
+      }
+    else if (sub.stalled == 0)
+      sub.stalled = now;
+    else if (now - sub.stalled > JOB_EVENTS_SEND_TIMEOUT)
+      {
+      drop_subscriber(i);
+      continue;
+      }
+
+    if (sub.pending.size() != 0)
+      waiting.push_back(sub.sock);
+
+    i++;
+    }
+
+  return(waiting.size());
+  } /* END send_pending() */
+
+
+
+/*
+ * flush_job_events - send the pending events of every subscriber
+ *
+ * Runs on a task thread until nothing is left to send.
+ */
+
+void *flush_job_events(
+
+  void *vp)
+
+  {
+  std::vector<int>           waiting;
+  std::vector<struct pollfd> pfds;
+
+  pthread_mutex_lock(&subscribers_mutex);
+
+  while (send_pending(waiting) > 0)
+    {
+    pthread_mutex_unlock(&subscribers_mutex);
+
+    pfds.resize(waiting.size());
+
+    for (size_t i = 0; i < waiting.size(); i++)
+      {
+      pfds[i].fd = waiting[i];
+      pfds[i].events = POLLOUT;
+      pfds[i].revents = 0;
+      }
+
+    poll(&pfds[0], pfds.size(), 1000);
+
+    pthread_mutex_lock(&subscribers_mutex);
+    }
+
+  flush_queued = false;
+
+  pthread_mutex_unlock(&subscribers_mutex);
+
+  return(NULL);
+  } /* END flush_job_events() */
+
+
+
+/*
+ * req_subscribe - subscribe a connection to job events
+ *
+ * The reply is BATCH_REPLY_CHOICE_EventStream and the connection is then
+ * handed off: it is no longer read for requests and stays open until the
+ * client closes it or falls too far behind.
+ *
+ * @return PBSE_CONN_HANDED_OFF once the connection carries job events
+ */
+
+int req_subscribe(
+
+  struct batch_request *preq) /* I */
+
+  {
+  job_subscriber  sub;
+  job            *pjob;
+  long            query_others = FALSE;
+  int             sock = preq->rq_conn;
+  char            log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((sock < 0) ||
+      (sock == PBS_LOCAL_CONNECTION))
+    {
+    req_reject(PBSE_IVALREQ, 0, preq, NULL, NULL);
+    return(PBSE_IVALREQ);
+    }
+
+  get_svr_attr_l(SRV_ATR_query_others, &query_others);
+
+  sub.sock = sock;
+  sub.ready = false;
+  sub.stalled = 0;
+  sub.user = preq->rq_user;
+  sub.all_users = ((query_others != FALSE) ||
+                   (preq->rq_perm & (ATR_DFLAG_MGRD | ATR_DFLAG_OPRD)));
+
+  if (preq->rq_ind.rq_subscribe[0] != '\0')
+    {
+    if ((pjob = svr_find_job(preq->rq_ind.rq_subscribe, TRUE)) == NULL)
+      {
+      req_reject(PBSE_UNKJOBID, 0, preq, NULL, NULL);
+      return(PBSE_UNKJOBID);
+      }
+
+    if ((sub.all_users == false) &&
+        (svr_authorize_jobreq(preq, pjob) == -1))
+      {
+      unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+      req_reject(PBSE_PERM, 0, preq, NULL, NULL);
+      return(PBSE_PERM);
+      }
+
+    sub.job_id = pjob->ji_qs.ji_jobid;
+
+    /* start with the job's current state so a change between the client's
+     * last status and this request isn't missed */
+    encode_job_event(pjob, 0, sub.pending);
+
+    pthread_mutex_lock(&subscribers_mutex);
+    subscribers.push_back(sub);
+    pthread_mutex_unlock(&subscribers_mutex);
+
+    unlock_ji_mutex(pjob, __func__, NULL, LOGLEVEL);
+    }
+  else
+    {
+    pthread_mutex_lock(&subscribers_mutex);
+    subscribers.push_back(sub);
+    pthread_mutex_unlock(&subscribers_mutex);
+    }
+
+  /* the connection now lives as long as the client wants it */
+  pthread_mutex_lock(svr_conn[sock].cn_mutex);
+  svr_conn[sock].cn_authen |= PBS_NET_CONN_NOTIMEOUT;
+  pthread_mutex_unlock(svr_conn[sock].cn_mutex);
+
+  if (LOGLEVEL >= 6)
+    {
+    snprintf(log_buf, sizeof(log_buf), "%s@%s subscribed to job events for %s on sock %d",
+      preq->rq_user,
+      preq->rq_host,
+      (sub.job_id.size() != 0) ? sub.job_id.c_str() : "all jobs",
+      sock);
+    log_event(PBSEVENT_CLIENTAUTH, PBS_EVENTCLASS_SERVER, __func__, log_buf);
+    }
+
+  /* events queued until now are sent after the reply */
+  preq->rq_reply.brp_code = PBSE_NONE;
+  preq->rq_reply.brp_auxcode = 0;
+  preq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_EventStream;
+
+  /* events are always classic, see encode_job_event() */
+  preq->rq_encoding = DIS_ENCODING_CLASSIC;
+
+  if (reply_send_svr(preq) != PBSE_NONE)
+    {
+    pthread_mutex_lock(&subscribers_mutex);
+
+    for (size_t i = 0; i < subscribers.size(); i++)
+      {
+      if (subscribers[i].sock == sock)
+        {
+        subscribers.erase(subscribers.begin() + i);
+        break;
+        }
+      }
+
+    pthread_mutex_unlock(&subscribers_mutex);
+
+    return(PBSE_SOCKET_WRITE);
+    }
+
+  pthread_mutex_lock(&subscribers_mutex);
+
+  for (size_t i = 0; i < subscribers.size(); i++)
+    {
+    if (subscribers[i].sock == sock)
+      {
+      subscribers[i].ready = true;
+
+      if (subscribers[i].pending.size() != 0)
+        queue_flush();
+
+      break;
+      }
+    }
+
+  pthread_mutex_unlock(&subscribers_mutex);
+
+  return(PBSE_CONN_HANDED_OFF);
+  } /* END req_subscribe() */
+
+
+
+/*
+ * check_job_subscribers - drop the subscribers whose client has gone away
+ *
+ * A subscribed client never sends anything, so a readable socket means it
+ * was closed.
+ */
+
+void check_job_subscribers(
+
+  struct work_task *ptask) /* I */
+
+  {
+  time_t now = time(NULL);
+
+  pthread_mutex_lock(&subscribers_mutex);
+
+  for (size_t i = 0; i < subscribers.size();)
+    {
+    struct pollfd pfd;
+
+    if (subscribers[i].ready == false)
+      {
+      i++;
+      continue;
+      }
+
+    pfd.fd = subscribers[i].sock;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if ((poll(&pfd, 1, 0) > 0) &&
+        (pfd.revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)))
+      {
+      drop_subscriber(i);
+      continue;
+      }
+
+    i++;
+    }
+
+  pthread_mutex_unlock(&subscribers_mutex);
+
+  free(ptask->wt_mutex);
+  free(ptask);
+
+  set_task(WORK_Timed, now + JOB_EVENTS_CHECK_RATE, check_job_subscribers, NULL, FALSE);
+  } /* END check_job_subscribers() */
+
+
+
+int job_events_subscriber_count(void)
+
+  {
+  int count;
+
+  pthread_mutex_lock(&subscribers_mutex);
+  count = subscribers.size();
+  pthread_mutex_unlock(&subscribers_mutex);
+
+  return(count);
+  } /* END job_events_subscriber_count() */
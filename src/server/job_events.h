@@ -0,0 +1,27 @@
+#ifndef _JOB_EVENTS_H
+#define _JOB_EVENTS_H
+#include "license_pbs.h" /* See here for the software license */
+
+#include <string>
+
+#include "pbs_job.h" /* job */
+#include "work_task.h" /* work_task */
+#include "batch_request.h" /* batch_request */
+
+#define JOB_EVENTS_MAX_PENDING   (1024 * 1024) /* bytes queued for one subscriber */
+#define JOB_EVENTS_SEND_TIMEOUT  60            /* seconds a subscriber may stall */
+#define JOB_EVENTS_CHECK_RATE    30
+
+int req_subscribe(struct batch_request *preq);
+
+int encode_job_event(job *pjob, int flags, std::string &out);
+
+void job_events_publish(job *pjob, int flags);
+
+void *flush_job_events(void *vp);
+
+void check_job_subscribers(struct work_task *ptask);
+
+int job_events_subscriber_count(void);
+
+#endif /* _JOB_EVENTS_H */
@@ -89,6 +89,7 @@
  *
  *   job_clone    clones a job (for use with job_arrays)
  *   job_clone_wt work task for cloning a job
+ *   clone_uncloned_subjob clones an array job that a request names
  *
  * Include private function:
  *   job_init_wattr() initialize job working pbs_attribute array to "unspecified"
@@ -121,6 +122,7 @@
 #include <string.h>
 #include <pthread.h>
 #include <string>
+#include <vector>
 #include <semaphore.h>
 
 #include "pbs_ifl.h"
@@ -152,6 +154,9 @@
 #include "job_route.h" /* job_route */
 #include "id_map.hpp"
 #include "completed_jobs_map.h"
+#include "job_index.hpp"
+#include "change_log.hpp"
+#include "job_events.h" /* job_events_publish() */
 
 #ifndef TRUE
 #define TRUE 1
@@ -182,6 +187,9 @@ void free_all_of_job(job *pjob);
 
 /* Global Data items */
 all_jobs        alljobs;
+job_index       alljobs_index;
+/* change sequences continue from the last start, see change_log */
+change_log      server_changes((long long)time(NULL) << 20, CHANGE_LOG_MAX_DELETIONS);
 extern all_jobs array_summary;
 
 int check_job_log_started = 0;
@@ -781,6 +789,7 @@ job *job_alloc(void)
   pj->ji_is_array_template = FALSE;
 
   pj->ji_momhandle = -1;  /* mark mom connection invalid */
+  pj->ji_change_seq = server_changes.next();
 
   /* set the working attributes to "unspecified" */
   job_init_wattr(pj);
@@ -817,6 +826,8 @@ void free_job_allocation(
     delete pjob->ji_rejectdest;
     pjob->ji_rejectdest = NULL;
     }
+
+  job_stat_cache_invalidate(pjob);
   } /* END free_job_allocation() */
 
 
@@ -855,7 +866,8 @@ void job_free(
     log_record(PBSEVENT_DEBUG,PBS_EVENTCLASS_JOB,pj->ji_qs.ji_jobid,log_buf);
     }
 
-  remove_job(&alljobs, pj, true);
+  if (remove_job(&alljobs, pj, true) == PBSE_NONE)
+    server_changes.record_deletion(MGR_OBJ_JOB, pj->ji_qs.ji_jobid, NULL);
 
   /* move to the recycling structure - deleting right away can cause a race
    * condition where two threads are pending on the same job. Thread 1 gets 
@@ -1187,8 +1199,202 @@ job *job_clone(
 
 
 
+/*
+ * clone_array_subjob - clone the job at index of array pa and queue it
+ *
+ * pa is locked on entry and on return, unless the array went away in
+ * between and *pa_ptr is set to NULL. The new job keeps the HOLD_a that
+ * job_clone() gives it.
+ *
+ * @param prev_job_id - I/O - the job the new one is queued behind
+ * @return the new job, locked, or NULL if it couldn't be made
+ */
+
+static job *clone_array_subjob(
+
+  job          *template_job,
+  job_array   **pa_ptr,
+  const char   *arrayid,
+  int           index,
+  std::string  &prev_job_id)
+
+  {
+  job_array *pa = *pa_ptr;
+  job       *pjobclone;
+  int        newstate;
+  int        newsub;
+  int        rc;
+
+  lock_ji_mutex(template_job, __func__, NULL, LOGLEVEL);
+  pjobclone = job_clone(template_job, pa, index);
+  unlock_ji_mutex(template_job, __func__, NULL, LOGLEVEL);
+
+  if (pjobclone == NULL)
+    {
+    log_err(-1, __func__, "unable to clone job in job_clone_wt");
+    return(NULL);
+    }
+  else if (pjobclone == (job *)1)
+    {
+    /* this happens if we attempted to clone an existing job */
+    return(NULL);
+    }
+
+  svr_evaljobstate(*pjobclone, newstate, newsub, 1);
+
+  /* do this so that  svr_setjobstate() doesn't alter sv_jobstates,
+   * these are set later in svr_enquejob() */
+  pjobclone->ji_qs.ji_state = newstate;
+  pjobclone->ji_qs.ji_substate = newsub;
+
+  svr_setjobstate(pjobclone, newstate, newsub, FALSE);
+
+  pjobclone->ji_wattr[JOB_ATR_qrank].at_val.at_long = ++queue_rank;
+  pjobclone->ji_wattr[JOB_ATR_qrank].at_flags |= ATR_VFLAG_SET;
+
+  unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
+
+  if ((rc = svr_enquejob(pjobclone, FALSE, prev_job_id.c_str(), false)))
+    {
+    /* XXX need more robust error handling */
+    if (rc != PBSE_JOB_RECYCLED)
+      {
+      svr_job_purge(pjobclone);
+      }
+
+    *pa_ptr = get_array((char *)arrayid);
+
+    return(NULL);
+    }
+
+  if ((*pa_ptr = get_jobs_array(&pjobclone)) == NULL)
+    {
+    /* if pjobclone has been released there is no mutex left to unlock */
+    if (pjobclone != NULL)
+      unlock_ji_mutex(pjobclone, __func__, "1", LOGLEVEL);
+
+    return(NULL);
+    }
+
+  pa = *pa_ptr;
+
+  if (job_save(pjobclone, SAVEJOB_FULL, 0) != 0)
+    {
+    /* XXX need more robust error handling */
+    unlock_ai_mutex(pa, __func__, "2", LOGLEVEL);
+    svr_job_purge(pjobclone);
+
+    *pa_ptr = get_array((char *)arrayid);
+
+    return(NULL);
+    }
+
+  prev_job_id = pjobclone->ji_qs.ji_jobid;
+
+  pa->ai_qs.num_cloned++;
+
+  if (pa->num_idle >= 0)
+    pa->num_idle++;
+
+  return(pjobclone);
+  } /* END clone_array_subjob() */
+
+
+
+/*
+ * release_array_hold - take the HOLD_a that job_clone() puts on a new array
+ * job off, and route the job if it is in a started routing queue
+ *
+ * @param pjob_ptr - I/O - the job, locked. Set to NULL if it went away.
+ * @param pa - the job's array, locked
+ * @param actual_job_count - the job's place among the array's jobs, for
+ * applying slot limit holds when moab_array_compatible is set
+ */
+
+static void release_array_hold(
+
+  job       **pjob_ptr,
+  job_array  *pa,
+  int         actual_job_count)
+
+  {
+  job       *pjob = *pjob_ptr;
+  pbs_queue *pque;
+  long       moab_compatible = FALSE;
+  int        newstate;
+  int        newsub;
+  char       log_buf[LOCAL_LOG_BUF_SIZE];
+
+  get_svr_attr_l(SRV_ATR_MoabArrayCompatible, &moab_compatible);
+  pjob->ji_wattr[JOB_ATR_hold].at_val.at_long &= ~HOLD_a;
+  
+  if (moab_compatible != FALSE)
+    {
+    /* if configured and necessary, apply a slot limit hold to all
+     * jobs above the slot limit threshold */
+    if ((pa->ai_qs.slot_limit != NO_SLOT_LIMIT) &&
+        (actual_job_count > pa->ai_qs.slot_limit))
+      {
+      pjob->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_l;
+      }
+    }
+  
+  if (pjob->ji_wattr[JOB_ATR_hold].at_val.at_long == 0)
+    {
+    pjob->ji_wattr[JOB_ATR_hold].at_flags &= ~ATR_VFLAG_SET;
+    }
+  else
+    {
+    pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
+    }
+  
+  pjob->ji_modified = TRUE;
+  svr_evaljobstate(*pjob, newstate, newsub, 1);
+  svr_setjobstate(pjob, newstate, newsub, FALSE);
+
+  /*
+   * if the job went into a Route (push) queue that has been started,
+   * try once to route it to give immediate feedback as a courtsey
+   * to the user.
+   */
+
+  if ((pque = get_jobs_queue(&pjob)) != NULL)
+    {
+    mutex_mgr pque_mutex = mutex_mgr(pque->qu_mutex,true);
+    if ((pque->qu_qs.qu_type == QTYPE_RoutePush) &&
+        (pque->qu_attr[QA_ATR_Started].at_val.at_long != 0))
+      { 
+      /* job_route expects the queue to be unlocked */
+      pque_mutex.unlock();
+      if (job_route(pjob))
+        {
+        if (LOGLEVEL >= 6)
+          {
+          snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "cannot route job %s", pjob->ji_qs.ji_jobid);
+          log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buf);
+          }
+        svr_job_purge(pjob);
+        pjob = NULL;
+        }
+      }
+    }
+
+  if (pjob != NULL) //The call to get_jobs_queue call set pjob to NULL.
+    {
+    pjob->ji_commit_done = 1;
+    }
+
+  *pjob_ptr = pjob;
+  } /* END release_array_hold() */
+
+
+
 /*
  * job_clone_wt - worktask to clone jobs for job array
+ *
+ * When the server's idle_slot_limit is set this stops once that many of the
+ * array's jobs are queued or held. The other indices stay in the array's
+ * request tokens and update_array_values() starts this again as jobs run.
  */
 
 void *job_clone_wt(
@@ -1201,22 +1407,16 @@ void *job_clone_wt(
   job                *pjobclone;
   char               *jobid;
   int                 i;
+  int                 j;
   int                 rc;
+  int                 count;
   std::string         prev_job_id;
   int                 actual_job_count = 0;
-  int                 newstate;
-  int                 newsub;
-  char                namebuf[MAXPATHLEN];
   char                arrayid[PBS_MAXSVRJOBID + 1];
   job_array          *pa;
-  struct pbs_queue   *pque;
-  char               log_buf[LOCAL_LOG_BUF_SIZE];
-
-  array_request_node *rn;
-  int                 start;
-  int                 end;
-
-  std::string	      adjusted_path_jobs;
+  long                idle_slot_limit = 0;
+  bool                recovered;
+  std::vector<int>    cloned;
 
   jobid = (char *)cloned_id;
 
@@ -1247,139 +1447,66 @@ void *job_clone_wt(
     return(NULL);
     }
 
-  mutex_mgr array_mgr(pa->ai_mutex, true);
-  mutex_mgr template_job_mgr(template_job->ji_mutex,true);
-
   strcpy(arrayid, pa->ai_qs.parent_id);
 
   free(jobid);
 
-  // get the adjusted path_jobs path
-  adjusted_path_jobs = get_path_jobdata(template_job->ji_qs.ji_jobid, path_jobs);
+  unlock_ji_mutex(template_job, __func__, "2", LOGLEVEL);
 
-  snprintf(namebuf, sizeof(namebuf), "%s%s%s",
-    adjusted_path_jobs.c_str(), template_job->ji_qs.ji_fileprefix, ARRAY_FILE_SUFFIX);
-
-  template_job_mgr.unlock();
-
-  while ((rn = (array_request_node *)GET_NEXT(pa->request_tokens)) != NULL)
-    {
-    start = rn->start;
-    end = rn->end;
-
-    for (i = start; i <= end; i++)
-      {
-      if (pa->job_ids[i] != NULL)
-        {
-        /* This job already exists. This can happen when trying to recover a job
-         * array that wasn't fully cloned. */
-        rn->start++;
-        continue;
-        }
-
-      template_job_mgr.lock();
-      pjobclone = job_clone(template_job, pa, i);
-      template_job_mgr.unlock();
-
-      if (pjobclone == NULL)
-        {
-        log_err(-1, __func__, "unable to clone job in job_clone_wt");
-        continue;
-        }
-      else if (pjobclone == (job *)1)
-        {
-        /* this happens if we attempted to clone an existing job */
-        rn->start++;
-        continue;
-        }
+  pa->cloning = true;
 
-      mutex_mgr clone_mgr(pjobclone->ji_mutex, true);
+  /* an array recovered at startup can have jobs from before the restart that
+   * still have their array hold */
+  recovered = (pa->num_idle < 0);
 
-      svr_evaljobstate(*pjobclone, newstate, newsub, 1);
-
-      /* do this so that  svr_setjobstate() doesn't alter sv_jobstates,
-       * these are set later in svr_enquejob() */
-      pjobclone->ji_qs.ji_state = newstate;
-      pjobclone->ji_qs.ji_substate = newsub;
-
-      svr_setjobstate(pjobclone, newstate, newsub, FALSE);
-
-      pjobclone->ji_wattr[JOB_ATR_qrank].at_val.at_long = ++queue_rank;
-      pjobclone->ji_wattr[JOB_ATR_qrank].at_flags |= ATR_VFLAG_SET;
-
-      array_mgr.unlock();
-
-      if ((rc = svr_enquejob(pjobclone, FALSE, prev_job_id.c_str(), false)))
-        {
-        /* XXX need more robust error handling */
-        clone_mgr.set_unlock_on_exit(false);
-
-        if (rc != PBSE_JOB_RECYCLED)
-          {
-          svr_job_purge(pjobclone);
-          }
-
-        if ((pa = get_array(arrayid)) == NULL)
-          {
-          sem_wait(job_clone_semaphore);
-          return(NULL);
-          }
+  if (recovered == true)
+    pa->num_idle = count_idle_subjobs(pa);
+  else
+    actual_job_count = pa->num_idle + pa->ai_qs.jobs_running;
 
-        array_mgr.mark_as_locked();
+  get_svr_attr_l(SRV_ATR_IdleSlotLimit, &idle_slot_limit);
 
-        continue;
-        }
+  while ((idle_slot_limit <= 0) ||
+         (pa->num_idle < idle_slot_limit))
+    {
+    if ((i = next_uncloned_index(pa)) < 0)
+      break;
 
-      if ((pa = get_jobs_array(&pjobclone)) == NULL)
-        {
-        if (pjobclone == NULL)
-          {
-          /* pjobclone has been released. No mutex left to unlock */
-          clone_mgr.set_unlock_on_exit(false);
-          }
+    if (pa->job_ids[i] != NULL)
+      {
+      /* This job already exists. This can happen when trying to recover a job
+       * array that wasn't fully cloned. */
+      continue;
+      }
 
-        sem_wait(job_clone_semaphore);
-        return(NULL);
-        }
-      
-      array_mgr.mark_as_locked();
+    pjobclone = clone_array_subjob(template_job, &pa, arrayid, i, prev_job_id);
 
-      if (job_save(pjobclone, SAVEJOB_FULL, 0) != 0)
-        {
-        /* XXX need more robust error handling */
-        array_mgr.unlock();
-        svr_job_purge(pjobclone);
-        
-        if ((pa = get_array(arrayid)) == NULL)
-          {
-          sem_wait(job_clone_semaphore);
-          return(NULL);
-          }
-
-        array_mgr.mark_as_locked();
-        
-        continue;
-        }
-      
-      prev_job_id = pjobclone->ji_qs.ji_jobid;
-      
-      pa->ai_qs.num_cloned++;
-      
-      rn->start++;
-      }  /* END for (i) */
+    if (pa == NULL)
+      {
+      sem_wait(job_clone_semaphore);
+      return(NULL);
+      }
 
-    if (rn->start > rn->end)
+    if (pjobclone != NULL)
       {
-      delete_link(&rn->request_tokens_link);
-      free(rn);
+      unlock_ji_mutex(pjobclone, __func__, "3", LOGLEVEL);
+      cloned.push_back(i);
       }
-    }    /* END while (loop) */
+    }  /* END while (loop) */
       
   array_save(pa);
 
-  /* scan over all the jobs in the array and unset the hold */
-  for (i = 0; i < pa->ai_qs.array_size; i++)
+  /* unset the hold on the jobs that were just cloned, or on all of them
+   * for a recovered array */
+  if (recovered == true)
+    count = pa->ai_qs.array_size;
+  else
+    count = (int)cloned.size();
+
+  for (j = 0; j < count; j++)
     {
+    i = (recovered == true) ? j : cloned[j];
+
     if (pa->job_ids[i] == NULL)
       continue;
     
@@ -1394,70 +1521,17 @@ void *job_clone_wt(
       }
     else
       {
-      mutex_mgr job_mutex(pjob->ji_mutex,true);
-      long moab_compatible = FALSE;;
-      get_svr_attr_l(SRV_ATR_MoabArrayCompatible, &moab_compatible);
-      pjob->ji_wattr[JOB_ATR_hold].at_val.at_long &= ~HOLD_a;
-      
-      if (moab_compatible != FALSE)
-        {
-        /* if configured and necessary, apply a slot limit hold to all
-         * jobs above the slot limit threshold */
-        if ((pa->ai_qs.slot_limit != NO_SLOT_LIMIT) &&
-            (actual_job_count > pa->ai_qs.slot_limit))
-          {
-          pjob->ji_wattr[JOB_ATR_hold].at_val.at_long |= HOLD_l;
-          }
-        }
-      
-      if (pjob->ji_wattr[JOB_ATR_hold].at_val.at_long == 0)
-        {
-        pjob->ji_wattr[JOB_ATR_hold].at_flags &= ~ATR_VFLAG_SET;
-        }
-      else
-        {
-        pjob->ji_wattr[JOB_ATR_hold].at_flags |= ATR_VFLAG_SET;
-        }
-      
-      pjob->ji_modified = TRUE;
-      svr_evaljobstate(*pjob, newstate, newsub, 1);
-      svr_setjobstate(pjob, newstate, newsub, FALSE);
-
-       /*
-       * if the job went into a Route (push) queue that has been started,
-       * try once to route it to give immediate feedback as a courtsey
-       * to the user.
-       */
-
-     if ((pque = get_jobs_queue(&pjob)) != NULL)
-       {
-       mutex_mgr pque_mutex = mutex_mgr(pque->qu_mutex,true);
-       if ((pque->qu_qs.qu_type == QTYPE_RoutePush) &&
-           (pque->qu_attr[QA_ATR_Started].at_val.at_long != 0))
-         { 
-         /* job_route expects the queue to be unlocked */
-         pque_mutex.unlock();
-         if ((rc = job_route(pjob)))
-           {
-           if (LOGLEVEL >= 6)
-             {
-             snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "cannot route job %s", pjob->ji_qs.ji_jobid);
-             log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buf);
-             }
-           svr_job_purge(pjob);
-           pque_mutex.unlock();
-           continue;
-           }
-         }
-       }
-
-      if(pjob != NULL) //The call to get_jobs_queue call set pjob to NULL.
-        {
-        pjob->ji_commit_done = 1;
-        }
+      release_array_hold(&pjob, pa, actual_job_count);
+
+      if (pjob != NULL)
+        unlock_ji_mutex(pjob, __func__, "4", LOGLEVEL);
       }
     }
-  
+
+  pa->cloning = false;
+
+  /* jobs may have started while the last ones were cloned */
+  clone_more_subjobs(pa);
 
   unlock_ai_mutex(pa, __func__, "3", LOGLEVEL);
   sem_wait(job_clone_semaphore);
@@ -1466,6 +1540,86 @@ void *job_clone_wt(
 
 
 
+/*
+ * clone_subjob_now - clone the job at index of array pa now instead of
+ * leaving it to job_clone_wt(), because a request named it
+ *
+ * @param pa_ptr - I/O - the array, locked. It is still locked on return
+ * unless it went away in between, then it is set to NULL.
+ * @return the new job, locked, or NULL if index wasn't waiting to be cloned
+ */
+
+job *clone_subjob_now(
+
+  job_array **pa_ptr,
+  int         index)
+
+  {
+  job_array   *pa = *pa_ptr;
+  job         *template_job;
+  job         *pjob;
+  std::string  prev_job_id;
+  char         arrayid[PBS_MAXSVRJOBID + 1];
+
+  if (is_uncloned_index(pa, index) == false)
+    return(NULL);
+
+  strcpy(arrayid, pa->ai_qs.parent_id);
+
+  if ((template_job = svr_find_job(arrayid, FALSE)) == NULL)
+    return(NULL);
+
+  unlock_ji_mutex(template_job, __func__, "1", LOGLEVEL);
+
+  remove_uncloned_range(pa, index, index);
+
+  if ((pjob = clone_array_subjob(template_job, pa_ptr, arrayid, index, prev_job_id)) != NULL)
+    {
+    pa = *pa_ptr;
+    release_array_hold(&pjob, pa, pa->num_idle + pa->ai_qs.jobs_running);
+    }
+
+  if (*pa_ptr != NULL)
+    array_save(*pa_ptr);
+
+  return(pjob);
+  } /* END clone_subjob_now() */
+
+
+
+/*
+ * clone_uncloned_subjob - clone the array job job_id names if it is still
+ * waiting to be cloned
+ *
+ * @return the job, locked, or NULL if job_id isn't an array job that is
+ * waiting to be cloned
+ */
+
+job *clone_uncloned_subjob(
+
+  const char *job_id)
+
+  {
+  job_array *pa;
+  job       *pjob;
+  char       parent_id[PBS_MAXSVRJOBID + 1];
+  int        index;
+
+  if ((strlen(job_id) > PBS_MAXSVRJOBID) ||
+      ((index = get_subjob_index(job_id, parent_id)) < 0) ||
+      ((pa = get_array(parent_id)) == NULL))
+    return(NULL);
+
+  pjob = clone_subjob_now(&pa, index);
+
+  if (pa != NULL)
+    unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
+
+  return(pjob);
+  } /* END clone_uncloned_subjob() */
+
+
+
 
 /*
  * job_init_wattr - initialize job working pbs_attribute array
@@ -1922,6 +2076,9 @@ int svr_job_purge(
   if (LOGLEVEL >= 10)
     log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, __func__, pjob->ji_qs.ji_jobid);
 
+  if (job_is_array_template == FALSE)
+    job_events_publish(pjob, PBS_EVENT_PURGED);
+
   /* check to see if we are keeping a log of all jobs completed */
   get_svr_attr_l(SRV_ATR_RecordJobInfo, &record_job_info);
   if (record_job_info)
@@ -2128,6 +2285,16 @@ int svr_job_purge(
     log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, job_id, log_buf);
     }
 
+  if (job_is_array_template != TRUE)
+    {
+    snprintf(namebuf, sizeof(namebuf), "%s%s%s",
+      adjusted_path_jobs.c_str(), job_fileprefix, JOB_FILE_JOURNAL);
+
+    if ((unlink(namebuf) < 0) &&
+        (errno != ENOENT))
+      log_err(errno, __func__, msg_err_purgejob);
+    }
+
   if (do_delete_array == TRUE)
     {
     pa = get_array(array_id);
@@ -2463,15 +2630,11 @@ bool job_id_exists(
   {
   bool rc = false;
 
-  alljobs.lock();
-
-  if (alljobs.find(job_id_string) != NULL)
+  if (alljobs_index.find(job_id_string) != NULL)
     {
     rc = true;
     }
 
-  alljobs.unlock();
-
   return(rc);
   }
   
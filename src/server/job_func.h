@@ -16,6 +16,10 @@ struct job *job_clone(struct job *template_job, struct job_array *pa, int taskid
 
 void *job_clone_wt(void *vp);
 
+struct job *clone_subjob_now(struct job_array **pa, int index);
+
+struct job *clone_uncloned_subjob(const char *job_id);
+
 struct batch_request *cpy_checkpoint(struct batch_request *preq, struct job *pjob, enum job_atr ati, int direction);
 
 void remove_checkpoint(struct job **pjob);
@@ -0,0 +1,229 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+#include "job_index.hpp"
+
+
+
+/*
+ * get_shard()
+ *
+ * hashes the job id with FNV-1a to pick its shard. A different hash than the
+ * one the shard's map uses keeps the ids well spread inside each shard.
+ */
+
+job_index::index_shard &job_index::get_shard(
+
+  const std::string &id)
+
+  {
+  unsigned int hash = 2166136261U;
+
+  for (size_t i = 0; i < id.size(); i++)
+    {
+    hash ^= (unsigned char)id[i];
+    hash *= 16777619U;
+    }
+
+  return(this->shards[hash % JOB_INDEX_SHARDS]);
+  } // END get_shard()
+
+
+
+/*
+ * insert()
+ *
+ * adds pjob under id, replacing any job already indexed with that id
+ */
+
+void job_index::insert(
+
+  const std::string &id,
+  job               *pjob)
+
+  {
+  index_shard &s = this->get_shard(id);
+
+  pthread_rwlock_wrlock(&s.lock);
+  s.jobs[id] = pjob;
+  pthread_rwlock_unlock(&s.lock);
+  } // END insert()
+
+
+
+/*
+ * remove()
+ *
+ * removes id from the index if it still refers to pjob. A NULL pjob removes
+ * id no matter which job it refers to.
+ *
+ * @return true if an entry was removed
+ */
+
+bool job_index::remove(
+
+  const std::string &id,
+  job               *pjob)
+
+  {
+  index_shard &s = this->get_shard(id);
+  bool         removed = false;
+
+  pthread_rwlock_wrlock(&s.lock);
+
+  boost::unordered_map<std::string, job *>::iterator it = s.jobs.find(id);
+
+  if ((it != s.jobs.end()) &&
+      ((pjob == NULL) ||
+       (it->second == pjob)))
+    {
+    s.jobs.erase(it);
+    removed = true;
+    }
+
+  pthread_rwlock_unlock(&s.lock);
+
+  return(removed);
+  } // END remove()
+
+
+
+/*
+ * find()
+ *
+ * @return the job indexed under id, or NULL. The job isn't locked; the
+ * caller locks it and checks ji_being_recycled as next_job() does.
+ */
+
+job *job_index::find(
+
+  const std::string &id)
+
+  {
+  index_shard &s = this->get_shard(id);
+  job         *pjob = NULL;
+
+  pthread_rwlock_rdlock(&s.lock);
+
+  boost::unordered_map<std::string, job *>::iterator it = s.jobs.find(id);
+
+  if (it != s.jobs.end())
+    pjob = it->second;
+
+  pthread_rwlock_unlock(&s.lock);
+
+  return(pjob);
+  } // END find()
+
+
+
+size_t job_index::count()
+
+  {
+  size_t total = 0;
+
+  for (int i = 0; i < JOB_INDEX_SHARDS; i++)
+    {
+    pthread_rwlock_rdlock(&this->shards[i].lock);
+    total += this->shards[i].jobs.size();
+    pthread_rwlock_unlock(&this->shards[i].lock);
+    }
+
+  return(total);
+  } // END count()
+
+
+
+job_index::job_index()
+
+  {
+  this->shards = new index_shard[JOB_INDEX_SHARDS];
+
+  for (int i = 0; i < JOB_INDEX_SHARDS; i++)
+    pthread_rwlock_init(&this->shards[i].lock, NULL);
+  }
+
+
+
+job_index::~job_index()
+
+  {
+  // leave the shards alone. Like id_map, this is only destroyed when the main
+  // thread exits and other threads may still be looking up jobs.
+  }
@@ -85,6 +85,11 @@
  * The following public functions are provided:
  *  job_save()   - save the disk image
  *  job_recov()  - recover (read) job from disk
+ *
+ * On the server a quick save appends the changed fields to a journal
+ * (.JL) next to the job file instead of rewriting it. A full save writes
+ * a new job file and starts an empty journal, and job_recov() replays
+ * the journal on top of the job file.
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -101,6 +106,8 @@
 #include <stdio.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <string>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <pthread.h>
@@ -122,6 +129,7 @@
 #include "array.h"
 #include "../lib/Libutils/u_lock_ctl.h" /* lock_ss, unlock_ss */
 #include "job_func.h"
+#include "change_log.hpp"
 #else
 #include "../resmom/mom_job_func.h"
 #endif
@@ -138,6 +146,38 @@
 #define MAX_SAVE_TRIES 3
 #define BUFSIZE 1024
 
+#define JOURNAL_MAGIC       0x4c4e4a54 /* "TJNL" */
+#define JOURNAL_REC_MAGIC   0x52434a54 /* "TJCR" */
+#define JOURNAL_VERSION     1
+#define JOURNAL_MAX_SIZE    (64 * 1024) /* compact into the job file past this */
+#define JOURNAL_MAX_RECORD  (1024 * 1024)
+
+/* first bytes of a journal, ties it to the job file it follows */
+typedef struct journal_header
+  {
+  unsigned int jh_magic;
+  unsigned int jh_version;
+  unsigned int jh_snapshot_len;
+  unsigned int jh_snapshot_crc;
+  } journal_header;
+
+/* precedes each record: ji_qs followed by the changed attributes */
+typedef struct journal_record
+  {
+  unsigned int jr_magic;
+  unsigned int jr_len;
+  unsigned int jr_crc;
+  } journal_record;
+
+/* one attribute inside a record, followed by its name, resource and value */
+typedef struct journal_attr
+  {
+  unsigned int ja_flags;
+  unsigned int ja_nameln;
+  unsigned int ja_rescln;
+  unsigned int ja_valln;
+  } journal_attr;
+
 #ifdef PBS_MOM
 int recov_tmsock(int, job *);
 extern unsigned int pbs_mom_port;
@@ -1159,6 +1199,487 @@ int saveJobToXML(
   } /* saveJobToXML */
 
 
+#ifndef PBS_MOM
+/*
+ * journal_crc() - crc32 of buf, continuing from crc (pass 0 to start)
+ */
+
+unsigned int journal_crc(
+
+  const char   *buf,
+  size_t        len,
+  unsigned int  crc)
+
+  {
+  crc = ~crc;
+
+  for (size_t i = 0; i < len; i++)
+    {
+    crc ^= (unsigned char)buf[i];
+
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+
+  return(~crc);
+  } /* END journal_crc() */
+
+
+
+/*
+ * get_journal_path() - the journal for a job file is the job file with
+ * its .JB suffix replaced by .JL. Returns -1 for other job files.
+ */
+
+int get_journal_path(
+
+  const char *jobfile,
+  char       *path,
+  size_t      path_len)
+
+  {
+  size_t len = strlen(jobfile);
+  size_t suf_len = strlen(JOB_FILE_SUFFIX);
+
+  if ((len <= suf_len) ||
+      (strcmp(jobfile + len - suf_len, JOB_FILE_SUFFIX)) ||
+      (len - suf_len + strlen(JOB_FILE_JOURNAL) >= path_len))
+    return(-1);
+
+  snprintf(path, path_len, "%.*s%s", (int)(len - suf_len), jobfile, JOB_FILE_JOURNAL);
+
+  return(PBSE_NONE);
+  } /* END get_journal_path() */
+
+
+
+/*
+ * crc_job_file() - checksum and length of the job file a journal follows
+ */
+
+int crc_job_file(
+
+  const char   *jobfile,
+  unsigned int *crc,
+  unsigned int *len)
+
+  {
+  char    buf[BUFSIZE * 8];
+  ssize_t amt;
+  int     fds;
+
+  if ((fds = open(jobfile, O_RDONLY, 0)) < 0)
+    return(-1);
+
+  *crc = 0;
+  *len = 0;
+
+  while ((amt = read_ac_socket(fds, buf, sizeof(buf))) > 0)
+    {
+    *crc = journal_crc(buf, amt, *crc);
+    *len += amt;
+    }
+
+  close(fds);
+
+  return((amt < 0) ? -1 : PBSE_NONE);
+  } /* END crc_job_file() */
+
+
+
+void add_journal_attr(
+
+  std::string  &payload,
+  unsigned int  flags,
+  const char   *name,
+  const char   *resc,
+  const char   *value)
+
+  {
+  journal_attr ja;
+
+  ja.ja_flags = flags;
+  ja.ja_nameln = strlen(name) + 1;
+  ja.ja_rescln = (resc != NULL) ? strlen(resc) + 1 : 0;
+  ja.ja_valln = (value != NULL) ? strlen(value) + 1 : 0;
+
+  payload.append((char *)&ja, sizeof(ja));
+  payload.append(name, ja.ja_nameln);
+
+  if (ja.ja_rescln)
+    payload.append(resc, ja.ja_rescln);
+
+  if (ja.ja_valln)
+    payload.append(value, ja.ja_valln);
+  } /* END add_journal_attr() */
+
+
+
+/*
+ * journal_this_attr() - the state fields are updated directly by the quick
+ * save callers, everything else is journaled when it was modified
+ */
+
+bool journal_this_attr(
+
+  pbs_attribute *pattr,
+  int            index)
+
+  {
+  if (job_attr_def[index].at_type == ATR_TYPE_ACL)
+    return(false);
+
+  switch (index)
+    {
+    case JOB_ATR_state:
+    case JOB_ATR_substate:
+    case JOB_ATR_etime:
+    case JOB_ATR_mtime:
+
+      return(true);
+    }
+
+  return((pattr->at_flags & ATR_VFLAG_MODIFY) != 0);
+  } /* END journal_this_attr() */
+
+
+
+/*
+ * encode_journal_attrs() - add the changed attributes to a record payload
+ * using the same encoding as the job file. An unset attribute is written
+ * without a value so replay clears it.
+ */
+
+int encode_journal_attrs(
+
+  std::string   &payload,
+  pbs_attribute *pattr)
+
+  {
+  tlist_head  lhead;
+  svrattrl   *pal;
+  int         rc;
+
+  CLEAR_HEAD(lhead);
+
+  for (int i = 0; i < JOB_ATR_LAST; i++)
+    {
+    if (journal_this_attr(pattr + i, i) == false)
+      continue;
+
+    if ((pattr[i].at_flags & ATR_VFLAG_SET) == 0)
+      {
+      add_journal_attr(payload, 0, job_attr_def[i].at_name, NULL, NULL);
+      }
+    else if ((i != JOB_ATR_resource) &&
+             (i != JOB_ATR_resc_used) &&
+             (i != JOB_ATR_req_information))
+      {
+      std::string value;
+
+      if (i == JOB_ATR_depend)
+        translate_dependency_to_string(pattr + i, value);
+      else
+        attr_to_str(value, job_attr_def + i, pattr[i], true);
+
+      if (value.size() == 0)
+        add_journal_attr(payload, 0, job_attr_def[i].at_name, NULL, NULL);
+      else
+        add_journal_attr(payload, pattr[i].at_flags, job_attr_def[i].at_name, NULL, value.c_str());
+      }
+    else
+      {
+      bool encoded = false;
+
+      rc = job_attr_def[i].at_encode(pattr + i,
+          &lhead,
+          job_attr_def[i].at_name,
+          NULL,
+          ATR_ENCODE_SAVE,
+          ATR_DFLAG_ACCESS);
+
+      if (rc < 0)
+        return(-1);
+
+      while ((pal = (svrattrl *)GET_NEXT(lhead)) != NULL)
+        {
+        if (pal->al_atopl.resource != NULL)
+          {
+          add_journal_attr(payload, pal->al_flags, job_attr_def[i].at_name,
+            pal->al_atopl.resource, pal->al_atopl.value);
+          encoded = true;
+          }
+
+        delete_link(&pal->al_link);
+        free(pal);
+        }
+
+      if (encoded == false)
+        add_journal_attr(payload, 0, job_attr_def[i].at_name, NULL, NULL);
+      }
+
+    pattr[i].at_flags &= ~ATR_VFLAG_MODIFY;
+    }
+
+  return(PBSE_NONE);
+  } /* END encode_journal_attrs() */
+
+
+
+/*
+ * job_journal_append() - append the job's quick save fields and changed
+ * attributes to its journal.
+ *
+ * Returns -1 if there is no journal for the current job file or it has
+ * grown past JOURNAL_MAX_SIZE, in which case the caller does a full save.
+ */
+
+int job_journal_append(
+
+  job        *pjob,     /* I */
+  const char *journal)  /* I */
+
+  {
+  journal_record  jr;
+  std::string     payload;
+  struct stat     sb;
+  int             fds;
+  int             rc = PBSE_NONE;
+
+  if ((fds = open(journal, O_WRONLY | O_APPEND, 0)) < 0)
+    return(-1);
+
+  if ((fstat(fds, &sb) < 0) ||
+      (sb.st_size < (off_t)sizeof(journal_header)) ||
+      (sb.st_size >= JOURNAL_MAX_SIZE))
+    {
+    close(fds);
+    return(-1);
+    }
+
+  payload.append((char *)&pjob->ji_qs, sizeof(pjob->ji_qs));
+
+  if (encode_journal_attrs(payload, pjob->ji_wattr) != PBSE_NONE)
+    {
+    close(fds);
+    return(-1);
+    }
+
+  jr.jr_magic = JOURNAL_REC_MAGIC;
+  jr.jr_len = payload.size();
+  jr.jr_crc = journal_crc(payload.c_str(), payload.size(), 0);
+
+  payload.insert(0, (char *)&jr, sizeof(jr));
+
+  if (write_ac_socket(fds, payload.c_str(), payload.size()) != (ssize_t)payload.size())
+    {
+    /* a partial record fails its crc and ends replay, so just start over */
+    log_err(errno, __func__, "cannot write job journal");
+    rc = -1;
+    }
+
+  close(fds);
+
+  return(rc);
+  } /* END job_journal_append() */
+
+
+
+/*
+ * job_journal_reset() - start an empty journal for a newly written job file
+ */
+
+int job_journal_reset(
+
+  const char *jobfile,  /* I */
+  const char *journal)  /* I */
+
+  {
+  journal_header jh;
+  int            fds;
+  int            rc = PBSE_NONE;
+
+  jh.jh_magic = JOURNAL_MAGIC;
+  jh.jh_version = JOURNAL_VERSION;
+
+  if (crc_job_file(jobfile, &jh.jh_snapshot_crc, &jh.jh_snapshot_len) != PBSE_NONE)
+    {
+    unlink(journal);
+    return(-1);
+    }
+
+  if ((fds = open(journal, O_WRONLY | O_CREAT | O_TRUNC, 0600)) < 0)
+    return(-1);
+
+  if (write_ac_socket(fds, (char *)&jh, sizeof(jh)) != sizeof(jh))
+    rc = -1;
+
+  close(fds);
+
+  if (rc != PBSE_NONE)
+    unlink(journal);
+
+  return(rc);
+  } /* END job_journal_reset() */
+
+
+
+/*
+ * apply_journal_record() - set the job from one verified record
+ */
+
+int apply_journal_record(
+
+  job        *pjob,
+  const char *payload,
+  size_t      len)
+
+  {
+  const char   *end = payload + len;
+  journal_attr  ja;
+  int           last_index = -1;
+  char          log_buf[LOCAL_LOG_BUF_SIZE];
+  struct jobfix qs;
+
+  if (len < sizeof(qs))
+    return(-1);
+
+  memcpy(&qs, payload, sizeof(qs));
+  payload += sizeof(qs);
+
+  if ((qs.qs_version != PBS_QS_VERSION) ||
+      (strcmp(qs.ji_jobid, pjob->ji_qs.ji_jobid)))
+    return(-1);
+
+  memcpy(&pjob->ji_qs, &qs, sizeof(qs));
+
+  while (payload < end)
+    {
+    if ((size_t)(end - payload) < sizeof(ja))
+      return(-1);
+
+    memcpy(&ja, payload, sizeof(ja));
+    payload += sizeof(ja);
+
+    if ((ja.ja_nameln == 0) ||
+        ((size_t)(end - payload) < (size_t)ja.ja_nameln + ja.ja_rescln + ja.ja_valln))
+      return(-1);
+
+    const char *name = payload;
+    const char *resc = (ja.ja_rescln) ? name + ja.ja_nameln : NULL;
+    const char *value = (ja.ja_valln) ? name + ja.ja_nameln + ja.ja_rescln : NULL;
+
+    payload += ja.ja_nameln + ja.ja_rescln + ja.ja_valln;
+
+    if ((name[ja.ja_nameln - 1] != '\0') ||
+        ((resc != NULL) && (resc[ja.ja_rescln - 1] != '\0')) ||
+        ((value != NULL) && (value[ja.ja_valln - 1] != '\0')))
+      return(-1);
+
+    int index = find_attr(job_attr_def, name, JOB_ATR_LAST);
+
+    if (index < 0)
+      index = JOB_ATR_UNKN;
+
+    if ((ja.ja_flags & ATR_VFLAG_SET) == 0)
+      {
+      job_attr_def[index].at_free(&pjob->ji_wattr[index]);
+      pjob->ji_wattr[index].at_flags = 0;
+      last_index = index;
+      continue;
+      }
+
+    svrattrl *pal = fill_svrattr_info(name, value, resc, log_buf, sizeof(log_buf));
+
+    if (pal == NULL)
+      return(-1);
+
+    pal->al_flags = ja.ja_flags;
+
+    /* the resources of one list attribute are consecutive entries */
+    decode_attribute(pal, &pjob, index != last_index);
+    last_index = index;
+
+    free(pal);
+    }
+
+  return(PBSE_NONE);
+  } /* END apply_journal_record() */
+
+
+
+/*
+ * job_journal_replay() - apply the journal written since jobfile was saved
+ *
+ * A journal left from an older job file is ignored, and replay stops at
+ * the first incomplete or damaged record.
+ *
+ * Returns the number of records applied or -1 if no journal was usable.
+ */
+
+int job_journal_replay(
+
+  job        *pjob,     /* M */
+  const char *jobfile,  /* I */
+  const char *journal)  /* I */
+
+  {
+  journal_header  jh;
+  journal_record  jr;
+  unsigned int    crc;
+  unsigned int    len;
+  int             fds;
+  int             applied = 0;
+  char            log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((fds = open(journal, O_RDONLY, 0)) < 0)
+    return(-1);
+
+  if ((read_ac_socket(fds, (char *)&jh, sizeof(jh)) != sizeof(jh)) ||
+      (jh.jh_magic != JOURNAL_MAGIC) ||
+      (jh.jh_version != JOURNAL_VERSION) ||
+      (crc_job_file(jobfile, &crc, &len) != PBSE_NONE) ||
+      (crc != jh.jh_snapshot_crc) ||
+      (len != jh.jh_snapshot_len))
+    {
+    close(fds);
+    return(-1);
+    }
+
+  while (read_ac_socket(fds, (char *)&jr, sizeof(jr)) == sizeof(jr))
+    {
+    if ((jr.jr_magic != JOURNAL_REC_MAGIC) ||
+        (jr.jr_len > JOURNAL_MAX_RECORD))
+      break;
+
+    char *payload = (char *)calloc(1, jr.jr_len + 1);
+
+    if (payload == NULL)
+      break;
+
+    if ((read_ac_socket(fds, payload, jr.jr_len) != (ssize_t)jr.jr_len) ||
+        (journal_crc(payload, jr.jr_len, 0) != jr.jr_crc) ||
+        (apply_journal_record(pjob, payload, jr.jr_len) != PBSE_NONE))
+      {
+      snprintf(log_buf, sizeof(log_buf),
+        "journal %s ends with a damaged record after %d records", journal, applied);
+      log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pjob->ji_qs.ji_jobid, log_buf);
+
+      free(payload);
+      break;
+      }
+
+    free(payload);
+    applied++;
+    }
+
+  close(fds);
+
+  return(applied);
+  } /* END job_journal_replay() */
+#endif /* !PBS_MOM */
+
+
 /*
  * job_save() - Saves (or updates) a job structure image on disk
  *
@@ -1179,6 +1700,10 @@ int saveJobToXML(
  * For a new file write, first time, the data is written directly to
  * the file.
  *
+ * On the server a quick update is appended to the job's journal instead,
+ * and every full update starts a new journal. Once the journal grows past
+ * JOURNAL_MAX_SIZE the next quick update is done as a full update.
+ *
  *      RETURN:  0 - success, -1 - failure
  */
 
@@ -1199,6 +1724,10 @@ int job_save(
 #ifndef PBS_MOM
   // get the adjusted path_jobs path
   std::string   adjusted_path_jobs = get_path_jobdata(pjob->ji_qs.ji_jobid, path_jobs);
+
+  // whatever changed, the encoded status no longer matches the job
+  job_stat_cache_invalidate(pjob);
+  pjob->ji_change_seq = server_changes.next();
 #endif
 
 
@@ -1247,6 +1776,20 @@ int job_save(
     pjob->ji_wattr[JOB_ATR_mtime].at_val.at_long = time_now;
     }
 
+#ifndef PBS_MOM
+  char  journal[MAXPATHLEN];
+  bool  use_journal = (mom_port == 0) &&
+                      (get_journal_path(namebuf1, journal, sizeof(journal)) == PBSE_NONE);
+
+  if ((use_journal == true) &&
+      (updatetype == SAVEJOB_QUICK) &&
+      (job_journal_append(pjob, journal) == PBSE_NONE))
+    {
+    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, 0);
+    return(PBSE_NONE);
+    }
+#endif /* !PBS_MOM */
+
   if (!(saveJobToXML(pjob, namebuf2)))
     {
     unlink(namebuf1);
@@ -1263,6 +1806,12 @@ int job_save(
       {
       unlink(namebuf2);
       }
+
+#ifndef PBS_MOM
+    /* whatever was journaled is now in the job file */
+    if (use_journal == true)
+      job_journal_reset(namebuf1, journal);
+#endif /* !PBS_MOM */
     }
   else /* saveJobToXML failed */
     {
@@ -1577,7 +2126,15 @@ job *job_recov(
     rc = job_recov_binary(filename, &pj, log_buf, logBufLen);
 
   if (rc == PBSE_NONE)
+    {
+    char journal[MAXPATHLEN];
+
+    /* the full save below folds the journal back into the job file */
+    if (get_journal_path(filename, journal, sizeof(journal)) == PBSE_NONE)
+      job_journal_replay(pj, filename, journal);
+
     rc = set_array_job_ids(&pj, log_buf, logBufLen);
+    }
 #endif
 
 
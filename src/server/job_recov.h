@@ -13,4 +13,9 @@ void   add_fix_fields(xmlNodePtr *rnode, const job *pjob);
 void   add_union_fields(xmlNodePtr *rnode, const job *pjob);
 int    saveJobToXML(job *pjob, const char *filename);
 
+int    get_journal_path(const char *jobfile, char *path, size_t path_len);
+int    job_journal_append(job *pjob, const char *journal);
+int    job_journal_reset(const char *jobfile, const char *journal);
+int    job_journal_replay(job *pjob, const char *jobfile, const char *journal);
+
 #endif /* _JOB_RECOV_H */
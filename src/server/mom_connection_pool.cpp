@@ -0,0 +1,342 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdlib.h>
+
+#include "mom_connection_pool.hpp"
+#include "svr_connect.h" /* svr_connect_unwatched, svr_disconnect */
+#include "server_limits.h" /* PBS_LOCAL_CONNECTION */
+
+
+mom_connection_pool mom_connections(MOM_POOL_MAX_IDLE, MOM_POOL_IDLE_TIMEOUT);
+
+
+
+/*
+ * key()
+ *
+ * @return the key for the mom at addr and port
+ */
+
+unsigned long long mom_connection_pool::key(
+
+  pbs_net_t      addr,
+  unsigned short port)
+
+  {
+  return(((unsigned long long)addr << 16) | port);
+  } // END key()
+
+
+
+/*
+ * get()
+ *
+ * hands out an idle connection to the mom at addr and port, or opens a new
+ * one if there is none that can still be used. Idle connections that timed
+ * out or that the mom closed are closed on the way.
+ *
+ * @param my_err - set to errno when a new connection fails
+ * @param reused - set to true if the connection was used before
+ * @return a connection handle, or < 0 if the mom can't be reached
+ */
+
+int mom_connection_pool::get(
+
+  pbs_net_t       addr,
+  unsigned short  port,
+  int            *my_err,
+  bool           *reused)
+
+  {
+  std::vector<int> stale;
+  int              handle = -1;
+  time_t           now = time(NULL);
+
+  *reused = false;
+
+  pthread_mutex_lock(&this->mutex);
+
+  std::map<unsigned long long, std::vector<idle_mom_connection> >::iterator it =
+    this->idle.find(this->key(addr, port));
+
+  if (it != this->idle.end())
+    {
+    std::vector<idle_mom_connection> &conns = it->second;
+
+    // the most recently used connection is the likeliest to still be open
+    while (conns.size() > 0)
+      {
+      idle_mom_connection ic = conns.back();
+
+      conns.pop_back();
+
+      if ((now - ic.last_used > this->idle_timeout) ||
+          (svr_connection_usable(ic.handle) == false))
+        {
+        stale.push_back(ic.handle);
+        continue;
+        }
+
+      handle = ic.handle;
+      *reused = true;
+      break;
+      }
+
+    if (conns.size() == 0)
+      this->idle.erase(it);
+    }
+
+  pthread_mutex_unlock(&this->mutex);
+
+  for (size_t i = 0; i < stale.size(); i++)
+    svr_disconnect(stale[i]);
+
+  if (handle < 0)
+    handle = svr_connect_unwatched(addr, port, my_err);
+
+  return(handle);
+  } // END get()
+
+
+
+/*
+ * release()
+ *
+ * hands back a connection from get(). It is kept for the next request unless
+ * the request on it failed, since then it may hold part of a reply, or
+ * max_idle connections to the mom are already waiting.
+ *
+ * @param usable - false if the connection must be closed
+ */
+
+void mom_connection_pool::release(
+
+  pbs_net_t       addr,
+  unsigned short  port,
+  int             handle,
+  bool            usable)
+
+  {
+  if ((handle < 0) ||
+      (handle >= PBS_LOCAL_CONNECTION))
+    return;
+
+  if (usable == true)
+    {
+    pthread_mutex_lock(&this->mutex);
+
+    std::vector<idle_mom_connection> &conns = this->idle[this->key(addr, port)];
+
+    if (conns.size() < this->max_idle)
+      {
+      idle_mom_connection ic;
+
+      ic.handle = handle;
+      ic.last_used = time(NULL);
+      conns.push_back(ic);
+
+      handle = -1;
+      }
+
+    pthread_mutex_unlock(&this->mutex);
+    }
+
+  if (handle >= 0)
+    svr_disconnect(handle);
+  } // END release()
+
+
+
+/*
+ * close_idle()
+ *
+ * closes the connections that have been idle for more than idle_timeout
+ * seconds at time now
+ */
+
+void mom_connection_pool::close_idle(
+
+  time_t now)
+
+  {
+  std::vector<int> stale;
+
+  pthread_mutex_lock(&this->mutex);
+
+  std::map<unsigned long long, std::vector<idle_mom_connection> >::iterator it =
+    this->idle.begin();
+
+  while (it != this->idle.end())
+    {
+    std::vector<idle_mom_connection> &conns = it->second;
+    size_t                            kept = 0;
+
+    // the connections are in the order they were released
+    for (size_t i = 0; i < conns.size(); i++)
+      {
+      if (now - conns[i].last_used > this->idle_timeout)
+        stale.push_back(conns[i].handle);
+      else
+        conns[kept++] = conns[i];
+      }
+
+    conns.resize(kept);
+
+    if (kept == 0)
+      this->idle.erase(it++);
+    else
+      it++;
+    }
+
+  pthread_mutex_unlock(&this->mutex);
+
+  for (size_t i = 0; i < stale.size(); i++)
+    svr_disconnect(stale[i]);
+  } // END close_idle()
+
+
+
+/*
+ * idle_count()
+ *
+ * @return the number of idle connections kept open
+ */
+
+size_t mom_connection_pool::idle_count()
+
+  {
+  size_t count = 0;
+
+  pthread_mutex_lock(&this->mutex);
+
+  std::map<unsigned long long, std::vector<idle_mom_connection> >::iterator it;
+
+  for (it = this->idle.begin(); it != this->idle.end(); it++)
+    count += it->second.size();
+
+  pthread_mutex_unlock(&this->mutex);
+
+  return(count);
+  } // END idle_count()
+
+
+
+mom_connection_pool::mom_connection_pool(
+
+  unsigned int max,
+  time_t       timeout)
+
+  {
+  pthread_mutex_init(&this->mutex, NULL);
+  this->max_idle = max;
+  this->idle_timeout = timeout;
+  }
+
+
+
+mom_connection_pool::~mom_connection_pool()
+
+  {
+  // destroyed only as the main thread exits, the connections close with it
+  }
+
+
+
+/*
+ * check_mom_connections - close the mom connections nobody has used lately
+ */
+
+void check_mom_connections(
+
+  struct work_task *ptask) /* I */
+
+  {
+  time_t now = time(NULL);
+
+  mom_connections.close_idle(now);
+
+  free(ptask->wt_mutex);
+  free(ptask);
+
+  set_task(WORK_Timed, now + MOM_POOL_CHECK_RATE, check_mom_connections, NULL, FALSE);
+  } // END check_mom_connections()
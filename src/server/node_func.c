@@ -64,6 +64,8 @@
 #include "threadpool.h"
 #include "timer.hpp"
 #include "mom_hierarchy_handler.h"
+#include "node_index.hpp"
+#include "change_log.hpp"
 
 #if !defined(H_ERRNO_DECLARED) && !defined(_AIX)
 /*extern int h_errno;*/
@@ -321,6 +323,65 @@ struct pbsnode *find_nodebyname(
 
 
 
+/*
+ * update_node_index() - refresh pnode's entry in allnodes_index
+ *
+ * Called with pnode locked whenever its properties, state or free execution
+ * slots may have changed.
+ */
+
+void update_node_index(
+
+  struct pbsnode *pnode) /* I */
+
+  {
+  std::vector<std::string> props;
+  bool                     is_available;
+  bool                     is_opaque;
+
+  /* numa and alps subnodes are never walked from allnodes */
+  if ((pnode == NULL) ||
+      (pnode->nd_name == NULL) ||
+      (pnode->parent != NULL))
+    return;
+
+  for (struct prop *pp = pnode->nd_first; pp != NULL; pp = pp->next)
+    props.push_back(pp->name);
+
+  is_available = ((pnode->nd_state & (INUSE_OFFLINE | INUSE_NOT_READY | INUSE_RESERVE | INUSE_JOB)) == 0) &&
+                 (pnode->nd_power_state == POWER_STATE_RUNNING);
+
+  is_opaque = (pnode->num_node_boards > 0) ||
+              (pnode->nd_is_alps_reporter);
+
+  allnodes_index.update(pnode->nd_name, props, pnode->nd_slots.get_number_free(), is_available, is_opaque);
+  }  /* END update_node_index() */
+
+
+
+/*
+ * node_changed() - stamp pnode with a new change sequence and refresh its
+ * entry in allnodes_index
+ *
+ * Called with pnode locked whenever something a status request reports
+ * about it has changed.
+ */
+
+void node_changed(
+
+  struct pbsnode *pnode) /* I */
+
+  {
+  if (pnode == NULL)
+    return;
+
+  pnode->nd_change_seq = server_changes.next();
+
+  update_node_index(pnode);
+  }  /* END node_changed() */
+
+
+
 /*
  * save_characteristic() -  save the characteristic values of the node along
  *       with the address of the node
@@ -863,6 +924,7 @@ int initialize_pbsnode(
   pnode->nd_ms_jobs         = new std::vector<std::string>();
   pnode->nd_acl             = NULL;
   pnode->nd_requestid       = new std::string();
+  pnode->nd_change_seq      = server_changes.next();
 
   if(hierarchy_handler.isHiearchyLoaded())
     {
@@ -925,6 +987,9 @@ void effective_node_delete(
   if (remove_node(&allnodes, pnode) != PBSE_NONE)
     return;
 
+  allnodes_index.remove(pnode->nd_name);
+  server_changes.record_deletion(MGR_OBJ_NODE, pnode->nd_name, NULL);
+
   unlock_node(pnode, __func__, NULL, LOGLEVEL);
 
   //The node has been removed from the allnodes array.
@@ -2012,6 +2077,7 @@ static int finalize_create_pbs_node(char     *pname, /* node name w/o any :ts
     }
 
   insert_node(&allnodes,pnode);
+  node_changed(pnode);
 
   svr_totnodes++;
 
@@ -2551,6 +2617,7 @@ void handle_cray_specific_node_values(
         np->nd_is_alps_reporter = TRUE;
         alps_reporter = np;
         np->alps_subnodes = new all_nodes();
+        node_changed(np);
         unlock_node(np, __func__, NULL, LOGLEVEL);
         }
       }
@@ -3569,6 +3636,7 @@ int create_partial_pbs_node(
     }
 
   insert_node(&allnodes,pnode);
+  node_changed(pnode);
   AVL_insert(addr, pnode->nd_mom_port, pnode, ipaddrs);
   
   svr_totnodes++;
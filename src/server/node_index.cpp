@@ -0,0 +1,332 @@
+/*
+*         OpenPBS (Portable Batch System) v2.3 Software License
+*
+* Copyright (c) 1999-2000 Veridian Information Solutions, Inc.
+* All rights reserved.
+*
+* ---------------------------------------------------------------------------
+* For a license to use or redistribute the OpenPBS software under conditions
+* other than those described below, or to purchase support for this software,
+* please contact Veridian Systems, PBS Products Department ("Licensor") at:
+*
+*    www.OpenPBS.org  +1 650 967-4675                  sales@OpenPBS.org
+*                        877 902-4PBS (US toll-free)
+* ---------------------------------------------------------------------------
+*
+* This license covers use of the OpenPBS v2.3 software (the "Software") at
+* your site or location, and, for certain users, redistribution of the
+* Software to other sites and locations.  Use and redistribution of
+* OpenPBS v2.3 in source and binary forms, with or without modification,
+* are permitted provided that all of the following conditions are met.
+* After December 31, 2001, only conditions 3-6 must be met:
+*
+* 1. Commercial and/or non-commercial use of the Software is permitted
+*    provided a current software registration is on file at www.OpenPBS.org.
+*    If use of this software contributes to a publication, product, or
+*    service, proper attribution must be given; see www.OpenPBS.org/credit.html
+*
+* 2. Redistribution in any form is only permitted for non-commercial,
+*    non-profit purposes.  There can be no charge for the Software or any
+*    software incorporating the Software.  Further, there can be no
+*    expectation of revenue generated as a consequence of redistributing
+*    the Software.
+*
+* 3. Any Redistribution of source code must retain the above copyright notice
+*    and the acknowledgment contained in paragraph 6, this list of conditions
+*    and the disclaimer contained in paragraph 7.
+*
+* 4. Any Redistribution in binary form must reproduce the above copyright
+*    notice and the acknowledgment contained in paragraph 6, this list of
+*    conditions and the disclaimer contained in paragraph 7 in the
+*    documentation and/or other materials provided with the distribution.
+*
+* 5. Redistributions in any form must be accompanied by information on how to
+*    obtain complete source code for the OpenPBS software and any
+*    modifications and/or additions to the OpenPBS software.  The source code
+*    must either be included in the distribution or be available for no more
+*    than the cost of distribution plus a nominal fee, and all modifications
+*    and additions to the Software must be freely redistributable by any party
+*    (including Licensor) without restriction.
+*
+* 6. All advertising materials mentioning features or use of the Software must
+*    display the following acknowledgment:
+*
+*     "This product includes software developed by NASA Ames Research Center,
+*     Lawrence Livermore National Laboratory, and Veridian Information
+*     Solutions, Inc.
+*     Visit www.OpenPBS.org for OpenPBS software support,
+*     products, and information."
+*
+* 7. DISCLAIMER OF WARRANTY
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND. ANY EXPRESS
+* OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT
+* ARE EXPRESSLY DISCLAIMED.
+*
+* IN NO EVENT SHALL VERIDIAN CORPORATION, ITS AFFILIATED COMPANIES, OR THE
+* U.S. GOVERNMENT OR ANY OF ITS AGENCIES BE LIABLE FOR ANY DIRECT OR INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+* LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+* OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+* LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+* EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+* This license will be governed by the laws of the Commonwealth of Virginia,
+* without reference to its choice of law rules.
+*/
+
+
+#include "node_index.hpp"
+
+
+
+/*
+ * slot_bucket()
+ *
+ * @return the bucket for a node with free_slots execution slots free
+ */
+
+static int slot_bucket(
+
+  int free_slots)
+
+  {
+  int bucket = 0;
+
+  while ((free_slots > 0) &&
+         (bucket < NODE_INDEX_BUCKETS - 1))
+    {
+    free_slots >>= 1;
+    bucket++;
+    }
+
+  return(bucket);
+  } // END slot_bucket()
+
+
+
+/*
+ * get_position()
+ *
+ * @return the bit that stands for name, giving it the next one if it is new.
+ * The caller holds the mutex.
+ */
+
+size_t node_index::get_position(
+
+  const std::string &name)
+
+  {
+  boost::unordered_map<std::string, size_t>::iterator it = this->positions.find(name);
+
+  if (it != this->positions.end())
+    return(it->second);
+
+  size_t pos = this->names.size();
+
+  this->names.push_back(name);
+  this->positions[name] = pos;
+
+  this->available.resize(pos + 1);
+  this->opaque.resize(pos + 1);
+
+  for (int i = 0; i < NODE_INDEX_BUCKETS; i++)
+    this->buckets[i].resize(pos + 1);
+
+  for (std::map<std::string, boost::dynamic_bitset<> >::iterator pit = this->prop_nodes.begin();
+       pit != this->prop_nodes.end();
+       pit++)
+    pit->second.resize(pos + 1);
+
+  return(pos);
+  } // END get_position()
+
+
+
+/*
+ * clear_position()
+ *
+ * forgets everything indexed for the node at pos. The caller holds the mutex.
+ */
+
+void node_index::clear_position(
+
+  size_t pos)
+
+  {
+  this->available.reset(pos);
+  this->opaque.reset(pos);
+
+  for (int i = 0; i < NODE_INDEX_BUCKETS; i++)
+    this->buckets[i].reset(pos);
+
+  for (std::map<std::string, boost::dynamic_bitset<> >::iterator it = this->prop_nodes.begin();
+       it != this->prop_nodes.end();
+       it++)
+    it->second.reset(pos);
+  } // END clear_position()
+
+
+
+/*
+ * update()
+ *
+ * records the current properties, free execution slots and availability of
+ * the node called name, adding it to the index if needed. is_opaque marks
+ * nodes the index can't speak for, such as those with numa boards or alps
+ * subnodes; while any are indexed get_candidates() gives up.
+ */
+
+void node_index::update(
+
+  const std::string              &name,
+  const std::vector<std::string> &props,
+  int                             free_slots,
+  bool                            is_available,
+  bool                            is_opaque)
+
+  {
+  pthread_mutex_lock(&this->mutex);
+
+  size_t pos = this->get_position(name);
+
+  this->clear_position(pos);
+
+  for (size_t i = 0; i < props.size(); i++)
+    {
+    boost::dynamic_bitset<> &nodes = this->prop_nodes[props[i]];
+
+    if (nodes.size() != this->names.size())
+      nodes.resize(this->names.size());
+
+    nodes.set(pos);
+    }
+
+  this->buckets[slot_bucket(free_slots)].set(pos);
+  this->available[pos] = is_available;
+  this->opaque[pos] = is_opaque;
+
+  pthread_mutex_unlock(&this->mutex);
+  } // END update()
+
+
+
+/*
+ * remove()
+ *
+ * drops the node called name from the index. Its bit is never reused, which
+ * keeps the candidates in the order the nodes were added.
+ */
+
+void node_index::remove(
+
+  const std::string &name)
+
+  {
+  pthread_mutex_lock(&this->mutex);
+
+  boost::unordered_map<std::string, size_t>::iterator it = this->positions.find(name);
+
+  if (it != this->positions.end())
+    {
+    this->clear_position(it->second);
+    this->names[it->second].clear();
+    this->positions.erase(it);
+    }
+
+  pthread_mutex_unlock(&this->mutex);
+  } // END remove()
+
+
+
+/*
+ * get_candidates()
+ *
+ * fills candidates with the names of the available nodes that have all of the
+ * properties and might have enough free slots for at least one of reqs, in
+ * the order the nodes were added.
+ *
+ * @return false if the index can't be used for this cluster
+ */
+
+bool node_index::get_candidates(
+
+  const std::vector<node_index_req> &reqs,
+  std::vector<std::string>          &candidates)
+
+  {
+  pthread_mutex_lock(&this->mutex);
+
+  if (this->opaque.any())
+    {
+    pthread_mutex_unlock(&this->mutex);
+    return(false);
+    }
+
+  boost::dynamic_bitset<> found(this->names.size());
+
+  for (size_t r = 0; r < reqs.size(); r++)
+    {
+    boost::dynamic_bitset<> fit(this->names.size());
+
+    // a bucket is a candidate if its largest free slot count fits the req
+    for (int b = 0; b < NODE_INDEX_BUCKETS; b++)
+      {
+      if ((b == NODE_INDEX_BUCKETS - 1) ||
+          (((1L << b) - 1) >= reqs[r].slots))
+        fit |= this->buckets[b];
+      }
+
+    for (size_t p = 0; (p < reqs[r].props.size()) && (fit.any()); p++)
+      {
+      std::map<std::string, boost::dynamic_bitset<> >::iterator it;
+
+      if ((it = this->prop_nodes.find(reqs[r].props[p])) == this->prop_nodes.end())
+        fit.reset();
+      else
+        fit &= it->second;
+      }
+
+    found |= fit;
+    }
+
+  found &= this->available;
+
+  for (size_t pos = found.find_first(); pos != boost::dynamic_bitset<>::npos; pos = found.find_next(pos))
+    candidates.push_back(this->names[pos]);
+
+  pthread_mutex_unlock(&this->mutex);
+
+  return(true);
+  } // END get_candidates()
+
+
+
+size_t node_index::count()
+
+  {
+  pthread_mutex_lock(&this->mutex);
+  size_t total = this->positions.size();
+  pthread_mutex_unlock(&this->mutex);
+
+  return(total);
+  } // END count()
+
+
+
+node_index::node_index()
+
+  {
+  pthread_mutex_init(&this->mutex, NULL);
+  }
+
+
+
+node_index::~node_index()
+
+  {
+  // like id_map, this is only destroyed when the main thread exits and other
+  // threads may still be selecting nodes, so leave everything in place.
+  }
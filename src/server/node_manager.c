@@ -97,6 +97,7 @@
 #include <arpa/inet.h>
 #endif
 #include <vector>
+#include <set>
 
 #include "portability.h"
 #include "libpbs.h"
@@ -134,6 +135,7 @@
 #include "mutex_mgr.hpp"
 #include "timer.hpp"
 #include "id_map.hpp"
+#include "node_index.hpp"
 #ifdef PENABLE_LINUX_CGROUPS
 #include "complete_req.hpp"
 #endif
@@ -156,6 +158,7 @@ int                     gpu_err_reset = FALSE;    /* was a gpu errcount reset re
 /* on server shutdown, (qmgr mods)  */
 
 all_nodes               allnodes;
+node_index              allnodes_index; /* hints for select_from_all_nodes() */
 
 static int              num_addrnote_tasks = 0; /* number of outstanding send_cluster_addrs tasks */
 pthread_mutex_t        *addrnote_mutex = NULL;
@@ -388,6 +391,8 @@ void update_node_state(
     np->nd_state |= INUSE_UNKNOWN;
     }
 
+  node_changed(np);
+
   if ((LOGLEVEL >= 2) && (log_buf[0] != '\0'))
     {
     log_record(PBSEVENT_SCHED, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
@@ -2928,12 +2933,133 @@ int select_nodes_using_hostlist(
 
 
 
+/*
+ * fit_node_to_reqs()
+ *
+ * checks each req of all_reqs that still needs nodes against pnode, which is
+ * locked, and records pnode for the reqs it satisfies
+ */
+
+void fit_node_to_reqs(
+
+  struct pbsnode     *pnode,           /* I */
+  int                &num,             /* M */
+  complete_spec_data *all_reqs,        /* M */
+  node_job_add_info  *naji,            /* O (optional) */
+  int                *eligible_nodes,  /* O */
+  alps_req_data     **ard_array,       /* O (optional) */
+  int                 first_node_id,   /* I */
+  int                 num_alps_reqs,   /* I */
+  enum job_types      job_type,        /* I */
+  char               *ProcBMStr,       /* I (optional) */
+  bool                job_is_exclusive)
+
+  {
+  for (int i = 0; i < all_reqs->num_reqs; i++)
+    {
+    single_spec_data *req = all_reqs->reqs + i;
+
+    if (req->nodes > 0)
+      {
+      if (node_is_spec_acceptable(pnode, req, ProcBMStr, eligible_nodes,job_is_exclusive) == true)
+        {
+        record_fitting_node(num, pnode, naji, req, first_node_id, i, num_alps_reqs, job_type, all_reqs, ard_array);
+
+        /* are all reqs satisfied? */
+        if (all_reqs->total_nodes == 0)
+          break;
+        }
+      }
+    }
+  } /* END fit_node_to_reqs() */
+
+
+
+/*
+ * select_from_indexed_nodes()
+ *
+ * Only visits the nodes that allnodes_index says are available, have the
+ * requested properties and enough free execution slots. Each one is still
+ * checked under its lock, since the index is only a hint.
+ *
+ * @param visited - the nodes that were checked, so they aren't checked again
+ * @return the number of nodes recorded
+ */
+
+int select_from_indexed_nodes(
+
+  complete_spec_data          *all_reqs,        /* I */
+  node_job_add_info           *naji,            /* O (optional) */
+  int                         *eligible_nodes,  /* O */
+  alps_req_data              **ard_array,       /* O (optional) */
+  int                          first_node_id,   /* I */
+  int                          num_alps_reqs,   /* I */
+  enum job_types               job_type,        /* I */
+  char                        *ProcBMStr,       /* I (optional) */
+  bool                         job_is_exclusive,
+  std::set<struct pbsnode *>  &visited)         /* O */
+
+  {
+  std::vector<node_index_req>  index_reqs;
+  std::vector<std::string>     candidates;
+  struct pbsnode              *pnode;
+  int                          num = 0;
+
+  for (int i = 0; i < all_reqs->num_reqs; i++)
+    {
+    single_spec_data *req = all_reqs->reqs + i;
+    node_index_req    ir;
+
+    if (req->nodes <= 0)
+      continue;
+
+    ir.slots = req->ppn;
+
+    for (struct prop *pp = req->prop; pp != NULL; pp = pp->next)
+      {
+      if (pp->mark != 0)
+        ir.props.push_back(pp->name);
+      }
+
+    index_reqs.push_back(ir);
+    }
+
+  if (allnodes_index.get_candidates(index_reqs, candidates) == false)
+    return(0);
+
+  for (unsigned int i = 0; i < candidates.size(); i++)
+    {
+    if ((pnode = find_node_in_allnodes(&allnodes, (char *)candidates[i].c_str())) == NULL)
+      continue;
+
+    visited.insert(pnode);
+
+    fit_node_to_reqs(pnode, num, all_reqs, naji, eligible_nodes, ard_array, first_node_id, num_alps_reqs, job_type, ProcBMStr, job_is_exclusive);
+
+    /* drop a stale hint now that the node itself has been seen */
+    update_node_index(pnode);
+
+    unlock_node(pnode, __func__, NULL, LOGLEVEL);
+
+    /* are all reqs satisfied? */
+    if (all_reqs->total_nodes == 0)
+      break;
+    }
+
+  return(num);
+  } /* END select_from_indexed_nodes() */
+
+
+
 /*
  * select_from_all_nodes()
  *
- * The traditional selecting algorithm. It iterates over every node that exists until finding the
- * node(s) that we are searching for. This is O(N) with respect to the number of nodes in the system
- * as each request is checked against each node at locking time.
+ * The traditional selecting algorithm. The nodes allnodes_index offers as
+ * candidates are tried first; if they don't satisfy the request, it iterates
+ * over every other node that exists until finding the node(s) that we are
+ * searching for. That pass is O(N) with respect to the number of nodes in the
+ * system as each request is checked against each node at locking time, and it
+ * also counts the eligible nodes that are busy right now.
  *
  * @pre-cond: all_reqs, eligible_nodes, and first_node_name must all be valid parameters
  * @post-cond: the nodes in the list are saved in naji to be added for the job later
@@ -2952,32 +3078,37 @@ int select_from_all_nodes(
   bool                job_is_exclusive)
 
   {
-  node_iterator   iter;
-  struct pbsnode *pnode = NULL;
-  int             num = 0;
+  node_iterator               iter;
+  struct pbsnode             *pnode = NULL;
+  int                         num = 0;
+  std::set<struct pbsnode *>  visited;
+
+  /* geometry requests are checked against the node itself */
+  if (!IS_VALID_STR(ProcBMStr))
+    {
+    num = select_from_indexed_nodes(all_reqs, naji, eligible_nodes, ard_array, first_node_id, num_alps_reqs, job_type, ProcBMStr, job_is_exclusive, visited);
+
+    if (all_reqs->total_nodes == 0)
+      return(num);
+    }
   
   reinitialize_node_iterator(&iter);
 
   /* iterate over all nodes */
   while ((pnode = next_node(&allnodes,pnode,&iter)) != NULL)
     {
-    /* check each req against this node to see if it satisfies it */
-    for (int i = 0; i < all_reqs->num_reqs; i++)
-      {
-      single_spec_data *req = all_reqs->reqs + i;
+    /* the indexed pass already checked this one */
+    if (visited.find(pnode) != visited.end())
+      continue;
 
-      if (req->nodes > 0)
-        {
-        if (node_is_spec_acceptable(pnode, req, ProcBMStr, eligible_nodes,job_is_exclusive) == true)
-          {
-          record_fitting_node(num, pnode, naji, req, first_node_id, i, num_alps_reqs, job_type, all_reqs, ard_array);
+    int prev_num = num;
 
-          /* are all reqs satisfied? */
-          if (all_reqs->total_nodes == 0)
-            break;
-          }
-        }
-      }
+    /* check each req against this node to see if it satisfies it */
+    fit_node_to_reqs(pnode, num, all_reqs, naji, eligible_nodes, ard_array, first_node_id, num_alps_reqs, job_type, ProcBMStr, job_is_exclusive);
+
+    /* the index missed a node that fits, so it must be out of date */
+    if (num != prev_num)
+      update_node_index(pnode);
 
     /* are all reqs satisfied? */
     if (all_reqs->total_nodes == 0)
@@ -4302,6 +4433,8 @@ int place_subnodes_in_hostlist(
 
     pnode->nd_np_to_be_used -= naji->ppn_needed;
     naji->ppn_needed = 0;
+
+    node_changed(pnode);
     }
   else
     {
@@ -5452,7 +5585,10 @@ int node_reserve(
 
 
       if (pnode->nd_np_to_be_used == pnode->nd_slots.get_total_execution_slots())
+        {
         pnode->nd_state |= INUSE_RESERVE;
+        node_changed(pnode);
+        }
       } /* END for each node */
     }
   else
@@ -5618,6 +5754,8 @@ int remove_job_from_node(
       }
     }
 
+  node_changed(pnode);
+
 #ifdef PENABLE_LINUX_CGROUPS
   if (pnode->nd_layout != NULL)
     {
@@ -5854,6 +5992,8 @@ int set_one_old(
     if (pnode->nd_slots.get_number_free() <= 0)
       pnode->nd_state |= INUSE_JOB;
 
+    node_changed(pnode);
+
     unlock_node(pnode, __func__, NULL, LOGLEVEL);
     }
   else
@@ -135,6 +135,7 @@
 #include "alps_constants.h"
 #include <string>
 #include <vector>
+#include <libxml/parser.h>
 #include "id_map.hpp"
 #include "exiting_jobs.h"
 #include "mom_hierarchy_handler.h"
@@ -204,8 +205,6 @@ extern char *path_jobinfo_log;
 extern int                      queue_rank;
 extern char                     server_name[];
 extern tlist_head               svr_newnodes;
-extern std::list<timed_task>   *task_list_timed;
-extern pthread_mutex_t          task_list_timed_mutex;
 task_recycler                   tr;
 extern all_jobs                alljobs;
 extern all_jobs                array_summary;
@@ -313,6 +312,28 @@ struct sort_string_by_number
 
 std::map<std::string, job *, sort_string_by_number> JobArray;
 int recovered_job_count; /* Count of recovered jobs */
+pthread_mutex_t recovery_mutex = PTHREAD_MUTEX_INITIALIZER; /* guards the two above */
+
+#define MAX_RECOVERY_THREADS 32
+
+/* a directory of job or array files, read by one scan thread */
+typedef struct recovery_dir
+  {
+  std::string              dir;
+  std::vector<std::string> files;
+  int                      rc;
+  } recovery_dir;
+
+/* files handed out to the threads that recover them */
+typedef struct recovery_batch
+  {
+  std::vector<std::string> *files;
+  size_t                    next;
+  int                       type;
+  int                       rc;
+  int                     (*process)(const char *, int);
+  pthread_mutex_t           mutex;
+  } recovery_batch;
 
 #define CHANGE_STATE 1
 #define KEEP_STATE   0
@@ -969,9 +990,6 @@ int initialize_data_structures_and_mutexes()
 
   initialize_recycler();
 
-  task_list_timed = new std::list<timed_task>();
-  pthread_mutex_init(&task_list_timed_mutex, NULL);
-
   initialize_task_recycler();
 
   CLEAR_HEAD(svr_newnodes);
@@ -1409,88 +1427,280 @@ void mark_as_badjob(
 
 
 
-int handle_array_recovery(
-    
-  int type)
+/*
+ * elapsed_seconds() - time since start, for the recovery phase timings
+ */
+
+double elapsed_seconds(
+
+  struct timeval *start)
 
   {
-  char              log_buf[LOCAL_LOG_BUF_SIZE];
-  struct dirent    *pdirent;
-  struct dirent    *pdirent_sub;
-  DIR              *dir;
-  DIR              *dir_sub;
-  int               rc = PBSE_NONE;
-  int               rc2 = PBSE_NONE;
-  long              use_jobs_subdirs = FALSE;
+  struct timeval now;
 
-  if (chdir(path_arrays) != 0)
-    {
-    sprintf(log_buf, msg_init_chdir, path_arrays);
+  gettimeofday(&now, NULL);
 
-    log_err(errno, __func__, log_buf);
+  return((now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1000000.0);
+  } /* END elapsed_seconds() */
 
-    sprintf(log_buf, "%s:2", __func__);
-    unlock_sv_qs_mutex(server.sv_qs_mutex, log_buf);
 
-    return(-1);
-    }
 
-  if ((dir = opendir(".")) == NULL)
-    return -1;
+/*
+ * get_recovery_threads() - number of threads used to recover count files
+ */
+
+int get_recovery_threads(
 
-  // get the value of use_jobs_subdirs if set
-  get_svr_attr_l(SRV_ATR_use_jobs_subdirs, &use_jobs_subdirs);
+  size_t count)
+
+  {
+  long threads = sysconf(_SC_NPROCESSORS_ONLN) * 2;
+
+  if (threads < 1)
+    threads = 1;
+  else if (threads > MAX_RECOVERY_THREADS)
+    threads = MAX_RECOVERY_THREADS;
+
+  if ((size_t)threads > count)
+    threads = (count > 0) ? count : 1;
+
+  return((int)threads);
+  } /* END get_recovery_threads() */
+
+
+
+/*
+ * scan_recovery_dir() - read the names in one directory. Names are kept
+ * relative to the current directory so no thread needs to chdir().
+ */
+
+void *scan_recovery_dir(
+
+  void *vp)
+
+  {
+  recovery_dir  *rd = (recovery_dir *)vp;
+  DIR           *dir;
+  struct dirent *pdirent;
+
+  rd->rc = PBSE_NONE;
+
+  if ((dir = opendir(rd->dir.c_str())) == NULL)
+    {
+    log_err(errno, __func__, rd->dir.c_str());
+    rd->rc = -1;
+    return(NULL);
+    }
 
   while ((pdirent = readdir(dir)) != NULL)
     {
-    // if we are using divided subdirectories for arrays
-    //   need to move into them
-    if ((use_jobs_subdirs == TRUE) && (strlen(pdirent->d_name) == 1) &&
-        isdigit(pdirent->d_name[0]))
-      {
-      if (chdir(pdirent->d_name) != 0)
-        {
-        rc = -1;
-        break;
-        }
-      if ((dir_sub = opendir(".")) == NULL)
-        {
-        rc = -1;
-        break;
-        }
-      while ((pdirent_sub = readdir(dir_sub)) != NULL)
-        {
-        rc = process_arrays_dirent(pdirent_sub->d_name, type);
-        }
-      closedir(dir_sub);
+    if (!strcmp(pdirent->d_name, ".") ||
+        !strcmp(pdirent->d_name, ".."))
+      continue;
 
-      if (chdir(path_arrays) != 0)
-        {
-        sprintf(log_buf, msg_init_chdir, path_arrays);
+    if (rd->dir == ".")
+      rd->files.push_back(pdirent->d_name);
+    else
+      rd->files.push_back(rd->dir + "/" + pdirent->d_name);
+    }
 
-        log_err(errno, __func__, log_buf);
+  closedir(dir);
 
-        sprintf(log_buf, "%s:2", __func__);
-        unlock_sv_qs_mutex(server.sv_qs_mutex, log_buf);
+  return(NULL);
+  } /* END scan_recovery_dir() */
 
-        closedir(dir);
-        return(-1);
-        }
+
+
+/*
+ * scan_recovery_files() - list the files to recover from the current
+ * directory. With use_jobs_subdirs each numbered subdirectory is read by
+ * its own thread. Returns -1 if the directory cannot be read.
+ */
+
+int scan_recovery_files(
+
+  std::vector<std::string> &files)
+
+  {
+  recovery_dir               top;
+  std::vector<recovery_dir>  subdirs;
+  std::vector<pthread_t>     threads;
+  long                       use_jobs_subdirs = FALSE;
+
+  top.dir = ".";
+  scan_recovery_dir(&top);
+
+  if (top.rc != PBSE_NONE)
+    return(-1);
+
+  get_svr_attr_l(SRV_ATR_use_jobs_subdirs, &use_jobs_subdirs);
+
+  for (size_t i = 0; i < top.files.size(); i++)
+    {
+    if ((use_jobs_subdirs == TRUE) &&
+        (top.files[i].size() == 1) &&
+        (isdigit(top.files[i][0])))
+      {
+      subdirs.push_back(recovery_dir());
+      subdirs.back().dir = top.files[i];
       }
+    else
+      files.push_back(top.files[i]);
+    }
+
+  for (size_t i = 0; i < subdirs.size(); i++)
+    {
+    pthread_t tid;
+
+    if (pthread_create(&tid, NULL, scan_recovery_dir, &subdirs[i]) == 0)
+      threads.push_back(tid);
     else
       {
-      rc = process_arrays_dirent(pdirent->d_name, type);
+      /* subdirectories whose thread did not start are read here */
+      scan_recovery_dir(&subdirs[i]);
       }
-    if (rc != PBSE_NONE)
+    }
+
+  for (size_t i = 0; i < threads.size(); i++)
+    pthread_join(threads[i], NULL);
+
+  for (size_t i = 0; i < subdirs.size(); i++)
+    files.insert(files.end(), subdirs[i].files.begin(), subdirs[i].files.end());
+
+  return(PBSE_NONE);
+  } /* END scan_recovery_files() */
+
+
+
+void *recover_batch_files(
+
+  void *vp)
+
+  {
+  recovery_batch *batch = (recovery_batch *)vp;
+  size_t          index;
+  int             rc;
+
+  while (true)
+    {
+    pthread_mutex_lock(&batch->mutex);
+    index = batch->next++;
+    pthread_mutex_unlock(&batch->mutex);
+
+    if (index >= batch->files->size())
+      break;
+
+    if ((rc = batch->process(batch->files->at(index).c_str(), batch->type)) != PBSE_NONE)
       {
-      rc2 = rc;
+      pthread_mutex_lock(&batch->mutex);
+      batch->rc = rc;
+      pthread_mutex_unlock(&batch->mutex);
       }
     }
 
-  closedir(dir);
+  return(NULL);
+  } /* END recover_batch_files() */
+
+
+
+/*
+ * recover_files_in_parallel() - call process on every file from a pool
+ * of threads. Returns the last error any call returned.
+ */
+
+int recover_files_in_parallel(
+
+  std::vector<std::string> &files,
+  int                       type,
+  int                     (*process)(const char *, int),
+  int                      *thread_count)
+
+  {
+  recovery_batch         batch;
+  std::vector<pthread_t> threads;
+  int                    count = get_recovery_threads(files.size());
+
+  batch.files = &files;
+  batch.next = 0;
+  batch.type = type;
+  batch.rc = PBSE_NONE;
+  batch.process = process;
+  pthread_mutex_init(&batch.mutex, NULL);
+
+  /* libxml2 must be initialized before it is used from several threads */
+  xmlInitParser();
+
+  for (int i = 0; i < count; i++)
+    {
+    pthread_t tid;
+
+    if (pthread_create(&tid, NULL, recover_batch_files, &batch) == 0)
+      threads.push_back(tid);
+    }
+
+  /* if no thread could be started recover everything here */
+  if (threads.size() == 0)
+    recover_batch_files(&batch);
+
+  for (size_t i = 0; i < threads.size(); i++)
+    pthread_join(threads[i], NULL);
+
+  pthread_mutex_destroy(&batch.mutex);
+
+  if (thread_count != NULL)
+    *thread_count = (threads.size() > 0) ? threads.size() : 1;
+
+  return(batch.rc);
+  } /* END recover_files_in_parallel() */
+
+
+
+int recover_job_file(
+
+  const char *filename,
+  int         type)
+
+  {
+  return(process_jobs_dirent(filename));
+  } /* END recover_job_file() */
+
+
+
+int handle_array_recovery(
+    
+  int type)
+
+  {
+  char                      log_buf[LOCAL_LOG_BUF_SIZE];
+  int                       rc = PBSE_NONE;
+  int                       threads = 1;
+  std::vector<std::string>  files;
+  struct timeval            start;
+
+  if (chdir(path_arrays) != 0)
+    {
+    sprintf(log_buf, msg_init_chdir, path_arrays);
+
+    log_err(errno, __func__, log_buf);
+
+    sprintf(log_buf, "%s:2", __func__);
+    unlock_sv_qs_mutex(server.sv_qs_mutex, log_buf);
+
+    return(-1);
+    }
+
+  gettimeofday(&start, NULL);
+
+  if (scan_recovery_files(files) != PBSE_NONE)
+    return(-1);
+
+  rc = recover_files_in_parallel(files, type, process_arrays_dirent, &threads);
+
+  snprintf(log_buf, sizeof(log_buf),
+    "array recovery: read %d files in %.2f seconds using %d threads",
+    (int)files.size(), elapsed_seconds(&start), threads);
+  log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
 
-  if (rc2 != PBSE_NONE)
-    rc = rc2;
   return(rc);
   } /* handle_array_recovery() */
 
@@ -1602,15 +1812,13 @@ int handle_job_recovery(
   int               rc = PBSE_NONE;
   int               job_rc = PBSE_NONE;
   int               logtype;
-  struct dirent    *pdirent;
-  struct dirent    *pdirent_sub;
-  DIR              *dir;
-  DIR              *dir_sub;
   int               had;
+  int               threads = 1;
   job              *pjob;
   time_t            time_now = time(NULL);
   char              basen[MAXPATHLEN+1];
-  long              use_jobs_subdirs = FALSE;
+  std::vector<std::string> files;
+  struct timeval    start;
 
   JobArray.clear();
   recovered_job_count = 0;
@@ -1633,9 +1841,9 @@ int handle_job_recovery(
   sprintf(log_buf, "%s:2", __func__);
   unlock_sv_qs_mutex(server.sv_qs_mutex, log_buf);
 
-  dir = opendir(".");
+  gettimeofday(&start, NULL);
 
-  if (dir == NULL)
+  if (scan_recovery_files(files) != PBSE_NONE)
     {
     if (type != RECOV_CREATE)
       {
@@ -1653,81 +1861,26 @@ int handle_job_recovery(
     }
   else
     {
-    // get the value of use_jobs_subdirs if set
-    get_svr_attr_l(SRV_ATR_use_jobs_subdirs, &use_jobs_subdirs);
-
-    while ((pdirent = readdir(dir)) != NULL)
-      {
-      // if we are using divided subdirectories for jobs
-      //   need to move into them
-      if ((use_jobs_subdirs == TRUE) && (strlen(pdirent->d_name) == 1) &&
-          isdigit(pdirent->d_name[0]))
-        {
-        if (chdir(pdirent->d_name) != 0)
-          {
-          char path_buf[1024];
-
-          snprintf(path_buf, sizeof(path_buf), "%s%s", path_arrays, pdirent->d_name);
-
-          sprintf(log_buf, msg_init_chdir, path_buf);
-
-          log_err(errno, __func__, log_buf);
-
-          sprintf(log_buf, "%s:1", __func__);
-          unlock_sv_qs_mutex(server.sv_qs_mutex, log_buf);
-
-          closedir(dir);
-          return(-1);
-          }
-        dir_sub = opendir(".");
-        if (dir_sub == NULL)
-          {
-          if (type != RECOV_CREATE)
-            {
-            if (had == 0)
-              {
-              log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, msg_daemonname, msg_init_nojobs);
-              }
-            else
-              {
-              sprintf(log_buf, msg_init_exptjobs, had, recovered_job_count);
-
-              log_err(-1, __func__, log_buf);
-              }
-            }
-          }
-        else
-          {
-          while ((pdirent_sub = readdir(dir_sub)) != NULL)
-            {
-            process_jobs_dirent(pdirent_sub->d_name);
-            }
+    snprintf(log_buf, sizeof(log_buf),
+      "job recovery: listed %d files in %.2f seconds",
+      (int)files.size(), elapsed_seconds(&start));
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
 
-          closedir(dir_sub);
+    /* parse the job files in parallel, JobArray keeps them in job id order */
+    gettimeofday(&start, NULL);
 
-          if (chdir(path_jobs) != 0)
-            {
-            sprintf(log_buf, msg_init_chdir, path_jobs);
-        
-            log_err(errno, __func__, log_buf);
-
-            sprintf(log_buf, "%s:1", __func__);
-            unlock_sv_qs_mutex(server.sv_qs_mutex, log_buf);
-
-            closedir(dir);
-            return(-1);
-            }
-          }
-        }
-      else
-        {
-        process_jobs_dirent(pdirent->d_name);
-        }
-      }
+    recover_files_in_parallel(files, type, recover_job_file, &threads);
 
     snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "%d total files read from disk", recovered_job_count);
     log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
-    closedir(dir);
+
+    snprintf(log_buf, sizeof(log_buf),
+      "job recovery: parsed %d jobs in %.2f seconds using %d threads",
+      (int)JobArray.size(), elapsed_seconds(&start), threads);
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
+
+    /* queueing stays serial so queue rank follows job id order */
+    gettimeofday(&start, NULL);
 
     int Index = 0;
     std::map<std::string, job *>::iterator JobArray_iter;
@@ -1805,6 +1958,11 @@ int handle_job_recovery(
         Index = 0;
       }
 
+    snprintf(log_buf, sizeof(log_buf),
+      "job recovery: queued %d jobs in %.2f seconds",
+      (int)JobArray.size(), elapsed_seconds(&start));
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
+
     sprintf(log_buf, "%s:1", __func__);
     lock_sv_qs_mutex(server.sv_qs_mutex, log_buf);
 
@@ -1845,7 +2003,8 @@ int handle_job_recovery(
   } /* END handle_job_recovery() */
 
 /**
- * Process a jobs directory entry
+ * Process a jobs directory entry. Called from several threads at once
+ * during recovery.
  * @param dirent_name - name of the entry
  */
 
@@ -1863,10 +2022,13 @@ int process_jobs_dirent(
   int               job_suf_len = strlen(job_suffix);
   char              basen[MAXPATHLEN+1];
 
-  recovered_job_count++;
-  if ((recovered_job_count % 1000) == 0)
+  pthread_mutex_lock(&recovery_mutex);
+  int count = ++recovered_job_count;
+  pthread_mutex_unlock(&recovery_mutex);
+
+  if ((count % 1000) == 0)
     {
-    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "%d files read from disk", recovered_job_count);
+    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "%d files read from disk", count);
     log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, msg_daemonname, log_buf);
     }
 
@@ -1882,8 +2044,9 @@ int process_jobs_dirent(
         {
         pjob->ji_is_array_template = TRUE;
 
-
+        pthread_mutex_lock(&recovery_mutex);
         JobArray[pjob->ji_qs.ji_jobid] = pjob;
+        pthread_mutex_unlock(&recovery_mutex);
 
         unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
         }
@@ -1896,7 +2059,9 @@ int process_jobs_dirent(
 
     if ((pjob = job_recov(dirent_name)) != NULL)
       {
+      pthread_mutex_lock(&recovery_mutex);
       JobArray[pjob->ji_qs.ji_jobid] = pjob;
+      pthread_mutex_unlock(&recovery_mutex);
 
       unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
       }
@@ -1943,8 +2108,11 @@ int cleanup_recovered_arrays()
       job_template_exists = TRUE;
       }
 
-    /* if no jobs were recovered, delete this array */
-    if (pa->jobs_recovered == 0)
+    /* if no jobs were recovered, delete this array unless it still has
+     * jobs to clone from its template */
+    if ((pa->jobs_recovered == 0) &&
+        ((job_template_exists == FALSE) ||
+         (GET_NEXT(pa->request_tokens) == NULL)))
       {
       if ((pjob = svr_find_job(pa->ai_qs.parent_id, FALSE)) != NULL)
         svr_job_purge(pjob);
@@ -1966,7 +2134,10 @@ int cleanup_recovered_arrays()
       array_save(pa);
       }
 
-    if (pa->ai_qs.num_cloned != pa->ai_qs.num_jobs)
+    /* jobs deleted before they were cloned never will be, so only arrays
+     * with request tokens left are still being built */
+    if ((pa->ai_qs.num_cloned != pa->ai_qs.num_jobs) &&
+        (GET_NEXT(pa->request_tokens) != NULL))
       {
       /* if we can't finish building the job array then delete whats been done
          so far */
@@ -148,6 +148,8 @@
 #include "mom_hierarchy_handler.h"
 #include "track_alps_reservations.h"
 #include "completed_jobs_map.h"
+#include "job_events.h"
+#include "mom_connection_pool.hpp"
 
 
 #define TASK_CHECK_INTERVAL      10
@@ -302,7 +304,6 @@ extern int              listener_command;
 //extern hello_container  failures;
 pthread_mutex_t        *listener_command_mutex;
 tlist_head              svr_newnodes;          /* list of newly created nodes      */
-pthread_mutex_t         task_list_timed_mutex;
 pid_t                   sid;
 
 char                   *plogenv = NULL;
@@ -1318,6 +1319,10 @@ void main_loop(void)
 
   set_task(WORK_Timed,time_now + 10,check_acct_log, (char *)NULL, FALSE);
 
+  set_task(WORK_Timed, time_now + JOB_EVENTS_CHECK_RATE, check_job_subscribers, (char *)NULL, FALSE);
+
+  set_task(WORK_Timed, time_now + MOM_POOL_CHECK_RATE, check_mom_connections, (char *)NULL, FALSE);
+
   /*
    * Now at last, we are ready to do some batch work.  The
    * following section constitutes the "main" loop of the server
@@ -1489,7 +1494,7 @@ void main_loop(void)
 
 
   alljobs.lock();
-  iter = alljobs.get_iterator();
+  iter = alljobs.get_snapshot_iterator();
   alljobs.unlock();
 
   /* save any jobs that need saving */
@@ -1884,6 +1889,10 @@ int main(
   log_open(log_file, path_log);
   pthread_mutex_unlock(&log_mutex);
 
+  /* from here on threads queue log records for a writer thread */
+  if (log_async_start() != PBSE_NONE)
+    log_err(-1, msg_daemonname, "cannot start the log writer thread, logging synchronously");
+
   sprintf(log_buf, msg_startup1, server_name, server_init_type);
 
   log_event(
@@ -1953,6 +1962,8 @@ int main(
 
   acct_close(false);
 
+  log_async_stop();
+
   pthread_mutex_lock(&log_mutex);
   log_close(1);
   pthread_mutex_unlock(&log_mutex);
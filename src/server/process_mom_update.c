@@ -81,6 +81,7 @@
 #include <ctype.h>
 #include <string>
 #include <vector>
+#include <set>
 #include <sstream>
 
 #include "pbs_config.h"
@@ -741,6 +742,191 @@ int save_node_status(
 
 
 
+/*
+ * status_entry_key()
+ *
+ * copies the key of a "key=value" status entry into key. Entries without an '='
+ * are the tail of a comma separated value and leave key alone.
+ */
+
+void status_entry_key(
+
+  const char  *entry,
+  std::string &key)
+
+  {
+  const char *eq = strchr(entry, '=');
+
+  if (eq != NULL)
+    key.assign(entry, eq - entry);
+  } /* END status_entry_key() */
+
+
+
+/*
+ * build_status_arst()
+ *
+ * packs entries into a single newly allocated array_strings, laid out the way
+ * decode_arst() leaves it so free_arst() can release it.
+ *
+ * @return the new array or NULL if out of memory
+ */
+
+struct array_strings *build_status_arst(
+
+  std::vector<const char *> &entries)
+
+  {
+  struct array_strings *arst;
+  size_t                bufsize = 0;
+  int                   count = entries.size();
+  char                 *pos;
+
+  for (unsigned int i = 0; i < entries.size(); i++)
+    bufsize += strlen(entries[i]) + 1;
+
+  if (count < 1)
+    count = 1;
+
+  if ((arst = (struct array_strings *)calloc(1,
+        sizeof(struct array_strings) + (count - 1) * sizeof(char *))) == NULL)
+    return(NULL);
+
+  if ((arst->as_buf = (char *)calloc(1, bufsize + 1)) == NULL)
+    {
+    free(arst);
+    return(NULL);
+    }
+
+  pos = arst->as_buf;
+
+  for (unsigned int i = 0; i < entries.size(); i++)
+    {
+    strcpy(pos, entries[i]);
+    arst->as_string[i] = pos;
+    pos += strlen(entries[i]) + 1;
+    }
+
+  arst->as_npointers = count;
+  arst->as_usedptr = entries.size();
+  arst->as_bufsize = bufsize + 1;
+  arst->as_next = pos;
+
+  return(arst);
+  } /* END build_status_arst() */
+
+
+
+/*
+ * save_node_status_delta()
+ *
+ * stores a delta status update: temp only holds the entries that changed since
+ * the mom's last acknowledged update and unset the keys the mom stopped reporting.
+ * Every other entry of the node's stored status is kept as is, so the unchanged
+ * strings are never sent or decoded again.
+ */
+
+int save_node_status_delta(
+
+  struct pbsnode        *np,
+  pbs_attribute         *temp,
+  std::set<std::string> &unset)
+
+  {
+  int                        rc = PBSE_NONE;
+  std::set<std::string>      replaced(unset);
+  std::vector<const char *>  entries;
+  struct array_strings      *changed = temp->at_val.at_arst;
+  struct array_strings      *stored = np->nd_status;
+  std::string                key;
+  char                       date_attrib[MAXLINE];
+  pbs_attribute              merged;
+
+  if (changed != NULL)
+    {
+    for (int i = 0; i < changed->as_usedptr; i++)
+      {
+      status_entry_key(changed->as_string[i], key);
+      replaced.insert(key);
+      }
+    }
+
+  replaced.insert("rectime");
+
+  if (stored != NULL)
+    {
+    key.clear();
+
+    for (int i = 0; i < stored->as_usedptr; i++)
+      {
+      status_entry_key(stored->as_string[i], key);
+
+      if (replaced.find(key) == replaced.end())
+        entries.push_back(stored->as_string[i]);
+      }
+    }
+
+  if (changed != NULL)
+    {
+    for (int i = 0; i < changed->as_usedptr; i++)
+      entries.push_back(changed->as_string[i]);
+    }
+
+  /* it's nice to know when the last update happened */
+  snprintf(date_attrib, sizeof(date_attrib), "rectime=%ld", (long)time(NULL));
+  entries.push_back(date_attrib);
+
+  memset(&merged, 0, sizeof(merged));
+  merged.at_type = ATR_TYPE_ARST;
+
+  if ((merged.at_val.at_arst = build_status_arst(entries)) == NULL)
+    rc = PBSE_SYSTEM;
+  else
+    {
+    merged.at_flags = ATR_VFLAG_SET;
+
+    /* node_status_list() frees the old status, which entries point into */
+    rc = node_status_list(&merged, np, ATR_ACTION_ALTER);
+    }
+
+  free_arst(temp);
+  unset.clear();
+
+  return(rc);
+  } /* END save_node_status_delta() */
+
+
+
+/*
+ * store_node_status()
+ *
+ * saves the status collected for np, as a delta if the mom marked it as one
+ */
+
+int store_node_status(
+
+  struct pbsnode        *np,
+  pbs_attribute         *temp,
+  bool                  &delta,
+  std::set<std::string> &unset)
+
+  {
+  int rc;
+
+  if (delta == true)
+    rc = save_node_status_delta(np, temp, unset);
+  else
+    rc = save_node_status(np, temp);
+
+  node_changed(np);
+
+  delta = false;
+
+  return(rc);
+  } /* END store_node_status() */
+
+
+
 int process_status_info(
 
   const char               *nd_name,
@@ -756,6 +942,9 @@ int process_status_info(
   pbs_attribute   temp;
   int             rc = PBSE_NONE;
   bool            send_hello = false;
+  bool            delta = false;
+  bool            send_full_status = false;
+  std::set<std::string> unset;
 
   get_svr_attr_l(SRV_ATR_MomJobSync, &mom_job_sync);
   get_svr_attr_l(SRV_ATR_AutoNodeNP, &auto_np);
@@ -797,7 +986,7 @@ int process_status_info(
       {
       /* if we've already processed some, save this before moving on */
       if (i != 0)
-        save_node_status(current, &temp);
+        store_node_status(current, &temp, delta, unset);
       
       dont_change_state = FALSE;
 
@@ -810,7 +999,7 @@ int process_status_info(
       {
       /* if we've already processed some, save this before moving on */
       if (i != 0)
-        save_node_status(current, &temp);
+        store_node_status(current, &temp, delta, unset);
 
       dont_change_state = FALSE;
 
@@ -857,6 +1046,23 @@ int process_status_info(
       continue;
       }
 #endif
+    else if (!strcmp(str, STATUS_DELTA_KEYWORD))
+      {
+      /* only the changes since the last acknowledged update follow */
+      delta = true;
+
+      /* we have nothing to apply them to, ask for the whole status next time */
+      if (current->nd_status == NULL)
+        send_full_status = true;
+
+      continue;
+      }
+    else if (!strncmp(str, STATUS_UNSET_KEYWORD, strlen(STATUS_UNSET_KEYWORD)))
+      {
+      unset.insert(str + strlen(STATUS_UNSET_KEYWORD));
+
+      continue;
+      }
     else if (!strcmp(str, "first_update=true"))
       {
       /* mom is requesting that we send the mom hierarchy file to her */
@@ -946,13 +1152,16 @@ int process_status_info(
 
   if (current != NULL)
     {
-    save_node_status(current, &temp);
+    store_node_status(current, &temp, delta, unset);
     unlock_node(current, __func__, NULL, LOGLEVEL);
     }
   
   if ((rc == PBSE_NONE) &&
       (send_hello == true))
     rc = SEND_HELLO;
+  else if ((rc == PBSE_NONE) &&
+           (send_full_status == true))
+    rc = SEND_FULL_STATUS;
     
   return(rc);
   } /* END process_status_info() */
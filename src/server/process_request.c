@@ -144,6 +144,8 @@
 #include "req_register.h" /* req_register, req_registerarray */
 #include "req_modify_node.h" /* req_modify_node */
 #include "job_func.h" /* svr_job_purge */
+#include "job_events.h" /* req_subscribe */
+#include "client_session.h" /* req_opensession, session_dispatch */
 #include "tcp.h" /* tcp_chan */
 #include "ji_mutex.h"
 #include "mutex_mgr.hpp"
@@ -350,6 +352,7 @@ batch_request *read_request_from_socket(
   unsigned short        conn_authen;
 #endif
   unsigned long         conn_addr;
+  client_session       *cs;
   int                   sfds = chan->sock;
 
   if ((sfds < 0) ||
@@ -364,6 +367,7 @@ batch_request *read_request_from_socket(
 #endif
   conn_addr = svr_conn[sfds].cn_addr;
   svr_conn[sfds].cn_lasttime = time_now;
+  cs = svr_conn[sfds].cn_session;
   pthread_mutex_unlock(svr_conn[sfds].cn_mutex);
 
   if ((request = alloc_br(0)) == NULL)
@@ -371,6 +375,28 @@ batch_request *read_request_from_socket(
 
   request->rq_conn = sfds;
 
+  if (cs != NULL)
+    {
+    /* a session's requests start with their tag, then the protocol type */
+    chan->encoding = DIS_ENCODING_CLASSIC;
+
+    request->rq_tag = disrui(chan, &rc);
+
+    if ((rc == DIS_SUCCESS) &&
+        (disrui(chan, &rc) != PBS_BATCH_PROT_TYPE) &&
+        (rc == DIS_SUCCESS))
+      rc = DIS_PROTO;
+
+    if (rc != DIS_SUCCESS)
+      {
+      request->rq_type = PBS_BATCH_Disconnect;
+      return(request);
+      }
+
+    session_hold(cs);
+    request->rq_session = cs;
+    }
+
   /*
    * Read in the request and decode it to the internal request structure.
    */
@@ -389,10 +415,12 @@ batch_request *read_request_from_socket(
 #endif /* END ENABLE_UNIX_SOCKETS */
     rc = dis_request_read(chan, request);
 
-    if ((rc == PBSE_SYSTEM) || (rc == PBSE_INTERNAL) || (rc == PBSE_SOCKET_CLOSE))
+    if ((rc == PBSE_SYSTEM) || (rc == PBSE_INTERNAL) || (rc == PBSE_SOCKET_CLOSE) ||
+        ((rc > 0) && (cs != NULL)))
       {
       /* read error, likely cannot send reply so just disconnect, indicate permanent
-       * failure by setting the type to PBS_BATCH_Disconnect */
+       * failure by setting the type to PBS_BATCH_Disconnect. A session can't
+       * skip a request it couldn't read either, the next one follows it */
       request->rq_type = PBS_BATCH_Disconnect;
       return(request);
       }
@@ -407,6 +435,10 @@ batch_request *read_request_from_socket(
       request->rq_failcode = rc;
       return(request);
       }
+
+    /* a streamed reply would interleave with the session's other replies */
+    if (cs != NULL)
+      request->rq_extflags &= ~REQ_EXTEND_STREAM;
     }
   else
     {
@@ -525,6 +557,16 @@ int process_request(
     return(rc);
     }
 
+  if ((request->rq_session != NULL) &&
+      ((request->rq_type == PBS_BATCH_Connect) ||
+       (request->rq_type == PBS_BATCH_OpenSession) ||
+       (request->rq_type == PBS_BATCH_SubscribeJobs)))
+    {
+    /* these change what the connection carries, a session's can't change */
+    req_reject(PBSE_IVALREQ, 0, request, NULL, NULL);
+    return(PBSE_IVALREQ);
+    }
+
   /*
    * determine source (user client or another server) of request.
    * set the permissions granted to the client
@@ -680,7 +722,10 @@ int process_request(
       case PBS_BATCH_MoveJob:
       case PBS_BATCH_QueueJob:
       case PBS_BATCH_RunJob:
+      case PBS_BATCH_RunJobs:
       case PBS_BATCH_StageIn:
+      case PBS_BATCH_SubmitJob:
+      case PBS_BATCH_SubmitMany:
       case PBS_BATCH_jobscript:
 
         req_reject(PBSE_SVRDOWN, 0, request, NULL, NULL);
@@ -695,6 +740,10 @@ int process_request(
    * the request struture.
    */
 
+  if ((request->rq_session != NULL) &&
+      (session_dispatch(request) == true))
+    return(PBSE_NONE);
+
   rc = dispatch_request(sfds, request);
 
   return(rc);
@@ -738,6 +787,20 @@ int dispatch_request(
       break;
 
 
+    case PBS_BATCH_SubmitJob:
+
+      rc = req_submitjob(request);
+
+      break;
+
+
+    case PBS_BATCH_SubmitMany:
+
+      rc = req_submitmany(request);
+
+      break;
+
+
     case PBS_BATCH_JobCred:
       rc = req_jobcredential(request);
       break;
@@ -834,6 +897,18 @@ int dispatch_request(
 
       break;
 
+    case PBS_BATCH_SubscribeJobs:
+
+      rc = req_subscribe(request);
+
+      break;
+
+    case PBS_BATCH_OpenSession:
+
+      rc = req_opensession(request);
+
+      break;
+
     case PBS_BATCH_MoveJob:
 
       rc = req_movejob(request);
@@ -881,6 +956,13 @@ int dispatch_request(
 
       break;
 
+    case PBS_BATCH_RunJobs:
+
+      globalset_del_sock(request->rq_conn);
+      rc = req_runjobs(request);
+
+      break;
+
     case PBS_BATCH_SelectJobs:
 
     case PBS_BATCH_SelStat:
@@ -1130,6 +1212,12 @@ void free_br(
 
   reply_free(&preq->rq_reply);
 
+  if (preq->rq_session != NULL)
+    {
+    session_release(preq->rq_session);
+    preq->rq_session = NULL;
+    }
+
   if (preq->rq_extend) 
     {
     free(preq->rq_extend);
@@ -1150,6 +1238,36 @@ void free_br(
 
       break;
 
+    case PBS_BATCH_SubmitJob:
+
+      free_attrlist(&preq->rq_ind.rq_submitjob.rq_queuejob.rq_attr);
+
+      if (preq->rq_ind.rq_submitjob.rq_script)
+        {
+        free(preq->rq_ind.rq_submitjob.rq_script);
+        preq->rq_ind.rq_submitjob.rq_script = NULL;
+        }
+
+      break;
+
+    case PBS_BATCH_SubmitMany:
+
+      if (preq->rq_ind.rq_submitmany.rq_jobs != NULL)
+        {
+        for (int i = 0; i < preq->rq_ind.rq_submitmany.rq_count; i++)
+          {
+          free_attrlist(&preq->rq_ind.rq_submitmany.rq_jobs[i].rq_queuejob.rq_attr);
+
+          if (preq->rq_ind.rq_submitmany.rq_jobs[i].rq_script)
+            free(preq->rq_ind.rq_submitmany.rq_jobs[i].rq_script);
+          }
+
+        free(preq->rq_ind.rq_submitmany.rq_jobs);
+        preq->rq_ind.rq_submitmany.rq_jobs = NULL;
+        }
+
+      break;
+
     case PBS_BATCH_JobCred:
 
       if (preq->rq_ind.rq_jobcred.rq_data)
@@ -1274,6 +1392,22 @@ void free_br(
         }
       break;
 
+    case PBS_BATCH_RunJobs:
+
+      if (preq->rq_ind.rq_runjobs.rq_jobs != NULL)
+        {
+        for (int i = 0; i < preq->rq_ind.rq_runjobs.rq_count; i++)
+          {
+          if (preq->rq_ind.rq_runjobs.rq_jobs[i].rq_destin)
+            free(preq->rq_ind.rq_runjobs.rq_jobs[i].rq_destin);
+          }
+
+        free(preq->rq_ind.rq_runjobs.rq_jobs);
+        preq->rq_ind.rq_runjobs.rq_jobs = NULL;
+        }
+
+      break;
+
     default:
 
       /* NO-OP */
@@ -116,6 +116,7 @@
 #include "svr_func.h" /* get_svr_attr_* */
 #include "ji_mutex.h"
 #include "mutex_mgr.hpp"
+#include "change_log.hpp"
 
 
 #define MSG_LEN_LONG 160
@@ -232,6 +233,7 @@ pbs_queue *que_alloc(
     }
 
   pq->qu_qs.qu_type = QTYPE_Unset;
+  pq->qu_change_seq = server_changes.next();
 
   pq->qu_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
   pq->qu_jobs = new all_jobs();
@@ -322,6 +324,7 @@ void que_free(
   delete pq->qu_uih;
 
   remove_queue(&svr_queues, pq);
+  server_changes.record_deletion(MGR_OBJ_QUEUE, pq->qu_qs.qu_name, NULL);
   pq->q_being_recycled = TRUE;
   insert_into_queue_recycler(pq);
   return;
@@ -110,6 +110,7 @@
 #include "utils.h"
 #include <pthread.h>
 #include "queue_func.h" /* que_alloc, que_free */
+#include "change_log.hpp"
 
 /* data global to this file */
 
@@ -142,6 +143,7 @@ int que_save(
 
   pque->qu_attr[QA_ATR_MTime].at_val.at_long = time(NULL);
   pque->qu_attr[QA_ATR_MTime].at_flags = ATR_VFLAG_SET;
+  pque->qu_change_seq = server_changes.next();
 
   snprintf(namebuf1,sizeof(namebuf1),
     "%s%s",
@@ -520,6 +520,12 @@ void *svr_is_request(
           hierarchy_handler.sendHierarchyToANode(node);
           ret = DIS_SUCCESS;
           }
+        else if (ret == SEND_FULL_STATUS)
+          {
+          /* the delta was applied, but the mom must refresh the whole status */
+          write_tcp_reply(chan, IS_PROTOCOL, IS_PROTOCOL_VER, IS_STATUS, SEND_FULL_STATUS);
+          ret = DIS_SUCCESS;
+          }
         else
           write_tcp_reply(chan,IS_PROTOCOL,IS_PROTOCOL_VER,IS_STATUS,ret);
         }
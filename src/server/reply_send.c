@@ -9,6 +9,8 @@
  * reply_text()  - send a return with a supplied text string
  * reply_jobid() - used by several requests where the job id must be sent
  * reply_free()  - free the substructure that might hang from a reply
+ * reply_stream_start(), reply_stream_status(), reply_stream_end()
+ *               - send a status reply a few objects at a time
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -32,6 +34,9 @@
 #include "work_task.h"
 #include "utils.h"
 #include "tcp.h" /* tcp_chan */
+#ifndef PBS_MOM
+#include "client_session.h" /* session_reply_write */
+#endif
 
 
 
@@ -41,6 +46,9 @@ extern char *msg_daemonname;
 
 #define ERR_MSG_SIZE 127
 
+/* a streamed status reply is flushed once this much is buffered */
+#define STATUS_STREAM_FLUSH_SIZE 65536
+
 
 static void set_err_msg(
 
@@ -86,13 +94,46 @@ static void set_err_msg(
 
 
 
+/*
+ * free_status_list - free the status objects of a status reply and leave
+ * the list empty
+ */
+
+static void free_status_list(
+
+  tlist_head *status)
+
+  {
+  struct brp_status  *pstat;
+  struct brp_status  *pstatx;
+
+  pstat = (struct brp_status *)GET_NEXT(*status);
+
+  while (pstat)
+    {
+    pstatx = (struct brp_status *)GET_NEXT(pstat->brp_stlink);
+    free_attrlist(&pstat->brp_attr);
+
+    if (pstat->brp_encoded != NULL)
+      free(pstat->brp_encoded);
+
+    (void)free(pstat);
+    pstat = pstatx;
+    }
+
+  CLEAR_HEAD((*status));
+  }  /* END free_status_list() */
+
+
+
 
 
 
 static int dis_reply_write(
 
-  int                 sfds,    /* I */
-  struct batch_reply *preply)  /* I */
+  int                 sfds,     /* I */
+  struct batch_reply *preply,   /* I */
+  int                 encoding) /* I - DIS_ENCODING_* */
 
   {
   int              rc = PBSE_NONE;
@@ -102,11 +143,14 @@ static int dis_reply_write(
   /* setup for DIS over tcp */
   if ((chan = DIS_tcp_setup(sfds)) == NULL)
     {
+    return(rc);
     }
 
+  chan->encoding = encoding;
+
   /* send message to remote client */
-  else if ((rc = encode_DIS_reply(chan, preply)) ||
-           (rc = DIS_tcp_wflush(chan)))
+  if ((rc = encode_DIS_reply(chan, preply)) ||
+      (rc = DIS_tcp_wflush(chan)))
     {
     sprintf(log_buf, "DIS reply failure, %d", rc);
 
@@ -116,8 +160,7 @@ static int dis_reply_write(
     close_conn(sfds, FALSE);
     }
 
-  if (chan != NULL)
-    DIS_tcp_cleanup(chan);
+  DIS_tcp_cleanup(chan);
 
   return(rc);
   }  /* END dis_reply_write() */
@@ -171,7 +214,12 @@ int reply_send_svr(
 
     if (request->rq_noreply != TRUE)
       {
-      rc = dis_reply_write(sfds, &request->rq_reply);
+      /* a request relayed to a mom is replied to on that mom's socket */
+      if ((request->rq_session != NULL) &&
+          (request->rq_session->cs_sock == sfds))
+        rc = session_reply_write(request);
+      else
+        rc = dis_reply_write(sfds, &request->rq_reply, request->rq_encoding);
 
       if (LOGLEVEL >= 7)
         {
@@ -184,6 +232,11 @@ int reply_send_svr(
       }
     }
 
+  /* let whoever dropped the reply know how the request went */
+  if ((request->rq_noreply == TRUE) &&
+      (request->rq_result != NULL))
+    *request->rq_result = request->rq_reply.brp_code;
+
   if (((request->rq_type != PBS_BATCH_AsyModifyJob) && 
        (request->rq_type != PBS_BATCH_AsyrunJob) &&
        (request->rq_type != PBS_BATCH_AsySignalJob)) ||
@@ -194,6 +247,123 @@ int reply_send_svr(
 
   return(rc);
   }  /* END reply_send_svr() */
+
+
+
+/*
+ * reply_stream_start - start a streamed status reply
+ *
+ * If the client asked for it, the status objects of a large status reply
+ * can be sent as they are built instead of all at once at the end:
+ * reply_stream_start() sends the reply header, reply_stream_status() sends
+ * and frees the objects gathered in the request's reply so far, and
+ * reply_stream_end() sends the final code and frees the request.
+ *
+ * @return the channel to stream the reply on, or NULL if the reply must
+ * be sent the usual way
+ */
+
+struct tcp_chan *reply_stream_start(
+
+  struct batch_request *preq)  /* I */
+
+  {
+  struct tcp_chan    *chan;
+  struct batch_reply  header;
+  int                 sfds = preq->rq_conn;
+
+  if (((preq->rq_extflags & REQ_EXTEND_STREAM) == 0) ||
+      (sfds < 0) ||
+      (sfds == PBS_LOCAL_CONNECTION) ||
+      (preq->rq_noreply == TRUE))
+    return(NULL);
+
+  if ((chan = DIS_tcp_setup(sfds)) == NULL)
+    return(NULL);
+
+  memset(&header, 0, sizeof(header));
+  header.brp_code   = PBSE_NONE;
+  header.brp_choice = BATCH_REPLY_CHOICE_StatusStream;
+
+  chan->encoding = preq->rq_encoding;
+
+  /* nothing has been written to the socket yet if this fails */
+  if (encode_DIS_reply(chan, &header) != DIS_SUCCESS)
+    {
+    DIS_tcp_cleanup(chan);
+    return(NULL);
+    }
+
+  return(chan);
+  }  /* END reply_stream_start() */
+
+
+
+/*
+ * reply_stream_status - send the status objects gathered in the request's
+ * reply since the last call and free them
+ *
+ * The channel is flushed once STATUS_STREAM_FLUSH_SIZE bytes are buffered,
+ * which bounds what a large reply holds in memory.
+ */
+
+int reply_stream_status(
+
+  struct tcp_chan      *chan,  /* I */
+  struct batch_request *preq)  /* I */
+
+  {
+  int rc;
+
+  rc = encode_DIS_status_stream(chan, &preq->rq_reply.brp_un.brp_status);
+
+  free_status_list(&preq->rq_reply.brp_un.brp_status);
+
+  if ((rc == DIS_SUCCESS) &&
+      (DIS_tcp_wpending(chan) >= STATUS_STREAM_FLUSH_SIZE))
+    rc = DIS_tcp_wflush(chan);
+
+  return(rc);
+  }  /* END reply_stream_status() */
+
+
+
+/*
+ * reply_stream_end - finish a streamed status reply with its final code,
+ * the request is freed
+ *
+ * Objects already sent can't be taken back, so an error found part way
+ * through is sent as the final code and the client drops what it read.
+ */
+
+int reply_stream_end(
+
+  struct tcp_chan      *chan,    /* I (freed) */
+  struct batch_request *preq,    /* I (freed) */
+  int                   code,    /* I */
+  int                   auxcode) /* I */
+
+  {
+  int  rc;
+  char log_buf[LOCAL_LOG_BUF_SIZE];
+
+  if ((rc = encode_DIS_status_stream(chan, &preq->rq_reply.brp_un.brp_status)) ||
+      (rc = encode_DIS_status_stream_end(chan, code, auxcode)) ||
+      (rc = DIS_tcp_wflush(chan)))
+    {
+    sprintf(log_buf, "DIS reply failure, %d", rc);
+
+    log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_REQUEST, __func__, log_buf);
+
+    close_conn(preq->rq_conn, FALSE);
+    }
+
+  DIS_tcp_cleanup(chan);
+
+  free_br(preq);
+
+  return(rc);
+  }  /* END reply_stream_end() */
 #endif /* PBS_MOM */
 
 
@@ -216,7 +386,7 @@ int reply_send_mom(
   else if (sfds >= 0)
     {
     /* Otherwise, the reply is to be sent to a remote client */
-    rc = dis_reply_write(sfds, &request->rq_reply);
+    rc = dis_reply_write(sfds, &request->rq_reply, request->rq_encoding);
     }
   free_br(request);
   return(rc);
@@ -255,10 +425,6 @@ void reply_free(
 
   {
 
-  struct brp_status  *pstat;
-
-  struct brp_status  *pstatx;
-
   struct brp_select  *psel;
 
   struct brp_select  *pselx;
@@ -287,15 +453,7 @@ void reply_free(
     }
   else if (prep->brp_choice == BATCH_REPLY_CHOICE_Status)
     {
-    pstat = (struct brp_status *)GET_NEXT(prep->brp_un.brp_status);
-
-    while (pstat)
-      {
-      pstatx = (struct brp_status *)GET_NEXT(pstat->brp_stlink);
-      free_attrlist(&pstat->brp_attr);
-      (void)free(pstat);
-      pstat = pstatx;
-      }
+    free_status_list(&prep->brp_un.brp_status);
     }
   else if (prep->brp_choice == BATCH_REPLY_CHOICE_RescQuery)
     {
@@ -5,6 +5,7 @@
 #include "batch_request.h" /* batch_request */
 #include "libpbs.h" /* batch_reply */
 #include "attribute.h" /* svrattrl */
+#include "tcp.h" /* tcp_chan */
 
 /* static void set_err_msg(int code, char *msgbuf); */
 
@@ -14,6 +15,10 @@ int reply_send(struct batch_request *request);
 int reply_send_svr(struct batch_request *request);
 int reply_send_mom(struct batch_request *request);
 
+struct tcp_chan *reply_stream_start(struct batch_request *preq);
+int reply_stream_status(struct tcp_chan *chan, struct batch_request *preq);
+int reply_stream_end(struct tcp_chan *chan, struct batch_request *preq, int code, int auxcode);
+
 void reply_ack(struct batch_request *preq);
 
 void reply_free(struct batch_reply *prep);
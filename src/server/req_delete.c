@@ -117,6 +117,7 @@
 #include "mutex_mgr.hpp"
 #include "threadpool.h"
 #include "req_delete.h"
+#include "client_session.h" /* session_hold */
 #include "delete_all_tracker.hpp"
 #include <string>
 
@@ -172,6 +173,7 @@ void chk_job_req_permissions(job **,struct batch_request *);
 void          on_job_exit_task(struct work_task *);
 void           remove_stagein(job **pjob_ptr);
 extern void removeBeforeAnyDependencies(const char *pJobID);
+extern int  svr_authorize_req(struct batch_request *preq, char *owner, char *submit_host);
 
 
 
@@ -948,6 +950,14 @@ batch_request *duplicate_request(
 
       break;
     }
+
+  /* the reply to the copy goes back the same way */
+  if (preq->rq_session != NULL)
+    {
+    session_hold(preq->rq_session);
+    preq_tmp->rq_session = preq->rq_session;
+    preq_tmp->rq_tag = preq->rq_tag;
+    }
   
   return(preq_tmp);
   } /* END duplicate_request() */
@@ -977,7 +987,7 @@ void *delete_all_work(
   char          *Msg = preq->rq_extend;
   
   alljobs.lock();
-  iter = alljobs.get_iterator();
+  iter = alljobs.get_snapshot_iterator();
   alljobs.unlock();
   while ((pjob = next_job(&alljobs, iter)) != NULL)
     {
@@ -1130,6 +1140,56 @@ void *single_delete_work(
   } /* END single_delete_work() */
 
 
+/*
+ * delete_uncloned_subjob()
+ *
+ * deletes an array job that hasn't been cloned yet by taking its index out
+ * of the array's request tokens
+ *
+ * @return PBSE_NONE if it was deleted, PBSE_UNKJOBID if jobid isn't an array
+ * job waiting to be cloned, PBSE_PERM if the user may not delete it
+ */
+
+int delete_uncloned_subjob(
+
+  batch_request *preq,
+  const char    *jobid)
+
+  {
+  job_array *pa;
+  char       parent_id[PBS_MAXSVRJOBID + 1];
+  char       owner[PBS_MAXUSER + 1];
+  int        index;
+
+  if ((strlen(jobid) > PBS_MAXSVRJOBID) ||
+      ((index = get_subjob_index(jobid, parent_id)) < 0) ||
+      ((pa = get_array(parent_id)) == NULL))
+    return(PBSE_UNKJOBID);
+
+  mutex_mgr pa_mutex(pa->ai_mutex, true);
+
+  if (is_uncloned_index(pa, index) == false)
+    return(PBSE_UNKJOBID);
+
+  get_jobowner(pa->ai_qs.owner, owner);
+
+  if (svr_authorize_req(preq, owner, pa->ai_qs.submit_host) == -1)
+    return(PBSE_PERM);
+
+  purge_uncloned_subjobs(pa, remove_uncloned_range(pa, index, index));
+
+  if (pa->ai_qs.num_purged >= pa->ai_qs.num_jobs)
+    {
+    /* array_delete() unlocks and frees the mutex */
+    array_delete(pa);
+    pa_mutex.set_unlock_on_exit(false);
+    }
+
+  return(PBSE_NONE);
+  } /* END delete_uncloned_subjob() */
+
+
+
 int handle_single_delete(
 
   batch_request *preq,
@@ -1139,12 +1199,24 @@ int handle_single_delete(
   {
   char *jobid = preq->rq_ind.rq_delete.rq_objname;
   job  *pjob = svr_find_job(jobid, FALSE);
+  int   rc;
 
   if (pjob == NULL)
     {
-    log_event(PBSEVENT_DEBUG,PBS_EVENTCLASS_JOB,jobid,pbse_to_txt(PBSE_UNKJOBID));
-    
-    req_reject(PBSE_UNKJOBID, 0, preq, NULL, "cannot locate job");
+    if ((rc = delete_uncloned_subjob(preq, jobid)) == PBSE_NONE)
+      {
+      /* nothing to wait for, so no need for the asynchronous reply */
+      if (preq_tmp != NULL)
+        free_br(preq_tmp);
+
+      reply_ack(preq);
+      }
+    else
+      {
+      log_event(PBSEVENT_DEBUG,PBS_EVENTCLASS_JOB,jobid,pbse_to_txt(rc));
+
+      req_reject(rc, 0, preq, NULL, (rc == PBSE_PERM) ? NULL : "cannot locate job");
+      }
     }
   else
     {
@@ -1825,7 +1897,7 @@ void purge_completed_jobs(
   reply_ack(preq);
 
   alljobs.lock();
-  iter = alljobs.get_iterator();
+  iter = alljobs.get_snapshot_iterator();
   alljobs.unlock();
 
   while ((pjob = next_job(&alljobs,iter)) != NULL)
@@ -1852,6 +1924,7 @@ void purge_completed_jobs(
     unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
     }
 
+  delete iter;
 
   return;
   } /* END purge_completed_jobs() */
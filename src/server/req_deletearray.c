@@ -216,8 +216,18 @@ int req_deletearray(
       log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, __func__, log_buf);
       }
 
-    if ((num_skipped = delete_whole_array(pa)) == NO_JOBS_IN_ARRAY)
-      array_delete(pa);
+    num_skipped = delete_whole_array(pa);
+    }
+
+  /* jobs that were never cloned are purged right away, that may have been
+   * all that was left of the array */
+  if ((num_skipped == NO_JOBS_IN_ARRAY) ||
+      (pa->ai_qs.num_purged >= pa->ai_qs.num_jobs))
+    {
+    /* array_delete() unlocks and frees the mutex */
+    array_delete(pa);
+    pa_mutex.set_unlock_on_exit(false);
+    num_skipped = NO_JOBS_IN_ARRAY;
     }
 
   if (num_skipped != NO_JOBS_IN_ARRAY)
@@ -149,7 +149,9 @@ int req_holdarray(
     }
   else
     {
-    /* do the entire array */
+    /* do the entire array, including the jobs that aren't cloned yet */
+    hold_array_template(pa, &temphold, INCR);
+
     for (i = 0;i < pa->ai_qs.array_size;i++)
       {
       if (pa->job_ids[i] == NULL)
@@ -509,9 +509,20 @@ int release_whole_array(
   struct batch_request *preq) /* I */
 
   {
-  int  i;
-  int  rc;
-  job *pjob;
+  int            i;
+  int            rc;
+  job           *pjob;
+  char          *pset;
+  pbs_attribute  temphold;
+
+  /* the jobs that aren't cloned yet get their holds from the template */
+  if ((rc = get_hold(&preq->rq_ind.rq_hold.rq_orig.rq_attr, (const char **)&pset, &temphold)) != 0)
+    return(rc);
+
+  if ((rc = chk_hold_priv(temphold.at_val.at_long, preq->rq_perm)) != 0)
+    return(rc);
+
+  hold_array_template(pa, &temphold, DECR);
 
   for (i = 0; i < pa->ai_qs.array_size; i++)
     {
@@ -563,7 +574,14 @@ int req_releasearray(
     if (((index = first_job_index(pa)) == -1) ||
         (pa->job_ids[index] == NULL))
       {
-      return(PBSE_NONE);
+      /* none of the jobs have been cloned yet, check against the template */
+      if ((pjob = svr_find_job(pa->ai_qs.parent_id, FALSE)) == NULL)
+        {
+        req_reject(PBSE_IVALREQ,0,preq,NULL,"Cannot find array");
+        return(PBSE_NONE);
+        }
+
+      break;
       }
 
     if ((pjob = svr_find_job(pa->job_ids[index], FALSE)) == NULL)
@@ -945,6 +945,8 @@ int mgr_set_node_attr(
 
   update_subnode(pnode);
 
+  node_changed(pnode);
+
   return(rc);
   }  /* END mgr_set_node_attr() */
 
@@ -114,6 +114,7 @@
 #include "threadpool.h"
 #include "mutex_mgr.hpp"
 #include <string>
+#include "change_log.hpp"
 
 #define CHK_HOLD 1
 #define CHK_CONT 2
@@ -1304,6 +1305,7 @@ int modify_job_attr(
   /* note, the newattr[] attributes are on the stack, they go away automatically */
 
   pjob->ji_modified = 1;
+  pjob->ji_change_seq = server_changes.next();
 
   return(PBSE_NONE);
   }  /* END modify_job_attr() */
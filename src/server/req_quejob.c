@@ -1344,19 +1344,21 @@ int check_attribute_settings(
 
 
 /*
- * req_quejob - Queue Job Batch Request processing routine
+ * queue_new_job - create the job described by a Queue Job or Submit Job
+ * request and link it into the server's new jobs list
  *  NOTE:  calls svr_chkque() to validate queue access
  *
+ * @return the job, locked, or NULL if the request was rejected (rc is set)
  */
 
-int req_quejob(
+static job *queue_new_job(
 
-  batch_request *preq)
+  batch_request *preq,
+  int           &rc)
 
   {
   int                   created_here = 0;
   int                   sock = preq->rq_conn;
-  int                   rc = PBSE_NONE;
   /* set basic (user) level access permission */
   int                   resc_access_perm = ATR_DFLAG_USWR | ATR_DFLAG_Creat;
 
@@ -1371,13 +1373,14 @@ int req_quejob(
   
 
   if ((rc = get_job_id(preq, resc_access_perm, created_here, jobid)) != PBSE_NONE)
-    return(rc);
+    return(NULL);
 
   if (job_exists(jobid.c_str()) == true)
     {
     log_err(PBSE_JOBEXIST, __func__, "cannot queue new job, job already exists");
     req_reject(PBSE_JOBEXIST, 0, preq, NULL, NULL);
-    return(PBSE_JOBEXIST);
+    rc = PBSE_JOBEXIST;
+    return(NULL);
     }
 
   pque = get_queue_for_job(preq->rq_ind.rq_queuejob.rq_destin, rc);
@@ -1389,7 +1392,7 @@ int req_quejob(
     snprintf(log_buf, sizeof(log_buf), "requested queue not found");
     log_err(-1, __func__, log_buf);
     req_reject(rc, 0, preq, NULL, log_buf); /* not there   */
-    return rc;
+    return(NULL);
     }
 
   mutex_mgr que_mgr(pque->qu_mutex, true);
@@ -1402,14 +1405,15 @@ int req_quejob(
 
   if ((rc = determine_job_file_name(preq, jobid, filename)) != PBSE_NONE)
     {
-    return(rc);
+    return(NULL);
     }
 
   if ((pj = create_and_initialize_job_structure(created_here, filename, jobid)) == NULL)
     {
     unlink(filename.c_str());
     req_reject(PBSE_SYSTEM, 0, preq, NULL, "");
-    return(PBSE_MEM_MALLOC);
+    rc = PBSE_MEM_MALLOC;
+    return(NULL);
     }
 
   mutex_mgr job_mutex(pj->ji_mutex, true);
@@ -1417,7 +1421,7 @@ int req_quejob(
   rc = decode_attributes_into_job(pj, resc_access_perm, preq, job_mutex, pque, cpuClock);
 
   if (rc != PBSE_NONE)
-    return(rc);
+    return(NULL);
 
   rc = set_nodes_attr(pj);
   if (rc)
@@ -1432,7 +1436,7 @@ int req_quejob(
   if ((rc = perform_attribute_post_actions(pj, preq, job_mutex)) != PBSE_NONE)
     {
     job_mutex.set_unlock_on_exit(false);
-    return(rc);
+    return(NULL);
     }
 
   sum_select_mem_request(pj);
@@ -1441,7 +1445,7 @@ int req_quejob(
   if (rc != PBSE_NONE)
     {
     job_mutex.set_unlock_on_exit(false);
-    return(rc);
+    return(NULL);
     }
 
   /* make sure its okay to submit this job */
@@ -1460,7 +1464,8 @@ int req_quejob(
 
     req_reject(PBSE_MAXQUED, 0, preq, NULL, log_buf);
     
-    return(PBSE_MAXQUED);
+    rc = PBSE_MAXQUED;
+    return(NULL);
     }
 
   /*
@@ -1506,7 +1511,7 @@ int req_quejob(
     svr_job_purge(pj);
     job_mutex.set_unlock_on_exit(false);
     req_reject(rc, 0, preq, NULL, EMsg);
-    return(rc);
+    return(NULL);
     }
   que_mgr.unlock();
 
@@ -1540,6 +1545,32 @@ int req_quejob(
   /* link job into server's new jobs list request  */
   insert_job(&newjobs,pj);
 
+  job_mutex.set_unlock_on_exit(false);
+
+  return(pj);
+  }  /* END queue_new_job() */
+
+
+
+
+/*
+ * req_quejob - Queue Job Batch Request processing routine
+ *
+ */
+
+int req_quejob(
+
+  batch_request *preq)
+
+  {
+  int  rc = PBSE_NONE;
+  job *pj;
+
+  if ((pj = queue_new_job(preq, rc)) == NULL)
+    return(rc);
+
+  mutex_mgr job_mutex(pj->ji_mutex, true);
+
   /* acknowledge the request with the job id */
   if (reply_jobid(preq, pj->ji_qs.ji_jobid, BATCH_REPLY_CHOICE_Queue) != 0)
     {
@@ -1609,6 +1640,79 @@ int req_jobcredential(
 
 
 
+/*
+ * write_job_script - append a section of a new job's script to its script
+ * file, creating the file for the first section
+ *
+ * @return PBSE_NONE, or an error with the reason in log_buf
+ */
+
+static int write_job_script(
+
+  job        *pj,
+  const char *data,
+  long        size,
+  char       *log_buf,
+  size_t      buf_size)
+
+  {
+  int         fds;
+  int         filemode = 0600;
+  char        namebuf[MAXPATHLEN];
+  std::string adjusted_path_jobs;
+
+  // get adjusted path_jobs path
+  adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
+  snprintf(namebuf, sizeof(namebuf), "%s%s%s", adjusted_path_jobs.c_str(),
+    pj->ji_qs.ji_fileprefix, JOB_SCRIPT_SUFFIX);
+
+  if (pj->ji_qs.ji_un.ji_newt.ji_scriptsz == 0)
+    {
+    /* NOTE:  fail is job script already exists */
+
+    fds = open(namebuf, O_WRONLY | O_CREAT | O_EXCL | O_Sync, filemode);
+    }
+  else
+    {
+    fds = open(namebuf, O_WRONLY | O_APPEND | O_Sync, filemode);
+    }
+
+  if (fds < 0)
+    {
+    snprintf(log_buf, buf_size, "cannot open '%s' errno=%d - %s (%s)",
+             namebuf,
+             errno,
+             strerror(errno),
+             msg_script_open);
+    return(PBSE_CAN_NOT_OPEN_FILE);
+    }
+
+  if (write_ac_socket(fds, data, (unsigned)size) != size)
+    {
+    snprintf(log_buf, buf_size, "cannot write to file %s (%d-%s) %s",
+        namebuf,
+        errno,
+        strerror(errno),
+        msg_script_write);
+    close(fds);
+    return(PBSE_CAN_NOT_WRITE_FILE);
+    }
+
+  close(fds);
+
+  pj->ji_qs.ji_un.ji_newt.ji_scriptsz += size;
+
+  /* job has a script file */
+
+  pj->ji_qs.ji_svrflags =
+    (pj->ji_qs.ji_svrflags & ~JOB_SVFLG_CHECKPOINT_FILE) | JOB_SVFLG_SCRIPT;
+
+  return(PBSE_NONE);
+  }  /* END write_job_script() */
+
+
+
+
 /*
  * req_jobscript - receive job script section
  *
@@ -1620,13 +1724,9 @@ int req_jobscript(
   struct batch_request *preq)
 
   {
-  int   fds;
-  char  namebuf[MAXPATHLEN];
   job  *pj;
-  int   filemode = 0600;
   char  log_buf[LOCAL_LOG_BUF_SIZE];
   int   rc = PBSE_NONE;
-  std::string adjusted_path_jobs;
 
   errno = 0;
 
@@ -1682,63 +1782,18 @@ int req_jobscript(
     return rc;
     }
 
-  // get adjusted path_jobs path
-  adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
-  snprintf(namebuf, sizeof(namebuf), "%s%s%s", adjusted_path_jobs.c_str(),
-    pj->ji_qs.ji_fileprefix, JOB_SCRIPT_SUFFIX);
-
-  if (pj->ji_qs.ji_un.ji_newt.ji_scriptsz == 0)
-    {
-    /* NOTE:  fail is job script already exists */
-
-    fds = open(namebuf, O_WRONLY | O_CREAT | O_EXCL | O_Sync, filemode);
-    }
-  else
-    {
-    fds = open(namebuf, O_WRONLY | O_APPEND | O_Sync, filemode);
-    }
-
-  if (fds < 0)
+  if ((rc = write_job_script(pj,
+                             preq->rq_ind.rq_jobfile.rq_data,
+                             preq->rq_ind.rq_jobfile.rq_size,
+                             log_buf,
+                             sizeof(log_buf))) != PBSE_NONE)
     {
-    rc = PBSE_CAN_NOT_OPEN_FILE;
-    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "cannot open '%s' errno=%d - %s (%s)",
-             namebuf,
-             errno,
-             strerror(errno),
-             msg_script_open);
     log_err(rc, __func__, log_buf);
-    req_reject(rc, 0, preq, NULL, log_buf);
+    req_reject((rc == PBSE_CAN_NOT_WRITE_FILE) ? PBSE_INTERNAL : rc, 0, preq, NULL, log_buf);
     unlock_ji_mutex(pj, __func__, "3", LOGLEVEL);
-    return rc;
-    }
-
-  if (write_ac_socket(
-        fds,
-        preq->rq_ind.rq_jobfile.rq_data,
-        (unsigned)preq->rq_ind.rq_jobfile.rq_size) != preq->rq_ind.rq_jobfile.rq_size)
-    {
-    rc = PBSE_CAN_NOT_WRITE_FILE;
-    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "cannot write to file %s (%d-%s) %s",
-        namebuf,
-        errno,
-        strerror(errno),
-        msg_script_write);
-    log_err(rc, __func__, log_buf);
-    req_reject(PBSE_INTERNAL, 0, preq, NULL, log_buf);
-    close(fds);
-    unlock_ji_mutex(pj, __func__, "4", LOGLEVEL);
-    return rc;
+    return(rc);
     }
 
-  close(fds);
-
-  pj->ji_qs.ji_un.ji_newt.ji_scriptsz += preq->rq_ind.rq_jobfile.rq_size;
-
-  /* job has a script file */
-
-  pj->ji_qs.ji_svrflags =
-    (pj->ji_qs.ji_svrflags & ~JOB_SVFLG_CHECKPOINT_FILE) | JOB_SVFLG_SCRIPT;
-
   /* SUCCESS */
   unlock_ji_mutex(pj, __func__, "5", LOGLEVEL);
 
@@ -1884,6 +1939,45 @@ int req_mvjobfile(
 
 
 
+/*
+ * set_ready_to_commit - move a new job whose script has arrived to the
+ * ready to commit substate
+ */
+
+static void set_ready_to_commit(
+
+  job *pj)
+
+  {
+  char        namebuf[MAXPATHLEN+1];
+  std::string adjusted_path_jobs;
+
+  pj->ji_qs.ji_state    = JOB_STATE_TRANSIT;
+  pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSICM;
+  pj->ji_wattr[JOB_ATR_state].at_val.at_char = 'T';
+  pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET;
+
+  /* if this is a job array template then we'll delete the .JB file that 
+     was created for this job since we are going to save it with a different 
+     suffix here. 
+     XXX: not sure why the .JB file already exists before we do the SAVEJOB_NEW
+     save below
+   */
+  if (pj->ji_wattr[JOB_ATR_job_array_request].at_flags & ATR_VFLAG_SET)
+    {
+    pj->ji_is_array_template = TRUE;
+
+    // get adjusted path_jobs path
+    adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
+    snprintf(namebuf, sizeof(namebuf), "%s%s%s", adjusted_path_jobs.c_str(),
+      pj->ji_qs.ji_fileprefix, JOB_FILE_SUFFIX);
+    unlink(namebuf);
+    }
+  }  /* END set_ready_to_commit() */
+
+
+
+
 /*
  * req_rdytocommit - Ready To Commit Batch Request
  *
@@ -1899,11 +1993,9 @@ int req_rdytocommit(
   {
   job  *pj;
 
-  char  namebuf[MAXPATHLEN+1];
   char  jobid[PBS_MAXSVRJOBID + 1];
   char  log_buf[LOCAL_LOG_BUF_SIZE];
   int   rc = PBSE_NONE;
-  std::string adjusted_path_jobs;
 
   pj = locate_new_job(preq->rq_ind.rq_rdytocommit);
 
@@ -1948,27 +2040,7 @@ int req_rdytocommit(
     return(rc);
     }
 
-  pj->ji_qs.ji_state    = JOB_STATE_TRANSIT;
-  pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSICM;
-  pj->ji_wattr[JOB_ATR_state].at_val.at_char = 'T';
-  pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET;
-
-  /* if this is a job array template then we'll delete the .JB file that 
-     was created for this job since we are going to save it with a different 
-     suffix here. 
-     XXX: not sure why the .JB file already exists before we do the SAVEJOB_NEW
-     save below
-   */
-  if (pj->ji_wattr[JOB_ATR_job_array_request].at_flags & ATR_VFLAG_SET)
-    {
-    pj->ji_is_array_template = TRUE;
-
-    // get adjusted path_jobs path
-    adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
-    snprintf(namebuf, sizeof(namebuf), "%s%s%s", adjusted_path_jobs.c_str(),
-      pj->ji_qs.ji_fileprefix, JOB_FILE_SUFFIX);
-    unlink(namebuf);
-    }
+  set_ready_to_commit(pj);
 
   /* acknowledge the request with the job id */
   strcpy(jobid, pj->ji_qs.ji_jobid);
@@ -2067,20 +2139,21 @@ int set_interactive_job_roaming_policy(
 
 
 /*
- * req_commit - commit ownership of job
+ * commit_new_job - take a new job off the new jobs list, enqueue it, save
+ * it and reply to the request with the job id
  *
- * Set state of job to JOB_STATE_QUEUED (or Held or Waiting) and
- * enqueue the job into its destination queue.
+ * Shared by req_commit() and req_submitjob(). The request is always
+ * replied to and the job is purged on failure.
  */
 
-int req_commit(
+static int commit_new_job(
 
-  struct batch_request *preq)  /* I */
+  batch_request *preq,       /* I */
+  job           *pj,         /* I (locked) */
+  mutex_mgr     &job_mutex)  /* I */
 
   {
-  int rc = PBSE_NONE;
-  job       *pj;
-
+  int        rc = PBSE_NONE;
   int        newstate;
   int        newsub;
   pbs_queue *pque;
@@ -2096,100 +2169,6 @@ int req_commit(
   char                  *rq_destin = NULL;
 #endif /* AUTORUN_JOBS */
 
-#ifdef QUICKCOMMIT
-  int                    OrigState;
-  int                    OrigSState;
-  char                   OrigSChar;
-  long                   OrigFlags;
-
-  char                   namebuf[MAXPATHLEN+1];
-#endif /* QUICKCOMMIT */
-
-  pj = locate_new_job(preq->rq_ind.rq_commit);
-
-  if (LOGLEVEL >= 6)
-    {
-    log_record(
-      PBSEVENT_JOB,
-      PBS_EVENTCLASS_JOB,
-      (pj != NULL) ? pj->ji_qs.ji_jobid : "NULL",
-      "committing job");
-    }
-
-  if (pj == NULL)
-    {
-    rc = PBSE_UNKJOBID;
-    req_reject(rc, 0, preq, NULL, NULL);
-    return(rc);
-    }
-
-  if (LOGLEVEL >= 10)
-    LOG_EVENT(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, __func__, pj->ji_qs.ji_jobid);
-
-  mutex_mgr job_mutex = mutex_mgr(pj->ji_mutex, true); 
-#ifdef QUICKCOMMIT
-  if (pj->ji_qs.ji_substate != JOB_SUBSTATE_TRANSIN)
-    {
-    rc = PBSE_IVALREQ;
-    snprint(log_buf, LOCAL_LOG_BUF_SIZE,
-        "cannot commit job in unexpected state (%d - %s)",
-        errno, strerror(errno));
-    log_err(rc, __func__, log_buf);
-    req_reject(PBSE_IVALREQ, 0, preq, NULL, log_buf);
-    job_mutex.unlock();
-    return(rc);
-    }
-
-  OrigState  = pj->ji_qs.ji_state;
-
-  OrigSState = pj->ji_qs.ji_substate;
-  OrigSChar  = pj->ji_wattr[JOB_ATR_state].at_val.at_char;
-  OrigFlags  = pj->ji_wattr[JOB_ATR_state].at_flags;
-
-  pj->ji_qs.ji_state    = JOB_STATE_TRANSIT;
-  pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSICM;
-  pj->ji_wattr[JOB_ATR_state].at_val.at_char = 'T';
-  pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET;
-
-  if (pj->ji_wattr[JOB_ATR_job_array_request].at_flags & ATR_VFLAG_SET)
-    {
-    std::string adjusted_path_jobs;
-
-    pj->ji_is_array_template = TRUE;
-    
-    // get adjusted path_jobs path
-    adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
-    snprintf(namebuf, sizeof(namebuf), "%s%s%s", adjusted_path_jobs.c_str(),
-      pj->ji_qs.ji_fileprefix, JOB_FILE_SUFFIX);
-    unlink(namebuf);
-    }
-
-#endif /* QUICKCOMMIT */
-
-  if (pj->ji_qs.ji_substate != JOB_SUBSTATE_TRANSICM)
-    {
-    rc = PBSE_IVALREQ;
-    snprintf(log_buf, LOCAL_LOG_BUF_SIZE,
-        "cannot commit job in unexpected state (%d-%s)",
-        errno, strerror(errno));
-    log_err(rc, __func__, "cannot commit job in unexpected state");
-    req_reject(rc, 0, preq, NULL, NULL);
-    job_mutex.unlock();
-    return(rc);
-    }
-
-  if (svr_authorize_jobreq(preq, pj) == -1)
-    {
-    rc = PBSE_PERM;
-    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "no permission to start job %s",
-        pj->ji_qs.ji_jobid);
-    req_reject(rc, 0, preq, NULL, log_buf);
-    if (LOGLEVEL >= 6)
-      log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pj->ji_qs.ji_jobid, log_buf);
-    job_mutex.unlock();
-    return(rc);
-    }
-
   /* remove job from the server new job list, set state, and enqueue it */
   if (remove_job(&newjobs, pj) == THING_NOT_FOUND)
     {
@@ -2369,7 +2348,7 @@ int req_commit(
     preq_run->rq_noreply = TRUE; /* set for no replies */
     strcpy(preq_run->rq_user, preq->rq_user);
     strcpy(preq_run->rq_host, preq->rq_host);
-    strcpy(preq_run->rq_ind.rq_run.rq_jid, preq->rq_ind.rq_rdytocommit);
+    strcpy(preq_run->rq_ind.rq_run.rq_jid, pj->ji_qs.ji_jobid);
     }
 
 #endif
@@ -2425,11 +2404,302 @@ int req_commit(
 #endif /* AUTORUN_JOBS */
 
   return(rc);
+  }  /* END commit_new_job() */
+
+
+
+
+/*
+ * req_commit - commit ownership of job
+ *
+ * Set state of job to JOB_STATE_QUEUED (or Held or Waiting) and
+ * enqueue the job into its destination queue.
+ */
+
+int req_commit(
+
+  struct batch_request *preq)  /* I */
+
+  {
+  int rc = PBSE_NONE;
+  job       *pj;
+  char       log_buf[LOCAL_LOG_BUF_SIZE] = {0};
+
+#ifdef QUICKCOMMIT
+  int                    OrigState;
+  int                    OrigSState;
+  char                   OrigSChar;
+  long                   OrigFlags;
+
+  char                   namebuf[MAXPATHLEN+1];
+#endif /* QUICKCOMMIT */
+
+  pj = locate_new_job(preq->rq_ind.rq_commit);
+
+  if (LOGLEVEL >= 6)
+    {
+    log_record(
+      PBSEVENT_JOB,
+      PBS_EVENTCLASS_JOB,
+      (pj != NULL) ? pj->ji_qs.ji_jobid : "NULL",
+      "committing job");
+    }
+
+  if (pj == NULL)
+    {
+    rc = PBSE_UNKJOBID;
+    req_reject(rc, 0, preq, NULL, NULL);
+    return(rc);
+    }
+
+  if (LOGLEVEL >= 10)
+    LOG_EVENT(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, __func__, pj->ji_qs.ji_jobid);
+
+  mutex_mgr job_mutex = mutex_mgr(pj->ji_mutex, true); 
+#ifdef QUICKCOMMIT
+  if (pj->ji_qs.ji_substate != JOB_SUBSTATE_TRANSIN)
+    {
+    rc = PBSE_IVALREQ;
+    snprint(log_buf, LOCAL_LOG_BUF_SIZE,
+        "cannot commit job in unexpected state (%d - %s)",
+        errno, strerror(errno));
+    log_err(rc, __func__, log_buf);
+    req_reject(PBSE_IVALREQ, 0, preq, NULL, log_buf);
+    job_mutex.unlock();
+    return(rc);
+    }
+
+  OrigState  = pj->ji_qs.ji_state;
+
+  OrigSState = pj->ji_qs.ji_substate;
+  OrigSChar  = pj->ji_wattr[JOB_ATR_state].at_val.at_char;
+  OrigFlags  = pj->ji_wattr[JOB_ATR_state].at_flags;
+
+  pj->ji_qs.ji_state    = JOB_STATE_TRANSIT;
+  pj->ji_qs.ji_substate = JOB_SUBSTATE_TRANSICM;
+  pj->ji_wattr[JOB_ATR_state].at_val.at_char = 'T';
+  pj->ji_wattr[JOB_ATR_state].at_flags |= ATR_VFLAG_SET;
+
+  if (pj->ji_wattr[JOB_ATR_job_array_request].at_flags & ATR_VFLAG_SET)
+    {
+    std::string adjusted_path_jobs;
+
+    pj->ji_is_array_template = TRUE;
+    
+    // get adjusted path_jobs path
+    adjusted_path_jobs = get_path_jobdata(pj->ji_qs.ji_jobid, path_jobs);
+    snprintf(namebuf, sizeof(namebuf), "%s%s%s", adjusted_path_jobs.c_str(),
+      pj->ji_qs.ji_fileprefix, JOB_FILE_SUFFIX);
+    unlink(namebuf);
+    }
+
+#endif /* QUICKCOMMIT */
+
+  if (pj->ji_qs.ji_substate != JOB_SUBSTATE_TRANSICM)
+    {
+    rc = PBSE_IVALREQ;
+    snprintf(log_buf, LOCAL_LOG_BUF_SIZE,
+        "cannot commit job in unexpected state (%d-%s)",
+        errno, strerror(errno));
+    log_err(rc, __func__, "cannot commit job in unexpected state");
+    req_reject(rc, 0, preq, NULL, NULL);
+    job_mutex.unlock();
+    return(rc);
+    }
+
+  if (svr_authorize_jobreq(preq, pj) == -1)
+    {
+    rc = PBSE_PERM;
+    snprintf(log_buf, LOCAL_LOG_BUF_SIZE, "no permission to start job %s",
+        pj->ji_qs.ji_jobid);
+    req_reject(rc, 0, preq, NULL, log_buf);
+    if (LOGLEVEL >= 6)
+      log_record(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, pj->ji_qs.ji_jobid, log_buf);
+    job_mutex.unlock();
+    return(rc);
+    }
+
+  return(commit_new_job(preq, pj, job_mutex));
   }  /* END req_commit() */
 
 
 
 
+/*
+ * submit_new_job - queue, write the script of and commit the job carried
+ * by a Submit Job request
+ *
+ * The request is always replied to. On success jobid holds the new job's id.
+ */
+
+static int submit_new_job(
+
+  batch_request *preq,   /* I */
+  std::string   &jobid)  /* O */
+
+  {
+  job  *pj;
+  char  log_buf[LOCAL_LOG_BUF_SIZE];
+  int   rc = PBSE_NONE;
+
+  /* rq_submitjob starts with an rq_queuejob, so the request can be
+   * handled as a Queue Job request until the script arrives */
+  if ((pj = queue_new_job(preq, rc)) == NULL)
+    return(rc);
+
+  mutex_mgr job_mutex(pj->ji_mutex, true);
+
+  if (preq->rq_ind.rq_submitjob.rq_scriptsz > 0)
+    {
+    if ((rc = write_job_script(pj,
+                               preq->rq_ind.rq_submitjob.rq_script,
+                               preq->rq_ind.rq_submitjob.rq_scriptsz,
+                               log_buf,
+                               sizeof(log_buf))) != PBSE_NONE)
+      {
+      log_err(rc, __func__, log_buf);
+
+      remove_job(&newjobs, pj);
+      svr_job_purge(pj);
+      job_mutex.set_unlock_on_exit(false);
+
+      req_reject(rc, 0, preq, NULL, log_buf);
+      return(rc);
+      }
+    }
+
+  set_ready_to_commit(pj);
+
+  if (LOGLEVEL >= 6)
+    {
+    log_record(
+      PBSEVENT_JOB,
+      PBS_EVENTCLASS_JOB,
+      pj->ji_qs.ji_jobid,
+      "committing submitted job");
+    }
+
+  jobid = pj->ji_qs.ji_jobid;
+
+  return(commit_new_job(preq, pj, job_mutex));
+  }  /* END submit_new_job() */
+
+
+
+
+/*
+ * req_submitjob - Submit Job Batch Request
+ *
+ * Does the work of the Queue Job, Job Script, Ready To Commit and Commit
+ * requests for a request that carries both the attributes and the script,
+ * so the client waits on a single reply and the job is saved once.
+ */
+
+int req_submitjob(
+
+  batch_request *preq)  /* I */
+
+  {
+  std::string jobid;
+
+  return(submit_new_job(preq, jobid));
+  }  /* END req_submitjob() */
+
+
+
+
+/*
+ * req_submitmany - Submit Many Batch Request
+ *
+ * Submits each job of the request as if it had come in its own Submit
+ * Job request and replies once, with a line of text per job holding the
+ * job's error code followed by its id or the error message.
+ */
+
+int req_submitmany(
+
+  batch_request *preq)  /* I */
+
+  {
+  struct rq_submitmany *psm = &preq->rq_ind.rq_submitmany;
+  std::string           reply;
+  std::string           jobid;
+  char                  line[PBS_MAXSVRJOBID + LOCAL_LOG_BUF_SIZE];
+  batch_request        *sub;
+  int                   submitted = 0;
+  int                   rc;
+  int                   i;
+
+  for (i = 0; i < psm->rq_count; i++)
+    {
+    /* the per job request shares our credentials, its own reply is dropped */
+    if ((sub = alloc_br(PBS_BATCH_SubmitJob)) == NULL)
+      {
+      rc = PBSE_SYSTEM;
+      }
+    else
+      {
+      sub->rq_perm    = preq->rq_perm;
+      sub->rq_fromsvr = preq->rq_fromsvr;
+      sub->rq_conn    = preq->rq_conn;
+      sub->rq_orgconn = preq->rq_orgconn;
+      sub->rq_time    = preq->rq_time;
+      sub->rq_noreply = TRUE;
+
+      strcpy(sub->rq_user, preq->rq_user);
+      strcpy(sub->rq_host, preq->rq_host);
+
+      if (preq->rq_extend != NULL)
+        sub->rq_extend = strdup(preq->rq_extend);
+
+      /* hand the job's attributes and script over to the sub request */
+      strcpy(sub->rq_ind.rq_submitjob.rq_queuejob.rq_jid, psm->rq_jobs[i].rq_queuejob.rq_jid);
+      strcpy(sub->rq_ind.rq_submitjob.rq_queuejob.rq_destin, psm->rq_jobs[i].rq_queuejob.rq_destin);
+      CLEAR_HEAD(sub->rq_ind.rq_submitjob.rq_queuejob.rq_attr);
+      list_move(&psm->rq_jobs[i].rq_queuejob.rq_attr, &sub->rq_ind.rq_submitjob.rq_queuejob.rq_attr);
+
+      sub->rq_ind.rq_submitjob.rq_script   = psm->rq_jobs[i].rq_script;
+      sub->rq_ind.rq_submitjob.rq_scriptsz = psm->rq_jobs[i].rq_scriptsz;
+      psm->rq_jobs[i].rq_script   = NULL;
+      psm->rq_jobs[i].rq_scriptsz = 0;
+
+      jobid.clear();
+      rc = submit_new_job(sub, jobid);
+      }
+
+    if (rc == PBSE_NONE)
+      {
+      snprintf(line, sizeof(line), "%d %s\n", rc, jobid.c_str());
+      submitted++;
+      }
+    else
+      {
+      const char *msg = pbse_to_txt(rc);
+
+      snprintf(line, sizeof(line), "%d %s\n", rc, (msg != NULL) ? msg : "submit failed");
+      }
+
+    reply += line;
+    }
+
+  if (LOGLEVEL >= 6)
+    {
+    snprintf(line, sizeof(line), "submitted %d of %d jobs from %s@%s",
+      submitted,
+      psm->rq_count,
+      preq->rq_user,
+      preq->rq_host);
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_REQUEST, __func__, line);
+    }
+
+  reply_text(preq, PBSE_NONE, reply.c_str());
+
+  return(PBSE_NONE);
+  }  /* END req_submitmany() */
+
+
+
+
 /*
  * locate_new_job - locate a "new" job which has been set up req_quejob on
  * the servers new job list.
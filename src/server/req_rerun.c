@@ -363,7 +363,7 @@ int handle_requeue_all(
     }
 
   alljobs.lock();
-  iter = alljobs.get_iterator();
+  iter = alljobs.get_snapshot_iterator();
   alljobs.unlock();
 
   while ((pjob = next_job(&alljobs, iter)) != NULL)
@@ -89,6 +89,9 @@
 #include <ctype.h>
 #include <time.h>
 #include <pthread.h>
+#include <map>
+#include <string>
+#include <vector>
 #include "libpbs.h"
 #include "server_limits.h"
 #include "list_link.h"
@@ -141,12 +144,15 @@ extern int LOGLEVEL;
 /* Public Functions in this file */
 
 int  svr_startjob(job *, struct batch_request **, char *, char *);
+int  svr_allocjob(job *, char *, char *);
+int  svr_launchjob(job *, struct batch_request **);
 
 /* Private Functions local to this file */
 
 int  svr_stagein(job **, struct batch_request **, int, int);
 int  svr_strtjob2(job **, struct batch_request *);
 job *chk_job_torun(struct batch_request *, int);
+static int is_checkpoint_restart(job *);
 int  assign_hosts(job *, char *, int, char *, char *);
 
 /* Global Data Items: */
@@ -182,13 +188,23 @@ int  kill_job_on_mom(const char *job_id, struct pbsnode *pnode);
 
 
 
-int check_and_run_job_work(
+/*
+ * allocate_job_to_run() - counts a job that is about to run against its
+ * array's slot limit and assigns its hosts
+ *
+ * preq is rejected if the job can't be run
+ *
+ * @param rc - O - PBSE_NONE or the error preq was rejected with
+ * @return the job, locked, or NULL
+ */
 
-  batch_request *preq)
+static job *allocate_job_to_run(
+
+  batch_request *preq,
+  int           &rc)
 
   {
   job             *pjob;
-  int              rc = PBSE_NONE;
   char             failhost[MAXLINE];
   char             emsg[MAXLINE];
   long             job_atr_hold;
@@ -204,7 +220,7 @@ int check_and_run_job_work(
     {
     req_reject(PBSE_JOBNOTFOUND, 0, preq, NULL, "Job unexpectedly deleted");
     rc = PBSE_JOBNOTFOUND;
-    return(rc);
+    return(NULL);
     }
 
   mutex_mgr job_mutex(pjob->ji_mutex, true);
@@ -222,7 +238,7 @@ int check_and_run_job_work(
       job_mutex.set_unlock_on_exit(false);
       req_reject(PBSE_JOBNOTFOUND, 0, preq, NULL, "Job unexpectedly deleted");
       rc = PBSE_JOBNOTFOUND;
-      return(rc);
+      return(NULL);
       }
    
     if (pa != NULL)
@@ -246,7 +262,7 @@ int check_and_run_job_work(
           req_reject(PBSE_JOBNOTFOUND, 0, preq, NULL,
             "Job deleted while updating array values");
           rc = PBSE_JOBNOTFOUND;
-          return(rc);
+          return(NULL);
           }
         else
           job_mutex.mark_as_locked();
@@ -264,14 +280,59 @@ int check_and_run_job_work(
         
         rc = PBSE_IVALREQ;
 
-        return(rc);
+        return(NULL);
         }
       }
     }
 
-  /* NOTE:  nodes assigned to job in svr_startjob() */
+  /* NOTE:  nodes assigned to job in svr_allocjob() */
+
+  rc = svr_allocjob(pjob, failhost, emsg);
+
+  if (rc != PBSE_NONE)
+    {
+    free_nodes(pjob);
+
+    /* if the job has a non-empty rejectdest list, pass the first host into req_reject() */
+    if (pjob->ji_rejectdest->size() > 0)
+      {
+      req_reject(rc, 0, preq, pjob->ji_rejectdest->at(0).c_str(), "could not contact host");
+      }
+    else
+      {
+      req_reject(rc, 0, preq, failhost, emsg);
+      }
+
+    return(NULL);
+    }
+
+  job_mutex.set_unlock_on_exit(false);
+
+  return(pjob);
+  } // END allocate_job_to_run()
+
 
-  rc = svr_startjob(pjob, &preq, failhost, emsg);
+
+/*
+ * launch_allocated_job() - starts a job whose hosts have been assigned
+ *
+ * preq is rejected if the job can't be started, otherwise it is replied to
+ * once the job is running
+ *
+ * @param pjob - the job, locked
+ */
+
+static int launch_allocated_job(
+
+  job           *pjob,
+  batch_request *preq)
+
+  {
+  int rc;
+
+  mutex_mgr job_mutex(pjob->ji_mutex, true);
+
+  rc = svr_launchjob(pjob, &preq);
 
   if ((rc != 0) && 
       (preq != NULL))
@@ -285,7 +346,7 @@ int check_and_run_job_work(
       }
     else
       {
-      req_reject(rc, 0, preq, failhost, emsg);
+      req_reject(rc, 0, preq, NULL, NULL);
       }
     }
 
@@ -294,6 +355,22 @@ int check_and_run_job_work(
     free_br(preq);
 
   return(rc);
+  } // END launch_allocated_job()
+
+
+
+int check_and_run_job_work(
+
+  batch_request *preq)
+
+  {
+  job *pjob;
+  int  rc = PBSE_NONE;
+
+  if ((pjob = allocate_job_to_run(preq, rc)) == NULL)
+    return(rc);
+
+  return(launch_allocated_job(pjob, preq));
   } // END check_and_run_job_work()
 
 
@@ -315,35 +392,39 @@ void *check_and_run_job(
 
 
 /*
- * req_runjob - service the Run Job and Async Run Job Requests
+ * accept_run_request() - checks that the job named in a Run Job request
+ * may be run and logs that it is being run
  *
- * This request forces a job into execution.  Client must be privileged.
+ * preq is rejected if the job may not be run
+ *
+ * @param rc - O - PBSE_NONE or the error preq was rejected with
+ * @return the job, locked, or NULL
  */
 
-int req_runjob(
+static job *accept_run_request(
 
-  batch_request *preq)  /* I (modified) */
+  batch_request *preq,
+  int           &rc)
 
   {
-  job                  *pjob;
-  int                   rc = PBSE_NONE;
-  int                   setneednodes;
-  char                  log_buf[LOCAL_LOG_BUF_SIZE + 1];
+  job  *pjob;
+  int   setneednodes;
+  char  log_buf[LOCAL_LOG_BUF_SIZE + 1];
 
-  /* chk_job_torun will extract job id and assign hostlist if specified */
-  if (preq == NULL)
-    return(PBSE_UNKJOBID);
+  rc = PBSE_NONE;
 
   if (getenv("TORQUEAUTONN"))
     setneednodes = 1;
   else
     setneednodes = 0;
 
+  /* chk_job_torun will extract job id and assign hostlist if specified */
   if ((pjob = chk_job_torun(preq, setneednodes)) == NULL)
     {
     /* FAILURE - chk_job_torun performs req_reject internally */
+    rc = PBSE_UNKJOBID;
 
-    return(PBSE_UNKJOBID);
+    return(NULL);
     }
 
   /* we don't currently allow running of an entire job array */
@@ -352,7 +433,9 @@ int req_runjob(
     {
     unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
     req_reject(PBSE_IVALREQ, 0, preq, NULL, "cannot run a job array");
-    return(PBSE_IVALREQ);
+    rc = PBSE_IVALREQ;
+
+    return(NULL);
     }
 
   pthread_mutex_lock(scheduler_sock_jobct_mutex);
@@ -364,6 +447,33 @@ int req_runjob(
 
   log_event(PBSEVENT_JOB,PBS_EVENTCLASS_JOB,pjob->ji_qs.ji_jobid,log_buf);
 
+  return(pjob);
+  } // END accept_run_request()
+
+
+
+
+/*
+ * req_runjob - service the Run Job and Async Run Job Requests
+ *
+ * This request forces a job into execution.  Client must be privileged.
+ */
+
+int req_runjob(
+
+  batch_request *preq)  /* I (modified) */
+
+  {
+  job                  *pjob;
+  int                   rc = PBSE_NONE;
+  char                  log_buf[LOCAL_LOG_BUF_SIZE + 1];
+
+  if (preq == NULL)
+    return(PBSE_UNKJOBID);
+
+  if ((pjob = accept_run_request(preq, rc)) == NULL)
+    return(rc);
+
   if (preq->rq_type == PBS_BATCH_AsyrunJob)
     svr_setjobstate(pjob, pjob->ji_qs.ji_state, JOB_SUBSTATE_ASYNCING, FALSE);
 
@@ -401,6 +511,276 @@ int req_runjob(
 
 
 
+
+/*
+ * run_jobs_batch - the jobs of one Run Jobs request while they are started
+ */
+
+class run_jobs_batch
+  {
+  public:
+  pthread_mutex_t               mutex;
+  batch_request                *preq;        /* the Run Jobs request */
+  std::vector<int>              codes;       /* the result for each job */
+  std::vector<batch_request *>  runs;        /* the Run Job request for each job */
+  int                           groups_left; /* groups still being started */
+
+  run_jobs_batch(
+
+    batch_request *preq,
+    int            count) : preq(preq), codes(count, PBSE_NONE), runs(count, (batch_request *)NULL), groups_left(0)
+
+    {
+    pthread_mutex_init(&this->mutex, NULL);
+    }
+
+  ~run_jobs_batch()
+    {
+    pthread_mutex_destroy(&this->mutex);
+    }
+  };
+
+
+
+/*
+ * run_jobs_group - the jobs of a Run Jobs request that go to the same mother
+ * superior, started one after another
+ */
+
+class run_jobs_group
+  {
+  public:
+  run_jobs_batch   *batch;
+  std::vector<int>  jobs;  /* indexes into the batch */
+  };
+
+
+
+/*
+ * finish_run_jobs() - replies to a Run Jobs request once all of its jobs
+ * have been started or have failed
+ *
+ * The reply is one line per job, in request order: "<code> <jobid>" when
+ * the job was started, "<code> <error text>" when it wasn't.
+ */
+
+static void finish_run_jobs(
+
+  run_jobs_batch *batch)
+
+  {
+  batch_request     *preq = batch->preq;
+  struct rq_runjobs *prj = &preq->rq_ind.rq_runjobs;
+  std::string        reply;
+  char               line[PBS_MAXSVRJOBID + MAXLINE];
+  int                started = 0;
+
+  for (int i = 0; i < prj->rq_count; i++)
+    {
+    int code = batch->codes[i];
+
+    if (code == PBSE_NONE)
+      {
+      snprintf(line, sizeof(line), "%d %s\n", code, prj->rq_jobs[i].rq_jid);
+      started++;
+      }
+    else
+      {
+      const char *msg = pbse_to_txt(code);
+
+      snprintf(line, sizeof(line), "%d %s\n", code, (msg != NULL) ? msg : "run failed");
+      }
+
+    reply += line;
+    }
+
+  if (LOGLEVEL >= 6)
+    {
+    snprintf(line, sizeof(line), "started %d of %d jobs for %s@%s",
+      started,
+      prj->rq_count,
+      preq->rq_user,
+      preq->rq_host);
+    log_event(PBSEVENT_JOB, PBS_EVENTCLASS_REQUEST, __func__, line);
+    }
+
+  delete batch;
+
+  reply_text(preq, PBSE_NONE, reply.c_str());
+  } // END finish_run_jobs()
+
+
+
+/*
+ * run_jobs_group_work() - sends the jobs of a group to their mother superior
+ * and replies to the Run Jobs request if this was the last group
+ */
+
+static void run_jobs_group_work(
+
+  run_jobs_group *grp)
+
+  {
+  run_jobs_batch *batch = grp->batch;
+  bool            last;
+
+  for (unsigned int j = 0; j < grp->jobs.size(); j++)
+    {
+    int            i = grp->jobs[j];
+    batch_request *sub = batch->runs[i];
+    job           *pjob;
+    int            rc;
+
+    if ((pjob = svr_find_job(sub->rq_ind.rq_run.rq_jid, FALSE)) == NULL)
+      {
+      req_reject(PBSE_JOBNOTFOUND, 0, sub, NULL, "Job unexpectedly deleted");
+      continue;
+      }
+
+    /* staging in files or a checkpoint replies to sub after this batch is
+     * answered, so don't let that reply write into it */
+    if (((pjob->ji_wattr[JOB_ATR_stagein].at_flags & ATR_VFLAG_SET) &&
+         (pjob->ji_qs.ji_substate != JOB_SUBSTATE_STAGECMP)) ||
+        (is_checkpoint_restart(pjob)))
+      sub->rq_result = NULL;
+
+    rc = launch_allocated_job(pjob, sub);
+
+    /* a reject may have recorded -1 when the job vanished mid-send */
+    if ((rc != PBSE_NONE) &&
+        (batch->codes[i] <= PBSE_NONE))
+      batch->codes[i] = rc;
+    }
+
+  delete grp;
+
+  pthread_mutex_lock(&batch->mutex);
+  last = (--batch->groups_left == 0);
+  pthread_mutex_unlock(&batch->mutex);
+
+  if (last == true)
+    finish_run_jobs(batch);
+  } // END run_jobs_group_work()
+
+
+
+static void *run_jobs_group_task(
+
+  void *vp)
+
+  {
+  run_jobs_group_work((run_jobs_group *)vp);
+
+  return(NULL);
+  } // END run_jobs_group_task()
+
+
+
+/*
+ * req_runjobs - service the Run Jobs request
+ *
+ * Starts several jobs on behalf of one request. Every job is checked and
+ * given its nodes before any of them is sent, then the jobs are grouped by
+ * mother superior: the groups are sent in parallel and the jobs within a
+ * group one after another over the same pooled connection. The reply has
+ * one line per job, see finish_run_jobs().
+ */
+
+int req_runjobs(
+
+  batch_request *preq)  /* I (modified) */
+
+  {
+  struct rq_runjobs                    *prj = &preq->rq_ind.rq_runjobs;
+  run_jobs_batch                       *batch;
+  std::map<pbs_net_t, run_jobs_group *> groups;
+  std::map<pbs_net_t, run_jobs_group *>::iterator it;
+  run_jobs_group                       *inline_grp;
+
+  batch = new run_jobs_batch(preq, prj->rq_count);
+
+  for (int i = 0; i < prj->rq_count; i++)
+    {
+    batch_request *sub;
+    job           *pjob;
+    pbs_net_t      momaddr;
+    int            rc;
+
+    if ((sub = alloc_br(PBS_BATCH_RunJob)) == NULL)
+      {
+      batch->codes[i] = PBSE_SYSTEM;
+      continue;
+      }
+
+    sub->rq_perm = preq->rq_perm;
+    sub->rq_fromsvr = preq->rq_fromsvr;
+    sub->rq_conn = preq->rq_conn;
+    sub->rq_orgconn = preq->rq_orgconn;
+    sub->rq_time = preq->rq_time;
+    strcpy(sub->rq_user, preq->rq_user);
+    strcpy(sub->rq_host, preq->rq_host);
+
+    if (preq->rq_extend != NULL)
+      sub->rq_extend = strdup(preq->rq_extend);
+
+    /* sub is never sent, its reply code is collected into the batch */
+    sub->rq_noreply = TRUE;
+    sub->rq_result = &batch->codes[i];
+
+    strcpy(sub->rq_ind.rq_run.rq_jid, prj->rq_jobs[i].rq_jid);
+    sub->rq_ind.rq_run.rq_destin = prj->rq_jobs[i].rq_destin;
+    sub->rq_ind.rq_run.rq_resch = prj->rq_jobs[i].rq_resch;
+    prj->rq_jobs[i].rq_destin = NULL;
+
+    if ((pjob = accept_run_request(sub, rc)) == NULL)
+      continue;
+
+    unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+
+    if ((pjob = allocate_job_to_run(sub, rc)) == NULL)
+      continue;
+
+    momaddr = pjob->ji_qs.ji_un.ji_exect.ji_momaddr;
+
+    unlock_ji_mutex(pjob, __func__, "2", LOGLEVEL);
+
+    batch->runs[i] = sub;
+
+    if ((it = groups.find(momaddr)) == groups.end())
+      {
+      run_jobs_group *grp = new run_jobs_group();
+
+      grp->batch = batch;
+      it = groups.insert(std::pair<pbs_net_t, run_jobs_group *>(momaddr, grp)).first;
+      }
+
+    it->second->jobs.push_back(i);
+    }
+
+  if (groups.size() == 0)
+    {
+    finish_run_jobs(batch);
+    return(PBSE_NONE);
+    }
+
+  batch->groups_left = groups.size();
+
+  /* this thread sends the last group itself */
+  inline_grp = groups.rbegin()->second;
+
+  for (it = groups.begin(); it->second != inline_grp; it++)
+    {
+    if (enqueue_threadpool_request(run_jobs_group_task, it->second, async_pool) != PBSE_NONE)
+      run_jobs_group_work(it->second);
+    }
+
+  run_jobs_group_work(inline_grp);
+
+  return(PBSE_NONE);
+  }  /* END req_runjobs() */
+
+
+
 /*
  * is_checkpoint_restart - Is this the restart of a checkpoint job
  */
@@ -997,7 +1377,6 @@ int verify_moms_up(
 
 /*
  * svr_startjob - place a job into running state by shipping it to MOM
- *   called by req_runjob()
  */
 
 int svr_startjob(
@@ -1007,6 +1386,30 @@ int svr_startjob(
   char                  *FailHost, /* O (optional,minsize=1024) */
   char                  *EMsg)     /* O (optional,minsize=1024) */
 
+  {
+  int rc;
+
+  if ((rc = svr_allocjob(pjob, FailHost, EMsg)) != PBSE_NONE)
+    return(rc);
+
+  return(svr_launchjob(pjob, preq));
+  }  /* END svr_startjob() */
+
+
+
+
+/*
+ * svr_allocjob - assign the hosts a job will run on and set up what its
+ * MOM needs, the first half of svr_startjob()
+ *   called by allocate_job_to_run()
+ */
+
+int svr_allocjob(
+
+  job                   *pjob,     /* I job to run (modified) */
+  char                  *FailHost, /* O (optional,minsize=1024) */
+  char                  *EMsg)     /* O (optional,minsize=1024) */
+
   {
   int     f;
   int     rc;
@@ -1047,7 +1450,7 @@ int svr_startjob(
      ((pjob->ji_qs.ji_svrflags & JOB_SVFLG_CHECKPOINT_FILE)) &&
       ((pjob->ji_qs.ji_svrflags & JOB_SVFLG_HasNodes) == 0))
     {
-    rc = assign_hosts(    /* inside svr_startjob() */
+    rc = assign_hosts(    /* inside svr_allocjob() */
            pjob,
            pjob->ji_wattr[JOB_ATR_exec_host].at_val.at_str,
            0,
@@ -1063,7 +1466,7 @@ int svr_startjob(
            NULL,
            1,
            FailHost,
-           EMsg);  /* inside svr_startjob() */
+           EMsg);  /* inside svr_allocjob() */
     }
 
   if (rc != 0)
@@ -1102,6 +1505,26 @@ int svr_startjob(
     return(rc);
 #endif  /* END BOEING */
 
+  return(PBSE_NONE);
+  }  /* END svr_allocjob() */
+
+
+
+
+/*
+ * svr_launchjob - ship a job whose hosts are assigned to its MOM, staging
+ * in its files or its checkpoint first if needed
+ *   called by launch_allocated_job()
+ */
+
+int svr_launchjob(
+
+  job                   *pjob,     /* I job to run (modified) */
+  struct batch_request **preq)     /* I Run Job batch request (optional) */
+
+  {
+  int rc;
+
   /* Next, are there files to be staged-in? */
 
   if ((pjob->ji_wattr[JOB_ATR_stagein].at_flags & ATR_VFLAG_SET) &&
@@ -1137,7 +1560,7 @@ int svr_startjob(
     }
 
   return(rc);
-  }  /* END svr_startjob() */
+  }  /* END svr_launchjob() */
 
 
 
@@ -7,6 +7,8 @@
 
 int req_runjob(struct batch_request *preq);
 
+int req_runjobs(struct batch_request *preq);
+
 /* static int is_checkpoint_restart(job *pjob); */
 
 /* static void post_checkpointsend(struct work_task *pwt); */
@@ -424,13 +424,13 @@ static void sel_step3(
     if (cntl->sc_pque)
       {
       cntl->sc_pque->qu_jobs->lock();
-      iter = cntl->sc_pque->qu_jobs->get_iterator();
+      iter = cntl->sc_pque->qu_jobs->get_snapshot_iterator();
       cntl->sc_pque->qu_jobs->unlock();
       }
     else
       {
       alljobs.lock();
-      iter = alljobs.get_iterator();
+      iter = alljobs.get_snapshot_iterator();
       alljobs.unlock();
       }
 
@@ -115,6 +115,7 @@
 #include "svr_connect.h" /* svr_connect */
 #include "queue_func.h" /* find_queuebyname */
 #include "reply_send.h" /* reply_send_svr */
+#include "dis.h"
 #include "svr_func.h" /* get_svr_attr_* */
 #include "alps_functions.h"
 #include "node_manager.h" /* tfind_addr */
@@ -123,6 +124,8 @@
 #include "unistd.h"
 #include "log.h"
 #include "job_func.h"
+#include "change_log.hpp"
+#include "svr_mail.h" /* get_mail_queue_stats */
 
 /* Global Data Items: */
 
@@ -144,6 +147,7 @@ extern pthread_mutex_t *netrates_mutex;
 /* Extern Functions */
 
 int status_job(job *, struct batch_request *, svrattrl *, tlist_head *, bool, int *);
+int status_uncloned_subjob(job *, int, struct batch_request *, svrattrl *, tlist_head *, int *);
 int status_attrib(svrattrl *, attribute_def *, pbs_attribute *, int, int, tlist_head *, bool, int *, int);
 extern int  status_nodeattrib(svrattrl *, attribute_def *, struct pbsnode *, int, int, tlist_head *, int*);
 extern int  hasprop(struct pbsnode *, struct prop *);
@@ -177,6 +181,137 @@ enum TJobStatTypeEnum
 
 
 
+/*
+ * get_changed_since()
+ *
+ * reads the CHANGEDSINCE extension of a status request, which asks for only
+ * the objects changed after a change sequence. since is -1 if it isn't
+ * there.
+ *
+ * @return PBSE_IVALREQ if the sequence is malformed, PBSE_NONE otherwise
+ */
+
+int get_changed_since(
+
+  struct batch_request *preq,   /* I */
+  long long            &since)  /* O */
+
+  {
+  char *ptr;
+  char *end;
+
+  since = -1;
+
+  if ((preq->rq_extend == NULL) ||
+      ((ptr = strstr(preq->rq_extend, CHANGEDSINCE)) == NULL))
+    return(PBSE_NONE);
+
+  ptr += strlen(CHANGEDSINCE);
+  since = strtoll(ptr, &end, 10);
+
+  if ((end == ptr) ||
+      (since < 0))
+    {
+    since = -1;
+    return(PBSE_IVALREQ);
+    }
+
+  return(PBSE_NONE);
+  }  /* END get_changed_since() */
+
+
+
+/*
+ * add_change_status()
+ *
+ * appends a status entry for an object called name of objtype, with the one
+ * attribute attr_name set to value
+ */
+
+int add_change_status(
+
+  tlist_head *pstathd,   /* M */
+  int         objtype,   /* I */
+  const char *name,      /* I */
+  const char *attr_name, /* I */
+  const char *value)     /* I */
+
+  {
+  struct brp_status *pstat;
+  svrattrl          *pal;
+
+  if ((pstat = (struct brp_status *)calloc(1, sizeof(struct brp_status))) == NULL)
+    return(PBSE_SYSTEM);
+
+  pstat->brp_objtype = objtype;
+  snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%s", name);
+
+  CLEAR_LINK(pstat->brp_stlink);
+  CLEAR_HEAD(pstat->brp_attr);
+
+  append_link(pstathd, &pstat->brp_stlink, pstat);
+
+  if ((pal = attrlist_create((char *)attr_name, NULL, strlen(value) + 1)) == NULL)
+    return(PBSE_SYSTEM);
+
+  strcpy(pal->al_value, value);
+  pal->al_flags = ATR_VFLAG_SET;
+
+  append_link(&pstat->brp_attr, &pal->al_link, pal);
+
+  return(PBSE_NONE);
+  }  /* END add_change_status() */
+
+
+
+/*
+ * add_changes_header()
+ *
+ * starts the reply to a status request asking for the objects changed after
+ * since. The first entry has an empty name and ATTR_change_seq set to the
+ * sequence to ask with next time, then comes one entry with ATTR_deleted
+ * for each object of objtype that was deleted from container after since.
+ * The changed objects follow, a client applies the deletions first so an
+ * object deleted and created again is kept. since 0 asks for everything and
+ * has no deletions.
+ *
+ * @return PBSE_CHANGES_EXPIRED if the changes after since are no longer all
+ * known and the client has to ask for the full status
+ */
+
+int add_changes_header(
+
+  tlist_head *pstathd,   /* M */
+  int         objtype,   /* I */
+  const char *container, /* I (optional) */
+  long long   since)     /* I */
+
+  {
+  std::vector<std::string> deleted;
+  char                     seq_buf[MAXLINE];
+  int                      rc;
+
+  /* read first, anything changed while the reply is built is sent again */
+  snprintf(seq_buf, sizeof(seq_buf), "%lld", server_changes.current());
+
+  if ((since > 0) &&
+      (server_changes.get_deletions(objtype, container, since, deleted) == false))
+    return(PBSE_CHANGES_EXPIRED);
+
+  if ((rc = add_change_status(pstathd, objtype, "", ATTR_change_seq, seq_buf)) != PBSE_NONE)
+    return(rc);
+
+  for (unsigned int i = 0; i < deleted.size(); i++)
+    {
+    if ((rc = add_change_status(pstathd, objtype, deleted[i].c_str(), ATTR_deleted, "True")) != PBSE_NONE)
+      return(rc);
+    }
+
+  return(PBSE_NONE);
+  }  /* END add_changes_header() */
+
+
+
 /**
  * req_stat_job - service the Status Job Request
  *
@@ -199,6 +334,7 @@ int req_stat_job(
   int                   rc = PBSE_NONE;
   char                  log_buf[LOCAL_LOG_BUF_SIZE];
   bool                  condensed = false;
+  long long             changed_since;
 
   enum TJobStatTypeEnum type = tjstNONE;
 
@@ -256,7 +392,9 @@ int req_stat_job(
 
       if ((pjob = svr_find_job(name, FALSE)) == NULL)
         {
-        rc = PBSE_UNKJOBID;
+        /* array jobs that aren't cloned yet are statused from the template */
+        if (is_uncloned_subjob(name) == false)
+          rc = PBSE_UNKJOBID;
         }
       else
         unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
@@ -289,9 +427,20 @@ int req_stat_job(
     rc = PBSE_IVALREQ;
     }
 
+  /* only whole queues or the server can be asked what changed */
+  if ((rc == PBSE_NONE) &&
+      ((rc = get_changed_since(preq, changed_since)) == PBSE_NONE) &&
+      (changed_since >= 0) &&
+      (type != tjstQueue) &&
+      (type != tjstServer))
+    rc = PBSE_IVALREQ;
+
   if (rc != 0)
     {
     /* is invalid - an error */
+    if (pque != NULL)
+      unlock_queue(pque, __func__, "invalid request", LOGLEVEL);
+
     req_reject(rc, 0, preq, NULL, NULL);
 
     return(rc);
@@ -329,6 +478,7 @@ int req_stat_job(
   cntl->sc_post   = req_stat_job_step2;
   cntl->sc_jobid[0] = '\0'; /* cause "start from beginning" */
   cntl->sc_condensed = condensed;
+  cntl->sc_changed_since = changed_since;
 
   req_stat_job_step2(cntl); /* go to step 2, see if running is current */
 
@@ -368,6 +518,8 @@ void handle_truncated_qstat(
   svrattrl            *pal = (svrattrl *)GET_NEXT(preq->rq_ind.rq_status.rq_attr);
   batch_reply         *preply = &preq->rq_reply;
   int                  bad = 0;
+  struct tcp_chan     *stream = reply_stream_start(preq);
+  bool                 stream_failed = false;
 
   svr_queues.lock();
   queue_iter = svr_queues.get_iterator();
@@ -427,8 +579,12 @@ void handle_truncated_qstat(
       if ((rc != 0) &&
           (rc != PBSE_PERM))
         {
-        req_reject(rc, bad, preq, NULL, NULL);
+        if (stream != NULL)
+          reply_stream_end(stream, preq, rc, bad);
+        else
+          req_reject(rc, bad, preq, NULL, NULL);
 
+        delete jobiter;
         delete queue_iter;
 
         return;
@@ -438,8 +594,26 @@ void handle_truncated_qstat(
 
       if (pjob->ji_qs.ji_state == JOB_STATE_QUEUED)
         qjcounter++;
+
+      if (stream != NULL)
+        {
+        /* don't hold the job while writing to the client */
+        job_mgr.unlock();
+
+        if (reply_stream_status(stream, preq) != DIS_SUCCESS)
+          {
+          /* the client is gone */
+          stream_failed = true;
+          break;
+          }
+        }
       } /* END foreach (pjob from pque) */
 
+    delete jobiter;
+
+    if (stream_failed == true)
+      break;
+
     if (LOGLEVEL >= 5)
       {
       snprintf(log_buf, sizeof(log_buf), "Reported %ld total jobs for queue %s\n",
@@ -450,7 +624,10 @@ void handle_truncated_qstat(
       }
     } /* END for (pque) */
 
-  reply_send_svr(preq);
+  if (stream != NULL)
+    reply_stream_end(stream, preq, PBSE_NONE, 0);
+  else
+    reply_send_svr(preq);
 
   delete queue_iter;
 
@@ -484,7 +661,7 @@ all_jobs_iterator *get_correct_status_iterator(
     ajptr = &alljobs;
 
   ajptr->lock();
-  iter = ajptr->get_iterator();
+  iter = ajptr->get_snapshot_iterator();
   ajptr->unlock();
 
   return(iter);
@@ -540,6 +717,120 @@ job *get_next_status_job(
 
 
 
+/*
+ * status_uncloned_job()
+ *
+ * builds the status of an array job that hasn't been cloned yet
+ *
+ * @param job_id - the job's id, like 12[3].napali
+ * @return PBSE_UNKJOBID if the job isn't waiting to be cloned any more,
+ * otherwise what status_uncloned_subjob() returns
+ */
+
+int status_uncloned_job(
+
+  const char    *job_id,
+  batch_request *preq,
+  svrattrl      *pal,
+  tlist_head    *pstathd,
+  int           *bad)
+
+  {
+  job_array *pa;
+  job       *template_job;
+  char       parent_id[PBS_MAXSVRJOBID + 1];
+  int        index;
+  int        rc = PBSE_UNKJOBID;
+
+  if ((strlen(job_id) > PBS_MAXSVRJOBID) ||
+      ((index = get_subjob_index(job_id, parent_id)) < 0) ||
+      ((pa = get_array(parent_id)) == NULL))
+    return(PBSE_UNKJOBID);
+
+  if ((is_uncloned_index(pa, index) == true) &&
+      ((template_job = svr_find_job(parent_id, FALSE)) != NULL))
+    {
+    rc = status_uncloned_subjob(template_job, index, preq, pal, pstathd, bad);
+
+    unlock_ji_mutex(template_job, __func__, "1", LOGLEVEL);
+    }
+
+  unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
+
+  return(rc);
+  } // END status_uncloned_job()
+
+
+
+/*
+ * status_uncloned_subjobs()
+ *
+ * adds the jobs of array pa that haven't been cloned yet to a status reply
+ *
+ * @param pa - the array, locked
+ * @param changed_since - only report them if the template changed after this
+ * @param stream - the stream the reply is written to, NULL if it is sent
+ * all at once
+ * @param client_gone - O - set to true if writing to the stream failed
+ * @return PBSE_NONE, or the error to end the reply with
+ */
+
+int status_uncloned_subjobs(
+
+  job_array       *pa,
+  batch_request   *preq,
+  svrattrl        *pal,
+  long long        changed_since,
+  struct tcp_chan *stream,
+  bool            &client_gone,
+  int             *bad)
+
+  {
+  array_request_node *rn;
+  job                *template_job;
+  int                 i;
+  int                 rc = PBSE_NONE;
+
+  if (GET_NEXT(pa->request_tokens) == NULL)
+    return(PBSE_NONE);
+
+  if ((template_job = svr_find_job(pa->ai_qs.parent_id, FALSE)) == NULL)
+    return(PBSE_NONE);
+
+  mutex_mgr template_mutex(template_job->ji_mutex, true);
+
+  if (template_job->ji_change_seq <= changed_since)
+    return(PBSE_NONE);
+
+  for (rn = (array_request_node *)GET_NEXT(pa->request_tokens);
+       rn != NULL;
+       rn = (array_request_node *)GET_NEXT(rn->request_tokens_link))
+    {
+    for (i = rn->start; i <= rn->end; i++)
+      {
+      rc = status_uncloned_subjob(template_job, i, preq, pal, &preq->rq_reply.brp_un.brp_status, bad);
+
+      /* the user can't see any of them */
+      if (rc == PBSE_PERM)
+        return(PBSE_NONE);
+
+      if (rc != PBSE_NONE)
+        return(rc);
+
+      if ((stream != NULL) &&
+          (reply_stream_status(stream, preq) != DIS_SUCCESS))
+        {
+        client_gone = true;
+        return(PBSE_NONE);
+        }
+      }
+    }
+
+  return(PBSE_NONE);
+  } // END status_uncloned_subjobs()
+
+
+
 /*
  * in_execution_queue()
  *
@@ -614,6 +905,8 @@ void req_stat_job_step2(
   int                    job_array_index = -1;
   job_array             *pa = NULL;
   all_jobs_iterator     *iter;
+  struct tcp_chan       *stream;
+  bool                   client_gone = false;
 
   if (preq->rq_extend != NULL)
     {
@@ -632,13 +925,23 @@ void req_stat_job_step2(
   else if (type == tjstJob)
     {
     pjob = svr_find_job(preq->rq_ind.rq_status.rq_id, FALSE);
+
+    if (pjob == NULL)
+      {
+      /* an array job that hasn't been cloned yet */
+      rc = status_uncloned_job(preq->rq_ind.rq_status.rq_id, preq, pal, &preply->brp_un.brp_status, &bad);
+      }
+    else
+      {
+      rc = status_job(pjob, preq, pal, &preply->brp_un.brp_status, cntl->sc_condensed, &bad);
+
+      unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
+      }
     
-    if ((rc = status_job(pjob, preq, pal, &preply->brp_un.brp_status, cntl->sc_condensed, &bad)))
+    if (rc != PBSE_NONE)
       req_reject(rc, bad, preq, NULL, NULL);
     else
       reply_send_svr(preq);
-
-    unlock_ji_mutex(pjob, __func__, "1", LOGLEVEL);
     }
   else
     {
@@ -655,9 +958,26 @@ void req_stat_job_step2(
     else if ((type == tjstSummarizeArraysQueue) || 
              (type == tjstSummarizeArraysServer))
       update_array_statuses();
+    else if (cntl->sc_changed_since >= 0)
+      {
+      rc = add_changes_header(
+             &preply->brp_un.brp_status,
+             MGR_OBJ_JOB,
+             (cntl->sc_pque != NULL) ? cntl->sc_pque->qu_qs.qu_name : NULL,
+             cntl->sc_changed_since);
+
+      if (rc != PBSE_NONE)
+        {
+        req_reject(rc, 0, preq, NULL, NULL);
+        return;
+        }
+      }
 
     iter = get_correct_status_iterator(cntl);
 
+    /* send each job's status as it is built if the client can take it */
+    stream = reply_stream_start(preq);
+
     for (pjob = get_next_status_job(cntl, job_array_index, pa, iter);
          pjob != NULL;
          pjob = get_next_status_job(cntl, job_array_index, pa, iter))
@@ -668,6 +988,10 @@ void req_stat_job_step2(
       if (pjob->ji_being_recycled == true)
         continue;
 
+      /* -1 unless only the changed jobs were asked for */
+      if (pjob->ji_change_seq <= cntl->sc_changed_since)
+        continue;
+
       if (exec_only)
         {
         if (cntl->sc_pque != NULL)
@@ -687,22 +1011,49 @@ void req_stat_job_step2(
         if (pa != NULL)
           unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
 
-        req_reject(rc, bad, preq, NULL, NULL);
+        if (stream != NULL)
+          reply_stream_end(stream, preq, rc, bad);
+        else
+          req_reject(rc, bad, preq, NULL, NULL);
 
         delete iter;
 
         return;
         }
+
+      if (stream != NULL)
+        {
+        /* don't hold the job while writing to the client */
+        job_mutex.unlock();
+
+        if (reply_stream_status(stream, preq) != DIS_SUCCESS)
+          {
+          client_gone = true;
+          break;
+          }
+        }
       }  /* END for (pjob != NULL) */
 
     delete iter;
 
+    rc = PBSE_NONE;
+
     if (pa != NULL)
       {
+      /* jobs the array hasn't cloned yet are reported from its template */
+      if ((exec_only == false) &&
+          (client_gone == false))
+        rc = status_uncloned_subjobs(pa, preq, pal, cntl->sc_changed_since, stream, client_gone, &bad);
+
       unlock_ai_mutex(pa, __func__, "1", LOGLEVEL);
       }
    
-    reply_send_svr(preq);
+    if (stream != NULL)
+      reply_stream_end(stream, preq, rc, bad);
+    else if (rc != PBSE_NONE)
+      req_reject(rc, bad, preq, NULL, NULL);
+    else
+      reply_send_svr(preq);
     }
 
   if (LOGLEVEL >= 7)
@@ -1074,6 +1425,7 @@ int req_stat_que(
   struct batch_reply   *preply;
   int                   rc   = 0;
   int                   type = 0;
+  long long             changed_since;
   char log_buf[LOCAL_LOG_BUF_SIZE+1];
 
   /*
@@ -1083,10 +1435,23 @@ int req_stat_que(
 
   name = preq->rq_ind.rq_status.rq_id;
 
+  if ((rc = get_changed_since(preq, changed_since)) != PBSE_NONE)
+    {
+    req_reject(rc, 0, preq, NULL, NULL);
+    return(rc);
+    }
+
   if ((*name == '\0') || (*name == '@'))
     {
     type = 1;
     }
+  else if (changed_since >= 0)
+    {
+    /* only the whole list of queues can be asked what changed */
+    rc = PBSE_IVALREQ;
+    req_reject(rc, 0, preq, NULL, NULL);
+    return(rc);
+    }
   else
     {
     pque = find_queuebyname(name);
@@ -1115,6 +1480,14 @@ int req_stat_que(
     }
   else
     {
+    if ((changed_since >= 0) &&
+        ((rc = add_changes_header(&preply->brp_un.brp_status, MGR_OBJ_QUEUE, NULL, changed_since)) != PBSE_NONE))
+      {
+      reply_free(preply);
+      req_reject(rc, 0, preq, NULL, NULL);
+      return(rc);
+      }
+
     /* pque == NULL before next_queue */
     svr_queues.lock();
     all_queues_iterator *iter = svr_queues.get_iterator();
@@ -1124,6 +1497,11 @@ int req_stat_que(
     while ((pque = next_queue(&svr_queues,iter)) != NULL)
       {
       mutex_mgr pque_mutex = mutex_mgr(pque->qu_mutex, true);
+
+      /* -1 unless only the changed queues were asked for */
+      if (pque->qu_change_seq <= changed_since)
+        continue;
+
       rc = status_que(pque, preq, &preply->brp_un.brp_status);
 
       if (rc != 0)
@@ -1308,6 +1686,7 @@ int req_stat_node(
   struct batch_reply   *preply;
   struct prop props;
   svrattrl             *pal;
+  long long             changed_since;
 
   /*
    * first, check that the server indeed has a list of nodes
@@ -1334,6 +1713,12 @@ int req_stat_node(
 
   name = preq->rq_ind.rq_status.rq_id;
 
+  if ((rc = get_changed_since(preq, changed_since)) != PBSE_NONE)
+    {
+    req_reject(rc, 0, preq, NULL, NULL);
+    return(rc);
+    }
+
   if ((*name == '\0') || (*name == '@'))
     {
     type = 1;
@@ -1359,6 +1744,15 @@ int req_stat_node(
 
   CLEAR_HEAD(preply->brp_un.brp_status);
 
+  if ((changed_since >= 0) &&
+      (type == 0))
+    {
+    /* only lists of nodes can be asked what changed */
+    rc = PBSE_IVALREQ;
+    req_reject(rc, 0, preq, NULL, NULL);
+    return(rc);
+    }
+
   if (type == 0)
     {
     /* get status of the named node */
@@ -1383,6 +1777,14 @@ int req_stat_node(
     /* get status of all or several nodes */
     all_nodes_iterator *iter = NULL;
 
+    if ((changed_since >= 0) &&
+        ((rc = add_changes_header(&preply->brp_un.brp_status, MGR_OBJ_NODE, NULL, changed_since)) != PBSE_NONE))
+      {
+      reply_free(preply);
+      req_reject(rc, 0, preq, NULL, NULL);
+      return(rc);
+      }
+
     while ((pnode = next_host(&allnodes,&iter,NULL)) != NULL)
       {
       if ((type == 2) && 
@@ -1392,6 +1794,15 @@ int req_stat_node(
         continue;
         }
 
+      /* numa and alps subnodes aren't stamped, so those nodes are always sent */
+      if ((pnode->nd_change_seq <= changed_since) &&
+          (pnode->num_node_boards == 0) &&
+          (pnode->nd_is_alps_reporter == FALSE))
+        {
+        unlock_node(pnode, __func__, "type != 0, unchanged", LOGLEVEL);
+        continue;
+        }
+
       /* get the status on all of the numa nodes */
       if (pnode->nd_is_alps_reporter == TRUE)
         rc = get_alps_statuses(pnode, preq, &bad, &preply->brp_un.brp_status);
@@ -1526,8 +1937,12 @@ int req_stat_svr(
   struct brp_status    *pstat;
   int                   bad = 0;
   char                  nc_buf[128];
+  char                  tl_buf[128];
+  char                  mq_buf[128];
   int                   numjobs;
   int                   netrates[3];
+  long                  lateness[3];
+  unsigned long         mail_stats[4];
 
   memset(netrates, 0, sizeof(netrates));
 
@@ -1535,6 +1950,10 @@ int req_stat_svr(
   lock_sv_qs_mutex(server.sv_qs_mutex, __func__);
   numjobs = server.sv_qs.sv_numjobs;
   unlock_sv_qs_mutex(server.sv_qs_mutex, __func__);
+
+  get_mail_queue_stats(mail_stats);
+  snprintf(mq_buf, sizeof(mq_buf), "%lu %lu %lu %lu",
+    mail_stats[0], mail_stats[1], mail_stats[2], mail_stats[3]);
   
   pthread_mutex_lock(server.sv_attr_mutex);
   server.sv_attr[SRV_ATR_TotalJobs].at_val.at_long = numjobs;
@@ -1552,11 +1971,26 @@ int req_stat_svr(
   netcounter_get(netrates);
   snprintf(nc_buf, 127, "%d %d %d", netrates[0], netrates[1], netrates[2]);
 
+  get_timer_lateness(lateness);
+  snprintf(tl_buf, sizeof(tl_buf), "%ld %ld %ld", lateness[0], lateness[1], lateness[2]);
+
   if (server.sv_attr[SRV_ATR_NetCounter].at_val.at_str != NULL)
     free(server.sv_attr[SRV_ATR_NetCounter].at_val.at_str);
   server.sv_attr[SRV_ATR_NetCounter].at_val.at_str = strdup(nc_buf);
   if (server.sv_attr[SRV_ATR_NetCounter].at_val.at_str != NULL)
     server.sv_attr[SRV_ATR_NetCounter].at_flags |= ATR_VFLAG_SET;
+
+  if (server.sv_attr[SRV_ATR_TimerLateness].at_val.at_str != NULL)
+    free(server.sv_attr[SRV_ATR_TimerLateness].at_val.at_str);
+  server.sv_attr[SRV_ATR_TimerLateness].at_val.at_str = strdup(tl_buf);
+  if (server.sv_attr[SRV_ATR_TimerLateness].at_val.at_str != NULL)
+    server.sv_attr[SRV_ATR_TimerLateness].at_flags |= ATR_VFLAG_SET;
+
+  if (server.sv_attr[SRV_ATR_MailQueueStats].at_val.at_str != NULL)
+    free(server.sv_attr[SRV_ATR_MailQueueStats].at_val.at_str);
+  server.sv_attr[SRV_ATR_MailQueueStats].at_val.at_str = strdup(mq_buf);
+  if (server.sv_attr[SRV_ATR_MailQueueStats].at_val.at_str != NULL)
+    server.sv_attr[SRV_ATR_MailQueueStats].at_flags |= ATR_VFLAG_SET;
   pthread_mutex_unlock(server.sv_attr_mutex);
 
   /* allocate a reply structure and a status sub-structure */
@@ -91,6 +91,7 @@
 #include "libpbs.h"
 #include <ctype.h>
 #include <stdio.h>
+#include <string.h>
 #include "server_limits.h"
 #include "list_link.h"
 #include "attribute.h"
@@ -106,6 +107,8 @@
 #include "svr_func.h" /* get_svr_attr_* */
 #include "log.h"
 #include "job_route.h" /* remove_procct */
+#include "dis.h"
+#include "tcp.h"
 
 extern int     svr_authorize_jobreq(struct batch_request *, job *);
 int status_attrib(svrattrl *, attribute_def *, pbs_attribute *, int, int, tlist_head *, bool, int *, int);
@@ -116,10 +119,186 @@ extern attribute_def job_attr_def[];
 
 extern struct server server;
 
+/* stat_cache_key() bit for a status cached in DIS_ENCODING_BINARY */
+#define STAT_CACHE_BINARY 0x40000
 
 
 
 
+
+/*
+ * job_stat_cache_invalidate - drop the encoded status kept for a job
+ *
+ * Called from job_save(), which every change to a job that is not
+ * running goes through, and when the job is freed.
+ */
+
+void job_stat_cache_invalidate(
+
+  job *pjob)
+
+  {
+  if (pjob->ji_stat_cache == NULL)
+    return;
+
+  if (pjob->ji_stat_cache->jsc_data != NULL)
+    free(pjob->ji_stat_cache->jsc_data);
+
+  free(pjob->ji_stat_cache);
+  pjob->ji_stat_cache = NULL;
+  }  /* END job_stat_cache_invalidate() */
+
+
+
+/*
+ * job_stat_cacheable - may the full status of this job be kept encoded?
+ *
+ * Running and exiting jobs are left out: their resources_used is updated
+ * from mom status without a save and their walltime remaining changes
+ * every second. A job with unsaved changes is also left out.
+ */
+
+bool job_stat_cacheable(
+
+  job *pjob)
+
+  {
+  if (pjob->ji_modified)
+    return(false);
+
+  switch (pjob->ji_qs.ji_state)
+    {
+    case JOB_STATE_QUEUED:
+    case JOB_STATE_HELD:
+    case JOB_STATE_WAITING:
+    case JOB_STATE_COMPLETE:
+
+      return(true);
+
+    default:
+
+      return(false);
+    }
+  }  /* END job_stat_cacheable() */
+
+
+
+/*
+ * stat_cache_key - the inputs besides the job that decide which attributes
+ * a full status encodes, and how
+ */
+
+int stat_cache_key(
+
+  int  priv,
+  int  IsOwner,
+  bool condensed,
+  int  encoding)
+
+  {
+  /* ATR_DFLAG_RDACC fits in the low 16 bits */
+  return((priv & ATR_DFLAG_RDACC) |
+         ((IsOwner != 0) ? 0x10000 : 0) |
+         ((condensed == true) ? 0x20000 : 0) |
+         ((encoding == DIS_ENCODING_BINARY) ? STAT_CACHE_BINARY : 0));
+  }  /* END stat_cache_key() */
+
+
+
+/*
+ * get_cached_job_status - hand the job's cached encoded status to a reply
+ *
+ * @return true if pstat now carries a copy of the cached bytes
+ */
+
+bool get_cached_job_status(
+
+  job               *pjob,
+  int                key,
+  struct brp_status *pstat)
+
+  {
+  job_stat_cache *cache = pjob->ji_stat_cache;
+
+  if ((cache == NULL) ||
+      (cache->jsc_key != key) ||
+      (cache->jsc_state != pjob->ji_qs.ji_state) ||
+      (cache->jsc_substate != pjob->ji_qs.ji_substate))
+    return(false);
+
+  if ((pstat->brp_encoded = (char *)malloc(cache->jsc_len)) == NULL)
+    return(false);
+
+  memcpy(pstat->brp_encoded, cache->jsc_data, cache->jsc_len);
+  pstat->brp_encoded_len = cache->jsc_len;
+
+  return(true);
+  }  /* END get_cached_job_status() */
+
+
+
+/*
+ * cache_job_status - encode the attribute list just built for a job and
+ * keep it on the job for later status requests
+ */
+
+void cache_job_status(
+
+  job        *pjob,
+  int         key,
+  tlist_head *phead)
+
+  {
+  struct tcp_chan *chan;
+  job_stat_cache  *cache;
+  char            *encoded;
+  char            *data;
+  size_t           len;
+
+  if ((chan = DIS_buf_setup()) == NULL)
+    return;
+
+  if (key & STAT_CACHE_BINARY)
+    chan->encoding = DIS_ENCODING_BINARY;
+
+  if (encode_DIS_svrattrl(chan, (svrattrl *)GET_NEXT(*phead)) != DIS_SUCCESS)
+    {
+    DIS_tcp_cleanup(chan);
+    return;
+    }
+
+  if (((encoded = DIS_buf_data(chan, &len)) == NULL) ||
+      ((data = (char *)malloc(len)) == NULL))
+    {
+    DIS_tcp_cleanup(chan);
+    return;
+    }
+
+  memcpy(data, encoded, len);
+  DIS_tcp_cleanup(chan);
+
+  if ((cache = pjob->ji_stat_cache) == NULL)
+    {
+    if ((cache = (job_stat_cache *)calloc(1, sizeof(job_stat_cache))) == NULL)
+      {
+      free(data);
+      return;
+      }
+
+    pjob->ji_stat_cache = cache;
+    }
+  else if (cache->jsc_data != NULL)
+    free(cache->jsc_data);
+
+  cache->jsc_key = key;
+  cache->jsc_state = pjob->ji_qs.ji_state;
+  cache->jsc_substate = pjob->ji_qs.ji_substate;
+  cache->jsc_len = len;
+  cache->jsc_data = data;
+  }  /* END cache_job_status() */
+
+
+
 /**
  * status_job - Build the status reply for a single job.
  *
@@ -141,6 +320,8 @@ int status_job(
   int                IsOwner = 0;
   long               query_others = 0;
   long               condensed_timeout = JOB_CONDENSED_TIMEOUT;
+  bool               cacheable;
+  int                key = 0;
 
   /* Make sure procct is removed from the job 
      resource attributes */
@@ -182,10 +363,22 @@ int status_job(
 
   append_link(pstathd, &pstat->brp_stlink, pstat);
 
-  /* add attributes to the status reply */
+  /* a full status of an unchanged job is copied from its cache */
 
   *bad = 0;
 
+  cacheable = (pal == NULL) && (job_stat_cacheable(pjob) == true);
+
+  if (cacheable == true)
+    {
+    key = stat_cache_key(preq->rq_perm, IsOwner, condensed, preq->rq_encoding);
+
+    if (get_cached_job_status(pjob, key, pstat) == true)
+      return(PBSE_NONE);
+    }
+
+  /* add attributes to the status reply */
+
   if (status_attrib(
         pal,
         job_attr_def,
@@ -200,11 +393,139 @@ int status_job(
     return(PBSE_NOATTR);
     }
 
+  if (cacheable == true)
+    cache_job_status(pjob, key, &pstat->brp_attr);
+
   return (0);
   }  /* END status_job() */
 
 
 
+/**
+ * status_uncloned_subjob - Build the status reply for the job at index of an
+ * array that hasn't been cloned from the array's template yet.
+ *
+ * The job is reported the way job_clone() will make it: queued, or held if
+ * the template is, with the index added to its name and output paths.
+ *
+ * @see req_stat_job_step2() - parent
+ */
+
+int status_uncloned_subjob(
+
+  job           *template_job, /* the array's template, locked */
+  int            index,
+  batch_request *preq,
+  svrattrl      *pal,     /* specific attributes to status */
+  tlist_head    *pstathd, /* RETURN: head of list to append status to */
+  int           *bad)     /* RETURN: index of first bad pbs_attribute */
+
+  {
+  struct brp_status *pstat;
+  svrattrl          *patr;
+  svrattrl          *next;
+  svrattrl          *renamed;
+  int                IsOwner = 0;
+  long               query_others = 0;
+  char               index_str[16];
+  char              *jobid = template_job->ji_qs.ji_jobid;
+  char              *bracket;
+
+  if (((bracket = strchr(jobid, '[')) == NULL) ||
+      (bracket[1] != ']'))
+    return(PBSE_IVALREQ);
+
+  if (svr_authorize_jobreq(preq, template_job) == 0)
+    IsOwner = 1;
+
+  get_svr_attr_l(SRV_ATR_query_others, &query_others);
+  if ((!query_others) &&
+      (IsOwner == 0))
+    {
+    return(PBSE_PERM);
+    }
+
+  if ((pstat = (struct brp_status *)calloc(1, sizeof(struct brp_status))) == NULL)
+    {
+    return(PBSE_SYSTEM);
+    }
+
+  CLEAR_LINK(pstat->brp_stlink);
+
+  pstat->brp_objtype = MGR_OBJ_JOB;
+
+  /* 12[].napali becomes 12[3].napali */
+  snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%.*s[%d]%s",
+    (int)(bracket - jobid), jobid, index, bracket + 2);
+
+  CLEAR_HEAD(pstat->brp_attr);
+
+  append_link(pstathd, &pstat->brp_stlink, pstat);
+
+  *bad = 0;
+
+  if (status_attrib(
+        pal,
+        job_attr_def,
+        template_job->ji_wattr,
+        JOB_ATR_LAST,
+        preq->rq_perm,
+        &pstat->brp_attr,
+        false,
+        bad,
+        IsOwner))
+    {
+    return(PBSE_NOATTR);
+    }
+
+  snprintf(index_str, sizeof(index_str), "%d", index);
+
+  for (patr = (svrattrl *)GET_NEXT(pstat->brp_attr); patr != NULL; patr = next)
+    {
+    next = (svrattrl *)GET_NEXT(patr->al_link);
+
+    if (!strcmp(patr->al_name, ATTR_t))
+      {
+      /* only the template has the array request */
+      delete_link(&patr->al_link);
+      free(patr);
+      }
+    else if (!strcmp(patr->al_name, ATTR_state))
+      {
+      patr->al_value[0] = (template_job->ji_wattr[JOB_ATR_hold].at_val.at_long != 0) ? 'H' : 'Q';
+      }
+    else if ((!strcmp(patr->al_name, ATTR_N)) ||
+             (!strcmp(patr->al_name, ATTR_o)) ||
+             (!strcmp(patr->al_name, ATTR_e)))
+      {
+      if ((renamed = attrlist_create(patr->al_name, patr->al_resc, strlen(patr->al_value) + strlen(index_str) + 2)) == NULL)
+        return(PBSE_SYSTEM);
+
+      sprintf(renamed->al_value, "%s-%s", patr->al_value, index_str);
+      renamed->al_op = patr->al_op;
+      renamed->al_flags = patr->al_flags;
+
+      insert_link(&patr->al_link, &renamed->al_link, renamed, LINK_INSET_BEFORE);
+      delete_link(&patr->al_link);
+      free(patr);
+      }
+    }
+
+  if (pal == NULL)
+    {
+    if ((patr = attrlist_create(ATTR_array_id, NULL, strlen(index_str) + 1)) == NULL)
+      return(PBSE_SYSTEM);
+
+    strcpy(patr->al_value, index_str);
+    patr->al_flags = ATR_VFLAG_SET;
+    append_link(&pstat->brp_attr, &patr->al_link, patr);
+    }
+
+  return(PBSE_NONE);
+  }  /* END status_uncloned_subjob() */
+
+
+
 /* Is this dead code? It isn't called anywhere. */
 int add_walltime_remaining(
    
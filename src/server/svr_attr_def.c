@@ -1493,4 +1493,64 @@ attribute_def svr_attr_def[] =
      ATR_TYPE_LONG,
      PARENT_TYPE_SERVER},
 
+    /* SRV_ATR_TimerLateness */
+    {(char *)ATTR_timerlateness, /* "timer_lateness" */
+     decode_null,
+     encode_str,
+     set_null,
+     comp_str,
+     free_null,
+     NULL_FUNC,
+     READ_ONLY,
+     ATR_TYPE_STR,
+     PARENT_TYPE_SERVER},
+
+    /* SRV_ATR_IdleSlotLimit */
+    {(char *)ATTR_idleslotlimit, /* "idle_slot_limit" */
+     decode_l,
+     encode_l,
+      set_l,
+      comp_l,
+      free_null,
+      NULL_FUNC,
+      MGR_ONLY_SET,
+      ATR_TYPE_LONG,
+      PARENT_TYPE_SERVER},
+
+    /* SRV_ATR_MailCoalesceWindow */
+    {(char *)ATTR_mailcoalescewindow, /* "mail_coalesce_window" */
+     decode_l,
+     encode_l,
+     set_l,
+     comp_l,
+     free_null,
+     NULL_FUNC,
+     MGR_ONLY_SET,
+     ATR_TYPE_LONG,
+     PARENT_TYPE_SERVER},
+
+    /* SRV_ATR_MailSmtpServer */
+    {(char *)ATTR_mailsmtpserver, /* "mail_smtp_server" */
+     decode_str,
+     encode_str,
+     set_str,
+     comp_str,
+     free_str,
+     NULL_FUNC,
+     MGR_ONLY_SET,
+     ATR_TYPE_STR,
+     PARENT_TYPE_SERVER},
+
+    /* SRV_ATR_MailQueueStats */
+    {(char *)ATTR_mailqueuestats, /* "mail_queue_stats" */
+     decode_null,
+     encode_str,
+     set_null,
+     comp_str,
+     free_null,
+     NULL_FUNC,
+     READ_ONLY,
+     ATR_TYPE_STR,
+     PARENT_TYPE_SERVER},
+
   };
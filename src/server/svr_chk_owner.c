@@ -101,6 +101,7 @@
 #include "net_cache.h"
 #include "../lib/Libnet/lib_net.h"
 #include "ji_mutex.h"
+#include "job_func.h" /* clone_uncloned_subjob */
 
 /* Global Data */
 
@@ -651,7 +652,9 @@ job *chk_job_request(
   {
   job *pjob = NULL;
 
-  if ((pjob = svr_find_job(jobid, FALSE)) == NULL)
+  /* array jobs that haven't been cloned yet are cloned when they are named */
+  if (((pjob = svr_find_job(jobid, FALSE)) == NULL) &&
+      ((pjob = clone_uncloned_subjob(jobid)) == NULL))
     {
     log_event(
       PBSEVENT_DEBUG,
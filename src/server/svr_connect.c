@@ -106,6 +106,7 @@
 #include <stdio.h>
 #include <signal.h>
 #include <unistd.h>
+#include <poll.h>
 #include "libpbs.h"
 #include "log.h"
 #include "../lib/Liblog/pbs_log.h"
@@ -173,13 +174,20 @@ int connect_while_handling_mutex(
 
 
 
-int svr_connect(
+/*
+ * connect_to_host - open a connection and give it a handle for the API
+ * routines. Unless watched is set, the connection is kept out of
+ * wait_request() and only the caller reads from it.
+ */
+
+static int connect_to_host(
 
   pbs_net_t        hostaddr,  /* host order */
   unsigned int     port,   /* I */
   int             *my_err,
   struct pbsnode  *pnode,
-  void           *(*func)(void *))
+  void           *(*func)(void *),
+  bool             watched)
 
   {
   char         EMsg[MAXLINE];
@@ -274,7 +282,12 @@ int svr_connect(
 
   /* add the connection to the server connection table and select list */
 
-  if ((rc = add_conn(sock, ToServerDIS, hostaddr, port, PBS_SOCK_INET, func)) != PBSE_NONE)
+  if (watched == true)
+    rc = add_conn(sock, ToServerDIS, hostaddr, port, PBS_SOCK_INET, func);
+  else
+    rc = add_scheduler_conn(sock, ToServerDIS, hostaddr, port, PBS_SOCK_INET, func);
+
+  if (rc != PBSE_NONE)
     {
     /* Return invalid handle */
     return -1;
@@ -305,9 +318,78 @@ int svr_connect(
     }
 
   return(handle);
+  }  /* END connect_to_host() */
+
+
+
+int svr_connect(
+
+  pbs_net_t        hostaddr,  /* host order */
+  unsigned int     port,   /* I */
+  int             *my_err,
+  struct pbsnode  *pnode,
+  void           *(*func)(void *))
+
+  {
+  return(connect_to_host(hostaddr, port, my_err, pnode, func, true));
   }  /* END svr_connect() */
 
 
+
+/*
+ * svr_connect_unwatched - like svr_connect(), but wait_request() never looks
+ * at the connection. Use it for connections that are kept open between
+ * requests, where wait_request() would otherwise keep waking up for a
+ * connection the other side closed while nobody was using it.
+ */
+
+int svr_connect_unwatched(
+
+  pbs_net_t     hostaddr, /* I (host order) */
+  unsigned int  port,     /* I */
+  int          *my_err)   /* O */
+
+  {
+  return(connect_to_host(hostaddr, port, my_err, NULL, NULL, false));
+  }  /* END svr_connect_unwatched() */
+
+
+
+/*
+ * svr_connection_usable - check that an idle connection can carry another
+ * request. Nothing is sent to us on an idle connection, so if its socket is
+ * readable the other side has closed it or it holds a late reply, and it
+ * mustn't be used.
+ */
+
+bool svr_connection_usable(
+
+  int handle) /* I */
+
+  {
+  struct pollfd pfd;
+
+  if ((handle < 0) ||
+      (handle >= PBS_LOCAL_CONNECTION))
+    return(false);
+
+  pthread_mutex_lock(connection[handle].ch_mutex);
+  pfd.fd = connection[handle].ch_socket;
+  pthread_mutex_unlock(connection[handle].ch_mutex);
+
+  if (pfd.fd < 0)
+    return(false);
+
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  if (poll(&pfd, 1, 0) != 0)
+    return(false);
+
+  return(true);
+  }  /* END svr_connection_usable() */
+
+
 /*
  * localalm() - alarm handler for svr_disconnect()
  */
@@ -8,6 +8,8 @@
 
 void connection_clear(int con_pos);
 int svr_connect(pbs_net_t hostaddr, unsigned int port, int *local_errno, struct pbsnode *pnode, void *(*func)(void *));
+int svr_connect_unwatched(pbs_net_t hostaddr, unsigned int port, int *my_err);
+bool svr_connection_usable(int handle);
 void svr_disconnect_sock(int handle);
 void svr_disconnect(int handle);
 int get_connection_entry(int *conn_pos);
@@ -145,6 +145,8 @@
 #include "mutex_mgr.hpp"
 #include "complete_req.hpp"
 #include "attr_req_info.hpp"
+#include "job_index.hpp"
+#include "change_log.hpp"
 #include "pbs_nodes.h"
 #include <string>
 #include <vector>
@@ -152,6 +154,7 @@
 #include "utils.h"
 
 #include "user_info.h" /* remove_server_suffix() */
+#include "job_events.h" /* job_events_publish() */
 
 #define MSG_LEN_LONG 160
 
@@ -409,6 +412,9 @@ int svr_enquejob(
     return(rc);
     }
 
+  /* the queue and rank attributes are about to change */
+  job_stat_cache_invalidate(pjob);
+
   /* make sure queue is still there, there exists a small window ... */
   strcpy(job_id, pjob->ji_qs.ji_jobid);
   /* ji_qs.ji_queue now holds the name of the destination queue */
@@ -503,6 +509,7 @@ int svr_enquejob(
       alljobs.insert(pjob,pjob->ji_qs.ji_jobid);
     else
       alljobs.insert_after(prev_job_id,pjob,pjob->ji_qs.ji_jobid);
+    alljobs_index.insert(pjob->ji_qs.ji_jobid, pjob);
     alljobs.unlock();
 
     if (has_sv_qs_mutex == FALSE)
@@ -553,6 +560,8 @@ int svr_enquejob(
     /* update counts: queue and queue by state */
     pque->qu_numjobs++;
     pque->qu_njstate[pjob->ji_qs.ji_state]++;
+    pque->qu_change_seq = server_changes.next();
+    pjob->ji_change_seq = server_changes.next();
     
     /* increment this user's job count for this queue */
     if (LOGLEVEL >= 6)
@@ -711,6 +720,8 @@ int svr_dequejob(
     return(PBSE_BAD_PARAMETER);
     }
 
+  job_stat_cache_invalidate(pjob);
+
   /* do not allow svr_dequeujob to be called on a running job */
   if ((pjob->ji_qs.ji_state == JOB_STATE_RUNNING) &&
       (pjob->ji_is_array_template == FALSE))
@@ -772,6 +783,9 @@ int svr_dequejob(
         bad_ct = 1;
         log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_JOB, __func__, "qu_njstate < 0. Recount required.");
         }
+
+      server_changes.record_deletion(MGR_OBJ_JOB, jobid.c_str(), pque->qu_qs.qu_name);
+      pque->qu_change_seq = server_changes.next();
       }
     else if (rc == PBSE_JOBNOTFOUND)
       {
@@ -864,6 +878,8 @@ int svr_dequejob(
   /* the only error is if the job isn't present */
   if ((rc = remove_job(&alljobs, pjob)) == PBSE_NONE)
     {
+    server_changes.record_deletion(MGR_OBJ_JOB, pjob->ji_qs.ji_jobid, NULL);
+
     if (!pjob->ji_is_array_template)
       {
       lock_sv_qs_mutex(server.sv_qs_mutex, __func__);
@@ -1203,6 +1219,7 @@ int svr_setjobstate(
             {
             pque->qu_njstate[oldstate]--;
             pque->qu_njstate[newstate]++;
+            pque->qu_change_seq = server_changes.next();
 
             /* decrement queued job count if we're completing */
             if ((pjob->ji_qs.ji_state != JOB_STATE_TRANSIT) &&
@@ -1258,11 +1275,17 @@ int svr_setjobstate(
       }
     }    /* END if (pjob->ji_qs.ji_substate != JOB_SUBSTATE_TRANSICM) */
 
+  oldstate = pjob->ji_qs.ji_state;
+
   set_jobstate_basic(*pjob, newstate, newsubstate);
 
   if (changed == true)
     pjob->ji_mod_time = time_now;
 
+  if ((oldstate != newstate) &&
+      (pjob->ji_is_array_template == FALSE))
+    job_events_publish(pjob, 0);
+
   /* update the job file */
   if (pjob->ji_modified)
     {
@@ -92,6 +92,13 @@
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <map>
+#include <string>
+#include <vector>
 #include "list_link.h"
 #include "attribute.h"
 #include "server_limits.h"
@@ -104,6 +111,7 @@
 #include "threadpool.h"
 #include "svrfunc.h" /* get_svr_attr_* */
 #include "work_task.h"
+#include "svr_mail.h"
 #include <sys/wait.h>
 
 /* Unit tests should use the special unit test sendmail command */
@@ -119,9 +127,32 @@ extern int  listening_socket;
 
 /* Global Data */
 extern struct server server;
+extern char          server_host[];
 
 extern int LOGLEVEL;
 
+#define MAIL_QUEUE_MAX     10000 /* notifications waiting to be sent, more are dropped */
+#define MAIL_SMTP_PORT     "25"
+#define MAIL_SMTP_TIMEOUT  30    /* seconds to wait for the MTA to answer */
+
+/*
+ * Notifications are not sent by the thread that makes them. svr_mailowner()
+ * puts them on mail_queue and a single mail thread sends them, so a burst of
+ * them (a mass abort, a large array finishing) neither forks the server once
+ * per message nor ties up the task pool. The mail thread sends one message
+ * per recipient for everything that is waiting.
+ */
+
+static pthread_mutex_t          mail_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t           mail_cond = PTHREAD_COND_INITIALIZER;
+static std::vector<mail_info *> mail_queue;
+static bool                     mail_thread_started = false;
+static unsigned long            mail_sent = 0;
+static unsigned long            mail_dropped = 0;
+static unsigned long            mail_failed = 0;
+
+unsigned int                    mail_queue_max = MAIL_QUEUE_MAX;
+
 
 
 void free_mail_info(
@@ -184,12 +215,40 @@ void add_body_info(
   }
 
 
+/*
+ * write_email_body()
+ *
+ * writes the body of the notification in mi, formatted with
+ * mail_body_fmt
+ */
+
+void write_email_body(
+
+  FILE      *outmail_input,
+  mail_info *mi)
+
+  {
+  char *bodyfmt = NULL;
+  char  bodyfmtbuf[MAXLINE];
+
+  /* mail body formating statement */
+  get_svr_attr_str(SRV_ATR_MailBodyFmt, &bodyfmt);
+  if (bodyfmt == NULL)
+    {
+    add_body_info(bodyfmtbuf, mi);
+    bodyfmt = bodyfmtbuf;
+    }
+
+  svr_format_job(outmail_input, mi, bodyfmt);
+  } /* END write_email_body() */
+
+
+
 /*
  * write_email()
  *
- * In emailing, the mail body is written to a pipe connected to
- * standard input for sendmail. This function supplies the body
- * of the message.
+ * writes the headers and the body of the message for the notification
+ * in mi.
  *
  */
 void write_email(
@@ -198,9 +257,7 @@ void write_email(
   mail_info *mi)
 
   {
-  char       *bodyfmt = NULL;
   const char *subjectfmt = NULL;
-  char bodyfmtbuf[MAXLINE];
 
   /* Pipe in mail headers: To: and Subject: */
   fprintf(outmail_input, "To: %s\n", mi->mailto);
@@ -219,72 +276,325 @@ void write_email(
   /* Set "Precedence: bulk" to avoid vacation messages, etc */
   fprintf(outmail_input, "Precedence: bulk\n\n");
 
-  /* mail body formating statement */
-  get_svr_attr_str(SRV_ATR_MailBodyFmt, &bodyfmt);
-  if (bodyfmt == NULL)
+  /* Now the email body */
+  write_email_body(outmail_input, mi);
+
+  } /* write_email() */
+
+
+/*
+ * compose_mail()
+ *
+ * writes the message for notifications that all go to the same recipients.
+ * A single notification is written as it always was, several are put into
+ * one message with each body in turn.
+ *
+ * @return the message, NULL if memory ran out
+ */
+
+char *compose_mail(
+
+  std::vector<mail_info *> &msgs) /* I */
+
+  {
+  char   *text = NULL;
+  size_t  len = 0;
+  FILE   *stream;
+
+  if ((stream = open_memstream(&text, &len)) == NULL)
+    return(NULL);
+
+  if (msgs.size() == 1)
+    write_email(stream, msgs[0]);
+  else
     {
-    add_body_info(bodyfmtbuf, mi);
-    bodyfmt = bodyfmtbuf;
+    fprintf(stream, "To: %s\n", msgs[0]->mailto);
+    fprintf(stream, "Subject: PBS: %d job notifications\n", (int)msgs.size());
+    fprintf(stream, "Precedence: bulk\n\n");
+
+    for (unsigned int i = 0; i < msgs.size(); i++)
+      {
+      if (i > 0)
+        fprintf(stream, "\n----------------------------------------\n\n");
+
+      write_email_body(stream, msgs[i]);
+      }
     }
 
-  /* Now pipe in the email body */
-  svr_format_job(outmail_input, mi, bodyfmt);
+  if (fclose(stream) != 0)
+    {
+    free(text);
+    return(NULL);
+    }
+
+  return(text);
+  } /* END compose_mail() */
+
+
+
+/*
+ * smtp_data()
+ *
+ * converts a message to what is sent after the SMTP DATA command: lines end
+ * in CRLF, a leading '.' is doubled, and it ends with a line holding a '.'.
+ */
+
+void smtp_data(
+
+  const char  *text, /* I */
+  std::string &data) /* O */
+
+  {
+  bool line_start = true;
+
+  data.clear();
+
+  for (const char *c = text; *c != '\0'; c++)
+    {
+    if ((line_start == true) &&
+        (*c == '.'))
+      data += '.';
+
+    if (*c == '\n')
+      {
+      data += "\r\n";
+      line_start = true;
+      }
+    else
+      {
+      data += *c;
+      line_start = false;
+      }
+    }
+
+  if (line_start == false)
+    data += "\r\n";
+
+  data += ".\r\n";
+  } /* END smtp_data() */
 
-  } /* write_email() */
 
 
 /*
- * send_the_mail()
+ * smtp_reply()
  *
- * In emailing, we fork and exec sendmail providing the body of
- * the message on standard in.
+ * reads an SMTP reply. Every line but the last of a reply is "<code>-..."
  *
+ * @return the reply code, -1 if the connection failed or timed out
  */
-void *send_the_mail(
 
-  void *vp)
+static int smtp_reply(
+
+  int sock)
+
+  {
+  char           buf[1024];
+  size_t         len = 0;
+  ssize_t        got;
+  char          *line;
+  char          *eol;
+  struct pollfd  pfd;
+
+  pfd.fd = sock;
+  pfd.events = POLLIN;
+
+  for (;;)
+    {
+    if (poll(&pfd, 1, MAIL_SMTP_TIMEOUT * 1000) <= 0)
+      return(-1);
+
+    if ((got = read(sock, buf + len, sizeof(buf) - 1 - len)) <= 0)
+      return(-1);
+
+    len += got;
+    buf[len] = '\0';
+
+    line = buf;
+
+    while ((eol = strchr(line, '\n')) != NULL)
+      {
+      if ((eol - line >= 3) &&
+          (line[3] != '-'))
+        return(atoi(line));
+
+      line = eol + 1;
+      }
+
+    /* keep only the unfinished line */
+    len = strlen(line);
+    memmove(buf, line, len + 1);
+
+    if (len >= sizeof(buf) - 1)
+      return(-1);
+    }
+  } /* END smtp_reply() */
+
+
+
+/*
+ * smtp_command()
+ *
+ * sends cmd over sock and reads the reply
+ *
+ * @return true if the reply code is in the expected hundred (2 for 2xx)
+ */
+
+static bool smtp_command(
+
+  int          sock,
+  std::string  cmd,
+  int          expected)
+
+  {
+  const char *ptr = cmd.c_str();
+  size_t      left = cmd.size();
+  ssize_t     wrote;
+
+  while (left > 0)
+    {
+    if ((wrote = write(sock, ptr, left)) <= 0)
+      {
+      if (errno == EINTR)
+        continue;
+
+      return(false);
+      }
+
+    ptr += wrote;
+    left -= wrote;
+    }
+
+  return(smtp_reply(sock) / 100 == expected);
+  } /* END smtp_command() */
+
+
+
+/*
+ * send_mail_smtp()
+ *
+ * delivers a message to the MTA at smtp_server ("host" or "host:port")
+ *
+ * @return PBSE_NONE if the MTA accepted it
+ */
+
+int send_mail_smtp(
+
+  const char *smtp_server, /* I */
+  const char *mailfrom,    /* I */
+  const char *mailto,      /* I - comma separated */
+  const char *text)        /* I */
 
   {
-  mail_info  *mi = (mail_info *)vp;
+  std::string      host(smtp_server);
+  std::string      port(MAIL_SMTP_PORT);
+  std::string      rcpts(mailto);
+  std::string      data;
+  std::size_t      pos;
+  struct addrinfo  hints;
+  struct addrinfo *addrs = NULL;
+  struct addrinfo *ai;
+  int              sock = -1;
+  bool             ok;
+
+  if ((pos = host.find(':')) != std::string::npos)
+    {
+    port = host.substr(pos + 1);
+    host.erase(pos);
+    }
+
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addrs) != 0)
+    return(PBSE_SYSTEM);
+
+  for (ai = addrs; ai != NULL; ai = ai->ai_next)
+    {
+    if ((sock = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)) < 0)
+      continue;
+
+    if (connect(sock, ai->ai_addr, ai->ai_addrlen) == 0)
+      break;
+
+    close(sock);
+    sock = -1;
+    }
+
+  freeaddrinfo(addrs);
+
+  if (sock < 0)
+    return(PBSE_SYSTEM);
+
+  ok = (smtp_reply(sock) / 100 == 2) &&
+       (smtp_command(sock, std::string("HELO ") + server_host + "\r\n", 2)) &&
+       (smtp_command(sock, std::string("MAIL FROM:<") + mailfrom + ">\r\n", 2));
+
+  while ((ok == true) &&
+         (rcpts.size() > 0))
+    {
+    pos = rcpts.find(',');
+
+    if (pos != 0)
+      ok = smtp_command(sock, "RCPT TO:<" + rcpts.substr(0, pos) + ">\r\n", 2);
+
+    rcpts.erase(0, (pos == std::string::npos) ? pos : pos + 1);
+    }
+
+  if (ok == true)
+    {
+    smtp_data(text, data);
+
+    ok = (smtp_command(sock, "DATA\r\n", 3)) &&
+         (smtp_command(sock, data, 2));
+    }
+
+  smtp_command(sock, "QUIT\r\n", 2);
+  close(sock);
+
+  return((ok == true) ? PBSE_NONE : PBSE_SYSTEM);
+  } /* END send_mail_smtp() */
+
+
 
+/*
+ * send_mail_sendmail()
+ *
+ * pipes a message to sendmail. The server is vfork()ed rather than fork()ed,
+ * so starting sendmail doesn't copy the page tables of a large server.
+ *
+ * @return PBSE_NONE if the message was handed to sendmail
+ */
+
+int send_mail_sendmail(
+
+  const char *mailfrom, /* I */
+  const char *mailto,   /* I - comma separated */
+  const char *text,     /* I */
+  const char *jobid)    /* I - for logging */
+
+  {
   int         status = 0;
   int         numargs = 0;
+  int         numfds;
   int         pipes[2];
   int         counter;
   pid_t       pid;
   char       *mailptr;
-  const char *mailfrom = NULL;
   char        tmpBuf[LOG_BUF_SIZE];
+  const char *ptr;
+  size_t      left;
+  ssize_t     wrote;
+  int         rc = PBSE_NONE;
   // We call sendmail with cmd_name + 2 arguments + # of mailto addresses + 1 for null
   char       *sendmail_args[100];
-  FILE       *stream;
-
-
-  /* Who is mail from, if SRV_ATR_mailfrom not set use default */
-  get_svr_attr_str(SRV_ATR_mailfrom, (char **)&mailfrom);
-  if (mailfrom == NULL)
-    {
-    mailfrom = PBS_DEFAULT_MAIL;
-    if (LOGLEVEL >= 5)
-      {
-      char tmpBuf[LOG_BUF_SIZE];
-
-      snprintf(tmpBuf,sizeof(tmpBuf),
-        "Updated mailfrom to default: '%s'\n",
-        mailfrom);
-      log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
-        PBS_EVENTCLASS_JOB,
-        mi->jobid,
-        tmpBuf);
-      }
-    }
 
   sendmail_args[numargs++] = (char *)SENDMAIL_CMD;
   sendmail_args[numargs++] = (char *)"-f";
   sendmail_args[numargs++] = (char *)mailfrom;
 
   /* Add the e-mail addresses to the command line */
-  mailptr = strdup(mi->mailto);
+  mailptr = strdup(mailto);
   sendmail_args[numargs++] = mailptr;
   for (counter=0; counter < (int)strlen(mailptr); counter++)
     {
@@ -299,33 +609,34 @@ void *send_the_mail(
 
   sendmail_args[numargs] = NULL;
 
-  /* Create a pipe to talk to the sendmail process we are about to fork */
+  /* Create a pipe to talk to the sendmail process we are about to start */
   if (pipe(pipes) == -1)
     {
     snprintf(tmpBuf, sizeof(tmpBuf), "Unable to pipes for sending e-mail\n");
     log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
       PBS_EVENTCLASS_JOB,
-      mi->jobid,
+      jobid,
       tmpBuf);
 
-    free_mail_info(mi);
     free(mailptr);
-    return(NULL);
+    return(PBSE_SYSTEM);
     }
 
-  if ((pid=fork()) == -1)
+  /* the child may only call async-signal-safe functions before execv() */
+  numfds = sysconf(_SC_OPEN_MAX);
+
+  if ((pid = vfork()) == -1)
     {
     snprintf(tmpBuf, sizeof(tmpBuf), "Unable to fork for sending e-mail\n");
     log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
       PBS_EVENTCLASS_JOB,
-      mi->jobid,
+      jobid,
       tmpBuf);
 
-    free_mail_info(mi);
     free(mailptr);
     close(pipes[0]);
     close(pipes[1]);
-    return(NULL);
+    return(PBSE_SYSTEM);
     }
   else if (pid == 0)
     {
@@ -335,69 +646,291 @@ void *send_the_mail(
     dup2(pipes[0],STDIN_FILENO);
 
     /* Close the rest of the open file descriptors */
-    int numfds = sysconf(_SC_OPEN_MAX);
     while (--numfds > 0)
       close(numfds);
 
     execv(SENDMAIL_CMD, sendmail_args);
     /* This never returns, but if the execv fails the child should exit */
-    exit(1);
+    _exit(1);
     }
-  else
-    {
-    /* This is the parent */
 
-    /* Close the read end of the pipe */
-    close(pipes[0]);
+  /* This is the parent */
+  free(mailptr);
 
-    /* Write the body to the pipe */
-    stream = fdopen(pipes[1], "w");
-    write_email(stream, mi);
+  /* Close the read end of the pipe */
+  close(pipes[0]);
 
-    fflush(stream);
+  /* Write the message to the pipe */
+  ptr = text;
+  left = strlen(text);
 
-    /* Close and wait for the command to finish */
-    if (fclose(stream) != 0)
+  while (left > 0)
+    {
+    if ((wrote = write(pipes[1], ptr, left)) <= 0)
       {
+      if (errno == EINTR)
+        continue;
+
       snprintf(tmpBuf,sizeof(tmpBuf),
         "Piping mail body to sendmail closed: errno %d:%s\n",
         errno, strerror(errno));
 
       log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
         PBS_EVENTCLASS_JOB,
-        mi->jobid,
+        jobid,
         tmpBuf);
+
+      rc = PBSE_SYSTEM;
+      break;
       }
 
-    // we aren't going to block in order to find out whether or not sendmail worked 
-    if ((waitpid(pid, &status, WNOHANG) != 0) &&
-        (status != 0))
+    ptr += wrote;
+    left -= wrote;
+    }
+
+  close(pipes[1]);
+
+  /* only the mail thread waits here. The server ignores SIGCHLD, in which
+   * case the child is reaped for us and there is no status to look at */
+  if ((waitpid(pid, &status, 0) == pid) &&
+      (status != 0))
+    {
+    snprintf(tmpBuf,sizeof(tmpBuf),
+      "Sendmail command returned %d. Mail may not have been sent\n",
+      status);
+
+    log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
+      PBS_EVENTCLASS_JOB,
+      jobid,
+      tmpBuf);
+
+    rc = PBSE_SYSTEM;
+    }
+
+  return(rc);
+  } /* END send_mail_sendmail() */
+
+
+
+/*
+ * send_mail_batch()
+ *
+ * sends notifications taken off the mail queue, one message per recipient,
+ * and frees them
+ */
+
+void send_mail_batch(
+
+  std::vector<mail_info *> &batch) /* I (freed) */
+
+  {
+  std::map<std::string, std::vector<mail_info *> >           by_rcpt;
+  std::map<std::string, std::vector<mail_info *> >::iterator it;
+  const char *mailfrom = NULL;
+  char       *smtp_server = NULL;
+  char       *text;
+  char        tmpBuf[LOG_BUF_SIZE];
+  int         rc;
+
+  /* Who is mail from, if SRV_ATR_mailfrom not set use default */
+  get_svr_attr_str(SRV_ATR_mailfrom, (char **)&mailfrom);
+  if (mailfrom == NULL)
+    mailfrom = PBS_DEFAULT_MAIL;
+
+  get_svr_attr_str(SRV_ATR_MailSmtpServer, &smtp_server);
+
+  for (unsigned int i = 0; i < batch.size(); i++)
+    by_rcpt[batch[i]->mailto].push_back(batch[i]);
+
+  for (it = by_rcpt.begin(); it != by_rcpt.end(); it++)
+    {
+    std::vector<mail_info *> &msgs = it->second;
+
+    if ((text = compose_mail(msgs)) == NULL)
       {
-      snprintf(tmpBuf,sizeof(tmpBuf),
-        "Sendmail command returned %d. Mail may not have been sent\n",
-        status);
+      log_err(ENOMEM, __func__, "Cannot allocate memory to send email");
+      rc = PBSE_MEM_MALLOC;
+      }
+    else
+      {
+      rc = PBSE_SYSTEM;
 
-      log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
-        PBS_EVENTCLASS_JOB,
-        mi->jobid,
-        tmpBuf);
+      if ((smtp_server != NULL) &&
+          (*smtp_server != '\0'))
+        {
+        if ((rc = send_mail_smtp(smtp_server, mailfrom, msgs[0]->mailto, text)) != PBSE_NONE)
+          {
+          snprintf(tmpBuf, sizeof(tmpBuf),
+            "Unable to send e-mail to %s through %s, using %s\n",
+            msgs[0]->mailto, smtp_server, SENDMAIL_CMD);
+          log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
+            PBS_EVENTCLASS_JOB,
+            msgs[0]->jobid,
+            tmpBuf);
+          }
+        }
+
+      if (rc != PBSE_NONE)
+        rc = send_mail_sendmail(mailfrom, msgs[0]->mailto, text, msgs[0]->jobid);
+
+      free(text);
       }
 
-    // don't leave zombies
-    while (waitpid(-1, &status, WNOHANG) != 0)
+    if ((LOGLEVEL >= 7) &&
+        (msgs.size() > 1))
       {
-      // zombie reaped, NO-OP
+      snprintf(tmpBuf, sizeof(tmpBuf), "sent %d notifications to %s in one e-mail",
+        (int)msgs.size(), msgs[0]->mailto);
+      log_event(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, msgs[0]->jobid, tmpBuf);
       }
-      
-    free_mail_info(mi);
-    free(mailptr);
-    return(NULL);
+
+    pthread_mutex_lock(&mail_mutex);
+    if (rc == PBSE_NONE)
+      mail_sent += msgs.size();
+    else
+      mail_failed += msgs.size();
+    pthread_mutex_unlock(&mail_mutex);
+
+    for (unsigned int i = 0; i < msgs.size(); i++)
+      free_mail_info(msgs[i]);
+    }
+
+  batch.clear();
+  } /* END send_mail_batch() */
+
+
+
+/*
+ * mail_thread()
+ *
+ * sends what is put on the mail queue. When mail_coalesce_window is set it
+ * waits that many seconds after the first notification of a burst, so that
+ * the rest of the burst goes out with it.
+ */
+
+void *mail_thread(
+
+  void *vp)
+
+  {
+  std::vector<mail_info *> batch;
+  long                     window;
+
+  for (;;)
+    {
+    pthread_mutex_lock(&mail_mutex);
+
+    while (mail_queue.size() == 0)
+      pthread_cond_wait(&mail_cond, &mail_mutex);
+
+    pthread_mutex_unlock(&mail_mutex);
+
+    window = 0;
+    get_svr_attr_l(SRV_ATR_MailCoalesceWindow, &window);
+
+    if (window > 0)
+      sleep(window);
+
+    pthread_mutex_lock(&mail_mutex);
+    batch.swap(mail_queue);
+    pthread_mutex_unlock(&mail_mutex);
+
+    send_mail_batch(batch);
     }
-    
+
   /* NOT REACHED */
 
   return(NULL);
-  } /* END send_the_mail() */
+  } /* END mail_thread() */
+
+
+
+/*
+ * queue_mail()
+ *
+ * hands a notification to the mail thread, starting it the first time.
+ * If mail_queue_max notifications are already waiting, mi is dropped.
+ *
+ * @return PBSE_NONE, or PBSE_RESCUNAV if mi was dropped
+ */
+
+int queue_mail(
+
+  mail_info *mi) /* I (freed) */
+
+  {
+  pthread_attr_t attr;
+  pthread_t      tid;
+  unsigned long  dropped = 0;
+  char           tmpBuf[LOG_BUF_SIZE];
+
+  pthread_mutex_lock(&mail_mutex);
+
+  if (mail_thread_started == false)
+    {
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    if (pthread_create(&tid, &attr, mail_thread, NULL) == 0)
+      mail_thread_started = true;
+    else
+      log_err(errno, __func__, "Unable to start the mail thread, will retry");
+
+    pthread_attr_destroy(&attr);
+    }
+
+  if (mail_queue.size() >= mail_queue_max)
+    dropped = ++mail_dropped;
+  else
+    {
+    mail_queue.push_back(mi);
+    pthread_cond_signal(&mail_cond);
+    }
+
+  pthread_mutex_unlock(&mail_mutex);
+
+  if (dropped == 0)
+    return(PBSE_NONE);
+
+  /* don't flood the log during the burst that filled the queue */
+  if ((dropped == 1) ||
+      (dropped % 1000 == 0))
+    {
+    snprintf(tmpBuf, sizeof(tmpBuf),
+      "Mail queue is full (%u waiting), dropped e-mail for job %s (%lu dropped so far)",
+      mail_queue_max, mi->jobid, dropped);
+    log_event(PBSEVENT_ERROR | PBSEVENT_ADMIN | PBSEVENT_JOB,
+      PBS_EVENTCLASS_JOB,
+      mi->jobid,
+      tmpBuf);
+    }
+
+  free_mail_info(mi);
+
+  return(PBSE_RESCUNAV);
+  } /* END queue_mail() */
+
+
+
+/*
+ * get_mail_queue_stats()
+ *
+ * @param stats - O - notifications waiting, sent, dropped because the
+ * queue was full, and failed to send
+ */
+
+void get_mail_queue_stats(
+
+  unsigned long stats[4])
+
+  {
+  pthread_mutex_lock(&mail_mutex);
+  stats[0] = mail_queue.size();
+  stats[1] = mail_sent;
+  stats[2] = mail_dropped;
+  stats[3] = mail_failed;
+  pthread_mutex_unlock(&mail_mutex);
+  } /* END get_mail_queue_stats() */
 
 
 
@@ -708,8 +1241,8 @@ void svr_mailowner(
   else
     mi->text = NULL;
 
-  /* have a thread do the work of sending the mail */
-  enqueue_threadpool_request(send_the_mail, mi, task_pool);
+  /* have the mail thread do the work of sending the mail */
+  queue_mail(mi);
 
   return;
   }  /* END svr_mailowner() */
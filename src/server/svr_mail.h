@@ -2,9 +2,22 @@
 #define _SVR_MAIL_H
 #include "license_pbs.h" /* See here for the software license */
 
+#include <string>
+#include <vector>
+
 #include "server.h" /* mail_info */
 #include "pbs_job.h" /* job */
 
 void svr_mailowner(job *pjob, int mailpoint, int force, const char *text);
 
+void free_mail_info(mail_info *mi);
+
+int queue_mail(mail_info *mi);
+
+void get_mail_queue_stats(unsigned long stats[4]);
+
+char *compose_mail(std::vector<mail_info *> &msgs);
+
+void smtp_data(const char *text, std::string &data);
+
 #endif /* _SVR_MAIL_H */
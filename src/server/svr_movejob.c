@@ -120,6 +120,7 @@
 #include "ji_mutex.h"
 #include "mutex_mgr.hpp"
 #include "job_func.h"
+#include "mom_connection_pool.hpp"
 
 #if __STDC__ != 1
 #include <memory.h>
@@ -1082,35 +1083,60 @@ int send_job_over_network_with_retries(
   int  con = PBS_NET_RC_UNSET;
   char log_buf[LOCAL_LOG_BUF_SIZE];
   int  rc = LOCUTION_RETRY;
+  bool reused = false;
+  bool stale = false;
 
   for (int NumRetries = 0; NumRetries < RETRY; NumRetries++)
     {
     /* connect to receiving server with retries */
     if (NumRetries > 0)
       {
+      /* a pooled connection the mom had already closed failed without a
+       * reply, so the job never got there. Try again right away on a new
+       * connection. */
+      stale = ((reused == true) &&
+               (timeout == false) &&
+               ((*my_err == PBSE_NONE) ||
+                (*my_err == PBSE_PROTOCOL)));
+
       /* recycle after an error */
       if (con >= 0)
         {
-        svr_disconnect(con);
+        if (type == MOVE_TYPE_Exec)
+          mom_connections.release(job_momaddr, job_momport, con, false);
+        else
+          svr_disconnect(con);
+
         con = PBS_NET_RC_UNSET;
         }
 
+      if (stale == true)
+        {
+        reused = false;
+        NumRetries--;
+        }
       /* check my_err from previous attempt */
-      if (should_retry_route(*my_err) == -1)
+      else if (should_retry_route(*my_err) == -1)
         {
         sprintf(log_buf, "child failed in previous commit request for job %s", job_id);
 
         log_err(*my_err, __func__, log_buf);
         break;
         }
-
-      sleep(1 << NumRetries);
+      else
+        sleep(1 << NumRetries);
       }
 
     /* make sure this is zero at the point that we're retrying */
     *my_err = 0;
 
-    if ((con = svr_connect(job_momaddr, job_momport, my_err, NULL, NULL)) == PBS_NET_RC_FATAL)
+    /* jobs sent to a mom one after another share a kept-open connection */
+    if (type == MOVE_TYPE_Exec)
+      con = mom_connections.get(job_momaddr, job_momport, my_err, &reused);
+    else
+      con = svr_connect(job_momaddr, job_momport, my_err, NULL, NULL);
+
+    if (con == PBS_NET_RC_FATAL)
       {
       sprintf(log_buf, "send_job failed to host %s, %lx port %d",
         (job_destin[0] != '\0') ? job_destin : "unknown host",
@@ -1159,7 +1185,12 @@ int send_job_over_network_with_retries(
     }  /* END for (NumRetries) */
   
   if (con >= 0)
-    svr_disconnect(con);
+    {
+    if (type == MOVE_TYPE_Exec)
+      mom_connections.release(job_momaddr, job_momport, con, rc == LOCUTION_SUCCESS);
+    else
+      svr_disconnect(con);
+    }
 
   return(rc);
   } /* END send_job_over_network_with_retries() */
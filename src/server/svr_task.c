@@ -94,6 +94,7 @@
 #include "portability.h"
 #include <stdlib.h>
 #include <time.h>
+#include <string.h>
 #include <sys/param.h>
 #include <sys/types.h>
 #include "server_limits.h"
@@ -108,72 +109,360 @@ extern void check_nodes(struct work_task *);
 
 /* Global Data Items: */
 
-std::list<timed_task>  *task_list_timed;
-extern pthread_mutex_t  task_list_timed_mutex;
+timed_task_heap         task_list_timed;
 extern task_recycler    tr;
 
 
 
-void insert_timed_task(
+timed_task_heap::timed_task_heap()
+
+  {
+  pthread_mutex_init(&this->mutex, NULL);
+  this->next_seq = 0;
+  this->late_count = 0;
+
+  memset(this->late_times, 0, sizeof(this->late_times));
+  memset(this->late_max, 0, sizeof(this->late_max));
+  }
+
+
+
+timed_task_heap::~timed_task_heap()
+
+  {
+  // tasks may still be set while the main thread exits, leave everything in place
+  }
+
+
+
+/*
+ * before()
+ *
+ * @return true if a is due before b
+ */
+
+bool timed_task_heap::before(
+
+  const timed_task &a,
+  const timed_task &b)
+
+  {
+  if (a.task_time != b.task_time)
+    return(a.task_time < b.task_time);
+
+  return(a.seq < b.seq);
+  } /* END before() */
+
+
+
+/*
+ * place()
+ *
+ * puts tt at pos in the heap and tells its task where it is
+ */
+
+void timed_task_heap::place(
+
+  size_t            pos,
+  const timed_task &tt)
+
+  {
+  this->heap[pos] = tt;
+  tt.wt->wt_heap_pos = pos + 1;
+  } /* END place() */
+
+
+
+void timed_task_heap::sift_up(
+
+  size_t pos)
+
+  {
+  timed_task tt = this->heap[pos];
+
+  while (pos > 0)
+    {
+    size_t parent = (pos - 1) / 2;
+
+    if (!this->before(tt, this->heap[parent]))
+      break;
+
+    this->place(pos, this->heap[parent]);
+    pos = parent;
+    }
+
+  this->place(pos, tt);
+  } /* END sift_up() */
+
+
+
+void timed_task_heap::sift_down(
+
+  size_t pos)
+
+  {
+  timed_task tt = this->heap[pos];
+  size_t     count = this->heap.size();
+
+  while (2 * pos + 1 < count)
+    {
+    size_t child = 2 * pos + 1;
+
+    if ((child + 1 < count) &&
+        (this->before(this->heap[child + 1], this->heap[child])))
+      child++;
+
+    if (!this->before(this->heap[child], tt))
+      break;
+
+    this->place(pos, this->heap[child]);
+    pos = child;
+    }
+
+  this->place(pos, tt);
+  } /* END sift_down() */
+
+
+
+/*
+ * take()
+ *
+ * removes the task at pos from the heap. The caller holds the mutex.
+ */
+
+void timed_task_heap::take(
+
+  size_t pos)
+
+  {
+  size_t last = this->heap.size() - 1;
+
+  this->heap[pos].wt->wt_heap_pos = 0;
+
+  if (pos != last)
+    {
+    this->place(pos, this->heap[last]);
+    this->heap.pop_back();
+
+    /* the task moved in may belong above or below pos */
+    if ((pos > 0) &&
+        (this->before(this->heap[pos], this->heap[(pos - 1) / 2])))
+      this->sift_up(pos);
+    else
+      this->sift_down(pos);
+    }
+  else
+    this->heap.pop_back();
+  } /* END take() */
+
+
+
+/*
+ * insert()
+ *
+ * adds wt to the heap, due at wt->wt_event
+ */
+
+void timed_task_heap::insert(
 
   work_task *wt)
 
   {
-  std::list<timed_task>::iterator it;
-  bool                            inserted = false;
-  timed_task                      tt;
+  timed_task tt;
 
   tt.wt = wt;
   tt.task_time = wt->wt_event;
 
-  pthread_mutex_lock(&task_list_timed_mutex);
+  pthread_mutex_lock(&this->mutex);
+
+  tt.seq = this->next_seq++;
+
+  this->heap.push_back(tt);
+  this->sift_up(this->heap.size() - 1);
+
+  pthread_mutex_unlock(&this->mutex);
+  } /* END insert() */
+
 
-  for (it = task_list_timed->begin(); it != task_list_timed->end(); it++)
+
+/*
+ * remove()
+ *
+ * takes wt out of the heap if it is in it
+ *
+ * @return true if wt was in the heap
+ */
+
+bool timed_task_heap::remove(
+
+  work_task *wt)
+
+  {
+  bool found = false;
+
+  pthread_mutex_lock(&this->mutex);
+
+  if ((wt->wt_heap_pos > 0) &&
+      (wt->wt_heap_pos <= this->heap.size()) &&
+      (this->heap[wt->wt_heap_pos - 1].wt == wt))
     {
-    if (it->task_time >= tt.task_time)
-      {
-      task_list_timed->insert(it, tt);
-      inserted = true;
-      break;
-      }
+    this->take(wt->wt_heap_pos - 1);
+    found = true;
     }
 
-  if (inserted == false)
-    task_list_timed->push_back(tt);
+  pthread_mutex_unlock(&this->mutex);
 
-  pthread_mutex_unlock(&task_list_timed_mutex);
-  } /* END insert_timed_task() */
+  return(found);
+  } /* END remove() */
 
 
 
-work_task *pop_timed_task(
+/*
+ * record_lateness()
+ *
+ * notes that a task came due lateness seconds before time_now. The caller
+ * holds the mutex.
+ */
 
-  time_t  time_now)
+void timed_task_heap::record_lateness(
 
-  {
-  struct work_task                *wt = NULL;
-  std::list<timed_task>::iterator  it;
+  time_t time_now,
+  long   lateness)
 
-  pthread_mutex_lock(&task_list_timed_mutex);
+  {
+  int slot = time_now % TIMER_LATENESS_WINDOW;
 
-  if (task_list_timed->begin() != task_list_timed->end())
+  if (this->late_times[slot] != time_now)
     {
-    it = task_list_timed->begin();
+    this->late_times[slot] = time_now;
+    this->late_max[slot] = 0;
+    }
 
-    if (it->task_time <= time_now)
-      {
-      wt = it->wt;
-      task_list_timed->pop_front();
-      }
+  if (lateness > this->late_max[slot])
+    this->late_max[slot] = lateness;
+
+  if (lateness > 1)
+    this->late_count++;
+  } /* END record_lateness() */
+
+
+
+/*
+ * pop()
+ *
+ * @return the task due first if it is due by time_now, NULL otherwise
+ */
+
+work_task *timed_task_heap::pop(
+
+  time_t time_now)
+
+  {
+  work_task *wt = NULL;
+
+  pthread_mutex_lock(&this->mutex);
+
+  if ((this->heap.size() > 0) &&
+      (this->heap[0].task_time <= time_now))
+    {
+    wt = this->heap[0].wt;
+    this->record_lateness(time_now, time_now - this->heap[0].task_time);
+    this->take(0);
     }
-  
-  pthread_mutex_unlock(&task_list_timed_mutex);
+
+  pthread_mutex_unlock(&this->mutex);
 
   return(wt);
+  } /* END pop() */
+
+
+
+size_t timed_task_heap::size()
+
+  {
+  size_t count;
+
+  pthread_mutex_lock(&this->mutex);
+  count = this->heap.size();
+  pthread_mutex_unlock(&this->mutex);
+
+  return(count);
+  } /* END size() */
+
+
+
+/*
+ * get_lateness()
+ *
+ * fills lateness with how many seconds overdue the first task is at
+ * time_now, the most seconds a task was late over the last
+ * TIMER_LATENESS_WINDOW seconds, and how many tasks have been more than a
+ * second late.
+ */
+
+void timed_task_heap::get_lateness(
+
+  time_t time_now,
+  long   lateness[3])
+
+  {
+  pthread_mutex_lock(&this->mutex);
+
+  lateness[0] = 0;
+  lateness[1] = 0;
+  lateness[2] = this->late_count;
+
+  if ((this->heap.size() > 0) &&
+      (this->heap[0].task_time < time_now))
+    lateness[0] = time_now - this->heap[0].task_time;
+
+  for (int i = 0; i < TIMER_LATENESS_WINDOW; i++)
+    {
+    if ((this->late_times[i] > time_now - TIMER_LATENESS_WINDOW) &&
+        (this->late_max[i] > lateness[1]))
+      lateness[1] = this->late_max[i];
+    }
+
+  pthread_mutex_unlock(&this->mutex);
+  } /* END get_lateness() */
+
+
+
+void insert_timed_task(
+
+  work_task *wt)
+
+  {
+  task_list_timed.insert(wt);
+  } /* END insert_timed_task() */
+
+
+
+work_task *pop_timed_task(
+
+  time_t  time_now)
+
+  {
+  return(task_list_timed.pop(time_now));
   } /* END pop_timed_task() */
 
 
 
+/*
+ * get_timer_lateness - how far dispatching timed tasks has fallen behind,
+ * see timed_task_heap::get_lateness()
+ */
+
+void get_timer_lateness(
+
+  long lateness[3])
+
+  {
+  task_list_timed.get_lateness(time(NULL), lateness);
+  } /* END get_timer_lateness() */
+
+
+
 /*
  * set_task - add the job entry to the task list
  *
@@ -288,6 +577,9 @@ int dispatch_task(
   if (ptask->wt_tasklist)
     remove_task(ptask->wt_tasklist, ptask);
 
+  /* a timed task dispatched early must not come due again */
+  task_list_timed.remove(ptask);
+
   /* mark the task as being recycled - it gets freed later */
   ptask->wt_being_recycled = TRUE;
   pthread_mutex_unlock(ptask->wt_mutex);
@@ -338,6 +630,9 @@ void delete_task(
   if (ptask->wt_tasklist)
     remove_task(ptask->wt_tasklist,ptask);
 
+  /* the recycler frees it, so it can't be left to come due */
+  task_list_timed.remove(ptask);
+
   /* put the task in the recycler */
   insert_task_into_recycler(ptask);
 
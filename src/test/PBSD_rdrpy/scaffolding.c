@@ -58,3 +58,8 @@ char *pbs_strerror(
 
   return(NULL);
   }
+
+struct batch_reply *PBSD_session_rdrpy(int *local_errno, int c)
+  {
+  return(NULL);
+  }
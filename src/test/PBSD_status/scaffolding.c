@@ -1,33 +1,94 @@
 #include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
 
 #include "libpbs.h" /* connect_handle */
+#include "dis.h"
+#include "tcp.h"
 
 struct connect_handle connection[10];
 
 
 void pbs_statfree(struct batch_status *bsp)
   {
-  fprintf(stderr, "The call to pbs_statfree needs to be mocked!!\n");
-  exit(1);
+  struct batch_status *next;
+
+  while (bsp != NULL)
+    {
+    next = bsp->next;
+    free(bsp->name);
+    free(bsp);
+    bsp = next;
+    }
   }
 
-struct batch_reply *PBSD_rdrpy(int *local_errno, int c)
+/* the streamed reply handed out by PBSD_rdrpy_stream(): each job is a 1,
+ * its object type and its name; then a 0 and the final codes */
+unsigned    stream_uints[16];
+int         stream_uint_count = 0;
+int         stream_final_code = 0;
+int         stream_objects = 0;
+struct tcp_chan stream_chan;
+
+static int next_uint = 0;
+static int next_sint = 0;
+
+struct batch_reply *PBSD_rdrpy_stream(int *local_errno, int c, struct tcp_chan **stream)
   {
-  fprintf(stderr, "The call to PBSD_rdrpy needs to be mocked!!\n");
-  exit(1);
+  struct batch_reply *reply = (struct batch_reply *)calloc(1, sizeof(struct batch_reply));
+
+  reply->brp_choice = BATCH_REPLY_CHOICE_StatusStream;
+  *stream = &stream_chan;
+  *local_errno = 0;
+  next_uint = 0;
+  next_sint = 0;
+
+  return(reply);
+  }
+
+unsigned disrui(struct tcp_chan *chan, int *retval)
+  {
+  *retval = DIS_SUCCESS;
+
+  if (next_uint >= stream_uint_count)
+    {
+    *retval = DIS_EOD;
+    return(0);
+    }
+
+  return(stream_uints[next_uint++]);
   }
 
+int disrsi(struct tcp_chan *chan, int *retval)
+  {
+  *retval = DIS_SUCCESS;
+
+  return((next_sint++ == 0) ? stream_final_code : 0);
+  }
+
+int disrfst(struct tcp_chan *chan, size_t achars, char *value)
+  {
+  snprintf(value, achars, "%d.napali", ++stream_objects);
+  return(DIS_SUCCESS);
+  }
+
+int decode_DIS_attrl(struct tcp_chan *chan, struct attrl **ppatt)
+  {
+  *ppatt = NULL;
+  return(DIS_SUCCESS);
+  }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan) {}
+
 void PBSD_FreeReply(struct batch_reply *reply)
   {
-  fprintf(stderr, "The call to PBSD_FreeReply needs to be mocked!!\n");
-  exit(1);
+  free(reply);
   }
 
-int PBSD_status_put(int c, int function, char *id, struct attrl *attrib, char *extend)
+int PBSD_status_put_flags(int c, int function, char *id, struct attrl *attrib, char *extend, int ext_flags)
   {
-  fprintf(stderr, "The call to PBSD_status_put needs to be mocked!!\n");
+  fprintf(stderr, "The call to PBSD_status_put_flags needs to be mocked!!\n");
   exit(1);
   }
 
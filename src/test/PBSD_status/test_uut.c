@@ -3,9 +3,16 @@
 #include "test_PBSD_status.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 #include "pbs_error.h"
+#include "libpbs.h"
+
+extern unsigned stream_uints[];
+extern int      stream_uint_count;
+extern int      stream_final_code;
+extern int      stream_objects;
 
 START_TEST(test_one)
   {
@@ -22,6 +29,46 @@ START_TEST(test_PBSD_status_get)
   }
 END_TEST
 
+START_TEST(test_PBSD_status_get_stream)
+  {
+  struct batch_status *bs;
+  unsigned             two_jobs[] = { 1, MGR_OBJ_JOB, 1, MGR_OBJ_JOB, 0 };
+  int                  local_errno = 0;
+
+  connection[1].ch_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(connection[1].ch_mutex, NULL);
+
+  memcpy(stream_uints, two_jobs, sizeof(two_jobs));
+  stream_uint_count = 5;
+  stream_final_code = PBSE_NONE;
+  stream_objects = 0;
+
+  bs = PBSD_status_get(&local_errno, 1);
+  fail_unless(local_errno == PBSE_NONE);
+  fail_unless(bs != NULL);
+  fail_unless(!strcmp(bs->name, "1.napali"));
+  fail_unless(bs->next != NULL);
+  fail_unless(!strcmp(bs->next->name, "2.napali"));
+  fail_unless(bs->next->next == NULL);
+  pbs_statfree(bs);
+
+  /* an error after some jobs were sent throws them away */
+  stream_final_code = PBSE_SYSTEM;
+  stream_objects = 0;
+
+  fail_unless(PBSD_status_get(&local_errno, 1) == NULL);
+  fail_unless(local_errno == PBSE_SYSTEM);
+
+  /* a stream cut short is a protocol error */
+  stream_uint_count = 3;
+  stream_final_code = PBSE_NONE;
+  stream_objects = 0;
+
+  fail_unless(PBSD_status_get(&local_errno, 1) == NULL);
+  fail_unless(local_errno == PBSE_PROTOCOL);
+  }
+END_TEST
+
 Suite *PBSD_status_suite(void)
   {
   Suite *s = suite_create("PBSD_status_suite methods");
@@ -31,6 +78,7 @@ Suite *PBSD_status_suite(void)
 
   tc_core = tcase_create("test_PBSD_status_get");
   tcase_add_test(tc_core, test_PBSD_status_get);
+  tcase_add_test(tc_core, test_PBSD_status_get_stream);
   suite_add_tcase(s, tc_core);
 
   return s;
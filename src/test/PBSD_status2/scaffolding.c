@@ -31,9 +31,9 @@ int encode_DIS_ReqHdr(struct tcp_chan *chan, int reqt, char *user)
   exit(1);
   }
 
-int encode_DIS_ReqExtend(struct tcp_chan *chan, char *extend)
+int encode_DIS_ReqExtend_flags(struct tcp_chan *chan, char *extend, int flags)
   {
-  fprintf(stderr, "The call to encode_DIS_ReqExtend needs to be mocked!!\n");
+  fprintf(stderr, "The call to encode_DIS_ReqExtend_flags needs to be mocked!!\n");
   exit(1);
   }
 
@@ -76,6 +76,16 @@ int encode_DIS_QueueJob_hash(struct tcp_chan *chan, char *jobid, char *destin, j
   return(0);
   }
 
+int encode_DIS_SubmitJob_hash(struct tcp_chan *chan, char *jobid, char *destin, job_data_container *job_attr, job_data_container *res_attr, char *script, size_t script_len)
+  {
+  return(0);
+  }
+
+int encode_DIS_SubmitMany_hash(struct tcp_chan *chan, int count, char **destins, job_data_container **job_attrs, job_data_container **res_attrs, char **scripts, size_t *script_lens)
+  {
+  return(0);
+  }
+
 void PBSD_FreeReply(struct batch_reply *reply)
   {
   fprintf(stderr, "The call to PBSD_FreeReply needs to be mocked!!\n");
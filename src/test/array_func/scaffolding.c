@@ -9,6 +9,7 @@
 #include "work_task.h" /* work_task */
 #include "array.h" /* job_array */
 #include "server.h" /* server */
+#include "threadpool.h" /* threadpool_t */
 
 const char *text_name              = "text";
 
@@ -19,6 +20,10 @@ const char *pbs_o_host = "PBS_O_HOST";
 struct server server;
 int LOGLEVEL = 7; /* force logging code to be exercised as tests run */
 int array_259_upgrade = 0;
+long idle_slot_limit = 0;
+int clones_enqueued = 0;
+threadpool_t *task_pool;
+attribute_def job_attr_def[10];
 
 int job_save(job *pjob, int updatetype, int mom_port)
   {
@@ -102,8 +107,15 @@ int attempt_delete(void *j)
 
 void append_link(tlist_head *head, list_link *new_link, void *pobj)
   {
-  fprintf(stderr, "The call to append_link needs to be mocked!!\n");
-  exit(1);
+  list_link *last = head;
+
+  while (last->ll_next != NULL)
+    last = last->ll_next;
+
+  last->ll_next = new_link;
+  new_link->ll_prior = last;
+  new_link->ll_next = NULL;
+  new_link->ll_struct = pobj;
   }
 
 bool set_array_depend_holds(job_array *pa)
@@ -143,8 +155,15 @@ void *get_prior(list_link pl, char *file, int line)
 
 void insert_link(struct list_link *old, struct list_link *new_link, void *pobj, int position)
   {
-  fprintf(stderr, "The call to insert_link needs to be mocked!!\n");
-  exit(1);
+  /* only LINK_INSET_AFTER is used */
+  new_link->ll_next = old->ll_next;
+  new_link->ll_prior = old;
+  new_link->ll_struct = pobj;
+
+  if (old->ll_next != NULL)
+    old->ll_next->ll_prior = new_link;
+
+  old->ll_next = new_link;
   }
 
 void *get_next(list_link pl, char *file, int line)
@@ -205,6 +224,8 @@ int get_svr_attr_l(int attr_index, long *l)
     
     *l = 5;
     }
+  else if (attr_index == SRV_ATR_IdleSlotLimit)
+    *l = idle_slot_limit;
 
   return(0);
   }
@@ -296,3 +317,20 @@ int unlock_ss()
     }
 
 std::string get_path_jobdata(const char *a, const char *b) {return ""; }
+
+void *job_clone_wt(void *vp)
+  {
+  return(NULL);
+  }
+
+int enqueue_threadpool_request(void *(*func)(void *), void *arg, threadpool_t *tp)
+  {
+  clones_enqueued++;
+  free(arg);
+  return(0);
+  }
+
+job *clone_subjob_now(job_array **pa_ptr, int index)
+  {
+  return(NULL);
+  }
@@ -3,6 +3,7 @@
 #include "test_uut.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 #include "pbs_error.h"
 #include <libxml/parser.h>
 #include <libxml/tree.h>
@@ -17,6 +18,23 @@ void update_array_values(job_array *pa, int old_state, enum ArrayEventsEnum even
 extern std::string get_path_jobdata(const char *, const char *);
 const char *array_sample = "<array>\n</array>";
 extern char *path_arrays;
+extern long idle_slot_limit;
+extern int clones_enqueued;
+
+
+void add_token(
+
+  job_array *pa,
+  int        start,
+  int        end)
+
+  {
+  array_request_node *rn = (array_request_node *)calloc(1, sizeof(array_request_node));
+
+  rn->start = start;
+  rn->end = end;
+  append_link(&pa->request_tokens, &rn->request_tokens_link, rn);
+  }
 
 
 START_TEST(update_array_values_test)
@@ -38,6 +56,98 @@ START_TEST(update_array_values_test)
 END_TEST
 
 
+START_TEST(clone_more_subjobs_test)
+  {
+  job_array  *pa = (job_array *)calloc(1, sizeof(job_array));
+  const char *job_id = "1[0].napali";
+
+  pa->ai_qs.num_jobs = 10;
+  pa->num_idle = 2;
+  idle_slot_limit = 2;
+  clones_enqueued = 0;
+  add_token(pa, 2, 9);
+
+  // at the limit, nothing more is cloned
+  clone_more_subjobs(pa);
+  fail_unless(clones_enqueued == 0);
+
+  // a job starting makes room for another
+  update_array_values(pa, JOB_STATE_QUEUED, aeRun, job_id, -1, -1);
+  fail_unless(pa->num_idle == 1);
+  fail_unless(clones_enqueued == 1);
+  fail_unless(pa->cloning == true);
+
+  // only one clone task at a time
+  update_array_values(pa, JOB_STATE_QUEUED, aeRun, job_id, -1, -1);
+  fail_unless(pa->num_idle == 0);
+  fail_unless(clones_enqueued == 1);
+
+  update_array_values(pa, JOB_STATE_RUNNING, aeRerun, job_id, -1, -1);
+  fail_unless(pa->num_idle == 1);
+
+  // no limit clones everything
+  pa->cloning = false;
+  pa->num_idle = 5;
+  idle_slot_limit = 0;
+  clone_more_subjobs(pa);
+  fail_unless(clones_enqueued == 2);
+
+  idle_slot_limit = 0;
+  }
+END_TEST
+
+
+START_TEST(uncloned_range_test)
+  {
+  job_array          *pa = (job_array *)calloc(1, sizeof(job_array));
+  array_request_node *rn;
+  char                parent_id[PBS_MAXSVRJOBID + 1];
+  const char         *subjob = "12[3].napali";
+  const char         *parent = "12[].napali";
+  const char         *plain = "12.napali";
+  const char         *bad_index = "12[3x].napali";
+
+  fail_unless(get_subjob_index(subjob, parent_id) == 3);
+  fail_unless(strcmp(parent_id, parent) == 0);
+  fail_unless(get_subjob_index(parent, parent_id) == -1);
+  fail_unless(get_subjob_index(plain, parent_id) == -1);
+  fail_unless(get_subjob_index(bad_index, parent_id) == -1);
+
+  add_token(pa, 0, 9);
+  add_token(pa, 20, 29);
+
+  // splits the first token
+  fail_unless(remove_uncloned_range(pa, 4, 5) == 2);
+  fail_unless(is_uncloned_index(pa, 3) == true);
+  fail_unless(is_uncloned_index(pa, 4) == false);
+  fail_unless(is_uncloned_index(pa, 5) == false);
+  fail_unless(is_uncloned_index(pa, 6) == true);
+
+  rn = (array_request_node *)GET_NEXT(pa->request_tokens);
+  fail_unless((rn->start == 0) && (rn->end == 3));
+  rn = (array_request_node *)GET_NEXT(rn->request_tokens_link);
+  fail_unless((rn->start == 6) && (rn->end == 9));
+
+  // trims the end of one token and the start of the next, nothing is in between
+  fail_unless(remove_uncloned_range(pa, 8, 21) == 4);
+  fail_unless(remove_uncloned_range(pa, 10, 19) == 0);
+
+  // takes the indices out lowest first
+  fail_unless(next_uncloned_index(pa) == 0);
+  fail_unless(next_uncloned_index(pa) == 1);
+
+  // removes whole tokens
+  fail_unless(remove_uncloned_range(pa, 0, 7) == 4);
+  rn = (array_request_node *)GET_NEXT(pa->request_tokens);
+  fail_unless((rn->start == 22) && (rn->end == 29));
+
+  fail_unless(remove_uncloned_range(pa, 0, INT_MAX) == 8);
+  fail_unless(GET_NEXT(pa->request_tokens) == NULL);
+  fail_unless(next_uncloned_index(pa) == -1);
+  }
+END_TEST
+
+
 START_TEST(parse_array_dom_test)
   {
   xmlDocPtr doc = xmlReadMemory(array_sample, strlen(array_sample), "array", NULL, 0);
@@ -261,6 +371,8 @@ Suite *array_func_suite(void)
   tc_core = tcase_create("array_recov_binary_test");
   tcase_add_test(tc_core, array_recov_binary_test);
   tcase_add_test(tc_core, update_array_values_test);
+  tcase_add_test(tc_core, clone_more_subjobs_test);
+  tcase_add_test(tc_core, uncloned_range_test);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -3,6 +3,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <stddef.h>
+
 #include "attribute.h"
 #include "pbs_error.h"
 
@@ -47,6 +49,46 @@ START_TEST(test_one)
   }
 END_TEST
 
+START_TEST(test_find_def_index)
+  {
+  attribute_def defa[4];
+  attribute_def defb[4];
+
+  memset(defa, 0, sizeof(defa));
+  defa[0].at_name = "Hello There.";
+  defa[1].at_name = "hello";
+  defa[2].at_name = "HELLO";
+  defa[3].at_name = "Howdy Pard.";
+
+  // the first of several names that match is returned
+  fail_unless(find_attr(defa, "HeLlo", 4) == 1);
+  fail_unless(find_attr(defa, "howdy pard.", 4) == 3);
+  fail_unless(find_attr(defa, "howdy", 4) == -1);
+  fail_unless(find_attr(defa, NULL, 4) == -1);
+  fail_unless(find_attr(NULL, "hello", 4) == -1);
+
+  // a different limit is a different table
+  fail_unless(find_attr(defa, "Howdy Pard.", 3) == -1);
+
+  // case sensitive lookups do not share the case insensitive table
+  fail_unless(find_def_index(defa, 4, sizeof(attribute_def),
+                offsetof(attribute_def, at_name), false, "HELLO") == 2);
+  fail_unless(find_def_index(defa, 4, sizeof(attribute_def),
+                offsetof(attribute_def, at_name), false, "Hello") == -1);
+
+  // new contents at the same address are noticed
+  defa[0].at_name = "first";
+  defa[3].at_name = "last";
+  fail_unless(find_attr(defa, "last", 4) == 3);
+  fail_unless(find_attr(defa, "Howdy Pard.", 4) == -1);
+
+  // many definition arrays can be searched
+  memcpy(defb, defa, sizeof(defb));
+  for (int i = 1; i <= 4; i++)
+    fail_unless(find_attr(defb, "first", i) == 0);
+  }
+END_TEST
+
 START_TEST(test_two)
   {
   svrattrl *attrl = attrlist_create("Fred","Wilma",20);
@@ -122,6 +164,7 @@ Suite *attr_func_suite(void)
 
   tc_core = tcase_create("test_two");
   tcase_add_test(tc_core, test_two);
+  tcase_add_test(tc_core, test_find_def_index);
   suite_add_tcase(s, tc_core);
 
   tc_core = tcase_create("test_three");
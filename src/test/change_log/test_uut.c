@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "change_log.hpp"
+#include "pbs_ifl.h"
+#include <check.h>
+
+
+
+START_TEST(test_next_current)
+  {
+  change_log cl(1000, 10);
+
+  fail_unless(cl.current() == 1000);
+  fail_unless(cl.next() == 1001);
+  fail_unless(cl.next() == 1002);
+  fail_unless(cl.current() == 1002);
+  }
+END_TEST
+
+
+
+START_TEST(test_get_deletions)
+  {
+  change_log               cl(1000, 10);
+  std::vector<std::string> names;
+  long long                before;
+
+  cl.record_deletion(MGR_OBJ_JOB, "1.napali", "batch");
+  cl.record_deletion(MGR_OBJ_JOB, "1.napali", NULL);
+  before = cl.current();
+  cl.record_deletion(MGR_OBJ_NODE, "waimea", NULL);
+  cl.record_deletion(MGR_OBJ_JOB, "2.napali", "");
+
+  // everything since the start
+  fail_unless(cl.get_deletions(MGR_OBJ_JOB, NULL, 1000, names) == true);
+  fail_unless(names.size() == 2);
+  fail_unless(names[0] == "1.napali");
+  fail_unless(names[1] == "2.napali");
+
+  names.clear();
+  fail_unless(cl.get_deletions(MGR_OBJ_JOB, "batch", 1000, names) == true);
+  fail_unless(names.size() == 1);
+
+  // only the ones after before
+  names.clear();
+  fail_unless(cl.get_deletions(MGR_OBJ_JOB, "", before, names) == true);
+  fail_unless(names.size() == 1);
+  fail_unless(names[0] == "2.napali");
+
+  names.clear();
+  fail_unless(cl.get_deletions(MGR_OBJ_NODE, NULL, before, names) == true);
+  fail_unless(names.size() == 1);
+  fail_unless(names[0] == "waimea");
+
+  names.clear();
+  fail_unless(cl.get_deletions(MGR_OBJ_QUEUE, NULL, before, names) == true);
+  fail_unless(names.size() == 0);
+
+  // from before the start and not handed out yet
+  fail_unless(cl.get_deletions(MGR_OBJ_JOB, NULL, 999, names) == false);
+  fail_unless(cl.get_deletions(MGR_OBJ_JOB, NULL, cl.current() + 1, names) == false);
+  fail_unless(cl.get_deletions(MGR_OBJ_JOB, NULL, cl.current(), names) == true);
+  fail_unless(names.size() == 0);
+  }
+END_TEST
+
+
+
+START_TEST(test_dropped_deletions)
+  {
+  change_log               cl(1000, 2);
+  std::vector<std::string> names;
+  long long                first;
+
+  cl.record_deletion(MGR_OBJ_QUEUE, "batch", NULL);
+  first = cl.current();
+  cl.record_deletion(MGR_OBJ_QUEUE, "debug", NULL);
+  cl.record_deletion(MGR_OBJ_QUEUE, "long", NULL);
+
+  // "batch" was dropped, so changes from before it are gone
+  fail_unless(cl.get_deletions(MGR_OBJ_QUEUE, NULL, 1000, names) == false);
+  fail_unless(names.size() == 0);
+
+  fail_unless(cl.get_deletions(MGR_OBJ_QUEUE, NULL, first, names) == true);
+  fail_unless(names.size() == 2);
+  fail_unless(names[0] == "debug");
+  fail_unless(names[1] == "long");
+  }
+END_TEST
+
+
+
+Suite *change_log_suite(void)
+  {
+  Suite *s = suite_create("change_log test suite methods");
+  TCase *tc_core = tcase_create("test_next_current");
+  tcase_add_test(tc_core, test_next_current);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_get_deletions");
+  tcase_add_test(tc_core, test_get_deletions);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_dropped_deletions");
+  tcase_add_test(tc_core, test_dropped_deletions);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(change_log_suite());
+  srunner_set_log(sr, "change_log_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
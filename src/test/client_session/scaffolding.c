@@ -0,0 +1,89 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "server_limits.h" /* PBS_NET_MAX_CONNECTIONS */
+#include "batch_request.h"
+#include "net_connect.h"
+#include "threadpool.h"
+#include "dis.h"
+#include "tcp.h"
+
+int               LOGLEVEL = 7; /* force logging code to be exercised as tests run */
+threadpool_t     *request_pool;
+struct connection svr_conn[PBS_NET_MAX_CONNECTIONS];
+
+int          rejected = 0;
+int          acked = 0;
+int          enqueued = 0;
+int          enqueue_rc = 0;
+int          flush_rc = 0;
+int          written_encoding = -1;
+unsigned int written_tag = 0;
+int          tag_encoding = -1;
+
+void req_reject(int code, int aux, struct batch_request *preq, const char *HostName, const char *Msg)
+  {
+  rejected = code;
+  }
+
+void reply_ack(struct batch_request *preq)
+  {
+  acked++;
+  }
+
+int enqueue_threadpool_request(void *(*func)(void *), void *arg, threadpool_t *tp)
+  {
+  if (enqueue_rc == 0)
+    enqueued++;
+
+  return(enqueue_rc);
+  }
+
+int dispatch_request(int sfds, struct batch_request *request)
+  {
+  return(0);
+  }
+
+struct tcp_chan *DIS_tcp_setup(int fd)
+  {
+  struct tcp_chan *chan = (struct tcp_chan *)calloc(1, sizeof(struct tcp_chan));
+
+  chan->sock = fd;
+
+  return(chan);
+  }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan)
+  {
+  free(chan);
+  }
+
+int DIS_tcp_wflush(struct tcp_chan *chan)
+  {
+  return(flush_rc);
+  }
+
+int diswui(struct tcp_chan *chan, unsigned value)
+  {
+  written_tag = value;
+  tag_encoding = chan->encoding;
+
+  return(0);
+  }
+
+int diswul(struct tcp_chan *chan, unsigned long value)
+  {
+  return(diswui(chan, (unsigned)value));
+  }
+
+int encode_DIS_reply(struct tcp_chan *chan, struct batch_reply *reply)
+  {
+  written_encoding = chan->encoding;
+
+  return(0);
+  }
+
+void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _CLIENT_SESSION_CT_H
+#define _CLIENT_SESSION_CT_H
+#include <check.h>
+
+Suite *client_session_suite();
+
+#endif /* _CLIENT_SESSION_CT_H */
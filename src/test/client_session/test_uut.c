@@ -0,0 +1,193 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+#include "client_session.h"
+#include "test_client_session.h"
+#include "pbs_error.h"
+#include "batch_request.h"
+#include "libpbs.h"
+#include "net_connect.h"
+#include "dis.h"
+
+extern struct connection svr_conn[];
+extern int          rejected;
+extern int          acked;
+extern int          enqueued;
+extern int          enqueue_rc;
+extern int          flush_rc;
+extern int          written_encoding;
+extern unsigned int written_tag;
+extern int          tag_encoding;
+
+
+client_session *open_session(int sock, batch_request &preq)
+  {
+  if (svr_conn[sock].cn_mutex == NULL)
+    svr_conn[sock].cn_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+
+  svr_conn[sock].cn_session = NULL;
+
+  memset(&preq, 0, sizeof(preq));
+  preq.rq_conn = sock;
+  preq.rq_type = PBS_BATCH_OpenSession;
+
+  rejected = 0;
+  acked = 0;
+
+  fail_unless(req_opensession(&preq) == PBSE_NONE);
+
+  return(svr_conn[sock].cn_session);
+  }
+
+
+START_TEST(test_req_opensession)
+  {
+  batch_request   preq;
+  client_session *cs = open_session(5, preq);
+
+  fail_unless(cs != NULL);
+  fail_unless(cs->cs_sock == 5);
+  fail_unless(cs->cs_refs == 1);
+  fail_unless(acked == 1);
+
+  /* one session per connection */
+  fail_unless(req_opensession(&preq) == PBSE_IVALREQ);
+  fail_unless(rejected == PBSE_IVALREQ);
+  fail_unless(svr_conn[5].cn_session == cs);
+
+  preq.rq_session = cs;
+  rejected = 0;
+  fail_unless(req_opensession(&preq) == PBSE_IVALREQ);
+  fail_unless(rejected == PBSE_IVALREQ);
+
+  preq.rq_conn = -1;
+  preq.rq_session = NULL;
+  fail_unless(req_opensession(&preq) == PBSE_IVALREQ);
+
+  session_hold(cs);
+  fail_unless(cs->cs_refs == 2);
+
+  /* the requests still out keep it after the client is gone */
+  session_close(cs);
+  fail_unless(cs->cs_refs == 1);
+  fail_unless(cs->cs_closed == TRUE);
+
+  session_release(cs);
+  }
+END_TEST
+
+
+START_TEST(test_session_dispatch)
+  {
+  batch_request   preq;
+  client_session *cs = open_session(6, preq);
+
+  preq.rq_session = cs;
+  enqueued = 0;
+  enqueue_rc = 0;
+
+  preq.rq_type = PBS_BATCH_StatusJob;
+  fail_unless(session_dispatch(&preq) == true);
+  preq.rq_type = PBS_BATCH_DeleteJob;
+  fail_unless(session_dispatch(&preq) == true);
+  fail_unless(enqueued == 2);
+
+  /* the steps of queueing a job share the connection's state */
+  preq.rq_type = PBS_BATCH_QueueJob;
+  fail_unless(session_dispatch(&preq) == false);
+  preq.rq_type = PBS_BATCH_Manager;
+  fail_unless(session_dispatch(&preq) == false);
+  fail_unless(enqueued == 2);
+
+  /* a full pool leaves it to the caller */
+  enqueue_rc = ENOMEM;
+  preq.rq_type = PBS_BATCH_StatusNode;
+  fail_unless(session_dispatch(&preq) == false);
+  enqueue_rc = 0;
+
+  session_close(cs);
+  }
+END_TEST
+
+
+START_TEST(test_session_reply_write)
+  {
+  batch_request   preq;
+  client_session *cs;
+  int             sv[2];
+  char            buf[8];
+
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+  cs = open_session(sv[0], preq);
+  preq.rq_session = cs;
+  preq.rq_tag = 42;
+  preq.rq_encoding = DIS_ENCODING_BINARY;
+  flush_rc = 0;
+
+  /* the tag is always classic, the reply as the request asked */
+  fail_unless(session_reply_write(&preq) == PBSE_NONE);
+  fail_unless(written_tag == 42);
+  fail_unless(tag_encoding == DIS_ENCODING_CLASSIC);
+  fail_unless(written_encoding == DIS_ENCODING_BINARY);
+
+  /* a reply that can't be sent ends the session */
+  flush_rc = DIS_PROTO;
+  fail_unless(session_reply_write(&preq) != PBSE_NONE);
+  fail_unless(recv(sv[1], buf, sizeof(buf), MSG_DONTWAIT) == 0);
+  flush_rc = 0;
+
+  /* nothing is sent once the client is gone */
+  session_hold(cs);
+  session_close(cs);
+  written_tag = 0;
+  fail_unless(session_reply_write(&preq) == PBSE_SOCKET_CLOSE);
+  fail_unless(written_tag == 0);
+
+  session_release(cs);
+  close(sv[0]);
+  close(sv[1]);
+  }
+END_TEST
+
+
+Suite *client_session_suite(void)
+  {
+  Suite *s = suite_create("client_session_suite methods");
+  TCase *tc_core = tcase_create("test_req_opensession");
+  tcase_add_test(tc_core, test_req_opensession);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_session_dispatch");
+  tcase_add_test(tc_core, test_session_dispatch);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_session_reply_write");
+  tcase_add_test(tc_core, test_session_reply_write);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(client_session_suite());
+  srunner_set_log(sr, "client_session_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
@@ -1,18 +1,44 @@
 #include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>   /* the master config generated by configure */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <string.h>
 
 #include "tcp.h"
 #include "list_link.h" /* tlist_head */
+#include "dis.h"
+
+const char *script_to_read = NULL;
+int         disrcs_rc = DIS_SUCCESS;
+unsigned long count_to_read = 0;
 
 int decode_DIS_svrattrl(tcp_chan *chan, tlist_head *phead)
   {
-  fprintf(stderr, "The call to decode_DIS_svrattrl needs to be mocked!!\n");
-  exit(1);
+  return(0);
   }
 
 int disrfst(tcp_chan *chan, size_t achars, char *value)
   {
-  fprintf(stderr, "The call to disrfst needs to be mocked!!\n");
-  exit(1);
+  value[0] = '\0';
+  return(0);
+  }
+
+char *disrcs(tcp_chan *chan, size_t *nchars, int *retval)
+  {
+  *retval = disrcs_rc;
+
+  if (script_to_read == NULL)
+    {
+    *nchars = 0;
+    return(NULL);
+    }
+
+  *nchars = strlen(script_to_read);
+  return(strdup(script_to_read));
+  }
+
+unsigned disrui(tcp_chan *chan, int *retval)
+  {
+  *retval = DIS_SUCCESS;
+  return(count_to_read);
   }
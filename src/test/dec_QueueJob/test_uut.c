@@ -3,33 +3,106 @@
 #include "test_dec_QueueJob.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
-
+#include "list_link.h"
+#include "attribute.h"
+#include "batch_request.h"
+#include "dis.h"
 #include "pbs_error.h"
+#include "libpbs.h"
+
+extern const char *script_to_read;
+extern int         disrcs_rc;
+extern unsigned long count_to_read;
 
-START_TEST(test_one)
+START_TEST(test_decode_DIS_SubmitJob)
   {
+  struct batch_request preq;
+
+  memset(&preq, 0, sizeof(preq));
+  script_to_read = "#!/bin/sh\nhostname\n";
+  disrcs_rc = DIS_SUCCESS;
 
+  fail_unless(decode_DIS_SubmitJob(NULL, &preq) == DIS_SUCCESS);
+  fail_unless(preq.rq_ind.rq_submitjob.rq_scriptsz == strlen(script_to_read));
+  fail_unless(!strcmp(preq.rq_ind.rq_submitjob.rq_script, script_to_read));
+  free(preq.rq_ind.rq_submitjob.rq_script);
 
+  /* a job without a script */
+  memset(&preq, 0, sizeof(preq));
+  script_to_read = NULL;
+
+  fail_unless(decode_DIS_SubmitJob(NULL, &preq) == DIS_SUCCESS);
+  fail_unless(preq.rq_ind.rq_submitjob.rq_scriptsz == 0);
   }
 END_TEST
 
-START_TEST(test_two)
+START_TEST(test_decode_DIS_SubmitJob_bad_script)
   {
+  struct batch_request preq;
 
+  memset(&preq, 0, sizeof(preq));
+  script_to_read = "#!/bin/sh\n";
+  disrcs_rc = DIS_EOD;
 
+  fail_unless(decode_DIS_SubmitJob(NULL, &preq) == DIS_EOD);
+  fail_unless(preq.rq_ind.rq_submitjob.rq_script == NULL);
+  fail_unless(preq.rq_ind.rq_submitjob.rq_scriptsz == 0);
+  }
+END_TEST
+
+START_TEST(test_decode_DIS_SubmitMany)
+  {
+  struct batch_request preq;
+  int                  i;
+
+  memset(&preq, 0, sizeof(preq));
+  script_to_read = "#!/bin/sh\nhostname\n";
+  disrcs_rc = DIS_SUCCESS;
+
+  count_to_read = 0;
+  fail_unless(decode_DIS_SubmitMany(NULL, &preq) == DIS_PROTO);
+  fail_unless(preq.rq_ind.rq_submitmany.rq_jobs == NULL);
+
+  count_to_read = SUBMIT_MANY_MAX + 1;
+  fail_unless(decode_DIS_SubmitMany(NULL, &preq) == DIS_PROTO);
+  fail_unless(preq.rq_ind.rq_submitmany.rq_jobs == NULL);
+
+  count_to_read = 3;
+  fail_unless(decode_DIS_SubmitMany(NULL, &preq) == DIS_SUCCESS);
+  fail_unless(preq.rq_ind.rq_submitmany.rq_count == 3);
+
+  for (i = 0; i < 3; i++)
+    {
+    fail_unless(!strcmp(preq.rq_ind.rq_submitmany.rq_jobs[i].rq_script, script_to_read));
+    free(preq.rq_ind.rq_submitmany.rq_jobs[i].rq_script);
+    }
+
+  free(preq.rq_ind.rq_submitmany.rq_jobs);
+
+  /* a failure part way through still counts the job being decoded */
+  memset(&preq, 0, sizeof(preq));
+  disrcs_rc = DIS_EOD;
+  fail_unless(decode_DIS_SubmitMany(NULL, &preq) == DIS_EOD);
+  fail_unless(preq.rq_ind.rq_submitmany.rq_count == 1);
+  free(preq.rq_ind.rq_submitmany.rq_jobs);
   }
 END_TEST
 
 Suite *dec_QueueJob_suite(void)
   {
   Suite *s = suite_create("dec_QueueJob_suite methods");
-  TCase *tc_core = tcase_create("test_one");
-  tcase_add_test(tc_core, test_one);
+  TCase *tc_core = tcase_create("test_decode_DIS_SubmitJob");
+  tcase_add_test(tc_core, test_decode_DIS_SubmitJob);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_decode_DIS_SubmitJob_bad_script");
+  tcase_add_test(tc_core, test_decode_DIS_SubmitJob_bad_script);
   suite_add_tcase(s, tc_core);
 
-  tc_core = tcase_create("test_two");
-  tcase_add_test(tc_core, test_two);
+  tc_core = tcase_create("test_decode_DIS_SubmitMany");
+  tcase_add_test(tc_core, test_decode_DIS_SubmitMany);
   suite_add_tcase(s, tc_core);
 
   return s;
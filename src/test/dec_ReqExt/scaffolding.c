@@ -1,16 +1,20 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <string.h>
 #include "tcp.h"
 
+unsigned    extend_marker = 0;
+const char *extend_string = NULL;
+
 char *disrst(tcp_chan *chan, int *retval)
   {
-  fprintf(stderr, "The call to disrst needs to be mocked!!\n");
-  exit(1);
+  *retval = 0;
+  return(strdup(extend_string));
   }
 
 unsigned disrui(tcp_chan *chan, int *retval)
   {
-  fprintf(stderr, "The call to disrui needs to be mocked!!\n");
-  exit(1);
+  *retval = 0;
+  return(extend_marker);
   }
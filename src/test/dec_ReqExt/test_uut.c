@@ -3,9 +3,15 @@
 #include "test_dec_ReqExt.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 #include "pbs_error.h"
+#include "libpbs.h"
+#include "batch_request.h"
+
+extern unsigned    extend_marker;
+extern const char *extend_string;
 
 START_TEST(test_one)
   {
@@ -21,6 +27,37 @@ START_TEST(test_two)
   }
 END_TEST
 
+START_TEST(test_decode_DIS_ReqExtend_flags)
+  {
+  struct batch_request preq;
+
+  /* the old form, just a string */
+  memset(&preq, 0, sizeof(preq));
+  extend_marker = 1;
+  extend_string = "truncated";
+  fail_unless(decode_DIS_ReqExtend(NULL, &preq) == 0);
+  fail_unless(!strcmp(preq.rq_extend, "truncated"));
+  fail_unless(preq.rq_extflags == REQ_EXTEND_STRING);
+  free(preq.rq_extend);
+
+  /* flags and the caller's string */
+  memset(&preq, 0, sizeof(preq));
+  extend_marker = REQ_EXTEND_STRING | REQ_EXTEND_STREAM;
+  fail_unless(decode_DIS_ReqExtend(NULL, &preq) == 0);
+  fail_unless(!strcmp(preq.rq_extend, "truncated"));
+  fail_unless((preq.rq_extflags & REQ_EXTEND_STREAM) != 0);
+  free(preq.rq_extend);
+
+  /* flags with a placeholder */
+  memset(&preq, 0, sizeof(preq));
+  extend_marker = REQ_EXTEND_STREAM;
+  extend_string = "flags";
+  fail_unless(decode_DIS_ReqExtend(NULL, &preq) == 0);
+  fail_unless(preq.rq_extend == NULL);
+  fail_unless(preq.rq_extflags == REQ_EXTEND_STREAM);
+  }
+END_TEST
+
 Suite *dec_ReqExt_suite(void)
   {
   Suite *s = suite_create("dec_ReqExt_suite methods");
@@ -32,6 +69,10 @@ Suite *dec_ReqExt_suite(void)
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_decode_DIS_ReqExtend_flags");
+  tcase_add_test(tc_core, test_decode_DIS_ReqExtend_flags);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -0,0 +1,9 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _DISRVI__CT_H
+#define _DISRVI__CT_H
+#include <check.h>
+
+#define DISRVI__SUITE 1
+Suite *disrvi__suite();
+
+#endif /* _DISRVI__CT_H */
@@ -0,0 +1,130 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "test_disrvi_.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "dis_internal.h"
+#include "dis.h"
+#include "pbs_error.h"
+#include "tcp.h"
+
+void DIS_tcp_reset(struct tcp_chan *chan, int i);
+
+/* make bytes available on the read side of chan */
+
+void set_read_data(
+
+  struct tcp_chan     *chan,
+  const unsigned char *data,
+  size_t               len)
+
+  {
+  memcpy(chan->readbuf.tdis_thebuf, data, len);
+  chan->readbuf.tdis_leadp = chan->readbuf.tdis_thebuf;
+  chan->readbuf.tdis_trailp = chan->readbuf.tdis_thebuf;
+  chan->readbuf.tdis_eod = chan->readbuf.tdis_thebuf + len;
+  }
+
+
+
+START_TEST(test_disrvi_)
+  {
+  struct tcp_chan     *chan = DIS_tcp_setup(20);
+  int                  negate = 0;
+  unsigned long        value = 0;
+  const unsigned char  small[] = { 0x3f, 0x41, 0x80, 0x01 };
+
+  fail_unless(chan != NULL);
+
+  fail_unless(disrvi_(chan, NULL, &value, 0) == DIS_INVALID);
+  fail_unless(disrvi_(chan, &negate, NULL, 0) == DIS_INVALID);
+
+  set_read_data(chan, small, sizeof(small));
+
+  fail_unless(disrvi_(chan, &negate, &value, 0) == DIS_SUCCESS);
+  fail_unless(negate == FALSE);
+  fail_unless(value == 63);
+
+  fail_unless(disrvi_(chan, &negate, &value, 0) == DIS_SUCCESS);
+  fail_unless(negate == TRUE);
+  fail_unless(value == 1);
+
+  /* bytes with the high bit set must not be taken as errors */
+  fail_unless(disrvi_(chan, &negate, &value, 0) == DIS_SUCCESS);
+  fail_unless(negate == FALSE);
+  fail_unless(value == 64);
+
+  DIS_tcp_cleanup(chan);
+  }
+END_TEST
+
+
+
+START_TEST(test_disrvi_overflow)
+  {
+  struct tcp_chan *chan = DIS_tcp_setup(21);
+  int              negate = 1;
+  unsigned long    value = 0;
+  unsigned char    big[16];
+  unsigned         uvalue = 0;
+
+  fail_unless(chan != NULL);
+
+  /* more magnitude bits than an unsigned long holds */
+  memset(big, 0xff, sizeof(big));
+  big[sizeof(big) - 1] = 0x01;
+  set_read_data(chan, big, sizeof(big));
+
+  fail_unless(disrvi_(chan, &negate, &value, 0) == DIS_OVERFLOW);
+  fail_unless(negate == FALSE);
+  fail_unless(value == ULONG_MAX);
+
+  /* fits an unsigned long, but not the unsigned disrsi_() returns */
+  chan->encoding = DIS_ENCODING_BINARY;
+  DIS_tcp_reset(chan, 1);
+  fail_unless(diswvi_(chan, FALSE, (unsigned long)UINT_MAX + 1) == DIS_SUCCESS);
+  set_read_data(chan,
+    (unsigned char *)chan->writebuf.tdis_thebuf,
+    chan->writebuf.tdis_leadp - chan->writebuf.tdis_thebuf);
+
+  fail_unless(disrsi_(chan, &negate, &uvalue, 1, 0) == DIS_OVERFLOW);
+  fail_unless(uvalue == UINT_MAX);
+
+  DIS_tcp_cleanup(chan);
+  }
+END_TEST
+
+
+
+Suite *disrvi__suite(void)
+  {
+  Suite *s = suite_create("disrvi__suite methods");
+  TCase *tc_core = tcase_create("test_disrvi_");
+  tcase_add_test(tc_core, test_disrvi_);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_disrvi_overflow");
+  tcase_add_test(tc_core, test_disrvi_overflow);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(disrvi__suite());
+  srunner_set_log(sr, "disrvi__suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
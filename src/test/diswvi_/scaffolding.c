@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "tcp.h"
+#include "dis_internal.h"
+
+/* the tcp layer comes from libtorque_test */
@@ -0,0 +1,9 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _DISWVI__CT_H
+#define _DISWVI__CT_H
+#include <check.h>
+
+#define DISWVI__SUITE 1
+Suite *diswvi__suite();
+
+#endif /* _DISWVI__CT_H */
@@ -0,0 +1,399 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>
+#include "test_diswvi_.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#include "dis_internal.h"
+#include "dis.h"
+#include "pbs_error.h"
+#include "tcp.h"
+
+void DIS_tcp_reset(struct tcp_chan *chan, int i);
+
+#define BENCH_JOBS 2000
+
+/* a typical full job status: attribute, resource, value */
+const char *job_status[][3] =
+  {
+  { "Job_Name", NULL, "run32_.2557" },
+  { "Job_Owner", NULL, "user1@login1" },
+  { "resources_used", "cput", "00:12:44" },
+  { "resources_used", "energy_used", "0" },
+  { "resources_used", "mem", "1934520kb" },
+  { "resources_used", "vmem", "2466716kb" },
+  { "resources_used", "walltime", "00:13:05" },
+  { "job_state", NULL, "R" },
+  { "queue", NULL, "batch" },
+  { "server", NULL, "napali.ac" },
+  { "Checkpoint", NULL, "u" },
+  { "ctime", NULL, "1476463624" },
+  { "Error_Path", NULL, "napali.ac:/home/user1/run32_.e2557" },
+  { "exec_host", NULL, "n012/0-15+n013/0-15" },
+  { "Hold_Types", NULL, "n" },
+  { "Join_Path", NULL, "n" },
+  { "Keep_Files", NULL, "n" },
+  { "Mail_Points", NULL, "a" },
+  { "mtime", NULL, "1476463702" },
+  { "Output_Path", NULL, "napali.ac:/home/user1/run32_.o2557" },
+  { "Priority", NULL, "0" },
+  { "qtime", NULL, "1476463624" },
+  { "Rerunable", NULL, "True" },
+  { "Resource_List", "nodes", "2:ppn=16" },
+  { "Resource_List", "walltime", "01:00:00" },
+  { "session_id", NULL, "48213" },
+  { "euser", NULL, "user1" },
+  { "egroup", NULL, "users" },
+  { "queue_type", NULL, "E" },
+  { "etime", NULL, "1476463624" },
+  { "submit_args", NULL, "-l nodes=2:ppn=16 run32.sh" },
+  { "start_time", NULL, "1476463625" },
+  { "start_count", NULL, "1" },
+  { "job_radix", NULL, "0" },
+  };
+
+const int job_status_count = sizeof(job_status) / sizeof(job_status[0]);
+
+
+
+/* hand what was written on chan to its read side */
+
+void loop_back(
+
+  struct tcp_chan *chan)
+
+  {
+  size_t len = chan->writebuf.tdis_trailp - chan->writebuf.tdis_thebuf;
+
+  memcpy(chan->readbuf.tdis_thebuf, chan->writebuf.tdis_thebuf, len);
+  chan->readbuf.tdis_leadp = chan->readbuf.tdis_thebuf;
+  chan->readbuf.tdis_trailp = chan->readbuf.tdis_thebuf;
+  chan->readbuf.tdis_eod = chan->readbuf.tdis_thebuf + len;
+
+  DIS_tcp_reset(chan, 1);
+  }
+
+
+
+/* encode a status object the way encode_DIS_status() and
+ * encode_DIS_svrattrl() lay it out */
+
+int encode_job_status(
+
+  struct tcp_chan *chan,
+  int              job)
+
+  {
+  char name[64];
+  int  rc;
+
+  snprintf(name, sizeof(name), "%d.napali.ac", job);
+
+  if ((rc = diswui(chan, 2)) ||
+      (rc = diswst(chan, name)) ||
+      (rc = diswui(chan, job_status_count)))
+    return(rc);
+
+  for (int i = 0; i < job_status_count; i++)
+    {
+    const char *resc = job_status[i][1];
+    unsigned    len = strlen(job_status[i][0]) + strlen(job_status[i][2]) + 2;
+
+    if (resc != NULL)
+      len += strlen(resc) + 1;
+
+    if ((rc = diswui(chan, len)) ||
+        (rc = diswst(chan, job_status[i][0])) ||
+        (rc = diswui(chan, resc != NULL)) ||
+        ((resc != NULL) && (rc = diswst(chan, resc))) ||
+        (rc = diswst(chan, job_status[i][2])) ||
+        (rc = diswui(chan, 0)))
+      return(rc);
+    }
+
+  return(DIS_SUCCESS);
+  }
+
+
+
+int decode_job_status(
+
+  struct tcp_chan *chan)
+
+  {
+  char     *str;
+  int       rc;
+  unsigned  count;
+
+  if ((disrui(chan, &rc) != 2) || rc)
+    return(DIS_PROTO);
+
+  if ((str = disrst(chan, &rc)) == NULL)
+    return(rc);
+
+  free(str);
+
+  count = disrui(chan, &rc);
+
+  if ((rc != DIS_SUCCESS) ||
+      ((int)count != job_status_count))
+    return(DIS_PROTO);
+
+  for (int i = 0; i < job_status_count; i++)
+    {
+    disrui(chan, &rc);
+
+    if (rc != DIS_SUCCESS)
+      return(rc);
+
+    if ((str = disrst(chan, &rc)) == NULL)
+      return(rc);
+
+    free(str);
+
+    if (disrui(chan, &rc))
+      {
+      if ((str = disrst(chan, &rc)) == NULL)
+        return(rc);
+
+      free(str);
+      }
+
+    if ((str = disrst(chan, &rc)) == NULL)
+      return(rc);
+
+    if (strcmp(str, job_status[i][2]) != 0)
+      rc = DIS_PROTO;
+
+    free(str);
+
+    disrui(chan, &rc);
+
+    if (rc != DIS_SUCCESS)
+      return(rc);
+    }
+
+  return(DIS_SUCCESS);
+  }
+
+
+
+double elapsed_us(
+
+  struct timespec *start)
+
+  {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return((now.tv_sec - start->tv_sec) * 1000000.0 +
+         (now.tv_nsec - start->tv_nsec) / 1000.0);
+  }
+
+
+
+/* encode and decode BENCH_JOBS job status objects, one at a time */
+
+size_t bench_encoding(
+
+  int         encoding,
+  const char *label)
+
+  {
+  struct tcp_chan *chan = DIS_tcp_setup(41 + encoding);
+  struct timespec  start;
+  double           encode_us = 0;
+  double           decode_us = 0;
+  size_t           bytes = 0;
+
+  fail_unless(chan != NULL);
+  chan->encoding = encoding;
+
+  for (int job = 0; job < BENCH_JOBS; job++)
+    {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    fail_unless(encode_job_status(chan, job) == DIS_SUCCESS);
+    encode_us += elapsed_us(&start);
+
+    bytes += chan->writebuf.tdis_trailp - chan->writebuf.tdis_thebuf;
+    loop_back(chan);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    fail_unless(decode_job_status(chan) == DIS_SUCCESS);
+    decode_us += elapsed_us(&start);
+    }
+
+  fprintf(stdout, "%s DIS: %d job status objects, %lu bytes, encode %.0f us (%.1f MB/s), decode %.0f us (%.1f MB/s)\n",
+    label,
+    BENCH_JOBS,
+    (unsigned long)bytes,
+    encode_us,
+    bytes / encode_us,
+    decode_us,
+    bytes / decode_us);
+
+  DIS_tcp_cleanup(chan);
+
+  return(bytes);
+  }
+
+
+
+START_TEST(test_diswvi_)
+  {
+  struct tcp_chan *chan = DIS_tcp_setup(10);
+  unsigned char   *buf;
+
+  fail_unless(chan != NULL);
+  buf = (unsigned char *)chan->writebuf.tdis_thebuf;
+
+  /* not committed until the caller says so */
+  fail_unless(diswvi_(chan, FALSE, 0) == DIS_SUCCESS);
+  fail_unless(chan->writebuf.tdis_leadp - chan->writebuf.tdis_thebuf == 1);
+  fail_unless(chan->writebuf.tdis_trailp == chan->writebuf.tdis_thebuf);
+  fail_unless(buf[0] == 0x00);
+  DIS_tcp_reset(chan, 1);
+
+  fail_unless(diswvi_(chan, FALSE, 63) == DIS_SUCCESS);
+  fail_unless(chan->writebuf.tdis_leadp - chan->writebuf.tdis_thebuf == 1);
+  fail_unless(buf[0] == 0x3f);
+  DIS_tcp_reset(chan, 1);
+
+  fail_unless(diswvi_(chan, TRUE, 1) == DIS_SUCCESS);
+  fail_unless(chan->writebuf.tdis_leadp - chan->writebuf.tdis_thebuf == 1);
+  fail_unless(buf[0] == 0x41);
+  DIS_tcp_reset(chan, 1);
+
+  fail_unless(diswvi_(chan, FALSE, 64) == DIS_SUCCESS);
+  fail_unless(chan->writebuf.tdis_leadp - chan->writebuf.tdis_thebuf == 2);
+  fail_unless(buf[0] == 0x80);
+  fail_unless(buf[1] == 0x01);
+  DIS_tcp_reset(chan, 1);
+
+  fail_unless(diswvi_(chan, FALSE, ULONG_MAX) == DIS_SUCCESS);
+  fail_unless(chan->writebuf.tdis_leadp - chan->writebuf.tdis_thebuf == 1 + (CHAR_BIT * sizeof(unsigned long) - 6 + 6) / 7);
+  fail_unless((buf[chan->writebuf.tdis_leadp - chan->writebuf.tdis_thebuf - 1] & 0x80) == 0);
+
+  DIS_tcp_cleanup(chan);
+  }
+END_TEST
+
+
+
+START_TEST(test_binary_round_trip)
+  {
+  struct tcp_chan *chan = DIS_tcp_setup(11);
+  int              rc;
+  char            *str;
+
+  fail_unless(chan != NULL);
+  chan->encoding = DIS_ENCODING_BINARY;
+
+  fail_unless(diswsi(chan, -5) == DIS_SUCCESS);
+  fail_unless(diswui(chan, 70000) == DIS_SUCCESS);
+  fail_unless(diswsl(chan, LONG_MIN) == DIS_SUCCESS);
+  fail_unless(diswul(chan, ULONG_MAX) == DIS_SUCCESS);
+  fail_unless(diswst(chan, "walltime") == DIS_SUCCESS);
+  fail_unless(diswd(chan, 0.0) == DIS_SUCCESS);
+  fail_unless(diswd(chan, -2.5) == DIS_SUCCESS);
+
+  loop_back(chan);
+
+  fail_unless(disrsi(chan, &rc) == -5);
+  fail_unless(rc == DIS_SUCCESS);
+  fail_unless(disrui(chan, &rc) == 70000);
+  fail_unless(rc == DIS_SUCCESS);
+  fail_unless(disrsl(chan, &rc) == LONG_MIN);
+  fail_unless(rc == DIS_SUCCESS);
+  fail_unless(disrul(chan, &rc) == ULONG_MAX);
+  fail_unless(rc == DIS_SUCCESS);
+
+  str = disrst(chan, &rc);
+  fail_unless(rc == DIS_SUCCESS);
+  fail_unless(!strcmp(str, "walltime"));
+  free(str);
+
+  fail_unless(disrd(chan, &rc) == 0.0);
+  fail_unless(rc == DIS_SUCCESS);
+  fail_unless(disrd(chan, &rc) == -2.5);
+  fail_unless(rc == DIS_SUCCESS);
+
+  DIS_tcp_cleanup(chan);
+  }
+END_TEST
+
+
+
+START_TEST(test_classic_unchanged)
+  {
+  struct tcp_chan *chan = DIS_tcp_setup(12);
+  size_t           len;
+
+  fail_unless(chan != NULL);
+
+  fail_unless(diswui(chan, 5) == DIS_SUCCESS);
+  fail_unless(diswsi(chan, -12) == DIS_SUCCESS);
+  fail_unless(diswst(chan, "abc") == DIS_SUCCESS);
+  fail_unless(diswd(chan, 0.0) == DIS_SUCCESS);
+
+  len = chan->writebuf.tdis_trailp - chan->writebuf.tdis_thebuf;
+  fail_unless(len == strlen("+52-12+3abc+0+0"));
+  fail_unless(!memcmp(chan->writebuf.tdis_thebuf, "+52-12+3abc+0+0", len));
+
+  DIS_tcp_cleanup(chan);
+  }
+END_TEST
+
+
+
+START_TEST(test_encoding_benchmark)
+  {
+  size_t classic = bench_encoding(DIS_ENCODING_CLASSIC, "classic");
+  size_t binary = bench_encoding(DIS_ENCODING_BINARY, "binary");
+
+  fail_unless(binary < classic);
+  }
+END_TEST
+
+
+
+Suite *diswvi__suite(void)
+  {
+  Suite *s = suite_create("diswvi__suite methods");
+  TCase *tc_core = tcase_create("test_diswvi_");
+  tcase_add_test(tc_core, test_diswvi_);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_binary_round_trip");
+  tcase_add_test(tc_core, test_binary_round_trip);
+  tcase_add_test(tc_core, test_classic_unchanged);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_encoding_benchmark");
+  tcase_add_test(tc_core, test_encoding_benchmark);
+  tcase_set_timeout(tc_core, 60);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(diswvi__suite());
+  srunner_set_log(sr, "diswvi__suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
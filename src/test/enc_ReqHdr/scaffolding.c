@@ -14,3 +14,8 @@ int diswui(tcp_chan *chan, unsigned value)
  fprintf(stderr, "The call to diswui needs to be mocked!!\n");
  exit(1);
  }
+
+int PBSD_session_tag(int sock, unsigned int *tag)
+  {
+  return(0);
+  }
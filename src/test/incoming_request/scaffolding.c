@@ -3,12 +3,17 @@
 
 #include "tcp.h"
 #include "threadpool.h"
+#include "server_limits.h" /* PBS_NET_MAX_CONNECTIONS */
+#include "net_connect.h" /* connection */
+#include "client_session.h"
 
 int LOGLEVEL = 10;
 time_t pbs_tcp_timeout = 300;
 int    peek_count;
 bool   busy_pool = false;
 
+struct connection svr_conn[PBS_NET_MAX_CONNECTIONS];
+
 void log_err(int errnum, const char *routine, const char *text) {}
 
 void log_event(int, int, const char *routine, const char *text) {}
@@ -83,3 +88,5 @@ int write_tcp_reply(
   {
   return(0);
   }
+
+void session_close(client_session *cs) {}
@@ -18,6 +18,7 @@ bool return_addr = true;
 bool local_connect = true;
 bool net_rc_retry = false;
 bool connect_error = false;
+int  unwatched_connects = 0;
 
 int pbs_errno = 0;
 const char *msg_daemonname = "unset";
@@ -111,12 +112,11 @@ int enqueue_threadpool_request(
   }
 
 
-int insert_timed_task(
+void insert_timed_task(
 
     work_task *wt)
 
   {
-  return(PBSE_NONE);
   }
 
 
@@ -236,6 +236,24 @@ int svr_connect(pbs_net_t hostaddr, unsigned int port, int *my_err, struct pbsno
   return(10);
   }
 
+int svr_connect_unwatched(pbs_net_t hostaddr, unsigned int port, int *my_err)
+  {
+  unwatched_connects++;
+
+  if (local_connect == true)
+    return PBS_LOCAL_CONNECTION;
+
+  if (connect_error == true)
+    return(-5);
+
+  return(5);
+  }
+
+bool svr_connection_usable(int handle)
+  {
+  return(true);
+  }
+
 int dispatch_task(struct work_task *ptask)
   {
   return(0);
@@ -8,16 +8,21 @@
 #include "test_uut.h"
 #include "pbs_error.h"
 #include "attribute.h"
+#include "dis.h"
+#include "mom_connection_pool.hpp"
 
 bool return_addr;
 bool local_connect;
 bool net_rc_retry;
 bool connect_error;
+extern int unwatched_connects;
+extern struct connect_handle connection[];
 
 extern std::string rq_id_str;
 void queue_a_retry_task(batch_request *preq, void (*replyfunc)(struct work_task *));
 int send_request_to_remote_server(int conn, batch_request *request, bool close_handle);
 int issue_Drequest(int conn, batch_request *request, bool close_handle);
+bool reply_was_read(int rc, batch_request *request);
 
 
 START_TEST(queue_a_retry_task_test)
@@ -55,6 +60,61 @@ START_TEST(test_one)
   }
 END_TEST
 
+START_TEST(test_relay_to_mom_pooled)
+  {
+  job testJob;
+  job *pTestJob;
+  struct batch_request request;
+
+  memset(&testJob,0,sizeof(job));
+  memset(&request,0,sizeof(request));
+  pTestJob = &testJob;
+
+  connection[5].ch_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  pthread_mutex_init(connection[5].ch_mutex, NULL);
+  connection[5].ch_socket = -1;
+
+  decode_str(&testJob.ji_wattr[JOB_ATR_exec_host],NULL,NULL,"Sherrie",0);
+  request.rq_type = PBS_BATCH_DeleteJob;
+
+  local_connect = false;
+  connect_error = false;
+  unwatched_connects = 0;
+
+  fail_unless(relay_to_mom(&pTestJob,&request,NULL) == PBSE_NONE);
+  fail_unless(unwatched_connects == 1);
+  fail_unless(mom_connections.idle_count() == 1);
+
+  // the second request goes over the same connection
+  pTestJob = &testJob;
+  fail_unless(relay_to_mom(&pTestJob,&request,NULL) == PBSE_NONE);
+  fail_unless(unwatched_connects == 1);
+  fail_unless(mom_connections.idle_count() == 1);
+
+  mom_connections.close_idle(time(NULL) + MOM_POOL_IDLE_TIMEOUT + 1);
+  fail_unless(mom_connections.idle_count() == 0);
+
+  local_connect = true;
+  }
+END_TEST
+
+START_TEST(test_reply_was_read)
+  {
+  struct batch_request request;
+
+  memset(&request,0,sizeof(request));
+
+  fail_unless(reply_was_read(PBSE_NONE, &request) == true);
+  fail_unless(reply_was_read(-1, &request) == false);
+
+  request.rq_reply.brp_code = PBSE_UNKJOBID;
+  fail_unless(reply_was_read(PBSE_NONE, &request) == true);
+
+  request.rq_reply.brp_code = DIS_EOF;
+  fail_unless(reply_was_read(PBSE_NONE, &request) == false);
+  }
+END_TEST
+
 START_TEST(test_send_request_to_remote_server)
   {
   int rc;
@@ -306,6 +366,11 @@ Suite *issue_request_suite(void)
   tcase_add_test(tc_core, test_one);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_relay_to_mom_pooled");
+  tcase_add_test(tc_core, test_relay_to_mom_pooled);
+  tcase_add_test(tc_core, test_reply_was_read);
+  suite_add_tcase(s, tc_core);
+
   tc_core = tcase_create("test_send_request_to_remote_server");
   tcase_add_test(tc_core, test_send_request_to_remote_server);
   suite_add_tcase(s, tc_core);
@@ -4,12 +4,14 @@
 #include "pbs_job.h"
 #include "log.h"
 #include "id_map.hpp"
+#include "job_index.hpp"
 #include "log.h"
 
 bool exit_called = false;
 all_jobs        array_summary;
 char                   server_name[PBS_MAXSERVERNAME + 1]; /* host_name[:service|port] */
 all_jobs        alljobs;
+job_index       alljobs_index;
 int                    LOGLEVEL;
 
 void log_event(int type, int cls, const char *ident, const char *msg) {}
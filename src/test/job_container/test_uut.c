@@ -3,9 +3,14 @@
 #include <stdlib.h>
 #include "pbs_job.h"
 #include "pbs_error.h"
+#include "job_index.hpp"
 #include <check.h>
 
 char *get_correct_jobname(const char *jobid);
+job  *find_job_by_array(all_jobs *aj, const char *job_id, int get_subjob, bool locked);
+
+extern all_jobs  alljobs;
+extern job_index alljobs_index;
 
 void log_err(int,const char *,const char *)
 {}
@@ -226,6 +231,87 @@ START_TEST(next_job_test)
   }
 END_TEST
 
+START_TEST(alljobs_index_test)
+  {
+  struct job *j1 = job_alloc();
+  struct job *j2 = job_alloc();
+
+  strcpy(j1->ji_qs.ji_jobid, "1.napali");
+  strcpy(j2->ji_qs.ji_jobid, "2.napali");
+
+  // inserting into and removing from alljobs keeps the index in step
+  fail_unless(insert_job(&::alljobs, j1) == PBSE_NONE);
+  fail_unless(insert_job_after(&::alljobs, j1, j2) == PBSE_NONE);
+  fail_unless(alljobs_index.find("1.napali") == j1);
+  fail_unless(alljobs_index.find("2.napali") == j2);
+  fail_unless(find_job_by_array(&::alljobs, "2.napali", FALSE, false) == j2);
+
+  fail_unless(remove_job(&::alljobs, j1) == PBSE_NONE);
+  fail_unless(alljobs_index.find("1.napali") == NULL);
+  fail_unless(find_job_by_array(&::alljobs, "1.napali", FALSE, false) == NULL);
+
+  // recycled jobs aren't returned
+  j2->ji_being_recycled = TRUE;
+  fail_unless(find_job_by_array(&::alljobs, "2.napali", FALSE, false) == NULL);
+  j2->ji_being_recycled = FALSE;
+
+  fail_unless(remove_job(&::alljobs, j2) == PBSE_NONE);
+  fail_unless(alljobs_index.count() == 0);
+  }
+END_TEST
+
+START_TEST(snapshot_iterator_test)
+  {
+  all_jobs           other;
+  all_jobs_iterator *iter;
+  struct job        *jobs[4];
+  char               id[PBS_MAXSVRJOBID + 1];
+
+  for (int i = 0; i < 4; i++)
+    {
+    jobs[i] = job_alloc();
+    snprintf(jobs[i]->ji_qs.ji_jobid, sizeof(jobs[i]->ji_qs.ji_jobid), "%d.napali", i);
+    }
+
+  fail_unless(insert_job(&::alljobs, jobs[0]) == PBSE_NONE);
+  fail_unless(insert_job(&::alljobs, jobs[1]) == PBSE_NONE);
+  fail_unless(insert_job(&::alljobs, jobs[2]) == PBSE_NONE);
+
+  ::alljobs.lock();
+  iter = ::alljobs.get_snapshot_iterator();
+  ::alljobs.unlock();
+
+  fail_unless(iter->is_snapshot() == true);
+
+  // changes made after the snapshot don't block or confuse the walk
+  fail_unless(remove_job(&::alljobs, jobs[1]) == PBSE_NONE);
+  fail_unless(insert_job_first(&::alljobs, jobs[3]) == PBSE_NONE);
+
+  fail_unless(next_job(&::alljobs, iter) == jobs[0]);
+  fail_unless(next_job(&::alljobs, iter) == jobs[2]);
+  fail_unless(next_job(&::alljobs, iter) == NULL);
+  delete iter;
+
+  // snapshots of containers without an index resolve through the container
+  fail_unless(insert_job(&other, jobs[1]) == PBSE_NONE);
+  fail_unless(insert_job(&other, jobs[0]) == PBSE_NONE);
+  other.lock();
+  iter = other.get_snapshot_iterator();
+  other.unlock();
+
+  fail_unless(next_job(&other, iter) == jobs[1]);
+  fail_unless(next_job(&other, iter) == jobs[0]);
+  fail_unless(next_job(&other, iter) == NULL);
+  delete iter;
+
+  for (int i = 0; i < 4; i++)
+    {
+    snprintf(id, sizeof(id), "%d.napali", i);
+    alljobs_index.remove(id, NULL);
+    }
+  }
+END_TEST
+
 START_TEST(find_job_by_array_with_removed_record_test)
   {
   int result;
@@ -293,6 +379,14 @@ Suite *job_container_suite(void)
   tcase_add_test(tc_core, next_job_test);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("alljobs_index_test");
+  tcase_add_test(tc_core, alljobs_index_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("snapshot_iterator_test");
+  tcase_add_test(tc_core, snapshot_iterator_test);
+  suite_add_tcase(s, tc_core);
+
   tc_core = tcase_create("find_job_by_array_with_removed_record");
   tcase_add_test(tc_core, find_job_by_array_with_removed_record_test);
   suite_add_tcase(s, tc_core);
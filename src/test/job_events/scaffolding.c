@@ -0,0 +1,117 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "server_limits.h" /* PBS_NET_MAX_CONNECTIONS */
+#include "pbs_job.h"
+#include "batch_request.h"
+#include "work_task.h"
+#include "net_connect.h"
+#include "threadpool.h"
+#include "dis.h"
+#include "tcp.h"
+
+int               LOGLEVEL = 7; /* force logging code to be exercised as tests run */
+threadpool_t     *task_pool;
+struct connection svr_conn[PBS_NET_MAX_CONNECTIONS];
+
+job  *found_job = NULL;
+int   authorized = 0;
+long  query_others = 0;
+int   rejected = 0;
+int   replied = 0;
+int   flushes_enqueued = 0;
+int   closed_sock = -1;
+
+
+struct tcp_chan *DIS_buf_setup(void)
+  {
+  struct tcp_chan *chan = (struct tcp_chan *)calloc(1, sizeof(struct tcp_chan));
+
+  chan->writebuf.tdis_thebuf = (char *)calloc(1, 256);
+  chan->writebuf.tdis_trailp = chan->writebuf.tdis_thebuf;
+
+  return(chan);
+  }
+
+char *DIS_buf_data(struct tcp_chan *chan, size_t *len)
+  {
+  *len = chan->writebuf.tdis_trailp - chan->writebuf.tdis_thebuf;
+
+  return(chan->writebuf.tdis_thebuf);
+  }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan)
+  {
+  free(chan->writebuf.tdis_thebuf);
+  free(chan);
+  }
+
+int encode_DIS_JobEvent(struct tcp_chan *chan, const char *job_id, char state, int exit_status, int flags)
+  {
+  chan->writebuf.tdis_trailp += sprintf(chan->writebuf.tdis_trailp, "%s:%c:%d:%d;",
+                                        job_id, state, exit_status, flags);
+  return(0);
+  }
+
+void close_conn(int sd, int has_mutex)
+  {
+  closed_sock = sd;
+  close(sd);
+  }
+
+int enqueue_threadpool_request(void *(*func)(void *), void *arg, threadpool_t *tp)
+  {
+  flushes_enqueued++;
+  return(0);
+  }
+
+int get_svr_attr_l(int index, long *l)
+  {
+  *l = query_others;
+  return(0);
+  }
+
+job *svr_find_job(const char *jobid, int get_subjob)
+  {
+  if ((found_job != NULL) &&
+      (!strncmp(found_job->ji_qs.ji_jobid, jobid, strlen(jobid))))
+    return(found_job);
+
+  return(NULL);
+  }
+
+int svr_authorize_jobreq(struct batch_request *preq, job *pjob)
+  {
+  return(authorized);
+  }
+
+int unlock_ji_mutex(job *pjob, const char *id, const char *msg, int logging)
+  {
+  return(0);
+  }
+
+void req_reject(int code, int aux, struct batch_request *preq, const char *HostName, const char *Msg)
+  {
+  rejected = code;
+  }
+
+int reply_send_svr(struct batch_request *request)
+  {
+  replied++;
+  return(0);
+  }
+
+struct work_task *set_task(enum work_type type, long event_id, void (*func)(struct work_task *), void *parm, int get_lock)
+  {
+  return(NULL);
+  }
+
+void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
+
+void log_err(int errnum, const char *routine, const char *text) {}
+
+void log_record(int eventtype, int objclass, const char *objname, const char *text) {}
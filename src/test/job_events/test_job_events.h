@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _JOB_EVENTS_CT_H
+#define _JOB_EVENTS_CT_H
+#include <check.h>
+
+Suite *job_events_suite();
+
+#endif /* _JOB_EVENTS_CT_H */
@@ -0,0 +1,200 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "job_events.h"
+#include "test_job_events.h"
+#include "pbs_error.h"
+#include "pbs_job.h"
+#include "batch_request.h"
+#include "libpbs.h"
+#include "net_connect.h"
+
+extern struct connection svr_conn[];
+extern job  *found_job;
+extern int   authorized;
+extern int   rejected;
+extern int   replied;
+extern int   flushes_enqueued;
+extern int   closed_sock;
+
+
+job *make_job(const char *id, const char *owner, char state)
+  {
+  job *pjob = (job *)calloc(1, sizeof(job));
+
+  strcpy(pjob->ji_qs.ji_jobid, id);
+  pjob->ji_wattr[JOB_ATR_job_owner].at_val.at_str = strdup(owner);
+  pjob->ji_wattr[JOB_ATR_state].at_val.at_char = state;
+
+  return(pjob);
+  }
+
+void make_subscriber(int sv[2], batch_request &preq, const char *user, const char *job_id)
+  {
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+
+  svr_conn[sv[0]].cn_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  svr_conn[sv[0]].cn_authen = 0;
+
+  memset(&preq, 0, sizeof(preq));
+  preq.rq_conn = sv[0];
+  strcpy(preq.rq_user, user);
+  strcpy(preq.rq_host, "napali");
+  strcpy(preq.rq_ind.rq_subscribe, job_id);
+  }
+
+std::string read_events(int sock)
+  {
+  char    buf[1024];
+  ssize_t len = recv(sock, buf, sizeof(buf) - 1, MSG_DONTWAIT);
+
+  if (len <= 0)
+    return("");
+
+  return(std::string(buf, len));
+  }
+
+
+START_TEST(test_subscribe_all_jobs)
+  {
+  int            sv[2];
+  batch_request  preq;
+  job           *mine = make_job("1.napali", "dbeer@napali", 'R');
+  job           *theirs = make_job("2.napali", "other@napali", 'R');
+  work_task     *ptask = (work_task *)calloc(1, sizeof(work_task));
+
+  make_subscriber(sv, preq, "dbeer", "");
+
+  fail_unless(req_subscribe(&preq) == PBSE_CONN_HANDED_OFF);
+  fail_unless(replied == 1);
+  fail_unless(preq.rq_reply.brp_choice == BATCH_REPLY_CHOICE_EventStream);
+  fail_unless((svr_conn[sv[0]].cn_authen & PBS_NET_CONN_NOTIMEOUT) != 0);
+  fail_unless(job_events_subscriber_count() == 1);
+
+  // only the subscriber's own jobs are sent
+  job_events_publish(theirs, 0);
+  fail_unless(flushes_enqueued == 0);
+
+  job_events_publish(mine, 0);
+  fail_unless(flushes_enqueued == 1);
+  flush_job_events(NULL);
+  fail_unless(read_events(sv[1]) == "1.napali:R:0:0;");
+
+  mine->ji_wattr[JOB_ATR_state].at_val.at_char = 'C';
+  mine->ji_wattr[JOB_ATR_exitstat].at_val.at_long = 3;
+  mine->ji_wattr[JOB_ATR_exitstat].at_flags = ATR_VFLAG_SET;
+  job_events_publish(mine, PBS_EVENT_PURGED);
+  flush_job_events(NULL);
+  fail_unless(read_events(sv[1]) == "1.napali:C:3:3;");
+
+  // the client going away drops the subscriber
+  close(sv[1]);
+  ptask->wt_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+  check_job_subscribers(ptask);
+  fail_unless(closed_sock == sv[0]);
+  fail_unless(job_events_subscriber_count() == 0);
+  }
+END_TEST
+
+
+START_TEST(test_subscribe_one_job)
+  {
+  int            sv[2];
+  batch_request  preq;
+  job           *pjob = make_job("2.napali", "dbeer@napali", 'Q');
+  job           *other = make_job("3.napali", "dbeer@napali", 'R');
+
+  make_subscriber(sv, preq, "dbeer", "4.napali");
+  fail_unless(req_subscribe(&preq) == PBSE_UNKJOBID);
+  fail_unless(rejected == PBSE_UNKJOBID);
+
+  found_job = pjob;
+  authorized = -1;
+  make_subscriber(sv, preq, "dbeer", "2");
+  fail_unless(req_subscribe(&preq) == PBSE_PERM);
+  fail_unless(rejected == PBSE_PERM);
+  fail_unless(job_events_subscriber_count() == 0);
+
+  // the job's current state is sent right after the reply
+  authorized = 0;
+  make_subscriber(sv, preq, "dbeer", "2");
+  fail_unless(req_subscribe(&preq) == PBSE_CONN_HANDED_OFF);
+  fail_unless(flushes_enqueued == 1);
+  flush_job_events(NULL);
+  fail_unless(read_events(sv[1]) == "2.napali:Q:0:0;");
+
+  job_events_publish(other, 0);
+  flush_job_events(NULL);
+  fail_unless(read_events(sv[1]) == "");
+
+  pjob->ji_wattr[JOB_ATR_state].at_val.at_char = 'R';
+  job_events_publish(pjob, 0);
+  flush_job_events(NULL);
+  fail_unless(read_events(sv[1]) == "2.napali:R:0:0;");
+  }
+END_TEST
+
+
+START_TEST(test_slow_subscriber_dropped)
+  {
+  int            sv[2];
+  batch_request  preq;
+  job           *pjob = make_job("5.napali", "dbeer@napali", 'R');
+
+  make_subscriber(sv, preq, "dbeer", "");
+  fail_unless(req_subscribe(&preq) == PBSE_CONN_HANDED_OFF);
+
+  // nothing is flushed so the events pile up until the limit is hit
+  for (int i = 0; i < JOB_EVENTS_MAX_PENDING / 10; i++)
+    {
+    job_events_publish(pjob, 0);
+
+    if (job_events_subscriber_count() == 0)
+      break;
+    }
+
+  fail_unless(job_events_subscriber_count() == 0);
+  fail_unless(closed_sock == sv[0]);
+  }
+END_TEST
+
+
+Suite *job_events_suite(void)
+  {
+  Suite *s = suite_create("job_events_suite methods");
+  TCase *tc_core = tcase_create("test_subscribe_all_jobs");
+  tcase_add_test(tc_core, test_subscribe_all_jobs);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_subscribe_one_job");
+  tcase_add_test(tc_core, test_subscribe_one_job);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_slow_subscriber_dropped");
+  tcase_add_test(tc_core, test_slow_subscriber_dropped);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_events_suite());
+  srunner_set_log(sr, "job_events_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
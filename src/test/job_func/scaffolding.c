@@ -22,6 +22,7 @@
 /* This section is for manipulting function return values */
 #include "test_job_func.h" /* *_SUITE */
 #include "user_info.h"
+#include "change_log.hpp"
 int func_num = 0; /* Suite number being run */
 int tc = 0; /* Used for test routining */
 int iter_num = 0;
@@ -674,3 +675,45 @@ bool completed_jobs_map_class::add_job(char const* s, time_t t)
 std::string get_path_jobdata(const char *a, const char *b) {return ""; }
 
 void add_to_completed_jobs(work_task *ptask) {}
+
+void job_stat_cache_invalidate(job *pjob) {}
+
+void job_events_publish(job *pjob, int flags) {}
+
+change_log::change_log(long long start, size_t max) {}
+
+change_log::~change_log() {}
+
+long long change_log::next()
+  {
+  return(0);
+  }
+
+void change_log::record_deletion(int objtype, const char *name, const char *container) {}
+
+int get_subjob_index(const char *job_id, char *parent_id)
+  {
+  return(-1);
+  }
+
+bool is_uncloned_index(job_array *pa, int index)
+  {
+  return(false);
+  }
+
+int next_uncloned_index(job_array *pa)
+  {
+  return(-1);
+  }
+
+int remove_uncloned_range(job_array *pa, int start, int end)
+  {
+  return(0);
+  }
+
+int count_idle_subjobs(job_array *pa)
+  {
+  return(0);
+  }
+
+void clone_more_subjobs(job_array *pa) {}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "job_index.hpp"
+#include <check.h>
+
+
+START_TEST(test_constructor)
+  {
+  job_index ji;
+
+  fail_unless(ji.count() == 0);
+  fail_unless(ji.find("1.napali") == NULL);
+  }
+END_TEST
+
+
+
+
+START_TEST(test_insert_find_remove)
+  {
+  job_index   ji;
+  job        *j1 = (job *)0x1;
+  job        *j2 = (job *)0x2;
+  char        id[64];
+
+  ji.insert("1.napali", j1);
+  ji.insert("2.napali", j2);
+  fail_unless(ji.count() == 2);
+  fail_unless(ji.find("1.napali") == j1);
+  fail_unless(ji.find("2.napali") == j2);
+
+  // inserting an existing id replaces the job
+  ji.insert("1.napali", j2);
+  fail_unless(ji.count() == 2);
+  fail_unless(ji.find("1.napali") == j2);
+
+  // a remove for a job that no longer owns the id is ignored
+  fail_unless(ji.remove("1.napali", j1) == false);
+  fail_unless(ji.find("1.napali") == j2);
+  fail_unless(ji.remove("1.napali", j2) == true);
+  fail_unless(ji.find("1.napali") == NULL);
+  fail_unless(ji.remove("1.napali", NULL) == false);
+  fail_unless(ji.remove("2.napali", NULL) == true);
+  fail_unless(ji.count() == 0);
+
+  // enough ids to land in every shard
+  for (int i = 0; i < 1000; i++)
+    {
+    snprintf(id, sizeof(id), "%d.waimea", i);
+    ji.insert(id, j1);
+    }
+
+  fail_unless(ji.count() == 1000);
+
+  for (int i = 0; i < 1000; i += 2)
+    {
+    snprintf(id, sizeof(id), "%d.waimea", i);
+    fail_unless(ji.remove(id, j1) == true);
+    }
+
+  fail_unless(ji.count() == 500);
+  fail_unless(ji.find("1.waimea") == j1);
+  fail_unless(ji.find("2.waimea") == NULL);
+  }
+END_TEST
+
+
+
+
+Suite *job_index_suite(void)
+  {
+  Suite *s = suite_create("job_index test suite methods");
+  TCase *tc_core = tcase_create("test_constructor");
+  tcase_add_test(tc_core, test_constructor);
+  suite_add_tcase(s, tc_core);
+  
+  tc_core = tcase_create("test_insert_find_remove");
+  tcase_add_test(tc_core, test_insert_find_remove);
+  suite_add_tcase(s, tc_core);
+  
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(job_index_suite());
+  srunner_set_log(sr, "job_index_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
@@ -111,12 +111,12 @@ int unlock_ai_mutex(job_array *pa, const char *func_id, const char *msg, int log
 
 ssize_t write_ac_socket(int fd, const void *buf, ssize_t count)
   {
-  return(0);
+  return(write(fd, buf, count));
   }
 
 ssize_t read_ac_socket(int fd, void *buf, ssize_t count)
   {
-  return(0);
+  return(read(fd, buf, count));
   }
 
 int enqueue_threadpool_request(void *(*func)(void *),void *arg, threadpool_t *tp)
@@ -221,6 +221,8 @@ job *next_job(all_jobs *aj, all_jobs_iterator *iter) {return NULL;}
 int  can_queue_new_job(char *user_name, job *pjob) {return 0;}
 struct work_task *set_task(enum work_type type, long event_id, void (*func)(work_task *), void *parm, int get_lock) {return NULL;}
 void reply_ack(struct batch_request *preq) {}
+
+void reply_text(struct batch_request *preq, int code, const char *text) {}
 int job_log_open(char *filename, char *directory) {return 0;}
 char *threadsafe_tokenizer(char **str, const char *delims) {return NULL;}
 int set_ll(struct pbs_attribute *attr, struct pbs_attribute *new_attr, enum batch_op op) {return 0;}
@@ -371,3 +373,34 @@ bool completed_jobs_map_class::add_job(char const* s, time_t t) {return false;}
 std::string get_path_jobdata(const char *a, const char *b) {return "";}
 
 void add_to_completed_jobs(work_task *wt) {}
+
+void job_stat_cache_invalidate(job *pjob) {}
+
+void job_events_publish(job *pjob, int flags) {}
+
+int get_subjob_index(const char *job_id, char *parent_id)
+  {
+  return(-1);
+  }
+
+bool is_uncloned_index(job_array *pa, int index)
+  {
+  return(false);
+  }
+
+int next_uncloned_index(job_array *pa)
+  {
+  return(-1);
+  }
+
+int remove_uncloned_range(job_array *pa, int start, int end)
+  {
+  return(0);
+  }
+
+int count_idle_subjobs(job_array *pa)
+  {
+  return(0);
+  }
+
+void clone_more_subjobs(job_array *pa) {}
@@ -338,6 +338,58 @@ START_TEST(test_job_recover)
   }
 END_TEST
 
+START_TEST(test_job_journal)
+  {
+  char        jobfile[MAXPATHLEN];
+  char        journal[MAXPATHLEN];
+  const char *jobid = "unit_test_job2";
+  job        *pj = create_a_job(jobid);
+
+  fail_unless(pj != NULL);
+  snprintf(jobfile, sizeof(jobfile), "/tmp/%s%s", jobid, JOB_FILE_SUFFIX);
+  fail_unless(get_journal_path(jobfile, journal, sizeof(journal)) == PBSE_NONE);
+  fail_unless(!strcmp(journal, "/tmp/unit_test_job2.JL"));
+  fail_unless(get_journal_path("/tmp/1.napali.TA", journal, sizeof(journal)) == -1);
+  get_journal_path(jobfile, journal, sizeof(journal));
+
+  // no journal yet, so a quick save must fall back to a full save
+  unlink(journal);
+  fail_unless(job_journal_append(pj, journal) == -1);
+
+  fail_unless(saveJobToXML(pj, jobfile) == PBSE_NONE);
+  fail_unless(job_journal_reset(jobfile, journal) == PBSE_NONE);
+
+  pj->ji_qs.ji_state = JOB_STATE_QUEUED;
+  pj->ji_qs.ji_substate = JOB_SUBSTATE_QUEUED;
+  fail_unless(job_journal_append(pj, journal) == PBSE_NONE);
+
+  job_attr_def[JOB_ATR_jobname].at_decode(&pj->ji_wattr[JOB_ATR_jobname], NULL, NULL, "renamed", 0);
+  fail_unless((pj->ji_wattr[JOB_ATR_jobname].at_flags & ATR_VFLAG_MODIFY) != 0);
+  fail_unless(job_journal_append(pj, journal) == PBSE_NONE);
+  fail_unless((pj->ji_wattr[JOB_ATR_jobname].at_flags & ATR_VFLAG_MODIFY) == 0);
+
+  // a torn record at the end is ignored
+  FILE *fp = fopen(journal, "a");
+  fputs("garbage", fp);
+  fclose(fp);
+
+  job *recov_pj = job_alloc();
+  strcpy(recov_pj->ji_qs.ji_jobid, jobid);
+  fail_unless(job_journal_replay(recov_pj, jobfile, journal) == 2);
+  fail_unless(recov_pj->ji_qs.ji_state == JOB_STATE_QUEUED);
+  fail_unless(recov_pj->ji_qs.ji_substate == JOB_SUBSTATE_QUEUED);
+  fail_unless(!strcmp(recov_pj->ji_wattr[JOB_ATR_jobname].at_val.at_str, "renamed"));
+
+  // a journal that does not follow the current job file is not replayed
+  pj->ji_qs.ji_substate = JOB_SUBSTATE_HELD;
+  fail_unless(saveJobToXML(pj, jobfile) == PBSE_NONE);
+  fail_unless(job_journal_replay(recov_pj, jobfile, journal) == -1);
+
+  unlink(jobfile);
+  unlink(journal);
+  }
+END_TEST
+
 Suite *job_recov_suite(void)
   {
   Suite *s = suite_create("job_recov_suite methods");
@@ -351,6 +403,7 @@ Suite *job_recov_suite(void)
 
   tc_core = tcase_create("test_moar");
   tcase_add_test(tc_core, test_set_array_jobs_ids);
+  tcase_add_test(tc_core, test_job_journal);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -0,0 +1,33 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <set>
+
+#include "net_connect.h" /* pbs_net_t */
+#include "work_task.h" /* work_task */
+
+int           next_handle = 0;
+int           connects = 0;
+int           disconnects = 0;
+std::set<int> closed_by_mom;
+
+
+int svr_connect_unwatched(pbs_net_t hostaddr, unsigned int port, int *my_err)
+  {
+  connects++;
+  return(next_handle++);
+  }
+
+bool svr_connection_usable(int handle)
+  {
+  return(closed_by_mom.find(handle) == closed_by_mom.end());
+  }
+
+void svr_disconnect(int handle)
+  {
+  disconnects++;
+  }
+
+struct work_task *set_task(enum work_type type, long event_id, void (*func)(struct work_task *), void *parm, int get_lock)
+  {
+  return(NULL);
+  }
@@ -0,0 +1,174 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <set>
+#include "mom_connection_pool.hpp"
+#include "server_limits.h" /* PBS_LOCAL_CONNECTION */
+#include <check.h>
+
+extern int           next_handle;
+extern int           connects;
+extern int           disconnects;
+extern std::set<int> closed_by_mom;
+
+void reset_counters()
+  {
+  next_handle = 0;
+  connects = 0;
+  disconnects = 0;
+  closed_by_mom.clear();
+  }
+
+
+
+START_TEST(test_get_release)
+  {
+  mom_connection_pool pool(2, 60);
+  int                 err = 0;
+  bool                reused;
+  int                 h1;
+  int                 h2;
+  int                 h3;
+
+  reset_counters();
+
+  // two requests to the same mom at once get their own connections
+  h1 = pool.get(1, 15002, &err, &reused);
+  fail_unless(h1 == 0);
+  fail_unless(reused == false);
+  h2 = pool.get(1, 15002, &err, &reused);
+  fail_unless(h2 == 1);
+  fail_unless(reused == false);
+  fail_unless(connects == 2);
+
+  pool.release(1, 15002, h1, true);
+  pool.release(1, 15002, h2, true);
+  fail_unless(pool.idle_count() == 2);
+  fail_unless(disconnects == 0);
+
+  // the most recently released is handed out first
+  fail_unless(pool.get(1, 15002, &err, &reused) == h2);
+  fail_unless(reused == true);
+  fail_unless(pool.get(1, 15002, &err, &reused) == h1);
+  fail_unless(reused == true);
+  h3 = pool.get(1, 15002, &err, &reused);
+  fail_unless(h3 == 2);
+  fail_unless(reused == false);
+  fail_unless(connects == 3);
+
+  // only two are kept
+  pool.release(1, 15002, h1, true);
+  pool.release(1, 15002, h2, true);
+  pool.release(1, 15002, h3, true);
+  fail_unless(pool.idle_count() == 2);
+  fail_unless(disconnects == 1);
+
+  // another mom doesn't get them
+  fail_unless(pool.get(2, 15002, &err, &reused) == 3);
+  fail_unless(reused == false);
+  fail_unless(pool.get(1, 15003, &err, &reused) == 4);
+  fail_unless(reused == false);
+  }
+END_TEST
+
+
+
+START_TEST(test_unusable_connections)
+  {
+  mom_connection_pool pool(4, 60);
+  int                 err = 0;
+  bool                reused;
+  int                 h1;
+  int                 h2;
+
+  reset_counters();
+
+  h1 = pool.get(1, 15002, &err, &reused);
+  h2 = pool.get(1, 15002, &err, &reused);
+
+  // a failed request closes its connection
+  pool.release(1, 15002, h1, false);
+  fail_unless(disconnects == 1);
+  fail_unless(pool.idle_count() == 0);
+
+  // a connection the mom closed while idle isn't handed out
+  pool.release(1, 15002, h2, true);
+  closed_by_mom.insert(h2);
+  fail_unless(pool.get(1, 15002, &err, &reused) == 2);
+  fail_unless(reused == false);
+  fail_unless(disconnects == 2);
+  fail_unless(pool.idle_count() == 0);
+
+  // nor is the local connection kept
+  pool.release(1, 15002, PBS_LOCAL_CONNECTION, true);
+  fail_unless(pool.idle_count() == 0);
+  }
+END_TEST
+
+
+
+START_TEST(test_close_idle)
+  {
+  mom_connection_pool pool(4, 60);
+  int                 err = 0;
+  bool                reused;
+  int                 h1;
+  int                 h2;
+  time_t              now = time(NULL);
+
+  reset_counters();
+
+  h1 = pool.get(1, 15002, &err, &reused);
+  h2 = pool.get(2, 15002, &err, &reused);
+  pool.release(1, 15002, h1, true);
+  pool.release(2, 15002, h2, true);
+
+  pool.close_idle(now + 30);
+  fail_unless(pool.idle_count() == 2);
+  fail_unless(disconnects == 0);
+
+  pool.close_idle(now + 61);
+  fail_unless(pool.idle_count() == 0);
+  fail_unless(disconnects == 2);
+
+  // nothing left to hand out
+  fail_unless(pool.get(1, 15002, &err, &reused) == 2);
+  fail_unless(reused == false);
+  }
+END_TEST
+
+
+
+Suite *mom_connection_pool_suite(void)
+  {
+  Suite *s = suite_create("mom_connection_pool test suite methods");
+  TCase *tc_core = tcase_create("test_get_release");
+  tcase_add_test(tc_core, test_get_release);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_unusable_connections");
+  tcase_add_test(tc_core, test_unusable_connections);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_close_idle");
+  tcase_add_test(tc_core, test_close_idle);
+  suite_add_tcase(s, tc_core);
+
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(mom_connection_pool_suite());
+  srunner_set_log(sr, "mom_connection_pool_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
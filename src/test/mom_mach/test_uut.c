@@ -4,6 +4,10 @@
 
 #include <map>
 #include <set>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
 
 #include "pbs_config.h"
 #include "mom_mach.h"
@@ -20,6 +24,7 @@ int overmem_proc(job*, unsigned long long);
 int overcpu_proc(job*, unsigned long);
 unsigned long long resi_sum(job*);
 unsigned long long mem_sum(job*);
+int read_cgroup_procs(const std::string &dir, std::vector<pid_t> &pids);
 
 double cputfactor;
 
@@ -442,6 +447,41 @@ START_TEST(test_mem_sum)
   }
 END_TEST
 
+START_TEST(test_read_cgroup_procs)
+  {
+  std::vector<pid_t> pids;
+  char               dir[] = "/tmp/cgroup_procsXXXXXX";
+  std::string        task_dir;
+  FILE              *fp;
+
+  fail_unless(mkdtemp(dir) != NULL);
+
+  /* no cgroup.procs means the cgroup can't be sampled */
+  fail_unless(read_cgroup_procs(dir, pids) == -1);
+
+  fp = fopen((std::string(dir) + "/cgroup.procs").c_str(), "w");
+  fprintf(fp, "101\n102\n");
+  fclose(fp);
+
+  task_dir = std::string(dir) + "/R0.t0";
+  mkdir(task_dir.c_str(), 0755);
+  fp = fopen((task_dir + "/cgroup.procs").c_str(), "w");
+  fprintf(fp, "201\n");
+  fclose(fp);
+
+  fail_unless(read_cgroup_procs(dir, pids) == PBSE_NONE);
+  fail_unless(pids.size() == 3);
+  fail_unless(pids[0] == 101);
+  fail_unless(pids[1] == 102);
+  fail_unless(pids[2] == 201);
+
+  unlink((task_dir + "/cgroup.procs").c_str());
+  rmdir(task_dir.c_str());
+  unlink((std::string(dir) + "/cgroup.procs").c_str());
+  rmdir(dir);
+  }
+END_TEST
+
 Suite *mom_mach_suite(void)
   {
   Suite *s = suite_create("mom_mach_suite methods");
@@ -480,6 +520,10 @@ Suite *mom_mach_suite(void)
   tcase_add_test(tc_core, test_mem_sum);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_read_cgroup_procs");
+  tcase_add_test(tc_core, test_read_cgroup_procs);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -39,6 +39,7 @@ time_t time_now;
 unsigned int pbs_mom_port = 0;
 unsigned int default_server_port = 0;
 int ServerStatUpdateInterval = DEFAULT_SERVER_STAT_UPDATES;
+int status_delta_refresh = 0;
 float ideal_load_val = -1.0;
 int updates_waiting_to_send = 0;
 const char *PBSServerCmds[] = { "NULL", "HELLO", "CLUSTER_ADDRS", "UPDATE", "STATUS", "GPU_STATUS", NULL };
@@ -3,10 +3,13 @@
 #include "test_mom_server.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <map>
 
 #include "pbs_error.h"
 #include "mom_server.h"
 #include "resmon.h"
+#include "pbs_nodes.h"
 
 #define MAXLINE 1024
 #define NO_SERVER_CONFIGURED -1
@@ -31,6 +34,14 @@ extern int    UpdateFailCount;
 extern time_t LastServerUpdateTime;
 extern int    is_reporter_mom;
 extern mom_server mom_servers[PBS_MAXSERVER];
+extern int    status_delta_refresh;
+extern int    updates_since_full_status;
+extern std::map<std::string, std::string> acked_status;
+extern std::map<std::string, std::string> sent_status;
+
+bool make_status_delta(std::vector<std::string> &status);
+void write_acked_status(int fd, bool delta);
+void read_acked_status(const std::string &reply);
 
 
 START_TEST(test_sort_paths)
@@ -219,6 +230,100 @@ START_TEST(test_mom_server_all_update_stat_clear_force)
 END_TEST
 
 
+START_TEST(test_make_status_delta)
+  {
+  std::vector<std::string> status;
+
+  acked_status.clear();
+  updates_since_full_status = 0;
+
+  status.push_back("state=free");
+  status.push_back("loadave=0.50");
+  status.push_back("gres=x");
+  status.push_back("ncpus=4");
+
+  /* delta updates are off by default */
+  status_delta_refresh = 0;
+  fail_unless(make_status_delta(status) == false);
+  fail_unless(status.size() == 4);
+
+  /* nothing acknowledged yet, so the first update is a full one */
+  status_delta_refresh = 3;
+  fail_unless(make_status_delta(status) == false);
+  fail_unless(status.size() == 4);
+  fail_unless(sent_status.size() == 4);
+
+  acked_status = sent_status;
+
+  status.clear();
+  status.push_back("state=free");
+  status.push_back("loadave=1.00");
+  status.push_back("ncpus=4");
+  status.push_back(START_GPU_STATUS);
+  status.push_back("gpu[0]=gpu_id=0");
+  status.push_back(END_GPU_STATUS);
+
+  fail_unless(make_status_delta(status) == true);
+  fail_unless(status.size() == 7);
+  fail_unless(status[0] == STATUS_DELTA_KEYWORD);
+  fail_unless(status[1] == "state=free"); /* always sent */
+  fail_unless(status[2] == "loadave=1.00");
+  fail_unless(status[3] == std::string(STATUS_UNSET_KEYWORD) + "gres");
+  fail_unless(status[4] == START_GPU_STATUS);
+  fail_unless(status[6] == END_GPU_STATUS);
+  fail_unless(sent_status.size() == 3);
+  fail_unless(sent_status["loadave"] == "loadave=1.00");
+
+  /* time for a full refresh */
+  status.clear();
+  status.push_back("state=free");
+  updates_since_full_status = 3;
+  fail_unless(make_status_delta(status) == false);
+  fail_unless(status.size() == 1);
+  }
+END_TEST
+
+
+START_TEST(test_acked_status)
+  {
+  int         fds[2];
+  char        buf[1024];
+  ssize_t     len;
+  std::string reply;
+
+  fail_unless(pipe(fds) == 0);
+
+  sent_status.clear();
+  sent_status["state"] = "state=free";
+  sent_status["loadave"] = "loadave=1.00";
+
+  fail_unless(write(fds[1], "0", 1) == 1);
+  write_acked_status(fds[1], true);
+
+  /* close() is stubbed out, so take it all in one read */
+  fail_unless((len = read(fds[0], buf, sizeof(buf))) > 0);
+  reply.assign(buf, len);
+
+  updates_since_full_status = 1;
+  read_acked_status(reply);
+  fail_unless(acked_status.size() == 2);
+  fail_unless(acked_status["state"] == "state=free");
+  fail_unless(acked_status["loadave"] == "loadave=1.00");
+  fail_unless(updates_since_full_status == 2);
+
+  /* a full update restarts the count */
+  read_acked_status("0 0\nstate=busy");
+  fail_unless(acked_status.size() == 1);
+  fail_unless(acked_status["state"] == "state=busy");
+  fail_unless(updates_since_full_status == 0);
+
+  /* nothing was acknowledged, so the next update has to be a full one */
+  read_acked_status("-1");
+  fail_unless(acked_status.size() == 0);
+  }
+END_TEST
+
+
 Suite *mom_server_suite(void)
   {
   Suite *s = suite_create("mom_server_suite methods");
@@ -238,6 +343,11 @@ Suite *mom_server_suite(void)
   tcase_add_test(tc_core, test_send_update_force_flag);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_make_status_delta");
+  tcase_add_test(tc_core, test_make_status_delta);
+  tcase_add_test(tc_core, test_acked_status);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
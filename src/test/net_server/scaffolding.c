@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <netinet/in.h>
 #include <string.h>
+#include <sys/select.h>
 
 #include "pbs_error.h"
 #include "net_connect.h"
@@ -121,14 +122,12 @@ char *PAddrToString(pbs_net_t *Addr)
 
 int get_max_num_descriptors(void)
   {
-  fprintf(stderr, "The call to get_max_num_descriptors needs to be mocked!!\n");
-  return(0);
+  return(FD_SETSIZE);
   }
 
 int get_fdset_size(void)
   {
-  fprintf(stderr, "The call to get_fdset_size needs to be mocked!!\n");
-  return(0);
+  return(sizeof(fd_set));
   }
 
 void log_err(int errnum, const char *routine, const char *text) {}
@@ -137,7 +136,7 @@ void log_record(int eventtype, int objclass, const char *objname, const char *te
 
 int pbs_getaddrinfo(const char *pNode,struct addrinfo *pHints,struct addrinfo **ppAddrInfoOut)
   {
-  return(0);
+  return(-1);
   }
 
 char *get_cached_nameinfo(const struct sockaddr_in *sai)
@@ -9,6 +9,7 @@
 #include <string>
 #include <errno.h>
 #include <string.h>
+#include <sys/socket.h>
 
 
 #include "server_limits.h"
@@ -24,6 +25,21 @@ extern bool  socket_read_code;
 int add_connection(int sock, enum conn_type type, pbs_net_t addr, unsigned int port, unsigned int socktype, void *(*func)(void *), int add_wait_request);
 void *accept_conn(void *new_conn);
 
+int wait_request_calls = 0;
+
+void *count_wait_request_calls(
+
+  void *args)
+
+  {
+  char buf[8];
+
+  wait_request_calls++;
+  read(((int *)args)[0], buf, sizeof(buf));
+
+  return(NULL);
+  }
+
 
 START_TEST(netaddr_pbs_net_t_test_one)
   {
@@ -66,6 +82,33 @@ START_TEST(test_add_connection)
   }
 END_TEST
 
+START_TEST(test_wait_request)
+  {
+  int sv[2];
+
+  fail_unless(init_network(0, count_wait_request_calls) == 0);
+  fail_unless(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  fail_unless(add_conn(sv[0], FromClientDIS, 0, 0, PBS_SOCK_UNIX, count_wait_request_calls) == PBSE_NONE);
+
+  fail_unless(write(sv[1], "x", 1) == 1);
+  fail_unless(wait_request(1, NULL) == PBSE_NONE);
+  fail_unless(wait_request_calls == 1, "%d calls", wait_request_calls);
+
+  /* the data was consumed, nothing should be dispatched */
+  fail_unless(wait_request(0, NULL) == PBSE_NONE);
+  fail_unless(wait_request_calls == 1, "%d calls", wait_request_calls);
+
+  /* sockets removed from the read set are no longer watched */
+  globalset_del_sock(sv[0]);
+  fail_unless(write(sv[1], "x", 1) == 1);
+  fail_unless(wait_request(0, NULL) == PBSE_NONE);
+  fail_unless(wait_request_calls == 1, "%d calls", wait_request_calls);
+
+  close(sv[0]);
+  close(sv[1]);
+  }
+END_TEST
+
 START_TEST(test_ping_trqauthd)
   {
   int rc;
@@ -161,6 +204,10 @@ Suite *net_server_suite(void)
   tcase_add_test(tc_core, test_add_connection);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_wait_request");
+  tcase_add_test(tc_core, test_wait_request);
+  suite_add_tcase(s, tc_core);
+
   tc_core = tcase_create("test_ping_trqauthd");
   tcase_add_test(tc_core, test_ping_trqauthd);
   suite_add_tcase(s, tc_core);
@@ -21,6 +21,8 @@
 #include "threadpool.h"
 #include "mom_hierarchy_handler.h"
 #include "machine.hpp"
+#include "node_index.hpp"
+#include "change_log.hpp"
 
 
 std::string attrname;
@@ -531,3 +533,26 @@ int Machine::getTotalChips() const
   return(0);
   }
 
+
+node_index allnodes_index;
+
+node_index::node_index() {}
+
+node_index::~node_index() {}
+
+void node_index::update(const std::string &name, const std::vector<std::string> &props, int free_slots, bool is_available, bool is_opaque) {}
+
+void node_index::remove(const std::string &name) {}
+
+change_log server_changes(0, 0);
+
+change_log::change_log(long long start, size_t max) {}
+
+change_log::~change_log() {}
+
+long long change_log::next()
+  {
+  return(0);
+  }
+
+void change_log::record_deletion(int objtype, const char *name, const char *container) {}
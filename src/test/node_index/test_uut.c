@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "node_index.hpp"
+#include <check.h>
+
+
+std::vector<node_index_req> make_reqs(
+
+  const char *prop,
+  int         slots)
+
+  {
+  std::vector<node_index_req> reqs;
+  node_index_req              req;
+
+  if (prop != NULL)
+    req.props.push_back(prop);
+
+  req.slots = slots;
+  reqs.push_back(req);
+
+  return(reqs);
+  }
+
+
+
+START_TEST(test_update_remove)
+  {
+  node_index               ni;
+  std::vector<std::string> props;
+  std::vector<std::string> candidates;
+
+  fail_unless(ni.count() == 0);
+
+  props.push_back("bigmem");
+  ni.update("napali", props, 8, true, false);
+  ni.update("waimea", std::vector<std::string>(), 8, true, false);
+  ni.update("kailua", props, 8, true, false);
+  fail_unless(ni.count() == 3);
+
+  // updating an existing node doesn't add it again
+  ni.update("napali", props, 4, true, false);
+  fail_unless(ni.count() == 3);
+
+  fail_unless(ni.get_candidates(make_reqs(NULL, 1), candidates) == true);
+  fail_unless(candidates.size() == 3);
+  fail_unless(candidates[0] == "napali");
+  fail_unless(candidates[2] == "kailua");
+
+  ni.remove("napali");
+  ni.remove("napali");
+  fail_unless(ni.count() == 2);
+
+  candidates.clear();
+  fail_unless(ni.get_candidates(make_reqs("bigmem", 1), candidates) == true);
+  fail_unless(candidates.size() == 1);
+  fail_unless(candidates[0] == "kailua");
+
+  // a removed node that comes back goes to the end
+  ni.update("napali", props, 4, true, false);
+  candidates.clear();
+  ni.get_candidates(make_reqs("bigmem", 1), candidates);
+  fail_unless(candidates.size() == 2);
+  fail_unless(candidates[1] == "napali");
+  }
+END_TEST
+
+
+
+
+START_TEST(test_get_candidates)
+  {
+  node_index                  ni;
+  std::vector<std::string>    props;
+  std::vector<std::string>    candidates;
+  std::vector<node_index_req> reqs;
+
+  props.push_back("fast");
+  ni.update("n1", props, 2, true, false);
+  ni.update("n2", props, 16, true, false);
+  ni.update("n3", props, 16, false, false);
+  ni.update("n4", std::vector<std::string>(), 16, true, false);
+  ni.update("n5", props, 0, true, false);
+
+  // busy nodes and nodes without the property are left out
+  fail_unless(ni.get_candidates(make_reqs("fast", 1), candidates) == true);
+  fail_unless(candidates.size() == 2);
+  fail_unless(candidates[0] == "n1");
+  fail_unless(candidates[1] == "n2");
+
+  // so are nodes with too few free slots
+  candidates.clear();
+  ni.get_candidates(make_reqs("fast", 8), candidates);
+  fail_unless(candidates.size() == 1);
+  fail_unless(candidates[0] == "n2");
+
+  candidates.clear();
+  ni.get_candidates(make_reqs("slow", 1), candidates);
+  fail_unless(candidates.size() == 0);
+
+  // a node fitting any of the reqs is a candidate
+  reqs = make_reqs("fast", 8);
+  reqs.push_back(make_reqs(NULL, 1)[0]);
+  candidates.clear();
+  ni.get_candidates(reqs, candidates);
+  fail_unless(candidates.size() == 3);
+  fail_unless(candidates[2] == "n4");
+
+  // one node the index can't describe turns it off
+  ni.update("n6", props, 16, true, true);
+  candidates.clear();
+  fail_unless(ni.get_candidates(make_reqs("fast", 1), candidates) == false);
+
+  ni.update("n6", props, 16, true, false);
+  fail_unless(ni.get_candidates(make_reqs("fast", 1), candidates) == true);
+  }
+END_TEST
+
+
+
+
+Suite *node_index_suite(void)
+  {
+  Suite *s = suite_create("node_index test suite methods");
+  TCase *tc_core = tcase_create("test_update_remove");
+  tcase_add_test(tc_core, test_update_remove);
+  suite_add_tcase(s, tc_core);
+  
+  tc_core = tcase_create("test_get_candidates");
+  tcase_add_test(tc_core, test_get_candidates);
+  suite_add_tcase(s, tc_core);
+  
+  return(s);
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(node_index_suite());
+  srunner_set_log(sr, "node_index_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return(number_failed);
+  }
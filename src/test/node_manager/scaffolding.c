@@ -21,6 +21,7 @@
 #include "id_map.hpp"
 #include "machine.hpp"
 #include "complete_req.hpp"
+#include "node_index.hpp"
 
 
 char *path_node_usage = strdup("/tmp/idontexistatallnotevenalittle");
@@ -744,3 +745,20 @@ bool task_hosts_match(
   return(true);
   }
 
+
+void update_node_index(struct pbsnode *pnode) {}
+
+node_index::node_index() {}
+
+node_index::~node_index() {}
+
+bool node_index::get_candidates(
+
+  const std::vector<node_index_req> &reqs,
+  std::vector<std::string>          &candidates)
+
+  {
+  return(false);
+  }
+
+void node_changed(struct pbsnode *pnode) {}
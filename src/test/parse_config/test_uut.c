@@ -9,10 +9,12 @@
 extern int encode_used_ctr;
 extern int encode_flagged_attrs_ctr;
 extern int MOMCudaVisibleDevices;
+extern int status_delta_refresh;
 
 void add_job_status_information(job &pjob, std::stringstream &list);
 u_long setcudavisibledevices(const char *value);
 unsigned long setjobstarterprivileged(const char *);
+unsigned long setstatusdeltarefresh(const char *);
 
 int jobstarter_privileged = 0;
 char         PBSNodeMsgBuf[MAXLINE];
@@ -76,6 +78,23 @@ START_TEST(test_setjobstarterprivileged)
 END_TEST
 
 
+START_TEST(test_setstatusdeltarefresh)
+  {
+  fail_unless(status_delta_refresh == 0, "delta updates should be off by default");
+
+  fail_unless(setstatusdeltarefresh("10") == 1);
+  fail_unless(status_delta_refresh == 10);
+
+  fail_unless(setstatusdeltarefresh("0") == 1);
+  fail_unless(status_delta_refresh == 0);
+
+  fail_unless(setstatusdeltarefresh("-1") == 0);
+  fail_unless(setstatusdeltarefresh("often") == 0);
+  fail_unless(status_delta_refresh == 0);
+  }
+END_TEST
+
+
 Suite *parse_config_suite(void)
   {
   Suite *s = suite_create("parse_config test suite methods");
@@ -90,6 +109,10 @@ Suite *parse_config_suite(void)
   tc_core = tcase_create("test_setjobstarterprivileged");
   tcase_add_test(tc_core, test_setjobstarterprivileged);
   suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_setstatusdeltarefresh");
+  tcase_add_test(tc_core, test_setstatusdeltarefresh);
+  suite_add_tcase(s, tc_core);
   
   return(s);
   }
@@ -154,3 +154,5 @@ int socket_wait_for_write(int sock)
   {
   return(0);
   }
+
+void PBSD_session_free(struct pbs_session *ps) {}
@@ -18,10 +18,25 @@ START_TEST(test_pbs_runjob_err)
 END_TEST
 
 
-START_TEST(test_two)
+START_TEST(test_pbs_runjobs)
   {
+  char *ids[2];
+  int   codes[2];
 
+  ids[0] = strdup("1.napali");
+  ids[1] = strdup("2.napali");
 
+  fail_unless(pbs_runjobs(-1, 2, ids, NULL, NULL, codes) == PBSE_IVALREQ);
+  fail_unless(pbs_runjobs(PBS_NET_MAX_CONNECTIONS, 2, ids, NULL, NULL, codes) == PBSE_IVALREQ);
+  fail_unless(pbs_runjobs(0, -1, ids, NULL, NULL, codes) == PBSE_IVALREQ);
+
+  // nothing to run means nothing is sent
+  fail_unless(pbs_runjobs(0, 0, ids, NULL, NULL, codes) == PBSE_NONE);
+
+  ids[1][0] = '\0';
+  fail_unless(pbs_runjobs(0, 2, ids, NULL, NULL, codes) == PBSE_IVALREQ);
+  ids[1] = NULL;
+  fail_unless(pbs_runjobs(0, 2, ids, NULL, NULL, codes) == PBSE_IVALREQ);
   }
 END_TEST
 
@@ -32,8 +47,8 @@ Suite *pbsD_runjob_suite(void)
   tcase_add_test(tc_core, test_pbs_runjob_err);
   suite_add_tcase(s, tc_core);
 
-  tc_core = tcase_create("test_two");
-  tcase_add_test(tc_core, test_two);
+  tc_core = tcase_create("test_pbs_runjobs");
+  tcase_add_test(tc_core, test_pbs_runjobs);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -0,0 +1,117 @@
+#include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+
+#include "libpbs.h" /* connect_handle */
+#include "server_limits.h" /* PBS_NET_MAX_CONNECTIONS */
+#include "dis.h"
+#include "tcp.h"
+
+struct connect_handle connection[PBS_NET_MAX_CONNECTIONS];
+char pbs_current_user[PBS_MAXUSER];
+
+/* the tags of the replies the fake server sends, in order */
+std::deque<unsigned int> reply_tags;
+int  replies_read = 0;
+int  open_rc = PBSE_NONE;
+int  connects = 0;
+int  disconnects = 0;
+
+unsigned disrui(struct tcp_chan *chan, int *retval)
+  {
+  unsigned int tag;
+
+  if (reply_tags.empty())
+    {
+    *retval = DIS_EOD;
+    return(0);
+    }
+
+  tag = reply_tags.front();
+  reply_tags.pop_front();
+  *retval = DIS_SUCCESS;
+
+  return(tag);
+  }
+
+int decode_DIS_replyCmd(struct tcp_chan *chan, struct batch_reply *reply)
+  {
+  replies_read++;
+  reply->brp_code = replies_read;
+  reply->brp_choice = BATCH_REPLY_CHOICE_NULL;
+
+  return(DIS_SUCCESS);
+  }
+
+struct tcp_chan *DIS_tcp_setup(int fd)
+  {
+  struct tcp_chan *chan = (struct tcp_chan *)calloc(1, sizeof(struct tcp_chan));
+
+  chan->sock = fd;
+
+  return(chan);
+  }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan)
+  {
+  free(chan);
+  }
+
+int DIS_tcp_wflush(struct tcp_chan *chan)
+  {
+  return(0);
+  }
+
+int encode_DIS_ReqHdr(struct tcp_chan *chan, int reqt, char *user)
+  {
+  return(0);
+  }
+
+int encode_DIS_ReqExtend(struct tcp_chan *chan, char *extend)
+  {
+  return(0);
+  }
+
+void PBSD_FreeReply(struct batch_reply *reply)
+  {
+  free(reply);
+  }
+
+struct batch_reply *PBSD_rdrpy(int *local_errno, int c)
+  {
+  connection[c].ch_errno = open_rc;
+  *local_errno = open_rc;
+
+  if (open_rc == PBSE_TIMEOUT)
+    return(NULL);
+
+  return((struct batch_reply *)calloc(1, sizeof(struct batch_reply)));
+  }
+
+int pbs_connect(char *server)
+  {
+  connects++;
+  connection[1].ch_inuse = TRUE;
+  connection[1].ch_socket = 7;
+  connection[1].ch_session = NULL;
+
+  return(1);
+  }
+
+int pbs_disconnect(int c)
+  {
+  disconnects++;
+  PBSD_session_free(connection[c].ch_session);
+  connection[c].ch_session = NULL;
+  connection[c].ch_inuse = FALSE;
+
+  return(0);
+  }
+
+char *pbs_strerror(int err)
+  {
+  return((char *)"session error");
+  }
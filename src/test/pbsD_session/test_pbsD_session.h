@@ -0,0 +1,8 @@
+#include "license_pbs.h" /* See here for the software license */
+#ifndef _PBSD_SESSION_CT_H
+#define _PBSD_SESSION_CT_H
+#include <check.h>
+
+Suite *pbsD_session_suite();
+
+#endif /* _PBSD_SESSION_CT_H */
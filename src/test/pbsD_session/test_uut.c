@@ -0,0 +1,178 @@
+#include "license_pbs.h" /* See here for the software license */
+#include "lib_ifl.h"
+#include "test_pbsD_session.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <deque>
+
+#include "dis.h"
+#include "pbs_error.h"
+#include "pbs_ifl.h"
+
+extern std::deque<unsigned int> reply_tags;
+extern int replies_read;
+extern int open_rc;
+extern int connects;
+extern int disconnects;
+
+
+void reset_session_test()
+  {
+  pthread_mutexattr_t attr;
+
+  reply_tags.clear();
+  replies_read = 0;
+  open_rc = PBSE_NONE;
+  connects = 0;
+  disconnects = 0;
+
+  if (connection[1].ch_mutex == NULL)
+    {
+    connection[1].ch_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ERRORCHECK);
+    pthread_mutex_init(connection[1].ch_mutex, &attr);
+    }
+  }
+
+
+START_TEST(test_pbs_session_open)
+  {
+  unsigned int tag;
+  int          c;
+
+  reset_session_test();
+
+  c = pbs_session_open((char *)"napali");
+  fail_unless(c == 1);
+  fail_unless(connects == 1);
+  fail_unless(connection[c].ch_session != NULL);
+
+  fail_unless(PBSD_session_tag(7, &tag) == TRUE);
+  fail_unless(tag == 1);
+  fail_unless(PBSD_session_tag(7, &tag) == TRUE);
+  fail_unless(tag == 2);
+
+  /* only the session's socket is tagged */
+  fail_unless(PBSD_session_tag(8, &tag) == FALSE);
+
+  pbs_session_close(c);
+  fail_unless(connection[c].ch_session == NULL);
+  fail_unless(PBSD_session_tag(7, &tag) == FALSE);
+
+  /* a server without sessions gets a plain connection */
+  reset_session_test();
+  open_rc = PBSE_UNKREQ;
+
+  c = pbs_session_open((char *)"napali");
+  fail_unless(c == 1);
+  fail_unless(connects == 2);
+  fail_unless(disconnects == 1);
+  fail_unless(connection[c].ch_session == NULL);
+
+  reset_session_test();
+  open_rc = PBSE_TIMEOUT;
+
+  c = pbs_session_open((char *)"napali");
+  fail_unless(c == 1);
+  fail_unless(connects == 2);
+  fail_unless(connection[c].ch_session == NULL);
+
+  /* but a real error is passed on */
+  reset_session_test();
+  open_rc = PBSE_PERM;
+
+  fail_unless(pbs_session_open((char *)"napali") == -1 * PBSE_PERM);
+  fail_unless(connects == 1);
+  fail_unless(disconnects == 1);
+  }
+END_TEST
+
+
+START_TEST(test_PBSD_session_rdrpy)
+  {
+  struct batch_reply *reply;
+  unsigned int        tag;
+  int                 local_errno = 0;
+  int                 c;
+
+  reset_session_test();
+
+  c = pbs_session_open((char *)"napali");
+  fail_unless(connection[c].ch_session != NULL);
+
+  fail_unless(PBSD_session_tag(7, &tag) == TRUE);
+  fail_unless(PBSD_session_tag(7, &tag) == TRUE);
+
+  /* the reply to the other request comes first and is kept for it,
+   * and one nobody asked for is dropped */
+  reply_tags.push_back(1);
+  reply_tags.push_back(99);
+  reply_tags.push_back(2);
+
+  pthread_mutex_lock(connection[c].ch_mutex);
+  reply = PBSD_session_rdrpy(&local_errno, c);
+  fail_unless(reply != NULL);
+  fail_unless(reply->brp_code == 3);
+  fail_unless(replies_read == 3);
+  fail_unless(connection[c].ch_errno == 3);
+
+  /* the caller's hold on the connection is given back */
+  fail_unless(pthread_mutex_unlock(connection[c].ch_mutex) == 0);
+  free(reply);
+
+  /* nothing outstanding */
+  reply = PBSD_session_rdrpy(&local_errno, c);
+  fail_unless(reply == NULL);
+  fail_unless(local_errno == PBSE_IVALREQ);
+
+  /* once a read fails the replies can't be trusted */
+  fail_unless(PBSD_session_tag(7, &tag) == TRUE);
+  reply = PBSD_session_rdrpy(&local_errno, c);
+  fail_unless(reply == NULL);
+  fail_unless(local_errno == PBSE_PROTOCOL);
+  fail_unless(connection[c].ch_errno == PBSE_PROTOCOL);
+
+  reply_tags.push_back(4);
+  fail_unless(PBSD_session_tag(7, &tag) == TRUE);
+  reply = PBSD_session_rdrpy(&local_errno, c);
+  fail_unless(reply == NULL);
+  fail_unless(local_errno == PBSE_PROTOCOL);
+  fail_unless(reply_tags.size() == 1);
+
+  pbs_session_close(c);
+  }
+END_TEST
+
+
+Suite *pbsD_session_suite(void)
+  {
+  Suite *s = suite_create("pbsD_session_suite methods");
+  TCase *tc_core = tcase_create("test_pbs_session_open");
+  tcase_add_test(tc_core, test_pbs_session_open);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_PBSD_session_rdrpy");
+  tcase_add_test(tc_core, test_PBSD_session_rdrpy);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+  }
+
+void rundebug()
+  {
+  }
+
+int main(void)
+  {
+  int number_failed = 0;
+  SRunner *sr = NULL;
+  rundebug();
+  sr = srunner_create(pbsD_session_suite());
+  srunner_set_log(sr, "pbsD_session_suite.log");
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return number_failed;
+  }
@@ -1,6 +1,8 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <string.h>
+#include <unistd.h>
 
 #include "libpbs.h" /* connect_handle */
 #include "attribute.h" /* attropl */
@@ -32,3 +34,31 @@ int PBSD_QueueJob_hash(int connect, char *jobid, char *destin, job_data_containe
  exit(1);
  }
 
+
+size_t submitted_script_len = 0;
+
+int PBSD_SubmitJob_hash(int connect, char *destin, job_data_container *job_attr, job_data_container *res_attr, char *script, size_t script_len, char *extend, char **job_id, char **msg)
+ {
+ submitted_script_len = script_len;
+ return(0);
+ }
+
+int         submitted_count = 0;
+int         submit_many_rc = 0;
+const char *submit_many_results = NULL;
+
+int PBSD_SubmitMany_hash(int connect, int count, char **destins, job_data_container **job_attrs, job_data_container **res_attrs, char **scripts, size_t *script_lens, char *extend, char **results)
+ {
+ submitted_count = count;
+
+ if ((submit_many_rc == 0) &&
+     (submit_many_results != NULL))
+   *results = strdup(submit_many_results);
+
+ return(submit_many_rc);
+ }
+
+ssize_t read_ac_socket(int fd, void *buf, ssize_t count)
+ {
+ return(read(fd, buf, count));
+ }
@@ -3,9 +3,17 @@
 #include "test_pbsD_submit_hash.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
 
 #include "pbs_error.h"
+#include "libpbs.h"
+
+extern size_t      submitted_script_len;
+extern int         submitted_count;
+extern int         submit_many_rc;
+extern const char *submit_many_results;
 
 START_TEST(test_pbs_submit_hash)
   {
@@ -15,10 +23,90 @@ START_TEST(test_pbs_submit_hash)
 END_TEST
 
 
-START_TEST(test_two)
+START_TEST(test_pbs_submit_commit_hash)
+  {
+  char  script[] = "./submit_commit_test.sh";
+  char  body[] = "#!/bin/sh\nsleep 30\n";
+  char  big[SCRIPT_CHUNK_Z + 1];
+  FILE *fp;
+
+  fail_unless(pbs_submit_commit_hash(-1, NULL, NULL, NULL, NULL, NULL, NULL, NULL) == PBSE_IVALREQ);
+  fail_unless(pbs_submit_commit_hash(PBS_NET_MAX_CONNECTIONS, NULL, NULL, NULL, NULL, NULL, NULL, NULL) == PBSE_IVALREQ);
+  fail_unless(pbs_submit_commit_hash(0, NULL, NULL, (char *)"./no_such_script.sh", NULL, NULL, NULL, NULL) == PBSE_BADSCRIPT);
+
+  fp = fopen(script, "w");
+  fail_unless(fp != NULL);
+  fputs(body, fp);
+  fclose(fp);
+
+  submitted_script_len = 0;
+  fail_unless(pbs_submit_commit_hash(0, NULL, NULL, script, NULL, NULL, NULL, NULL) == PBSE_NONE);
+  fail_unless(submitted_script_len == strlen(body));
+
+  /* scripts that don't fit in one chunk go through the old sequence */
+  memset(big, '#', sizeof(big));
+  fp = fopen(script, "w");
+  fail_unless(fp != NULL);
+  fwrite(big, 1, sizeof(big), fp);
+  fclose(fp);
+
+  submitted_script_len = 0;
+  fail_unless(pbs_submit_commit_hash(0, NULL, NULL, script, NULL, NULL, NULL, NULL) == PBSE_NOSUP);
+  fail_unless(submitted_script_len == 0);
+
+  unlink(script);
+  }
+END_TEST
+
+
+START_TEST(test_pbs_submit_many)
   {
+  char  script[] = "./submit_many_test.sh";
+  char  big_script[] = "./submit_many_big.sh";
+  char  big[SCRIPT_CHUNK_Z + 1];
+  char *scripts[4] = { script, big_script, script, script };
+  char *destins[4] = { NULL, NULL, NULL, NULL };
+  job_data_container *attrs[4] = { NULL, NULL, NULL, NULL };
+  char *jobids[4];
+  int   codes[4];
+  FILE *fp;
+
+  fail_unless(pbs_submit_many(-1, 1, NULL, NULL, scripts, destins, NULL, jobids, codes) == PBSE_IVALREQ);
+
+  fp = fopen(script, "w");
+  fail_unless(fp != NULL);
+  fputs("#!/bin/sh\nsleep 30\n", fp);
+  fclose(fp);
 
+  memset(big, '#', sizeof(big));
+  fp = fopen(big_script, "w");
+  fail_unless(fp != NULL);
+  fwrite(big, 1, sizeof(big), fp);
+  fclose(fp);
 
+  /* the oversized script is left for the caller, the short reply is a
+   * protocol error for the job it doesn't cover */
+  submit_many_rc = PBSE_NONE;
+  submit_many_results = "0 1.napali\n15007 Unauthorized Request\n";
+  fail_unless(pbs_submit_many(0, 4, attrs, attrs, scripts, destins, NULL, jobids, codes) == PBSE_NONE);
+  fail_unless(submitted_count == 3);
+  fail_unless(codes[0] == PBSE_NONE);
+  fail_unless(!strcmp(jobids[0], "1.napali"));
+  fail_unless(codes[1] == PBSE_NOSUP);
+  fail_unless(jobids[1] == NULL);
+  fail_unless(codes[2] == PBSE_PERM);
+  fail_unless(jobids[2] == NULL);
+  fail_unless(codes[3] == PBSE_PROTOCOL);
+  free(jobids[0]);
+
+  /* a server that doesn't know the request */
+  submit_many_rc = PBSE_NOSUP;
+  fail_unless(pbs_submit_many(0, 4, attrs, attrs, scripts, destins, NULL, jobids, codes) == PBSE_NOSUP);
+  fail_unless(codes[0] == PBSE_NOSUP);
+  fail_unless(codes[3] == PBSE_NOSUP);
+
+  unlink(script);
+  unlink(big_script);
   }
 END_TEST
 
@@ -30,8 +118,12 @@ Suite *pbsD_submit_hash_suite(void)
   tcase_add_test(tc_core, test_pbs_submit_hash);
   suite_add_tcase(s, tc_core);
 
-  tc_core = tcase_create("test_two");
-  tcase_add_test(tc_core, test_two);
+  tc_core = tcase_create("test_pbs_submit_commit_hash");
+  tcase_add_test(tc_core, test_pbs_submit_commit_hash);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_pbs_submit_many");
+  tcase_add_test(tc_core, test_pbs_submit_many);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -7,6 +7,8 @@
 #include <dirent.h>
 
 #include <string>
+#include <pthread.h>
+#include <unistd.h>
 
 #include "pbs_error.h"
 
@@ -87,10 +89,72 @@ START_TEST(test_one)
   }
 END_TEST
 
+void *log_async_records(
+
+  void *vp)
+
+  {
+  for (int i = 0; i < 200; i++)
+    log_record(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, "async", "async test record");
+
+  return(NULL);
+  }
+
 START_TEST(test_two)
   {
+  char           path[] = "/tmp/pbs_log_asyncXXXXXX";
+  char           dir[] = "/tmp";
+  char           line[1024];
+  char           last[1024];
+  pthread_t      threads[4];
+  unsigned long  queued;
+  unsigned long  dropped;
+  unsigned long  found = 0;
+  int            fd;
+  FILE          *fp;
+
+  fd = mkstemp(path);
+  fail_unless(fd >= 0);
+  close(fd);
+
+  pthread_mutex_lock(&log_mutex);
+  fail_unless(log_open(path, dir) == 0);
+  pthread_mutex_unlock(&log_mutex);
+
+  fail_unless(log_async_start() == PBSE_NONE);
+
+  for (int i = 0; i < 4; i++)
+    pthread_create(&threads[i], NULL, log_async_records, NULL);
+
+  for (int i = 0; i < 4; i++)
+    pthread_join(threads[i], NULL);
+
+  log_get_async_stats(&queued, &dropped);
+  fail_unless(queued + dropped == 800);
+
+  /* closing the log writes everything still queued before the close message */
+  pthread_mutex_lock(&log_mutex);
+  log_close(1);
+  pthread_mutex_unlock(&log_mutex);
+
+  log_async_stop();
+
+  fp = fopen(path, "r");
+  fail_unless(fp != NULL);
+
+  while (fgets(line, sizeof(line), fp) != NULL)
+    {
+    if (strstr(line, ";async;async test record") != NULL)
+      found++;
+
+    strcpy(last, line);
+    }
 
+  fclose(fp);
+  unlink(path);
 
+  fail_unless(found == queued, "found %lu of %lu records", found, queued);
+  fail_unless(strstr(last, "Log closed") != NULL);
   }
 END_TEST
 
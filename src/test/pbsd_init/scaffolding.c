@@ -87,8 +87,6 @@ const char *msg_init_unkstate = "Unable to recover job in strange substate: %d";
 all_jobs array_summary;
 attribute_def svr_attr_def[10];
 int a_opt_init = -1;
-all_tasks task_list_timed;
-pthread_mutex_t task_list_timed_mutex;
 char *path_jobinfo_log;
 int LOGLEVEL = 7; /* force logging code to be exercised as tests run */
 pthread_mutex_t *svr_requests_mutex = NULL;
@@ -476,8 +474,13 @@ char *threadsafe_tokenizer(char **str, const char *delims)
   exit(1);
   }
 
+long use_jobs_subdirs_attr = 0;
+
 int get_svr_attr_l(int index, long *l)
   {
+  if (index == SRV_ATR_use_jobs_subdirs)
+    *l = use_jobs_subdirs_attr;
+
   return(0);
   }
 
@@ -6,10 +6,31 @@
 #include <unistd.h>
 #include <log.h>
 #include "pbs_error.h"
+#include <string>
+#include <vector>
+#include <algorithm>
 
 int mk_subdirs(char **);
+int scan_recovery_files(std::vector<std::string> &files);
+int recover_files_in_parallel(std::vector<std::string> &files, int type, int (*process)(const char *, int), int *thread_count);
 
 extern char global_log_ext_msg[LOCAL_LOG_BUF_SIZE];
+extern long use_jobs_subdirs_attr;
+
+pthread_mutex_t recovered_mutex = PTHREAD_MUTEX_INITIALIZER;
+std::vector<std::string> recovered;
+
+int record_recovered(const char *filename, int type)
+  {
+  pthread_mutex_lock(&recovered_mutex);
+  recovered.push_back(filename);
+  pthread_mutex_unlock(&recovered_mutex);
+
+  if (!strcmp(filename, "bad.JB"))
+    return(-1);
+
+  return(PBSE_NONE);
+  }
 
 START_TEST(test_mk_subdirs)
   {
@@ -40,6 +61,72 @@ START_TEST(test_mk_subdirs)
 END_TEST
 
 
+START_TEST(test_scan_recovery_files)
+  {
+  std::vector<std::string> files;
+  char                     cwd[MAX_PATH_LEN];
+
+  fail_unless(getcwd(cwd, sizeof(cwd)) != NULL);
+  fail_unless(system("rm -rf ./recov_dir && mkdir -p ./recov_dir/3 && touch ./recov_dir/1.napali.JB ./recov_dir/3/13.napali.JB") == 0);
+  fail_unless(chdir("./recov_dir") == 0);
+
+  // without subdirectories the numbered directory is just another entry
+  use_jobs_subdirs_attr = 0;
+  fail_unless(scan_recovery_files(files) == PBSE_NONE);
+  std::sort(files.begin(), files.end());
+  fail_unless(files.size() == 2);
+  fail_unless(files[0] == "1.napali.JB");
+  fail_unless(files[1] == "3");
+
+  files.clear();
+  use_jobs_subdirs_attr = 1;
+  fail_unless(scan_recovery_files(files) == PBSE_NONE);
+  std::sort(files.begin(), files.end());
+  fail_unless(files.size() == 2);
+  fail_unless(files[0] == "1.napali.JB");
+  fail_unless(files[1] == "3/13.napali.JB");
+  use_jobs_subdirs_attr = 0;
+
+  fail_unless(chdir(cwd) == 0);
+  fail_unless(system("rm -rf ./recov_dir") == 0);
+  }
+END_TEST
+
+
+START_TEST(test_recover_files_in_parallel)
+  {
+  std::vector<std::string> files;
+  char                     buf[32];
+  int                      threads = 0;
+
+  for (int i = 0; i < 100; i++)
+    {
+    snprintf(buf, sizeof(buf), "%d.napali.JB", i);
+    files.push_back(buf);
+    }
+
+  recovered.clear();
+  fail_unless(recover_files_in_parallel(files, 0, record_recovered, &threads) == PBSE_NONE);
+  fail_unless(threads >= 1);
+  fail_unless(recovered.size() == files.size());
+
+  // every file is processed exactly once
+  std::sort(recovered.begin(), recovered.end());
+  std::sort(files.begin(), files.end());
+  fail_unless(recovered == files);
+
+  // an error from any file is reported
+  files.push_back("bad.JB");
+  recovered.clear();
+  fail_unless(recover_files_in_parallel(files, 0, record_recovered, NULL) == -1);
+  fail_unless(recovered.size() == files.size());
+
+  files.clear();
+  fail_unless(recover_files_in_parallel(files, 0, record_recovered, &threads) == PBSE_NONE);
+  }
+END_TEST
+
+
 START_TEST(test_two)
   {
 
@@ -54,6 +141,8 @@ Suite *pbsd_init_suite(void)
   suite_add_tcase(s, tc_core);
 
   tc_core = tcase_create("test_two");
+  tcase_add_test(tc_core, test_scan_recovery_files);
+  tcase_add_test(tc_core, test_recover_files_in_parallel);
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
 
@@ -220,6 +220,13 @@ int log_open(char *filename, char *directory)
   exit(1);
   }
 
+int log_async_start(void)
+  {
+  return(0);
+  }
+
+void log_async_stop(void) {}
+
 int init_network(unsigned int socket, void *(*readfunc)(void *))
   {
   fprintf(stderr, "The call to init_network needs to be mocked!!\n");
@@ -508,3 +515,6 @@ void clear_all_alps_reservations() {}
 completed_jobs_map_class::completed_jobs_map_class() {}
 completed_jobs_map_class::~completed_jobs_map_class() {}
 void *remove_completed_jobs(void *vp) {return(NULL);}
+
+void check_job_subscribers(struct work_task *ptask) {}
+void check_mom_connections(struct work_task *ptask) {}
@@ -183,6 +183,14 @@ int node_status_list(
   int            actmode)       /*action mode; "NEW" or "ALTER"   */
 
   {
+  struct pbsnode *np = (struct pbsnode *)pnode;
+
+  if (actmode == ATR_ACTION_ALTER)
+    {
+    np->nd_status = new_attr->at_val.at_arst;
+    new_attr->at_val.at_arst = NULL;
+    }
+
   return(0);
   }
 
@@ -354,3 +362,5 @@ bool task_hosts_match(const char *one, const char *two)
 #include "../../lib/Libutils/allocation.cpp"
 #include "../../lib/Libattr/req.cpp"
 #include "../../lib/Libattr/complete_req.cpp"
+
+void node_changed(struct pbsnode *pnode) {}
@@ -1,12 +1,39 @@
 #include "pbs_nodes.h"
+#include "attribute.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <check.h>
+#include <set>
 
 #include "pbs_error.h"
 
 int set_note_error(struct pbsnode *np, const char *str);
 int restore_note(struct pbsnode *np);
+struct array_strings *build_status_arst(std::vector<const char *> &entries);
+int save_node_status_delta(struct pbsnode *np, pbs_attribute *temp, std::set<std::string> &unset);
+
+/* the node's status entries, comma separated, without the rectime */
+
+std::string stored_status(
+
+  struct pbsnode *np)
+
+  {
+  std::string status;
+
+  for (int i = 0; i < np->nd_status->as_usedptr; i++)
+    {
+    if (!strncmp(np->nd_status->as_string[i], "rectime=", 8))
+      continue;
+
+    if (status.size() != 0)
+      status += ",";
+
+    status += np->nd_status->as_string[i];
+    }
+
+  return(status);
+  }
 
 START_TEST(test_set_note_error)
   {
@@ -57,6 +84,53 @@ END_TEST
 
 
 
+START_TEST(test_save_node_status_delta)
+  {
+  struct pbsnode            *pnode = (struct pbsnode *)calloc(1, sizeof(pbsnode));
+  std::vector<const char *>  entries;
+  std::set<std::string>      unset;
+  pbs_attribute              temp;
+
+  /* a delta with nothing stored yet keeps just the changes */
+  memset(&temp, 0, sizeof(temp));
+  entries.push_back("state=free");
+  temp.at_val.at_arst = build_status_arst(entries);
+  fail_unless(save_node_status_delta(pnode, &temp, unset) == PBSE_NONE);
+  fail_unless(stored_status(pnode) == "state=free");
+
+  entries.clear();
+  entries.push_back("rectime=1");
+  entries.push_back("state=free");
+  entries.push_back("varattr=a");
+  entries.push_back("b");
+  entries.push_back("loadave=0.50");
+  entries.push_back("gres=x");
+  pnode->nd_status = build_status_arst(entries);
+
+  entries.clear();
+  entries.push_back("loadave=1.00");
+  entries.push_back("ncpus=4");
+  temp.at_val.at_arst = build_status_arst(entries);
+  unset.insert("varattr");
+
+  fail_unless(save_node_status_delta(pnode, &temp, unset) == PBSE_NONE);
+  fail_unless(stored_status(pnode) == "state=free,gres=x,loadave=1.00,ncpus=4",
+    stored_status(pnode).c_str());
+  fail_unless(unset.size() == 0);
+
+  /* exactly one fresh rectime */
+  fail_unless(pnode->nd_status->as_usedptr == 5);
+  fail_unless(strcmp(pnode->nd_status->as_string[4], "rectime=1") != 0);
+
+  /* an empty delta only refreshes rectime */
+  temp.at_val.at_arst = NULL;
+  fail_unless(save_node_status_delta(pnode, &temp, unset) == PBSE_NONE);
+  fail_unless(stored_status(pnode) == "state=free,gres=x,loadave=1.00,ncpus=4");
+  }
+END_TEST
+
+
+
 Suite *process_mom_update_suite(void)
   {
   Suite *s = suite_create("process_mom_update test suite methods");
@@ -67,6 +141,10 @@ Suite *process_mom_update_suite(void)
   tc_core = tcase_create("test_two");
   tcase_add_test(tc_core, test_two);
   suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_save_node_status_delta");
+  tcase_add_test(tc_core, test_save_node_status_delta);
+  suite_add_tcase(s, tc_core);
   
   return(s);
   }
@@ -14,6 +14,7 @@
 #include "pbs_nodes.h" /* pbsnode */
 #include "attribute.h" /* pbs_attribute */
 #include "threadpool.h"
+#include "client_session.h"
 
 bool exit_called = false;
 const char *msg_err_noqueue = "Unable to requeue job, queue is not defined";
@@ -60,6 +61,12 @@ int req_rerunjob(batch_request *preq)
   exit(1);
   }
 
+int req_subscribe(batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_subscribe needs to be mocked!!\n");
+  exit(1);
+  }
+
 int req_stat_svr(batch_request *preq)
   {
   fprintf(stderr, "The call to req_stat_svr needs to be mocked!!\n");
@@ -253,6 +260,18 @@ void req_commit(struct batch_request *preq)
   exit(1);
   }
 
+int req_submitjob(struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_submitjob needs to be mocked!!\n");
+  exit(1);
+  }
+
+int req_submitmany(struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_submitmany needs to be mocked!!\n");
+  exit(1);
+  }
+
 void reply_free(struct batch_reply *prep) {}
 
 void free_attrlist(tlist_head *pattrlisthead) 
@@ -381,6 +400,12 @@ int req_runjob(batch_request *preq)
   exit(1);
   }
 
+int req_runjobs(batch_request *preq)
+  {
+  fprintf(stderr, "The call to req_runjobs needs to be mocked!!\n");
+  exit(1);
+  }
+
 int req_jobcredential(batch_request *preq)
   {
   fprintf(stderr, "The call to req_jobcredential needs to be mocked!!\n");
@@ -514,3 +539,16 @@ void log_event(int eventtype, int objclass, const char *objname, const char *tex
   }
 
 
+int req_opensession(struct batch_request *preq)
+  {
+  return(0);
+  }
+
+void session_hold(client_session *cs) {}
+
+void session_release(client_session *cs) {}
+
+bool session_dispatch(struct batch_request *preq)
+  {
+  return(false);
+  }
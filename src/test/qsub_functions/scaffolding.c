@@ -284,6 +284,39 @@ int pbs_submit_hash(
   exit(1);
   }
 
+int pbs_submit_commit_hash(
+
+  int                 socket,
+  job_data_container *job_attr,
+  job_data_container *res_attr,
+  char               *script,
+  char               *destination,
+  char               *extend,  /* (optional) */
+  char               **return_jobid,
+  char               **msg)
+
+  {
+  fprintf(stderr, "The call to pbs_submit_commit_hash to be mocked!!\n");
+  exit(1);
+  }
+
+int pbs_submit_many(
+
+  int                  socket,
+  int                  count,
+  job_data_container **job_attrs,
+  job_data_container **res_attrs,
+  char               **scripts,
+  char               **destinations,
+  char                *extend,
+  char               **return_jobids,
+  int                 *return_codes)
+
+  {
+  fprintf(stderr, "The call to pbs_submit_many to be mocked!!\n");
+  exit(1);
+  }
+
 int hash_count(job_data_container *head)
   {
   fprintf(stderr, "The call to hash_count to be mocked!!\n");
@@ -343,6 +376,8 @@ void complete_req::add_req(req &r)
   added_req = true;
   }
 
+void complete_req::clear_reqs() {}
+
 req::req()
 
   {
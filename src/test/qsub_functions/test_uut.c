@@ -13,6 +13,7 @@ void process_opt_L(const char *str);
 void validate_basic_resourcing(job_info *ji);
 void add_new_request_if_present(job_info *ji);
 bool retry_submit_error(int error);
+char *extract_batch_file(int &argc, char **argv);
 int  process_opt_d(job_info *ji, const char *cmd_arg, int data_type, job_data *tmp_job_info);
 int  process_opt_j(job_info *ji, const char *cmd_arg, int data_type);
 int  process_opt_k(job_info *ji, const char *cmd_arg, int data_type);
@@ -131,6 +132,38 @@ START_TEST(test_retry_submit_error)
 END_TEST
 
 
+START_TEST(test_extract_batch_file)
+  {
+  char  qsub[] = "qsub";
+  char  opt[] = "--batch-file";
+  char  path[] = "jobs.txt";
+  char  l[] = "-l";
+  char  nodes[] = "nodes=1";
+  char  eq[] = "--batch-file=more.txt";
+  char *argv1[] = { qsub, l, nodes, opt, path, NULL };
+  char *argv2[] = { qsub, eq, l, nodes, NULL };
+  char *argv3[] = { qsub, l, nodes, NULL };
+  int   argc;
+
+  argc = 5;
+  fail_unless(!strcmp(extract_batch_file(argc, argv1), "jobs.txt"));
+  fail_unless(argc == 3);
+  fail_unless(argv1[2] == nodes);
+  fail_unless(argv1[3] == NULL);
+
+  argc = 4;
+  fail_unless(!strcmp(extract_batch_file(argc, argv2), "more.txt"));
+  fail_unless(argc == 3);
+  fail_unless(argv2[1] == l);
+  fail_unless(argv2[3] == NULL);
+
+  argc = 3;
+  fail_unless(extract_batch_file(argc, argv3) == NULL);
+  fail_unless(argc == 3);
+  }
+END_TEST
+
+
 START_TEST(test_process_opt_d)
   {
   job_info    ji;
@@ -332,6 +365,7 @@ Suite *qsub_functions_suite(void)
   tcase_add_test(tc_core, test_process_opt_m);
   tcase_add_test(tc_core, test_process_opt_p);
   tcase_add_test(tc_core, test_retry_submit_error);
+  tcase_add_test(tc_core, test_extract_batch_file);
   suite_add_tcase(s, tc_core);
 
   tc_core = tcase_create("test isWindowsFormat");
@@ -7,6 +7,7 @@
 #include "attribute.h" /* pbs_attribute */
 #include "pbs_job.h" /* job */
 #include "user_info.h"
+#include "change_log.hpp"
 
 const char *msg_err_unlink = "Unlink of %s file %s failed";
 all_queues svr_queues;
@@ -66,3 +67,16 @@ void free_user_info_holder(user_info_holder *uih) {}
 void log_err(int errnum, const char *routine, const char *text) {}
 void log_record(int eventtype, int objclass, const char *objname, const char *text) {}
 void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
+
+change_log server_changes(0, 0);
+
+change_log::change_log(long long start, size_t max) {}
+
+change_log::~change_log() {}
+
+long long change_log::next()
+  {
+  return(0);
+  }
+
+void change_log::record_deletion(int objtype, const char *name, const char *container) {}
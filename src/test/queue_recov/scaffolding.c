@@ -7,6 +7,7 @@
 
 #include "attribute.h" /* attribute_def, pbs_attribute */
 #include "queue.h" /* pbs_queue */
+#include "change_log.hpp"
 
 pthread_mutex_t *setup_save_mutex = NULL;
 char *path_queues;
@@ -120,4 +121,13 @@ char *trim(
   return(front_ptr);
   } /* END trim() */
 
+change_log server_changes(0, 0);
 
+change_log::change_log(long long start, size_t max) {}
+
+change_log::~change_log() {}
+
+long long change_log::next()
+  {
+  return(0);
+  }
@@ -908,3 +908,5 @@ bool task_hosts_match(const char *one, const char *two)
 #include "../../src/lib/Libattr/req.cpp"
 #include "../../src/lib/Libattr/complete_req.cpp"
 //#include "../../src/lib/Libattr/attr_fn_str.c"
+
+void node_changed(struct pbsnode *pnode) {}
@@ -14,6 +14,7 @@
 #include "node_func.h" /* node_info */
 #include "threadpool.h"
 #include "delete_all_tracker.hpp"
+#include "client_session.h"
 
 int lock_ji_mutex(job *pjob, const char *id, const char *msg, int logging);
 int unlock_ji_mutex(job *pjob, const char *id, const char *msg, int logging);
@@ -568,3 +569,38 @@ int depend_on_term(
   }
 
 
+void session_hold(client_session *cs) {}
+
+int get_subjob_index(const char *job_id, char *parent_id)
+  {
+  return(-1);
+  }
+
+bool is_uncloned_index(job_array *pa, int index)
+  {
+  return(false);
+  }
+
+int remove_uncloned_range(job_array *pa, int start, int end)
+  {
+  return(0);
+  }
+
+void purge_uncloned_subjobs(job_array *pa, int count) {}
+
+int array_delete(job_array *pa)
+  {
+  return(0);
+  }
+
+job_array *get_array(char *id)
+  {
+  return(NULL);
+  }
+
+int svr_authorize_req(struct batch_request *preq, char *owner, char *submit_host)
+  {
+  return(0);
+  }
+
+void get_jobowner(char *from, char *to) {}
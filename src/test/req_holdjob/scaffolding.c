@@ -156,3 +156,5 @@ batch_request *duplicate_request(batch_request *preq, int type)
   {
   return(NULL);
   }
+
+void hold_array_template(job_array *pa, pbs_attribute *temphold, enum batch_op op) {}
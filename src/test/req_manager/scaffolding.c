@@ -431,3 +431,7 @@ int get_svr_attr_l(
   {
   return(0);
   }
+
+void update_node_index(struct pbsnode *pnode) {}
+
+void node_changed(struct pbsnode *pnode) {}
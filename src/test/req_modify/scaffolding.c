@@ -14,6 +14,7 @@
 #include "work_task.h" /* work_task */
 #include "dynamic_string.h"
 #include "threadpool.h"
+#include "change_log.hpp"
 
 const char *PJobSubState[10];
 int svr_resc_size = 0;
@@ -292,3 +293,14 @@ void overwrite_complete_req(
 
   pbs_attribute *attr,
   pbs_attribute *new_attr) {}
+
+change_log server_changes(0, 0);
+
+change_log::change_log(long long start, size_t max) {}
+
+change_log::~change_log() {}
+
+long long change_log::next()
+  {
+  return(0);
+  }
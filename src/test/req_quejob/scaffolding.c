@@ -90,6 +90,15 @@ void reply_ack(struct batch_request *preq)
   {
   }
 
+void reply_text(struct batch_request *preq, int code, const char *text)
+  {
+  }
+
+batch_request *alloc_br(int type)
+  {
+  return((batch_request *)calloc(1, sizeof(batch_request)));
+  }
+
 int svr_authorize_jobreq(struct batch_request *preq, job *pjob)
   {
   return 0;
@@ -112,6 +112,18 @@ void reply_ack(struct batch_request *preq)
   exit(1);
   }
 
+void reply_text(struct batch_request *preq, int code, const char *text)
+  {
+  fprintf(stderr, "The call to reply_text to be mocked!!\n");
+  exit(1);
+  }
+
+batch_request *alloc_br(int type)
+  {
+  fprintf(stderr, "The call to alloc_br to be mocked!!\n");
+  exit(1);
+  }
+
 void free_nodes(job *)
   {
   fprintf(stderr, "The call to free_nodes to be mocked!!\n");
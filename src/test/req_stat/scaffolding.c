@@ -14,6 +14,7 @@
 #include "work_task.h" /* work_task, work_type */
 #include "u_tree.h" /* AvlTree */
 #include "queue.h"
+#include "change_log.hpp"
 
 all_nodes allnodes;
 pthread_mutex_t *netrates_mutex = NULL;
@@ -78,6 +79,23 @@ int reply_send_svr(struct batch_request *request)
   exit(1);
   }
 
+struct tcp_chan *reply_stream_start(struct batch_request *preq)
+  {
+  return(NULL);
+  }
+
+int reply_stream_status(struct tcp_chan *chan, struct batch_request *preq)
+  {
+  fprintf(stderr, "The call to reply_stream_status to be mocked!!\n");
+  exit(1);
+  }
+
+int reply_stream_end(struct tcp_chan *chan, struct batch_request *preq, int code, int auxcode)
+  {
+  fprintf(stderr, "The call to reply_stream_end to be mocked!!\n");
+  exit(1);
+  }
+
 void free_br(struct batch_request *preq)
   {
   fprintf(stderr, "The call to free_br to be mocked!!\n");
@@ -344,3 +362,43 @@ void log_record(int eventtype, int objclass, const char *objname, const char *te
 void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
 
 int svr_unresolvednodes = 0;
+
+change_log server_changes(0, 0);
+
+change_log::change_log(long long start, size_t max) {}
+
+change_log::~change_log() {}
+
+long long change_log::current()
+  {
+  return(0);
+  }
+
+bool change_log::get_deletions(int objtype, const char *container, long long since, std::vector<std::string> &names)
+  {
+  return(true);
+  }
+
+void get_timer_lateness(long lateness[3]) {}
+
+int get_subjob_index(const char *job_id, char *parent_id)
+  {
+  return(-1);
+  }
+
+bool is_uncloned_index(job_array *pa, int index)
+  {
+  return(false);
+  }
+
+bool is_uncloned_subjob(const char *job_id)
+  {
+  return(false);
+  }
+
+int status_uncloned_subjob(job *template_job, int index, struct batch_request *preq, svrattrl *pal, tlist_head *pstathd, int *bad)
+  {
+  return(0);
+  }
+
+void get_mail_queue_stats(unsigned long stats[4]) {}
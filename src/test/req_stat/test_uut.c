@@ -8,6 +8,7 @@
 
 bool in_execution_queue(job *pjob, job_array *pa);
 job *get_next_status_job(struct stat_cntl *cntl, int &job_array_index, job_array *pa, all_jobs_iterator *iter);
+int get_changed_since(struct batch_request *preq, long long &since);
 extern int abort_called;
 
 enum TJobStatTypeEnum
@@ -107,6 +108,39 @@ START_TEST(test_get_next_status_job)
 END_TEST
 
 
+
+START_TEST(test_get_changed_since)
+  {
+  batch_request preq;
+  long long     since = 5;
+
+  memset(&preq, 0, sizeof(preq));
+
+  fail_unless(get_changed_since(&preq, since) == PBSE_NONE);
+  fail_unless(since == -1);
+
+  preq.rq_extend = strdup("exec_queue_only");
+  fail_unless(get_changed_since(&preq, since) == PBSE_NONE);
+  fail_unless(since == -1);
+
+  preq.rq_extend = strdup("changed_since=1234567");
+  fail_unless(get_changed_since(&preq, since) == PBSE_NONE);
+  fail_unless(since == 1234567);
+
+  preq.rq_extend = strdup("changed_since=0C");
+  fail_unless(get_changed_since(&preq, since) == PBSE_NONE);
+  fail_unless(since == 0);
+
+  preq.rq_extend = strdup("changed_since=");
+  fail_unless(get_changed_since(&preq, since) == PBSE_IVALREQ);
+  fail_unless(since == -1);
+
+  preq.rq_extend = strdup("changed_since=-4");
+  fail_unless(get_changed_since(&preq, since) == PBSE_IVALREQ);
+  }
+END_TEST
+
+
 Suite *req_stat_suite(void)
   {
   Suite *s = suite_create("req_stat_suite methods");
@@ -119,6 +153,10 @@ Suite *req_stat_suite(void)
   tcase_add_test(tc_core, test_get_next_status_job);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_get_changed_since");
+  tcase_add_test(tc_core, test_get_changed_since);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
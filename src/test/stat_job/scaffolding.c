@@ -1,11 +1,15 @@
 #include "license_pbs.h" /* See here for the software license */
+#include <pbs_config.h>
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <string.h>
 
 #include "attribute.h" /* attribute_def, svrattrl */
 #include "server.h" /* server */
 #include "batch_request.h" /* batch_request */
 #include "list_link.h" /* list_link */
+#include "dis.h"
+#include "tcp.h"
 
 attribute_def job_attr_def[10];
 struct server server;
@@ -32,8 +36,10 @@ int find_attr(struct attribute_def *attr_def, const char *name, int limit)
 
 void *get_next(list_link pl, char *file, int line)
   {
-  fprintf(stderr, "The call to get_next to be mocked!!\n");
-  exit(1);
+  if (pl.ll_next == NULL)
+    return(NULL);
+
+  return(pl.ll_next->ll_struct);
   }
 
 void append_link(tlist_head *head, list_link *new_link, void *pobj)
@@ -42,6 +48,18 @@ void append_link(tlist_head *head, list_link *new_link, void *pobj)
   exit(1);
   }
 
+void insert_link(struct list_link *old, struct list_link *new_link, void *pobj, int position)
+  {
+  fprintf(stderr, "The call to insert_link to be mocked!!\n");
+  exit(1);
+  }
+
+void delete_link(struct list_link *old)
+  {
+  fprintf(stderr, "The call to delete_link to be mocked!!\n");
+  exit(1);
+  }
+
 int get_svr_attr_l(int index, long *l)
   {
   return(0);
@@ -56,3 +74,31 @@ int remove_procct(
   {
   return(0);
   }
+
+struct tcp_chan *DIS_buf_setup(void)
+  {
+  struct tcp_chan *chan = (struct tcp_chan *)calloc(1, sizeof(struct tcp_chan));
+
+  chan->writebuf.tdis_thebuf = strdup("2+3+abc");
+  chan->writebuf.tdis_trailp = chan->writebuf.tdis_thebuf + strlen("2+3+abc");
+
+  return(chan);
+  }
+
+char *DIS_buf_data(struct tcp_chan *chan, size_t *len)
+  {
+  *len = chan->writebuf.tdis_trailp - chan->writebuf.tdis_thebuf;
+
+  return(chan->writebuf.tdis_thebuf);
+  }
+
+void DIS_tcp_cleanup(struct tcp_chan *chan)
+  {
+  free(chan->writebuf.tdis_thebuf);
+  free(chan);
+  }
+
+int encode_DIS_svrattrl(struct tcp_chan *chan, svrattrl *psattl)
+  {
+  return(0);
+  }
@@ -1,12 +1,18 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "pbs_error.h"
+#include "libpbs.h"
 #include "pbs_job.h"
 #include "test_stat_job.h"
 
 bool include_in_status(int index);
+bool job_stat_cacheable(job *pjob);
+int  stat_cache_key(int priv, int IsOwner, bool condensed, int encoding);
+bool get_cached_job_status(job *pjob, int key, struct brp_status *pstat);
+void cache_job_status(job *pjob, int key, tlist_head *phead);
 
 
 START_TEST(test_include_in_status)
@@ -37,10 +43,55 @@ START_TEST(test_include_in_status)
   }
 END_TEST
 
-START_TEST(test_two)
+START_TEST(test_job_stat_cache)
   {
+  job               *pjob = (job *)calloc(1, sizeof(job));
+  struct brp_status  stat;
+  tlist_head         head;
+  int                key = stat_cache_key(ATR_DFLAG_USRD, 1, false, DIS_ENCODING_CLASSIC);
 
+  CLEAR_HEAD(head);
+  memset(&stat, 0, sizeof(stat));
 
+  pjob->ji_qs.ji_state = JOB_STATE_QUEUED;
+  pjob->ji_qs.ji_substate = JOB_SUBSTATE_QUEUED;
+  fail_unless(job_stat_cacheable(pjob) == true);
+
+  pjob->ji_modified = 1;
+  fail_unless(job_stat_cacheable(pjob) == false);
+  pjob->ji_modified = 0;
+
+  pjob->ji_qs.ji_state = JOB_STATE_RUNNING;
+  fail_unless(job_stat_cacheable(pjob) == false);
+  pjob->ji_qs.ji_state = JOB_STATE_QUEUED;
+
+  fail_unless(key != stat_cache_key(ATR_DFLAG_USRD, 0, false, DIS_ENCODING_CLASSIC));
+  fail_unless(key != stat_cache_key(ATR_DFLAG_USRD, 1, true, DIS_ENCODING_CLASSIC));
+  fail_unless(key != stat_cache_key(ATR_DFLAG_MGRD, 1, false, DIS_ENCODING_CLASSIC));
+  fail_unless(key != stat_cache_key(ATR_DFLAG_USRD, 1, false, DIS_ENCODING_BINARY));
+
+  fail_unless(get_cached_job_status(pjob, key, &stat) == false);
+
+  cache_job_status(pjob, key, &head);
+  fail_unless(pjob->ji_stat_cache != NULL);
+  fail_unless(pjob->ji_stat_cache->jsc_len == strlen("2+3+abc"));
+
+  fail_unless(get_cached_job_status(pjob, key, &stat) == true);
+  fail_unless(stat.brp_encoded_len == strlen("2+3+abc"));
+  fail_unless(memcmp(stat.brp_encoded, "2+3+abc", stat.brp_encoded_len) == 0);
+  free(stat.brp_encoded);
+  stat.brp_encoded = NULL;
+
+  /* another requester or a state change misses the cache */
+  fail_unless(get_cached_job_status(pjob, stat_cache_key(ATR_DFLAG_USRD, 0, false, DIS_ENCODING_CLASSIC), &stat) == false);
+  pjob->ji_qs.ji_substate = JOB_SUBSTATE_HELD;
+  fail_unless(get_cached_job_status(pjob, key, &stat) == false);
+  fail_unless(stat.brp_encoded == NULL);
+
+  job_stat_cache_invalidate(pjob);
+  fail_unless(pjob->ji_stat_cache == NULL);
+
+  free(pjob);
   }
 END_TEST
 
@@ -51,8 +102,8 @@ Suite *stat_job_suite(void)
   tcase_add_test(tc_core, test_include_in_status);
   suite_add_tcase(s, tc_core);
 
-  tc_core = tcase_create("test_two");
-  tcase_add_test(tc_core, test_two);
+  tc_core = tcase_create("test_job_stat_cache");
+  tcase_add_test(tc_core, test_job_stat_cache);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -74,6 +74,12 @@ int add_conn(int sock, enum conn_type type, pbs_net_t addr, unsigned int port, u
   exit(1);
   }
 
+int add_scheduler_conn(int sock, enum conn_type type, pbs_net_t addr, unsigned int port, unsigned int socktype, void *(*func)(void *))
+  {
+  fprintf(stderr, "The call to add_scheduler_conn to be mocked!!\n");
+  exit(1);
+  }
+
 int client_to_svr(pbs_net_t hostaddr, unsigned int port, int local_port, char *EMsg)
   {
   return(0);
@@ -20,6 +20,8 @@
 #include "machine.hpp"
 #include "log.h"
 #include "utils.h"
+#include "job_index.hpp"
+#include "change_log.hpp"
 
 all_nodes               allnodes;
 bool possible = false;
@@ -32,6 +34,7 @@ const char *msg_daemonname = "unset";
 attribute_def job_attr_def[JOB_ATR_LAST];
 const char *msg_badwait = "Invalid time in work task for waiting, job = %s";
 all_jobs alljobs;
+job_index alljobs_index;
 const char *pbs_o_host = "PBS_O_HOST";
 extern resource_def *svr_resc_def;
 int svr_clnodes = 0;
@@ -371,6 +374,10 @@ void log_err(int errnum, const char *routine, const char *text) {}
 void log_record(int eventtype, int objclass, const char *objname, const char *text) {}
 void log_event(int eventtype, int objclass, const char *objname, const char *text) {}
 
+void job_stat_cache_invalidate(job *pjob) {}
+
+void job_events_publish(job *pjob, int flags) {}
+
 int remove_procct(job *pjob)
   {
   return(0);
@@ -704,7 +711,24 @@ struct group *getgrnam_ext(
 
 Machine::Machine() {}
 
+job_index::job_index() {}
+job_index::~job_index() {}
+void job_index::insert(const std::string &id, job *pjob) {}
+
 
 #include "../../lib/Libattr/req.cpp"
 #include "../../lib/Libattr/complete_req.cpp"
 #include "../../lib/Libattr/attr_req_info.cpp"
+
+change_log server_changes(0, 0);
+
+change_log::change_log(long long start, size_t max) {}
+
+change_log::~change_log() {}
+
+long long change_log::next()
+  {
+  return(0);
+  }
+
+void change_log::record_deletion(int objtype, const char *name, const char *container) {}
@@ -14,8 +14,6 @@
 #include "attribute.h" /* svrattrl */
 #include "work_task.h"
 
-extern void *send_the_mail(void *vp);
-
 pthread_mutex_t *scheduler_sock_jobct_mutex;
 int scheduler_sock=0;
 attribute_def svr_attr_def[10];
@@ -25,15 +23,10 @@ pthread_mutex_t *svr_do_schedule_mutex;
 pthread_mutex_t *listener_command_mutex;
 int listening_socket;
 threadpool_t *task_pool;
+char server_host[PBS_MAXHOSTNAME + 1] = "napali";
 
 int LOGLEVEL = 7; /* force logging code to be exercised as tests run */
 
-int enqueue_threadpool_request(void *(*func)(void *), void *arg, threadpool_t *tp)
-  {
-  send_the_mail((mail_info *)arg);
-  return 0;
-  }
-
 resource *find_resc_entry(pbs_attribute *pattr, resource_def *rscdf) 
   { 
   fprintf(stderr, "The call to find_ersc_entry need to be mocked!!\n");
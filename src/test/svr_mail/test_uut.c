@@ -8,8 +8,10 @@
 #include <unistd.h>
 #include <errno.h>
 #include "test_svr_mail.h"
+#include "svr_mail.h"
 
 struct server server;
+extern unsigned int mail_queue_max;
 
 const char owner[] = "xowner";
 const char jobid[] = "123";
@@ -246,6 +248,84 @@ START_TEST(test_with_eo_when_complete)
   }
 END_TEST
 
+mail_info *make_mail_info(const char *id, const char *to)
+  {
+  mail_info *mi = (mail_info *)calloc(1, sizeof(mail_info));
+
+  mi->jobid = strdup(id);
+  mi->mailto = strdup(to);
+  mi->jobname = strdup(jobname);
+  mi->mail_point = MAIL_END;
+
+  return(mi);
+  }
+
+START_TEST(test_compose_mail)
+  {
+  std::vector<mail_info *> msgs;
+  const char *subject = "Subject: PBS: 2 job notifications";
+  const char *first = "PBS Job Id: 1.napali";
+  const char *second = "PBS Job Id: 2.napali";
+  const char *single = "Subject: PBS JOB 1.napali";
+  char       *text;
+
+  msgs.push_back(make_mail_info("1.napali", "dbeer@napali"));
+
+  text = compose_mail(msgs);
+  fail_unless(text != NULL);
+  fail_unless(strstr(text, single) != NULL);
+  fail_unless(strstr(text, second) == NULL);
+  free(text);
+
+  // two notifications for the same recipient go out as one message
+  msgs.push_back(make_mail_info("2.napali", "dbeer@napali"));
+
+  text = compose_mail(msgs);
+  fail_unless(text != NULL);
+  fail_unless(strstr(text, subject) != NULL);
+  fail_unless(strstr(text, first) != NULL);
+  fail_unless(strstr(text, second) > strstr(text, first));
+  free(text);
+
+  free_mail_info(msgs[0]);
+  free_mail_info(msgs[1]);
+  }
+END_TEST
+
+START_TEST(test_smtp_data)
+  {
+  std::string data;
+  const char *stuffed = ".hidden\n\nlast line";
+  const char *stuffed_data = "..hidden\r\n\r\nlast line\r\n.\r\n";
+  const char *ended = "Subject: x\n\nbody\n";
+  const char *ended_data = "Subject: x\r\n\r\nbody\r\n.\r\n";
+
+  smtp_data(stuffed, data);
+  fail_unless(data == stuffed_data);
+
+  smtp_data(ended, data);
+  fail_unless(data == ended_data);
+  }
+END_TEST
+
+START_TEST(test_queue_full)
+  {
+  unsigned long before[4];
+  unsigned long after[4];
+
+  get_mail_queue_stats(before);
+
+  // nothing fits, so the notification is dropped and counted
+  mail_queue_max = 0;
+  fail_unless(queue_mail(make_mail_info("3.napali", "dbeer@napali")) == PBSE_RESCUNAV);
+  mail_queue_max = 10000;
+
+  get_mail_queue_stats(after);
+  fail_unless(after[2] == before[2] + 1);
+  fail_unless(after[0] == 0);
+  }
+END_TEST
+
 Suite *svr_mail_suite(void)
   {
   Suite *s = suite_create("svr_mail_suite methods");
@@ -261,6 +341,18 @@ Suite *svr_mail_suite(void)
   tcase_add_test(tc_core, test_with_eo_when_complete);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("test_compose_mail");
+  tcase_add_test(tc_core, test_compose_mail);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_smtp_data");
+  tcase_add_test(tc_core, test_smtp_data);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_queue_full");
+  tcase_add_test(tc_core, test_queue_full);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
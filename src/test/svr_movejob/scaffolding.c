@@ -12,6 +12,7 @@
 #include "list_link.h" /* tlist_head, list_link */
 #include "threadpool.h"
 #include "array.h"
+#include "mom_connection_pool.hpp"
 
 threadpool_t *request_pool;
 char *path_jobs = strdup("/var/spool/torque/server_priv/jobs/");
@@ -439,4 +440,16 @@ std::string get_path_jobdata(const char *a, const char *b)
   return ret_string;
   }
 
+mom_connection_pool::mom_connection_pool(unsigned int max_idle, time_t idle_timeout) {}
 
+mom_connection_pool::~mom_connection_pool() {}
+
+int mom_connection_pool::get(pbs_net_t addr, unsigned short port, int *my_err, bool *reused)
+  {
+  *reused = false;
+  return(svr_connect(addr, port, my_err, NULL, NULL));
+  }
+
+void mom_connection_pool::release(pbs_net_t addr, unsigned short port, int handle, bool usable) {}
+
+mom_connection_pool mom_connections(8, 60);
@@ -11,7 +11,6 @@
 #define FALSE 0
 all_tasks             task_list_event;
 task_recycler         tr;
-pthread_mutex_t       task_list_timed_mutex;
 
 threadpool_t         *task_pool;
 threadpool_t         *request_pool;
@@ -16,7 +16,6 @@ int          dispatch_timed_task(work_task *ptask);
 extern all_tasks      task_list_event;
 extern task_recycler  tr;
 extern threadpool_t  *request_pool;
-extern std::list<timed_task> *task_list_timed;
 
 START_TEST(dispatch_timed_task_test)
   {
@@ -26,9 +25,6 @@ START_TEST(dispatch_timed_task_test)
   wt.wt_mutex = (pthread_mutex_t *)calloc(1, sizeof(pthread_mutex_t));
   wt.wt_event = 200;
 
-  if (task_list_timed == NULL)
-    task_list_timed = new std::list<timed_task>();
-
   if (request_pool == NULL)
     initialize_threadpool(&request_pool,10,50,50);
   request_pool->tp_max_threads = 50;
@@ -73,9 +69,6 @@ START_TEST(manage_timed_task_test)
   memset(&ptask2, 0, sizeof(ptask2));
   memset(&ptask3, 0, sizeof(ptask3));
 
-  if (task_list_timed == NULL)
-    task_list_timed = new std::list<timed_task>();
-
   ptask1.wt_event = 100;
   ptask2.wt_event = 200;
   ptask3.wt_event = 300;
@@ -103,15 +96,84 @@ START_TEST(manage_timed_task_test)
   }
 END_TEST
 
+START_TEST(timed_task_heap_test)
+  {
+  timed_task_heap  th;
+  work_task        tasks[50];
+  long             lateness[3];
+  work_task       *wt;
+  long             last = 0;
+
+  memset(tasks, 0, sizeof(tasks));
+
+  for (int i = 0; i < 50; i++)
+    {
+    tasks[i].wt_event = (i * 37) % 50 + 100;
+    th.insert(tasks + i);
+    }
+
+  fail_unless(th.size() == 50);
+
+  // cancel a few, including one twice
+  fail_unless(th.remove(tasks + 3) == true);
+  fail_unless(th.remove(tasks + 3) == false);
+  fail_unless(th.remove(tasks + 20) == true);
+  fail_unless(th.remove(tasks + 49) == true);
+  fail_unless(th.size() == 47);
+  fail_unless(tasks[3].wt_heap_pos == 0);
+
+  fail_unless(th.pop(99) == NULL);
+
+  for (int i = 0; i < 47; i++)
+    {
+    wt = th.pop(200);
+    fail_unless(wt != NULL);
+    fail_unless(wt != tasks + 3);
+    fail_unless(wt != tasks + 20);
+    fail_unless(wt != tasks + 49);
+    fail_unless(wt->wt_event >= last);
+    fail_unless(wt->wt_heap_pos == 0);
+    last = wt->wt_event;
+    }
+
+  fail_unless(th.pop(200) == NULL);
+  fail_unless(th.size() == 0);
+
+  // the tasks were popped up to 100 seconds late
+  th.get_lateness(200, lateness);
+  fail_unless(lateness[0] == 0);
+  fail_unless(lateness[1] == 100);
+  fail_unless(lateness[2] == 47);
+
+  // a task waiting past its time
+  tasks[0].wt_event = 150;
+  th.insert(tasks);
+  th.get_lateness(230, lateness);
+  fail_unless(lateness[0] == 80);
+  fail_unless(lateness[1] == 100);
+
+  // the worst lateness is forgotten after a minute
+  th.get_lateness(300, lateness);
+  fail_unless(lateness[1] == 0);
+  fail_unless(lateness[2] == 47);
+
+  // tasks due at the same time come out in the order they were added
+  tasks[1].wt_event = 150;
+  tasks[2].wt_event = 150;
+  th.insert(tasks + 1);
+  th.insert(tasks + 2);
+  fail_unless(th.pop(150) == tasks);
+  fail_unless(th.pop(150) == tasks + 1);
+  fail_unless(th.pop(150) == tasks + 2);
+  }
+END_TEST
+
 START_TEST(test_one)
   {
   int rc;
   task_list_event.tasks.clear();
   initialize_task_recycler();
 
-  if (task_list_timed == NULL)
-    task_list_timed = new std::list<timed_task>();
-
   rc = initialize_threadpool(&request_pool, 5, 50, 60);
   fail_unless(rc == PBSE_NONE, "initalize_threadpool failed", rc);
 
@@ -147,6 +209,10 @@ Suite *svr_task_suite(void)
   tcase_add_test(tc_core, dispatch_timed_task_test);
   suite_add_tcase(s, tc_core);
 
+  tc_core = tcase_create("timed_task_heap_test");
+  tcase_add_test(tc_core, timed_task_heap_test);
+  suite_add_tcase(s, tc_core);
+
   return s;
   }
 
@@ -1,6 +1,8 @@
 #include "license_pbs.h" /* See here for the software license */
 #include <stdlib.h>
 #include <stdio.h> /* fprintf */
+#include <string.h>
+#include <sys/uio.h>
 #include "tcp.h"
 
 ssize_t read_nonblocking_socket(int fd, void *buf, ssize_t count)
@@ -29,10 +31,23 @@ int unlock_tcp_table()
 
 void log_err(int errnum, const char *routine, const char *text) {}
 
+const char *socket_read_data = NULL;
+long long   socket_read_len = 0;
+
 int socket_read(int socket, char **the_str, long long *str_len, unsigned int timeout)
   {
-  fprintf(stderr, "The call to socket_read needs to be mocked!!\n");
-  return(1);
+  if (socket_read_data == NULL)
+    {
+    fprintf(stderr, "The call to socket_read needs to be mocked!!\n");
+    return(1);
+    }
+
+  *the_str = (char *)malloc(socket_read_len);
+  memcpy(*the_str, socket_read_data, socket_read_len);
+  *str_len = socket_read_len;
+  socket_read_data = NULL;
+
+  return(0);
   }
 
 ssize_t write_ac_socket(int fd, const void *buf, ssize_t count)
@@ -40,6 +55,11 @@ ssize_t write_ac_socket(int fd, const void *buf, ssize_t count)
   return(0);
   }
 
+ssize_t writev_ac_socket(int fd, const struct iovec *iov, int iovcnt)
+  {
+  return(writev(fd, iov, iovcnt));
+  }
+
 ssize_t read_ac_socket(int fd, void *buf, ssize_t count)
   {
   return(0);
@@ -3,33 +3,187 @@
 #include "test_tcp_dis.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
-
+#include "dis.h"
+#include "tcp.h"
 #include "pbs_error.h"
 
-START_TEST(test_one)
+extern const char *socket_read_data;
+extern long long   socket_read_len;
+
+/* fill buf with a pattern that has NULs and high bytes in it */
+
+void fill_pattern(
+
+  char   *buf,
+  size_t  len,
+  int     seed)
+
+  {
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    buf[i] = (char)((i * 7 + seed) & 0xff);
+  }
+
+
+
+START_TEST(test_pool_reuse)
+  {
+  struct tcp_chan *chan = DIS_tcp_setup(10);
+  char            *rbuf;
+  char            *wbuf;
+
+  fail_unless(chan != NULL);
+  rbuf = chan->readbuf.tdis_thebuf;
+  wbuf = chan->writebuf.tdis_thebuf;
+  fail_unless(chan->writebuf.tdis_bufsize > 0);
+  DIS_tcp_cleanup(chan);
+
+  /* the buffers just given back are handed out again */
+  chan = DIS_tcp_setup(11);
+  fail_unless(chan != NULL);
+  fail_unless((chan->readbuf.tdis_thebuf == rbuf) || (chan->readbuf.tdis_thebuf == wbuf));
+  fail_unless((chan->writebuf.tdis_thebuf == rbuf) || (chan->writebuf.tdis_thebuf == wbuf));
+  DIS_tcp_cleanup(chan);
+
+  fail_unless(DIS_tcp_setup(-1) == NULL);
+  }
+END_TEST
+
+
+
+START_TEST(test_write_chain)
+  {
+  struct tcp_chan *chan = DIS_buf_setup();
+  char            *expected = (char *)malloc(300000);
+  char            *data;
+  size_t           len = 0;
+  size_t           i;
+
+  fail_unless(chan != NULL);
+  fill_pattern(expected, 300000, 3);
+
+  for (i = 0; i < 300000; i += 1000)
+    {
+    fail_unless(tcp_puts(chan, expected + i, 1000) == 1000);
+    tcp_wcommit(chan, TRUE);
+    }
+
+  /* the buffer filled up more than once and was chained, not copied */
+  fail_unless(chan->writebuf.tdis_segs != NULL);
+  fail_unless(DIS_tcp_wpending(chan) == 300000);
+
+  /* uncommitted data that forces a new segment can still be dropped */
+  fail_unless(tcp_puts(chan, expected, 200000) == 200000);
+  tcp_wcommit(chan, FALSE);
+  fail_unless(DIS_tcp_wpending(chan) == 300000);
+
+  data = DIS_buf_data(chan, &len);
+  fail_unless(data != NULL);
+  fail_unless(len == 300000);
+  fail_unless(memcmp(data, expected, len) == 0);
+  fail_unless(chan->writebuf.tdis_segs == NULL);
+
+  /* the data stays put until more is written */
+  fail_unless(DIS_buf_data(chan, &len) == data);
+
+  DIS_tcp_cleanup(chan);
+  free(expected);
+  }
+END_TEST
+
+
+
+START_TEST(test_wflush)
   {
+  FILE            *fp = tmpfile();
+  struct tcp_chan *chan;
+  char            *expected = (char *)malloc(400000);
+  char            *got = (char *)calloc(1, 400000);
+  size_t           i;
+
+  fail_unless(fp != NULL);
+  chan = DIS_tcp_setup(fileno(fp));
+  fail_unless(chan != NULL);
+  fill_pattern(expected, 400000, 5);
+
+  for (i = 0; i < 350000; i += 5000)
+    {
+    fail_unless(tcp_puts(chan, expected + i, 5000) == 5000);
+    tcp_wcommit(chan, TRUE);
+    }
+
+  /* uncommitted data is kept back for the next flush */
+  fail_unless(tcp_puts(chan, expected + 350000, 50000) == 50000);
 
+  fail_unless(DIS_tcp_wflush(chan) == 0);
+  fail_unless(chan->writebuf.tdis_segs == NULL);
+  fail_unless(DIS_tcp_wpending(chan) == 0);
+  fail_unless(ftell(fp) == 350000);
 
+  tcp_wcommit(chan, TRUE);
+  fail_unless(DIS_tcp_wflush(chan) == 0);
+
+  rewind(fp);
+  fail_unless(fread(got, 1, 400000, fp) == 400000);
+  fail_unless(memcmp(got, expected, 400000) == 0);
+
+  DIS_tcp_cleanup(chan);
+  fclose(fp);
+  free(expected);
+  free(got);
   }
 END_TEST
 
-START_TEST(test_two)
+
+
+START_TEST(test_read_grow)
   {
+  struct tcp_chan *chan = DIS_tcp_setup(12);
+  char            *expected = (char *)malloc(100000);
+  char            *got = (char *)calloc(1, 100000);
+
+  fail_unless(chan != NULL);
+  fill_pattern(expected, 100000, 9);
+
+  /* more than the buffer holds, with NULs that must survive the copy */
+  socket_read_data = expected;
+  socket_read_len = 100000;
 
+  fail_unless(tcp_gets(chan, got, 10, 0) == 10);
+  tcp_rcommit(chan, TRUE);
+  fail_unless(tcp_gets(chan, got + 10, 99990, 0) == 99990);
+  fail_unless(memcmp(got, expected, 100000) == 0);
+  fail_unless(tcp_chan_has_data(chan) == FALSE);
 
+  DIS_tcp_cleanup(chan);
+  free(expected);
+  free(got);
   }
 END_TEST
 
+
+
 Suite *tcp_dis_suite(void)
   {
   Suite *s = suite_create("tcp_dis_suite methods");
-  TCase *tc_core = tcase_create("test_one");
-  tcase_add_test(tc_core, test_one);
+  TCase *tc_core = tcase_create("test_pool_reuse");
+  tcase_add_test(tc_core, test_pool_reuse);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_write_chain");
+  tcase_add_test(tc_core, test_write_chain);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("test_wflush");
+  tcase_add_test(tc_core, test_wflush);
   suite_add_tcase(s, tc_core);
 
-  tc_core = tcase_create("test_two");
-  tcase_add_test(tc_core, test_two);
+  tc_core = tcase_create("test_read_grow");
+  tcase_add_test(tc_core, test_read_grow);
   suite_add_tcase(s, tc_core);
 
   return s;
@@ -74,6 +74,18 @@ void DIS_tcp_settimeout(long timeout)  /* I */
   {
   }  /* END DIS_tcp_settimeout() */
 
+std::map<int,int> encodings;
+
+void DIS_tcp_set_encoding(int fd, int encoding)
+  {
+  encodings[fd] = encoding;
+  }
+
+int DIS_tcp_get_encoding(int fd)
+  {
+  return encodings[fd];
+  }
+
 /*
  * tcp_pack_buff - pack existing data into front of buffer
  *
@@ -5,19 +5,102 @@
 #include <stdio.h>
 
 
+#include <unistd.h>
+
 #include "pbs_error.h"
 
+volatile long work_done;
+
+void *count_work(
+
+  void *arg)
+
+  {
+  __sync_add_and_fetch(&work_done, 1);
+  return(NULL);
+  }
+
+void *spawn_work(
+
+  void *arg)
+
+  {
+  threadpool_t *tp = (threadpool_t *)arg;
+  int           i;
+
+  /* work enqueued from a worker lands on that worker's own queue */
+  for (i = 0; i < 10; i++)
+    enqueue_threadpool_request(count_work, NULL, tp);
+
+  __sync_add_and_fetch(&work_done, 1);
+  return(NULL);
+  }
+
+void wait_for_work(
+
+  long expected)
+
+  {
+  int i;
+
+  for (i = 0; (i < 1000) && (work_done < expected); i++)
+    usleep(10000);
+  }
+
 START_TEST(test_one)
   {
+  threadpool_t *tp = NULL;
+  threadpool_t *bad = NULL;
+  tp_stats_t    stats;
+  int           i;
+
+  work_done = 0;
+  fail_unless(initialize_threadpool(&bad, 5, 4, -1) == EINVAL);
+  fail_unless(initialize_threadpool(&tp, 4, 4, -1) == PBSE_NONE);
 
+  for (i = 0; i < 1000; i++)
+    fail_unless(enqueue_threadpool_request(count_work, NULL, tp) == PBSE_NONE);
 
+  get_threadpool_stats(tp, &stats);
+  fail_unless(stats.queue_depth == 1000);
+  fail_unless(stats.completed == 0);
+
+  start_request_pool(tp);
+  wait_for_work(1000);
+  fail_unless(work_done == 1000);
+
+  get_threadpool_stats(tp, &stats);
+  fail_unless(stats.queue_depth == 0);
+  fail_unless(stats.completed == 1000);
+  fail_unless(stats.max_wait_usecs > 0);
+  fail_unless(stats.total_wait_usecs >= stats.max_wait_usecs);
+
+  destroy_request_pool(tp);
   }
 END_TEST
 
 START_TEST(test_two)
   {
+  threadpool_t *tp = NULL;
+  tp_stats_t    stats;
+  int           i;
+
+  work_done = 0;
+  fail_unless(initialize_threadpool(&tp, 2, 8, 1) == PBSE_NONE);
+  start_request_pool(tp);
+
+  for (i = 0; i < 100; i++)
+    enqueue_threadpool_request(spawn_work, tp, tp);
+
+  wait_for_work(1100);
+  fail_unless(work_done == 1100, "only %ld of 1100 work items ran", work_done);
 
+  get_threadpool_stats(tp, &stats);
+  fail_unless(stats.queue_depth == 0);
+  fail_unless(stats.completed == 1100);
+  fail_unless(stats.stolen <= stats.completed);
 
+  destroy_request_pool(tp);
   }
 END_TEST
 